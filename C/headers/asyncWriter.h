@@ -0,0 +1,189 @@
+/**
+ * @file asyncWriter.h
+ * @author Zyno and BlueNZ
+ * @brief Header to the asynchronous writer structure and functions
+ * @version 0.2
+ * @date 2024-06-19
+ *
+ * @note An asynchronous writer owns a fixed set of buffers and two dedicated threads : a writer thread, and a formatting thread.
+ * The files opened on the writer are formatted into one of its buffers : once it is full, it is queued for the writer thread and the next
+ * free buffer is taken. With two buffers or more, a buffer is filled while the previous one is written, so that the formatting overlaps
+ * the disk writes. When every buffer is queued, the formatting waits for the next one to be written : the queue is bounded.
+ *
+ * @note Whole exports can be submitted as jobs (see `submitAsyncJob`) : the formatting thread runs them one after another, so that the
+ * calling thread can go on generating the next map while the previous one is formatted and written.
+ *
+ * @note Without a writer (`NULL`), the files are written synchronously by the calling thread, through a single buffer of their own.
+ */
+
+#ifndef ASYNC_WRITER
+#define ASYNC_WRITER
+
+#include <pthread.h>
+#include <stddef.h>
+#include <stdio.h>
+
+#include "threadPool.h"
+
+// ----- Constants -----
+
+#define ASYNC_BUFFER_SIZE (1 << 20)     /**< the default size of the buffers, in bytes*/
+#define ASYNC_NB_BUFFERS 2              /**< the default number of buffers of a writer : one being filled, one being written*/
+
+// Sync policies
+
+#define ASYNC_SYNC_NEVER        0   /**< the files are closed without waiting for the disk (default)*/
+#define ASYNC_SYNC_ON_CLOSE     1   /**< each file is synced to the disk (`fsync`) before being closed*/
+#define ASYNC_SYNC_EACH_BUFFER  2   /**< each file is synced to the disk after each written buffer*/
+
+// ----- Structure definition -----
+
+/**
+ * @brief A buffer of bytes of a file, filled by its formatting thread then written by the writer thread.
+ *
+ */
+struct asyncBuffer
+{
+    unsigned char* bytes; /**< the bytes of the buffer*/
+    size_t nb_bytes; /**< the number of bytes filled*/
+    struct asyncFile* file; /**< the pointer to the file the bytes belong to*/
+    int closes_file; /**< `1` if the file is closed once the buffer is written*/
+};
+
+typedef struct asyncBuffer asyncBuffer;
+
+/**
+ * @brief A queued job of the formatting thread : the function to run and its argument.
+ *
+ */
+struct asyncJob
+{
+    taskFunction function; /**< the function to run*/
+    void* argument; /**< the argument to pass to the function*/
+    struct asyncJob* next; /**< the pointer to the next job in the queue*/
+};
+
+typedef struct asyncJob asyncJob;
+
+/**
+ * @brief An asynchronous writer : a writer thread with its queue of filled buffers, the free buffers, and a formatting thread with its queue of jobs.
+ *
+ */
+struct asyncWriter
+{
+    pthread_t writer_thread; /**< the thread writing the filled buffers*/
+    pthread_t formatting_thread; /**< the thread running the jobs*/
+    int sync_policy; /**< when the files are synced to the disk (e.g. `ASYNC_SYNC_ON_CLOSE`)*/
+    int nb_buffers; /**< the number of buffers*/
+    size_t buffer_size; /**< the size of each buffer, in bytes*/
+    asyncBuffer* buffers; /**< the array of buffers*/
+    asyncBuffer** queue; /**< the ring buffer of pointers to the filled buffers, in writing order*/
+    int queue_start; /**< the index of the next buffer to write in the queue*/
+    int nb_queued; /**< the number of filled buffers in the queue*/
+    asyncBuffer** free_buffers; /**< the stack of pointers to the free buffers*/
+    int nb_free; /**< the number of free buffers*/
+    int nb_writing; /**< `1` while the writer thread writes a buffer, `0` otherwise*/
+    asyncJob* first_job; /**< the pointer to the next job to run, `NULL` if the queue is empty*/
+    asyncJob* last_job; /**< the pointer to the last queued job*/
+    int nb_running_jobs; /**< `1` while the formatting thread runs a job, `0` otherwise*/
+    int success; /**< `0` once a write failed, until the next `waitAsyncWriter`*/
+    int stop; /**< set to `1` to make both threads exit once their queues are empty*/
+    pthread_mutex_t mutex; /**< the mutex protecting the queues, the free buffers and the flags*/
+    pthread_cond_t buffer_queued; /**< broadcast when a buffer is queued or when the writer stops*/
+    pthread_cond_t job_queued; /**< broadcast when a job is queued or when the writer stops*/
+    pthread_cond_t progressed; /**< broadcast when a buffer is free again or when a job is done*/
+};
+
+typedef struct asyncWriter asyncWriter;
+
+/**
+ * @brief A file written through an asynchronous writer, or synchronously.
+ *
+ */
+struct asyncFile
+{
+    asyncWriter* writer; /**< the pointer to the writer of the file, `NULL` if it is written synchronously*/
+    FILE* f; /**< the file, opened in binary writing mode*/
+    char* path; /**< the path of the file, for the error messages*/
+    asyncBuffer* buffer; /**< the pointer to the buffer being filled, `NULL` if none is taken yet*/
+    int success; /**< `0` once a write failed, marked by the writer thread under its mutex for an asynchronous file*/
+};
+
+typedef struct asyncFile asyncFile;
+
+// ----- Functions -----
+
+/**
+ * @brief Creates a new asynchronous writer and starts its threads.
+ *
+ * @param nb_buffers (int) : the number of buffers, at least `2` for the formatting to overlap the writes (e.g. `ASYNC_NB_BUFFERS`).
+ * @param buffer_size (size_t) : the size of each buffer, in bytes (e.g. `ASYNC_BUFFER_SIZE`).
+ * @param sync_policy (int) : when the files are synced to the disk : `ASYNC_SYNC_NEVER`, `ASYNC_SYNC_ON_CLOSE` or `ASYNC_SYNC_EACH_BUFFER`.
+ * @return asyncWriter* : the pointer to the new writer, `NULL` if its threads could not be started (the files are then written synchronously).
+ */
+asyncWriter* newAsyncWriter(int nb_buffers, size_t buffer_size, int sync_policy);
+
+/**
+ * @brief Opens a file in writing mode at the given path, written by the given writer.
+ *
+ * @param writer (asyncWriter*) : the pointer to the writer. If `NULL`, the file is written synchronously.
+ * @param path (char[]) : the path of the file.
+ * @return asyncFile* : the pointer to the opened file, `NULL` if it could not be opened.
+ */
+asyncFile* openAsyncFile(asyncWriter* writer, char path[]);
+
+/**
+ * @brief Appends the given bytes to the file.
+ *
+ * @param file (asyncFile*) : the pointer to the file.
+ * @param bytes (const void*) : the bytes.
+ * @param nb_bytes (size_t) : the number of bytes.
+ * @return int : `0` if a write of the file already failed, `1` otherwise (the buffers still queued are checked by `waitAsyncWriter`).
+ */
+int writeAsyncFile(asyncFile* file, const void* bytes, size_t nb_bytes);
+
+/**
+ * @brief Appends formatted text to the file, as `fprintf` does. The text is formatted by the calling thread, right in the buffer.
+ *
+ * @param file (asyncFile*) : the pointer to the file.
+ * @param format (const char*) : the format string.
+ * @param ... : the values to format.
+ * @return int : `0` if a write of the file already failed, `1` otherwise (the buffers still queued are checked by `waitAsyncWriter`).
+ */
+int printAsyncFile(asyncFile* file, const char* format, ...);
+
+/**
+ * @brief Closes the file. An asynchronous file is closed by the writer thread once its last buffer is written, with an `fsync` first
+ * if the sync policy of the writer asks for it : the file should not be used anymore, and it is free'd by the writer thread.
+ *
+ * @param file (asyncFile*) : the pointer to the file.
+ * @return int : `0` if a write of the file already failed, `1` otherwise (the buffers still queued are checked by `waitAsyncWriter`).
+ */
+int closeAsyncFile(asyncFile* file);
+
+/**
+ * @brief Queues a job for the formatting thread of the writer. The jobs are run one after another, in their submission order.
+ *
+ * @param writer (asyncWriter*) : the pointer to the writer. If `NULL`, the job is run right away by the calling thread.
+ * @param function (taskFunction) : the function to run.
+ * @param argument (void*) : the argument to pass to the function, which should stay valid until the job is done.
+ */
+void submitAsyncJob(asyncWriter* writer, taskFunction function, void* argument);
+
+/**
+ * @brief Waits until every queued job is done, every queued buffer of the writer is written, and every closed file is closed.
+ *
+ * @param writer (asyncWriter*) : the pointer to the writer, `NULL` for the synchronous files (nothing to wait for).
+ * @return int : `1` if every write since the previous wait succeeded, `0` otherwise.
+ */
+int waitAsyncWriter(asyncWriter* writer);
+
+/**
+ * @brief Waits for the writer (see `waitAsyncWriter`), stops its threads and frees it. Its files should all be closed.
+ *
+ * @param writer (asyncWriter*) : the pointer to the writer, `NULL` for the synchronous files (nothing to free).
+ * @return int : `1` if every write since the previous wait succeeded, `0` otherwise.
+ */
+int freeAsyncWriter(asyncWriter* writer);
+
+#endif
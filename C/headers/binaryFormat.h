@@ -0,0 +1,453 @@
+/**
+ * @file binaryFormat.h
+ * @author Zyno and BlueNZ
+ * @brief Header to the binary container format of the generated structures
+ * @version 0.2
+ * @date 2024-06-19
+ *
+ * @note A binary file is a fixed header of `BINARY_HEADER_SIZE` bytes followed by the samples, row after row. Every number is stored
+ * in little-endian, whatever the machine : on a little-endian machine, raw samples are written and read with single large `fwrite`/`fread`.
+ *
+ * @note With the `BINARY_CODEC_PREDICTIVE` codec, each sample is replaced by its residual to the prediction `left + up - upleft` (per
+ * component), computed on an order-preserving integer view of its bits so that the codec is lossless. The residuals are zigzag encoded
+ * in LEB128 varints : a row only needs the previous one to be decoded. The `BINARY_CODEC_QUANTIZED` codec first rounds the float samples
+ * to multiples of `2^-quantization_bits`, and predicts these integers : the samples of smooth heightmaps then mostly cost one or two bytes.
+ * The rounded integers are kept within 62 bits : non-finite samples, or larger ones, can not be quantized.
+ *
+ * @note Header layout (offsets in bytes) : magic "PGBF" (0), version (4, u16), kind (6, u16), dtype (8, u16), nb_components (10, u16),
+ * width (12, u32), height (16, u32), map_width (20, u32), map_height (24, u32), chunk_width (28, u32), chunk_height (32, u32),
+ * number_of_layers (36, u32), size_factor (40, u32), nb_records (44, u32), sea_level (48, f64), base_altitude (56, f64), seed (64, u64),
+ * codec (72, u16), quantization_bits (74, u16), reserved (76, 4 bytes).
+ *
+ * @note In a record file, the header is followed by an index of `nb_records` entries (offset, u64 ; size, u64) giving the position of each
+ * record in the file, so that any record can be read with a single `pread`.
+ */
+
+#ifndef BINARY_FORMAT
+#define BINARY_FORMAT
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stddef.h>
+
+#include "precision.h"
+
+// ----- Constants -----
+
+#define BINARY_MAGIC "PGBF"         /**< the first 4 bytes of every binary file*/
+#define BINARY_VERSION 2            /**< the version of the format written, the readers accept the versions up to it*/
+#define BINARY_HEADER_SIZE 80       /**< the size of the header, in bytes*/
+
+// Kinds of structures
+
+#define BINARY_MAP              1   /**< the values of a map*/
+#define BINARY_CHUNK            2   /**< the values of a chunk*/
+#define BINARY_LAYER            3   /**< the values of a layer*/
+#define BINARY_GRADIENT_GRID    4   /**< the vectors of a gradient grid, 2 components each*/
+#define BINARY_SEA_MAP          5   /**< the values of the sea map of a complete map*/
+#define BINARY_COLOR_MAP        6   /**< the RGB8 colors of the color map of a complete map, 3 components each*/
+#define BINARY_TILED_MAP        7   /**< the chunks of a map, one record each behind an index (see `writeMapTiledFile`)*/
+#define BINARY_RECIPE           8   /**< the parameters of a complete map generation, without any sample (see `writeMapRecipeFile`)*/
+
+// Codecs of the samples
+
+#define BINARY_CODEC_RAW        0   /**< the samples as they are*/
+#define BINARY_CODEC_PREDICTIVE 1   /**< the zigzag varint residuals of a 2D predictor, bit-exact*/
+#define BINARY_CODEC_QUANTIZED  2   /**< the zigzag varint residuals of a 2D predictor, over float samples rounded to a fixed precision*/
+
+#define BINARY_QUANTIZATION_BITS 24     /**< the default number of fractional bits kept by the quantized codec (a precision of about 6e-8)*/
+#define BINARY_MAX_QUANTIZATION_BITS 32 /**< the largest number of fractional bits of the quantized codec, which encodes the finite values
+                                             up to `2^(62 - quantization_bits)` in magnitude (`2^30` at most)*/
+
+// Types of the samples
+
+#define BINARY_UINT8    1   /**< 1 byte unsigned integers*/
+#define BINARY_FLOAT32  2   /**< IEEE 754 single precision floats*/
+#define BINARY_FLOAT64  3   /**< IEEE 754 double precision floats*/
+
+#ifdef PROCGEN_FLOAT_ALTITUDE
+    #define ALTITUDE_DTYPE BINARY_FLOAT32   /**< the type of the samples of `altitude_t` values*/
+#else
+    #define ALTITUDE_DTYPE BINARY_FLOAT64   /**< the type of the samples of `altitude_t` values*/
+#endif
+
+#ifdef PROCGEN_FLOAT_GRADIENT
+    #define GRADIENT_DTYPE BINARY_FLOAT32   /**< the type of the samples of `gradient_t` values*/
+#else
+    #define GRADIENT_DTYPE BINARY_FLOAT64   /**< the type of the samples of `gradient_t` values*/
+#endif
+
+// ----- Structure definition -----
+
+/**
+ * @brief The header of a binary file. The fields that do not apply to its kind are set to `0`.
+ *
+ */
+struct binaryHeader
+{
+    int version; /**< the version of the format of the file*/
+    int kind; /**< the kind of structure stored (e.g. `BINARY_MAP`)*/
+    int dtype; /**< the type of the samples (e.g. `BINARY_FLOAT64`)*/
+    int nb_components; /**< the number of samples per value (e.g. `2` for vectors), `0` if the file has no payload*/
+    int width; /**< the width of the structure, in values*/
+    int height; /**< the height of the structure, in values*/
+    int map_width; /**< the number of chunks in width of a map*/
+    int map_height; /**< the number of chunks in height of a map*/
+    int chunk_width; /**< the width of the chunks of a map, or of a chunk*/
+    int chunk_height; /**< the height of the chunks of a map, or of a chunk*/
+    int number_of_layers; /**< the number of layers of a chunk*/
+    int size_factor; /**< the size factor of a layer*/
+    int nb_records; /**< the number of records of a record file, `0` otherwise*/
+    double sea_level; /**< the sea level of a complete map*/
+    double base_altitude; /**< the base altitude of a chunk*/
+    uint64_t seed; /**< the seed of the generation*/
+    int codec; /**< the codec of the samples (e.g. `BINARY_CODEC_PREDICTIVE`)*/
+    int quantization_bits; /**< the number of fractional bits kept by the quantized codec*/
+};
+
+typedef struct binaryHeader binaryHeader;
+
+/**
+ * @brief A streaming encoder of the payload of a binary file, one row at a time.
+ *
+ */
+struct binaryEncoder
+{
+    FILE* f; /**< the file, opened in binary writing mode*/
+    int dtype; /**< the type of the samples*/
+    int codec; /**< the codec of the samples*/
+    int quantization_bits; /**< the number of fractional bits kept by the quantized codec*/
+    int nb_components; /**< the number of samples per value*/
+    int row_length; /**< the number of samples in a row*/
+    int nb_rows; /**< the number of rows encoded so far*/
+    uint64_t* previous_keys; /**< the integer views of the samples of the previous row (predictive codec only)*/
+    uint64_t* keys; /**< the integer views of the samples of the current row (predictive codec only)*/
+    unsigned char* buffer; /**< the buffer of the encoded bytes not written yet*/
+    size_t buffer_used; /**< the number of bytes in the buffer*/
+    int success; /**< `0` once a write failed*/
+};
+
+typedef struct binaryEncoder binaryEncoder;
+
+/**
+ * @brief A streaming decoder of the payload of a binary file, one row at a time, from the file or from its bytes in memory.
+ *
+ */
+struct binaryDecoder
+{
+    FILE* f; /**< the file, opened in binary reading mode, `NULL` when decoding bytes in memory*/
+    unsigned char* bytes; /**< the buffer of the bytes read from the file, or the bytes in memory*/
+    size_t nb_bytes; /**< the number of bytes available in `bytes`*/
+    size_t position; /**< the position of the next byte to decode in `bytes`*/
+    int file_dtype; /**< the type of the samples in the file*/
+    int dtype; /**< the type of the samples in memory*/
+    int codec; /**< the codec of the samples*/
+    int quantization_bits; /**< the number of fractional bits kept by the quantized codec*/
+    int nb_components; /**< the number of samples per value*/
+    int row_length; /**< the number of samples in a row*/
+    int nb_rows; /**< the number of rows decoded so far*/
+    uint64_t* previous_keys; /**< the integer views of the samples of the previous row (predictive codec only)*/
+    uint64_t* keys; /**< the integer views of the samples of the current row (predictive codec only)*/
+};
+
+typedef struct binaryDecoder binaryDecoder;
+
+/**
+ * @brief A binary file mapped in memory. Its samples are paged in lazily from the file by the system when they are first read.
+ *
+ */
+struct mappedBinaryFile
+{
+    binaryHeader header; /**< the header of the file*/
+    void* samples; /**< the read-only samples, in their type in memory*/
+    void* address; /**< the address of the mapping, `NULL` if the samples needed a conversion and were copied in a calloc'd array*/
+    size_t size; /**< the size of the mapping, in bytes*/
+};
+
+typedef struct mappedBinaryFile mappedBinaryFile;
+
+/**
+ * @brief A record file opened for random access : its index is loaded, and each record is read on demand.
+ *
+ */
+struct binaryRecordFile
+{
+    binaryHeader header; /**< the header of the file*/
+    int fd; /**< the file descriptor of the file*/
+    uint64_t* offsets; /**< the array of the offsets of the records in the file*/
+    uint64_t* sizes; /**< the array of the sizes of the records, in bytes*/
+};
+
+typedef struct binaryRecordFile binaryRecordFile;
+
+// ----- Functions -----
+
+/**
+ * @brief Initializes a header of the given kind, with every other field set to `0` but the version.
+ *
+ * @param kind (int) : the kind of structure stored.
+ * @param dtype (int) : the type of the samples.
+ * @param nb_components (int) : the number of samples per value.
+ * @param width (int) : the width of the structure, in values.
+ * @param height (int) : the height of the structure, in values.
+ * @param seed (uint64_t) : the seed of the generation.
+ * @return binaryHeader : the header.
+ */
+binaryHeader initBinaryHeader(int kind, int dtype, int nb_components, int width, int height, uint64_t seed);
+
+/**
+ * @brief Gets the size of the samples of the given type.
+ *
+ * @param dtype (int) : the type of the samples.
+ * @return size_t : the size of a sample in bytes, `0` for an unknown type.
+ */
+size_t getBinarySampleSize(int dtype);
+
+/**
+ * @brief Stores the given integer in little-endian in the given bytes.
+ *
+ * @param bytes (unsigned char*) : the bytes to fill.
+ * @param value (uint64_t) : the integer to store.
+ * @param nb_bytes (int) : the number of bytes of the integer.
+ */
+void putBinaryInteger(unsigned char* bytes, uint64_t value, int nb_bytes);
+
+/**
+ * @brief Loads a little-endian integer from the given bytes.
+ *
+ * @param bytes (unsigned char*) : the bytes to read.
+ * @param nb_bytes (int) : the number of bytes of the integer.
+ * @return uint64_t : the integer.
+ */
+uint64_t getBinaryInteger(unsigned char* bytes, int nb_bytes);
+
+/**
+ * @brief Stores the given double in little-endian in the given bytes.
+ *
+ * @param bytes (unsigned char*) : the 8 bytes to fill.
+ * @param value (double) : the double to store.
+ */
+void putBinaryDouble(unsigned char* bytes, double value);
+
+/**
+ * @brief Loads a little-endian double from the given bytes.
+ *
+ * @param bytes (unsigned char*) : the 8 bytes to read.
+ * @return double : the double.
+ */
+double getBinaryDouble(unsigned char* bytes);
+
+/**
+ * @brief Writes the given header at the current position of the given file.
+ *
+ * @param f (FILE*) : the file, opened in binary writing mode.
+ * @param header (binaryHeader*) : the pointer to the header to write.
+ * @return int : `1` on success, `0` otherwise.
+ */
+int writeBinaryHeader(FILE* f, binaryHeader* header);
+
+/**
+ * @brief Reads and checks the header at the current position of the given file. Its dimensions should fit in an int, its samples in memory,
+ * and a regular file should hold at least the bytes of its payload (see `getBinaryMinimumPayloadSize`).
+ *
+ * @param f (FILE*) : the file, opened in binary reading mode.
+ * @param kind (int) : the expected kind of structure.
+ * @param header (binaryHeader*) : the pointer to the header to fill.
+ * @return int : `1` on success, `0` if the file is not a valid binary file of the given kind and of a supported version.
+ */
+int readBinaryHeader(FILE* f, int kind, binaryHeader* header);
+
+/**
+ * @brief Gets the number of samples of the payload described by the given header.
+ *
+ * @param header (binaryHeader*) : the pointer to the header.
+ * @return uint64_t : `width * height * nb_components`.
+ */
+uint64_t getBinaryNbSamples(binaryHeader* header);
+
+/**
+ * @brief Gets the smallest size the payload described by the given header can have : the size of its samples for the raw codec,
+ * one byte per sample for the other ones.
+ *
+ * @param header (binaryHeader*) : the pointer to the header.
+ * @return uint64_t : the size in bytes.
+ */
+uint64_t getBinaryMinimumPayloadSize(binaryHeader* header);
+
+/**
+ * @brief Writes the given samples at the current position of the given file, in little-endian.
+ *
+ * @param f (FILE*) : the file, opened in binary writing mode.
+ * @param dtype (int) : the type of the samples, which is also their type in memory (`ALTITUDE_DTYPE`, `GRADIENT_DTYPE` or `BINARY_UINT8`).
+ * @param samples (void*) : the pointer to the samples.
+ * @param nb_samples (size_t) : the number of samples.
+ * @return int : `1` on success, `0` otherwise.
+ */
+int writeBinarySamples(FILE* f, int dtype, void* samples, size_t nb_samples);
+
+/**
+ * @brief Reads samples at the current position of the given file, and converts them to their type in memory.
+ *
+ * @param f (FILE*) : the file, opened in binary reading mode.
+ * @param file_dtype (int) : the type of the samples in the file.
+ * @param dtype (int) : the type of the samples in memory. Integers and floats can not be converted into one another.
+ * @param samples (void*) : the pointer to the array to fill.
+ * @param nb_samples (size_t) : the number of samples.
+ * @return int : `1` on success, `0` otherwise.
+ */
+int readBinarySamples(FILE* f, int file_dtype, int dtype, void* samples, size_t nb_samples);
+
+/**
+ * @brief Converts little-endian samples already loaded in memory (e.g. by a `pread`) to their type in memory.
+ *
+ * @param bytes (unsigned char*) : the samples, as stored in a file.
+ * @param file_dtype (int) : the type of the samples in the file.
+ * @param dtype (int) : the type of the samples in memory, of the same family (integers or floats) as `file_dtype`.
+ * @param samples (void*) : the pointer to the array to fill.
+ * @param nb_samples (size_t) : the number of samples.
+ */
+void decodeBinarySamples(unsigned char* bytes, int file_dtype, int dtype, void* samples, size_t nb_samples);
+
+/**
+ * @brief Creates a streaming encoder writing at the current position of the given file, which should be right after the header.
+ *
+ * @param f (FILE*) : the file, opened in binary writing mode.
+ * @param header (binaryHeader*) : the pointer to the header of the file. Its type of samples is also their type in memory.
+ * @return binaryEncoder* : the pointer to the new encoder.
+ */
+binaryEncoder* newBinaryEncoder(FILE* f, binaryHeader* header);
+
+/**
+ * @brief Encodes the next row of samples.
+ *
+ * @param encoder (binaryEncoder*) : the pointer to the encoder.
+ * @param row (void*) : the pointer to the `width * nb_components` samples of the row.
+ * @return int : `1` on success, `0` otherwise (e.g. a sample that the quantized codec can not encode).
+ */
+int encodeBinaryRow(binaryEncoder* encoder, void* row);
+
+/**
+ * @brief Writes the bytes still buffered by the given encoder, and frees it.
+ *
+ * @param encoder (binaryEncoder*) : the pointer to the encoder.
+ * @return int : `1` if every row was written, `0` otherwise.
+ */
+int freeBinaryEncoder(binaryEncoder* encoder);
+
+/**
+ * @brief Creates a streaming decoder reading at the current position of the given file, which should be right after the header.
+ *
+ * @param f (FILE*) : the file, opened in binary reading mode.
+ * @param header (binaryHeader*) : the pointer to the header of the file.
+ * @param dtype (int) : the type of the samples in memory.
+ * @return binaryDecoder* : the pointer to the new decoder.
+ */
+binaryDecoder* newBinaryDecoder(FILE* f, binaryHeader* header, int dtype);
+
+/**
+ * @brief Creates a streaming decoder reading the given payload bytes (e.g. of a mapped file).
+ *
+ * @param bytes (unsigned char*) : the bytes of the payload.
+ * @param nb_bytes (size_t) : the number of bytes of the payload.
+ * @param header (binaryHeader*) : the pointer to the header of the file.
+ * @param dtype (int) : the type of the samples in memory.
+ * @return binaryDecoder* : the pointer to the new decoder.
+ */
+binaryDecoder* newBinaryMemoryDecoder(unsigned char* bytes, size_t nb_bytes, binaryHeader* header, int dtype);
+
+/**
+ * @brief Decodes the next row of samples, and converts them to their type in memory.
+ *
+ * @param decoder (binaryDecoder*) : the pointer to the decoder.
+ * @param row (void*) : the pointer to the array of `width * nb_components` samples to fill.
+ * @return int : `1` on success, `0` if the payload is truncated or invalid.
+ */
+int decodeBinaryRow(binaryDecoder* decoder, void* row);
+
+/**
+ * @brief Frees the given decoder.
+ *
+ * @param decoder (binaryDecoder*) : the pointer to the decoder.
+ */
+void freeBinaryDecoder(binaryDecoder* decoder);
+
+/**
+ * @brief Writes the whole payload of a binary file with the codec of its header, at the current position of the given file.
+ *
+ * @param f (FILE*) : the file, opened in binary writing mode.
+ * @param header (binaryHeader*) : the pointer to the header of the file.
+ * @param samples (void*) : the pointer to the `width * height * nb_components` contiguous samples, in the type of the header.
+ * @return int : `1` on success, `0` otherwise.
+ */
+int writeBinaryPayload(FILE* f, binaryHeader* header, void* samples);
+
+/**
+ * @brief Reads the whole payload of a binary file, whatever its codec, at the current position of the given file.
+ *
+ * @param f (FILE*) : the file, opened in binary reading mode.
+ * @param header (binaryHeader*) : the pointer to the header of the file.
+ * @param dtype (int) : the type of the samples in memory.
+ * @param samples (void*) : the pointer to the array of `width * height * nb_components` samples to fill.
+ * @return int : `1` on success, `0` otherwise.
+ */
+int readBinaryPayload(FILE* f, binaryHeader* header, int dtype, void* samples);
+
+/**
+ * @brief Maps the binary file at the given path in memory, in read-only mode. Loading it only costs reading its header : when its samples
+ * are stored raw in their type in memory (always the case on a little-endian machine reading a raw file written with the same precision),
+ * they are used in place. Otherwise they are decoded once in a new array.
+ *
+ * @param path (char[]) : the path to the file.
+ * @param kind (int) : the expected kind of structure.
+ * @param dtype (int) : the type of the samples in memory.
+ * @param nb_components (int) : the expected number of samples per value.
+ * @return mappedBinaryFile* : the pointer to the mapped file, `NULL` if the file could not be mapped or is not a complete binary file
+ * of the given kind.
+ */
+mappedBinaryFile* mapBinaryFile(char path[], int kind, int dtype, int nb_components);
+
+/**
+ * @brief Unmaps a binary file mapped with `mapBinaryFile`. Its samples can not be used anymore.
+ *
+ * @param mapped_file (mappedBinaryFile*) : the pointer to the mapped file.
+ */
+void unmapBinaryFile(mappedBinaryFile* mapped_file);
+
+/**
+ * @brief Writes the index of a record file at the current position of the given file, which should be right after the header.
+ *
+ * @param f (FILE*) : the file, opened in binary writing mode.
+ * @param nb_records (int) : the number of records.
+ * @param offsets (uint64_t[]) : the offsets of the records in the file.
+ * @param sizes (uint64_t[]) : the sizes of the records, in bytes.
+ * @return int : `1` on success, `0` otherwise.
+ */
+int writeBinaryIndex(FILE* f, int nb_records, uint64_t offsets[nb_records], uint64_t sizes[nb_records]);
+
+/**
+ * @brief Opens the record file at the given path and loads its header and its index.
+ *
+ * @param path (char[]) : the path to the file.
+ * @param kind (int) : the expected kind of structure.
+ * @return binaryRecordFile* : the pointer to the opened record file, `NULL` if the file could not be opened or is not a record file
+ * of the given kind.
+ */
+binaryRecordFile* openBinaryRecordFile(char path[], int kind);
+
+/**
+ * @brief Reads the given record of an opened record file with a single `pread`. Several threads can read the same file at once.
+ *
+ * @param record_file (binaryRecordFile*) : the pointer to the opened record file.
+ * @param record_idx (int) : the index of the record.
+ * @return unsigned char* : the calloc'd bytes of the record (see the `sizes` of the record file), `NULL` if it could not be read.
+ */
+unsigned char* readBinaryRecord(binaryRecordFile* record_file, int record_idx);
+
+/**
+ * @brief Closes the given record file.
+ *
+ * @param record_file (binaryRecordFile*) : the pointer to the record file.
+ */
+void closeBinaryRecordFile(binaryRecordFile* record_file);
+
+#endif
@@ -49,8 +49,12 @@ struct chunk
 
     int width; /**< the width of the chunk (redundant with layers' width)*/
     int height; /**< the height of the chunk (redundant with layers' height)*/
-    double* chunk_values; /**< the final chunk altitude values*/
+    altitude_t* chunk_values; /**< the final chunk altitude values*/
+    int values_stride; /**< the number of values between two rows of `chunk_values` : the chunk width, or the map width for a view*/
+    int owns_values; /**< `1` if `chunk_values` was allocated for the chunk, `0` if it is a view into the map values*/
     double base_altitude; /**< the base altitude of the chunk to generate inhomogeneous maps*/
+    memoryArena* arena; /**< the pointer to the arena the chunk is allocated in, `NULL` if it was calloc'd*/
+    mappedBinaryFile* mapped_file; /**< the pointer to the mapped file holding the read-only values (see `readChunkFile`), `NULL` otherwise*/
 };
 
 typedef struct chunk chunk;
@@ -80,35 +84,61 @@ typedef struct chunk chunk;
  * @param chunk (chunk*) : the pointer to the chunk to extract the value pointer from.
  * @param width_idx (int) : the width index of the wanted value.
  * @param height_idx (int) : the height index of the wanted value.
- * @return double* : the pointer to the corresponding altitude value.
+ * @return altitude_t* : the pointer to the corresponding altitude value.
  */
-double* getChunkValue(chunk* chunk, int width_idx, int height_idx);
+altitude_t* getChunkValue(chunk* chunk, int width_idx, int height_idx);
 
 /**
- * @brief Initializes a chunk with the given parameters and allocates the space for the `values` array.
+ * @brief Get the altitude value pointer from the given chunk at given indexes, without any check on the indexes. Made for the generation loops.
+ * In a `PROCGEN_CHECKED` build, it keeps the validating behaviour of `getChunkValue`.
+ * 
+ * @param chunk (chunk*) : the pointer to the chunk to extract the value pointer from.
+ * @param width_idx (int) : the width index of the wanted value. Should be in `[0, width - 1]`.
+ * @param height_idx (int) : the height index of the wanted value. Should be in `[0, height - 1]`.
+ * @return altitude_t* : the pointer to the corresponding altitude value.
+ */
+static inline altitude_t* getChunkValueUnchecked(chunk* chunk, int width_idx, int height_idx)
+{
+#ifdef PROCGEN_CHECKED
+    return getChunkValue(chunk, width_idx, height_idx);
+#else
+    return chunk->chunk_values + height_idx * chunk->values_stride + width_idx;
+#endif
+}
+
+/**
+ * @brief Initializes a chunk with the given parameters and allocates the space for the `values` array, unless a view to place them in is given.
  * 
  * @param width (int) : the chunk width.
  * @param height (int) : the chunk height.
  * @param number_of_layers (int) : the number of layers in the chunk.
  * @param layers_factors (double[]) : the array containing the layers factors. Values will be copied in the structure as a double*.
  * @param layers (layer*[]) : the array of pointers to the layer structures composing the chunk. Pointers will be copied in the structure as a layer**.
+ * @param chunk_values (altitude_t*) : where to place the chunk values (e.g. a view into the map values), `NULL` to allocate them.
+ * @param values_stride (int) : the number of values between two rows of `chunk_values`. Unused if it is `NULL`.
+ * @param context (generatorContext*) : the pointer to the context of the chunk. Its arena is used. Can be `NULL`.
  * @return chunk* : the pointer to the newly created and initialized chunk structure.
  * 
  * @note `layers_factors` and `layers` arrays does not require to be dynamically allocated.
  */
-chunk* initChunk(int width, int height, int number_of_layers, double layers_factors[number_of_layers], layer* layers[number_of_layers]);
+chunk* initChunk(int width, int height, int number_of_layers, double layers_factors[number_of_layers], layer* layers[number_of_layers],
+                    altitude_t* chunk_values, int values_stride, generatorContext* context);
 
 
 
 /**
  * @brief Regenerates the given chunk final altitude values from its layers and layers factors.
+ * The layers without stored values (fused chunks) are evaluated on the fly from their gradient grids, one row at a time,
+ * and directly summed in the chunk values.
  * 
- * @param chunk (chunk*) : the pointer to the initialized chunk structure to regenerate the altitude values.
+ * @param chunk (chunk*) : the pointer to the initialized chunk structure to regenerate the altitude values. A trimmed chunk (see `trimChunk`)
+ *                        is refused with an error, and its values are left as they are.
+ * @param context (generatorContext*) : the pointer to the context of the chunk (see `getChunkContext`). Its base altitude is drawn from it.
  * @param display_loading (unsigned int) : the given value defines the behaviour.
  *                                         * If `0` the loading bars won't be printed.
  *                                         * If `> 0` the loading bars will be printed with a number of indent equal to `display_loading - 1`.
  */
-void regenerateChunk(chunk* chunk, unsigned int display_loading);
+void regenerateChunk(chunk* chunk, generatorContext* context, unsigned int display_loading);
 
 
 
@@ -120,6 +150,9 @@ void regenerateChunk(chunk* chunk, unsigned int display_loading);
  * @param number_of_layers (int) : the number of layers passed.
  * @param layers_factors (double[number_of_layers]) : the array of layers factors.
  * @param layers (layer*[number_of_layers]) : the array of pointers to the layers to generate the chunk from.
+ * @param chunk_values (altitude_t*) : where to place the chunk values (e.g. a view into the map values), `NULL` to allocate them.
+ * @param values_stride (int) : the number of values between two rows of `chunk_values`. Unused if it is `NULL`.
+ * @param context (generatorContext*) : the pointer to the context of the chunk (see `getChunkContext`). Its base altitude is drawn from it.
  * @param display_loading (unsigned int) : the given value defines the behaviour.
  *                                         * If `0` the loading bars won't be printed.
  *                                         * If `> 0` the loading bars will be printed with a number of indent equal to `display_loading - 1`.
@@ -128,7 +161,7 @@ void regenerateChunk(chunk* chunk, unsigned int display_loading);
  * @note The arrays does not need to be dynamically allocated and their content will be copied in the structure.
  */
 chunk* newChunkFromLayers(int width, int height, int number_of_layers, double layers_factors[number_of_layers], layer* layers[number_of_layers],
-                             unsigned int display_loading);
+                             altitude_t* chunk_values, int values_stride, generatorContext* context, unsigned int display_loading);
 
 /**
  * @brief Generates a new chunk structure from the given gradientGrids and parameters.
@@ -139,6 +172,11 @@ chunk* newChunkFromLayers(int width, int height, int number_of_layers, double la
  * @param gradient_grids (gradientGrid*[number_of_layers]) : the array of gradientGrid pointers to generate the layers and then the chunk from.
  * @param size_factors (int[number_of_layers]) : the array of size factors to generate the layers.
  * @param layers_factors (double[number_of_layers]) : the array of layers factors.
+ * @param keep_layers_values (int) : if `0`, the chunk is fused : the octaves are directly summed in the chunk values and the layers
+ *                                   only keep their gradient grid. Otherwise every layer also stores its own values.
+ * @param chunk_values (altitude_t*) : where to place the chunk values (e.g. a view into the map values), `NULL` to allocate them.
+ * @param values_stride (int) : the number of values between two rows of `chunk_values`. Unused if it is `NULL`.
+ * @param context (generatorContext*) : the pointer to the context of the chunk (see `getChunkContext`). Its base altitude is drawn from it.
  * @param display_loading (unsigned int) : the given value defines the behaviour.
  *                                         * If `0` the loading bars won't be printed.
  *                                         * If `> 0` the loading bars will be printed with a number of indent equal to `display_loading - 1`.
@@ -150,7 +188,8 @@ chunk* newChunkFromLayers(int width, int height, int number_of_layers, double la
  * @note The arrays does not need to be dynamically allocated and their content will be copied in the structure.
  */
 chunk* newChunkFromGradients(int width, int height, int number_of_layers, gradientGrid* gradient_grids[number_of_layers], 
-                                int size_factors[number_of_layers], double layers_factors[number_of_layers], unsigned int display_loading);
+                                int size_factors[number_of_layers], double layers_factors[number_of_layers], int keep_layers_values,
+                                altitude_t* chunk_values, int values_stride, generatorContext* context, unsigned int display_loading);
 
 /**
  * @brief Generates a new chunk structure from scratch with the given parameters.
@@ -160,6 +199,11 @@ chunk* newChunkFromGradients(int width, int height, int number_of_layers, gradie
  * @param gradGrids_height (int[number_of_layers]) : the array of gradientGrid height to be used to generate the random gradient grids.
  * @param size_factors (int[number_of_layers]) : the array of size factors to generate the layers.
  * @param layers_factors (double[number_of_layers]) : the array of layers factors.
+ * @param keep_layers_values (int) : if `0`, the chunk is fused : the octaves are directly summed in the chunk values and the layers
+ *                                   only keep their gradient grid. Otherwise every layer also stores its own values.
+ * @param chunk_values (altitude_t*) : where to place the chunk values (e.g. a view into the map values), `NULL` to allocate them.
+ * @param values_stride (int) : the number of values between two rows of `chunk_values`. Unused if it is `NULL`.
+ * @param context (generatorContext*) : the pointer to the context of the chunk (see `getChunkContext`). Its layers contexts are derived from it.
  * @param display_loading (unsigned int) : the given value defines the behaviour.
  *                                         * If `0` the loading bars won't be printed.
  *                                         * If `> 0` the loading bars will be printed with a number of indent equal to `display_loading - 1`.
@@ -172,7 +216,8 @@ chunk* newChunkFromGradients(int width, int height, int number_of_layers, gradie
  * @note The arrays does not need to be dynamically allocated and their content will be copied in the structure.
  */
 chunk* newChunk(int number_of_layers, int gradGrids_width[number_of_layers], int gradGrids_height[number_of_layers], int size_factors[number_of_layers], 
-                        double layers_factors[number_of_layers], unsigned int display_loading);
+                        double layers_factors[number_of_layers], int keep_layers_values, altitude_t* chunk_values, int values_stride,
+                        generatorContext* context, unsigned int display_loading);
 
 //TODO ? signature could be changed to avoid passing useless parameters -> `chunk_width` and `chunk_height` instead of `gradGrids_width`, `gradGrids_height` and `size_factors`
 /**
@@ -184,6 +229,7 @@ chunk* newChunk(int number_of_layers, int gradGrids_width[number_of_layers], int
  * @param gradGrids_height (int[number_of_layers]) : the array of gradientGrid height to compute the final height this virtual chunk should have.
  * @param size_factors (int[number_of_layers]) : the array of size factors to compute the final dimensions of this virtual chunk.
  * @param layers_factors (double[number_of_layers]) : the array of layers factors to be stored in the virtual chunk.
+ * @param context (generatorContext*) : the pointer to the context of the virtual chunk (see `getChunkContext`). Its base altitude is drawn from it.
  * @return chunk* : the pointer to the newly generated virtual chunk structure.
  * 
  * @warning The `size_factors` array should match the `gradGrids_width` and `gradGrids_height` arrays such that
@@ -193,7 +239,7 @@ chunk* newChunk(int number_of_layers, int gradGrids_width[number_of_layers], int
  * @note The arrays does not need to be dynamically allocated and their content will be copied in the structure.
  */
 chunk* newVirtualChunk(int number_of_layers, int gradGrids_width[number_of_layers], int gradGrids_height[number_of_layers], int size_factors[number_of_layers],
-                                double layers_factors[number_of_layers]);
+                                double layers_factors[number_of_layers], generatorContext* context);
 
 
 /**
@@ -201,6 +247,11 @@ chunk* newVirtualChunk(int number_of_layers, int gradGrids_width[number_of_layer
  * 
  * @param north_chunk (chunk*) : pointer to the chunk to the north.
  * @param west_chunk (chunk*) : pointer to the chunk to the west.
+ * @param keep_layers_values (int) : if `0`, the chunk is fused : the octaves are directly summed in the chunk values and the layers
+ *                                   only keep their gradient grid. Otherwise every layer also stores its own values.
+ * @param chunk_values (altitude_t*) : where to place the chunk values (e.g. a view into the map values), `NULL` to allocate them.
+ * @param values_stride (int) : the number of values between two rows of `chunk_values`. Unused if it is `NULL`.
+ * @param context (generatorContext*) : the pointer to the context of the chunk (see `getChunkContext`). Its layers contexts are derived from it.
  * @param display_loading (unsigned int) : the given value defines the behaviour.
  *                                         * If `0` the loading bars won't be printed.
  *                                         * If `> 0` the loading bars will be printed with a number of indent equal to `display_loading - 1`.
@@ -210,15 +261,24 @@ chunk* newVirtualChunk(int number_of_layers, int gradGrids_width[number_of_layer
  * 
  * @note If you want to pass only a single chunk, pass `NULL` for the other pointer. You should not pass two `NULL` chunks though.
  */
-chunk* newAdjacentChunk(chunk* north_chunk, chunk* west_chunk, unsigned int display_loading);
+chunk* newAdjacentChunk(chunk* north_chunk, chunk* west_chunk, int keep_layers_values, altitude_t* chunk_values, int values_stride,
+                            generatorContext* context, unsigned int display_loading);
+
 
 
+/**
+ * @brief Trims every layer of the given chunk (see `trimLayer`) : the chunk only keeps its values, and the south and east boundaries
+ * of its gradient grids that its neighbours copy in `newAdjacentChunk`. The chunk can no longer be regenerated.
+ * 
+ * @param chunk (chunk*) : the pointer to the chunk to trim.
+ */
+void trimChunk(chunk* chunk);
 
 /**
  * @brief Makes a deep copy of the given chunk structure.
  * 
  * @param p_chunk (chunk*) : the pointer to the chunk to be copied.
- * @return chunk* : the pointer to the deep copy of the initial chunk.
+ * @return chunk* : the pointer to the deep copy of the initial chunk, `NULL` if it was trimmed (see `trimChunk`).
  */
 chunk* copyChunk(chunk* p_chunk);
 
@@ -233,13 +293,32 @@ chunk* copyChunk(chunk* p_chunk);
 void writeChunkFile(chunk* chunk, char path[]);
 
 /**
- * @brief TODO : Reads the file at the given path and generates the associated chunk structure.
+ * @brief Maps a chunk binary file (see `writeChunkBinaryFile`) in memory. Only its header is read : the values are read-only and paged
+ * in lazily when they are first used. The chunk has its base altitude, but no layer.
  * 
  * @param path (char[]) : the path to the file to be read.
- * @return chunk* : the pointer to the generated chunk structure.
+ * @return chunk* : the pointer to the generated chunk structure, `NULL` if the file could not be mapped.
  */
 chunk* readChunkFile(char path[]);
 
+/**
+ * @brief Writes the values of the given chunk in a new binary file at path (see `binaryFormat.h`).
+ * 
+ * @param chunk (chunk*) : the pointer to the chunk to write. It can be a view into the map values.
+ * @param seed (uint64_t) : the seed of the generation, stored in the header.
+ * @param path (char[]) : the path to the file to write.
+ */
+void writeChunkBinaryFile(chunk* chunk, uint64_t seed, char path[]);
+
+/**
+ * @brief Reads a chunk binary file. The chunk has its values and its base altitude, but no layer.
+ * 
+ * @param path (char[]) : the path to the file to be read.
+ * @param header (binaryHeader*) : the pointer to the header to fill with the one of the file (e.g. the original number of layers). Can be `NULL`.
+ * @return chunk* : the pointer to the generated chunk structure, `NULL` if the file could not be read.
+ */
+chunk* readChunkBinaryFile(char path[], binaryHeader* header);
+
 
 
 /**
@@ -250,7 +329,7 @@ chunk* readChunkFile(char path[]);
 void printChunk(chunk* chunk);
 
 /**
- * @brief Frees the given chunk structure and every sub-structures.
+ * @brief Frees the given chunk structure and every sub-structures. Does nothing if it is allocated in an arena.
  * 
  * @param chunk (chunk*) : the pointer to the chunk to be free'd.
  * 
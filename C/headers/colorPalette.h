@@ -0,0 +1,183 @@
+/**
+ * @file colorPalette.h
+ * @author Zyno and BlueNZ
+ * @brief Header to the color, color palette and color lookup table structures and functions
+ * @version 0.2
+ * @date 2024-06-19
+ *
+ * @note A palette is made of two gradients : the sea one, from the minimum altitude to the sea level, and the land one, from the sea level
+ * to the maximum altitude. It is sampled once per map in a lookup table : colorizing a value is then a quantization and a table load.
+ */
+
+#ifndef COLOR_PALETTE
+#define COLOR_PALETTE
+
+#include <stdint.h>
+
+#include "precision.h"
+
+// ----- Constants -----
+
+#define PALETTE_LUT_SIZE 4096   /**< the default number of entries of a color lookup table*/
+
+// ----- Structure definition -----
+
+/**
+ * @brief A packed RGB8 color structure : 3 bytes per color. The float values in [0, 1] are only derived from it when exported.
+ *
+ */
+struct color
+{
+    uint8_t red; /**< the red value in [0, 255]*/
+    uint8_t green; /**< the green value in [0, 255]*/
+    uint8_t blue; /**< the blue value in [0, 255]*/
+};
+
+typedef struct color color;
+
+/**
+ * @brief A stop of a palette gradient : the color at the given position of the gradient.
+ *
+ */
+struct paletteStop
+{
+    double position; /**< the position of the stop in its gradient, in [0, 1]*/
+    color color; /**< the color at this position*/
+};
+
+typedef struct paletteStop paletteStop;
+
+/**
+ * @brief A color palette : a sea gradient and a land gradient, each one linearly interpolated between its stops.
+ *
+ */
+struct colorPalette
+{
+    int nb_sea_stops; /**< the number of stops of the sea gradient*/
+    paletteStop* sea_stops; /**< the stops of the sea gradient, by increasing position : `0` is the minimum altitude, `1` the sea level*/
+    int nb_land_stops; /**< the number of stops of the land gradient*/
+    paletteStop* land_stops; /**< the stops of the land gradient, by increasing position : `0` is the sea level, `1` the maximum altitude*/
+    int land_from_min; /**< `1` to put the position `0` of the land gradient at the minimum altitude rather than at the sea level : the land then
+                        * starts at the color of the sea level position, `0` for the palettes of `newColorPalette`*/
+    int marks_zero; /**< `1` to give `zero_color` to the altitudes exactly equal to `0`, `0` for the palettes of `newColorPalette`*/
+    color zero_color; /**< the color of the zero altitudes, when they are marked*/
+};
+
+typedef struct colorPalette colorPalette;
+
+/**
+ * @brief A color lookup table : a palette sampled at regular altitudes, in two ranges. The sea entries span `[min_value, sea_level]`
+ * and the land entries span `(sea_level, max_value]`, so that no entry mixes the sea and the land colors.
+ *
+ */
+struct colorLUT
+{
+    int nb_entries; /**< the number of entries of the table*/
+    int nb_sea_entries; /**< the number of sea entries, at the start of the table*/
+    color* entries; /**< the colors of the table, the first one at the minimum altitude and the last one at the maximum altitude*/
+    double min_value; /**< the altitude of the start of the first sea entry*/
+    double sea_level; /**< the altitude of the end of the last sea entry, and of the start of the first land entry*/
+    double sea_scale; /**< the number of sea entries per altitude unit*/
+    double land_scale; /**< the number of land entries per altitude unit*/
+    int marks_zero; /**< `1` if the altitudes exactly equal to `0` get `zero_color` rather than their entry (see `colorPalette`)*/
+    color zero_color; /**< the color of the zero altitudes, when they are marked*/
+};
+
+typedef struct colorLUT colorLUT;
+
+// ----- Functions -----
+
+/**
+ * @brief Generates a new colorPalette structure from the given gradients.
+ *
+ * @param nb_sea_stops (int) : the number of stops of the sea gradient.
+ * @param sea_stops (paletteStop[]) : the stops of the sea gradient, by increasing position. Values will be copied in the structure.
+ * @param nb_land_stops (int) : the number of stops of the land gradient.
+ * @param land_stops (paletteStop[]) : the stops of the land gradient, by increasing position. Values will be copied in the structure.
+ * @return colorPalette* : the pointer to the new color palette.
+ */
+colorPalette* newColorPalette(int nb_sea_stops, paletteStop sea_stops[nb_sea_stops], int nb_land_stops, paletteStop land_stops[nb_land_stops]);
+
+/**
+ * @brief Generates the default colorPalette, with the colors of the original maps : a dark to light blue sea, a dark to light green land
+ * laid over the whole altitude range (see `land_from_min`), and red zero altitudes.
+ *
+ * @return colorPalette* : the pointer to the new color palette.
+ */
+colorPalette* newDefaultColorPalette();
+
+/**
+ * @brief Computes the color of the given altitude value with the given palette, without any lookup table.
+ *
+ * @param palette (colorPalette*) : the pointer to the palette. If `NULL`, the default palette is used.
+ * @param value (double) : the altitude value to get the color of.
+ * @param sea_level (double) : the sea level of the map.
+ * @param min_value (double) : the minimum altitude value of the map.
+ * @param max_value (double) : the maximum altitude value of the map.
+ * @return color : the color of the value.
+ */
+color getPaletteColor(colorPalette* palette, double value, double sea_level, double min_value, double max_value);
+
+/**
+ * @brief Generates a new colorLUT structure by sampling the given palette at the center of each of its entries. The entries are shared
+ * between the sea and the land ranges in proportion to their lengths, with at least one entry each.
+ *
+ * @param palette (colorPalette*) : the pointer to the palette. If `NULL`, the default palette is used.
+ * @param nb_entries (int) : the number of entries of the table (e.g. `PALETTE_LUT_SIZE`). Should be at least `2`.
+ * @param sea_level (double) : the sea level of the map.
+ * @param min_value (double) : the minimum altitude value of the map.
+ * @param max_value (double) : the maximum altitude value of the map.
+ * @return colorLUT* : the pointer to the new color lookup table.
+ */
+colorLUT* newColorLUT(colorPalette* palette, int nb_entries, double sea_level, double min_value, double max_value);
+
+/**
+ * @brief Gets the color of the given altitude value from the given lookup table. The values out of its range get the color of its nearest end.
+ * The sea or land range is chosen by the same comparison as `getPaletteColor`, so the value always gets a color of its own class.
+ *
+ * @param lut (colorLUT*) : the pointer to the color lookup table.
+ * @param value (altitude_t) : the altitude value to get the color of.
+ * @return color : the color of the entry of the value.
+ */
+static inline color lookupColor(colorLUT* lut, altitude_t value)
+{
+    // The zero marks are not sampled in the table
+    if (lut->marks_zero && value == 0)
+    {
+        return lut->zero_color;
+    }
+
+    int idx;
+
+    if (value <= lut->sea_level)
+    {
+        idx = (int) ((value - lut->min_value) * lut->sea_scale);
+
+        idx = idx < 0 ? 0 : idx;
+        idx = idx >= lut->nb_sea_entries ? lut->nb_sea_entries - 1 : idx;
+    }
+    else
+    {
+        idx = lut->nb_sea_entries + (int) ((value - lut->sea_level) * lut->land_scale);
+
+        idx = idx >= lut->nb_entries ? lut->nb_entries - 1 : idx;
+    }
+
+    return lut->entries[idx];
+}
+
+/**
+ * @brief Frees the given colorPalette structure.
+ *
+ * @param palette (colorPalette*) : the pointer to the color palette.
+ */
+void freeColorPalette(colorPalette* palette);
+
+/**
+ * @brief Frees the given colorLUT structure.
+ *
+ * @param lut (colorLUT*) : the pointer to the color lookup table.
+ */
+void freeColorLUT(colorLUT* lut);
+
+#endif
@@ -0,0 +1,190 @@
+/**
+ * @file generatorContext.h
+ * @author Zyno and BlueNZ
+ * @brief Header to the generator context structure and to the counter-based random functions
+ * @version 0.2
+ * @date 2024-06-19
+ *
+ * @note Every random value of the generation is a pure function of `(seed, chunk_x, chunk_y, layer, cell_x, cell_y, draw)`.
+ * There is no hidden state : any chunk can be generated on its own, on any thread and in any order, and still match bit for bit.
+ */
+
+#ifndef GENERATOR_CONTEXT
+#define GENERATOR_CONTEXT
+
+#include <stdint.h>
+
+#include "colorPalette.h"
+#include "memoryArena.h"
+#include "threadPool.h"
+
+// ----- Constants -----
+
+/**
+ * @brief The version of the generation algorithms, stored in the recipe files. It should be increased by any change of the generated values :
+ * a recipe is only regenerated by the version that wrote it.
+ *
+ */
+#define GENERATOR_VERSION 2
+
+/**
+ * @brief The layer key used for the random values that belong to the chunk itself rather than to one of its layers (e.g. its base altitude).
+ *
+ */
+#define CHUNK_LAYER_KEY -1
+
+/**
+ * @brief The key folded in the lattice contexts (see `getLatticeContext`), so that their random values never share the keys of a chunk or layer
+ * context, such as the layers of the chunk `(0, 0)`.
+ *
+ */
+#define LATTICE_DOMAIN_KEY 0x4c415454
+
+// Gradient sources
+
+#define STORED_GRADIENTS    0   /**< each chunk stores its own random gradient grids, and copies its north and west neighbours' boundaries*/
+#define HASHED_GRADIENTS    1   /**< the gradient vectors are derived on the fly from their global lattice coordinates : chunks need no storage nor neighbours*/
+
+// Chunk retention policies
+
+#define KEEP_FULL_CHUNKS        0   /**< the map chunks keep their whole layers once generated*/
+#define KEEP_CHUNK_BOUNDARIES   1   /**< the map chunks only keep their values and their gradient grids boundaries once generated (see `trimChunk`)*/
+
+// ----- Structure definition -----
+
+// Defined in `layer.h`, which includes this header
+struct perlinTableSet;
+
+/**
+ * @brief The options of a generation : how the generated structures are computed and stored. They are not part of the random keys,
+ * and are kept as they are by the derived contexts.
+ *
+ */
+struct generatorOptions
+{
+    int gradient_source; /**< where the gradient vectors come from : `STORED_GRADIENTS` (default) or `HASHED_GRADIENTS`*/
+    int nb_workers; /**< the number of threads generating in parallel, `1` (default) for a sequential generation*/
+    threadPool* pool; /**< the pointer to the thread pool of the running generation, `NULL` outside of it*/
+    struct perlinTableSet* perlin_tables; /**< the pointer to the weights tables shared by the layers of the running generation (see `acquirePerlinTables`),
+                                               `NULL` outside of it*/
+    memoryArena* arena; /**< the pointer to the arena to allocate the generated structures in, `NULL` (default) to calloc them*/
+    int chunk_views; /**< `1` to generate the map chunks in place, as views into the map values, `0` (default) to let them own their values*/
+    int chunk_retention; /**< what the map chunks keep once generated : `KEEP_FULL_CHUNKS` (default) or `KEEP_CHUNK_BOUNDARIES`*/
+    colorPalette* palette; /**< the pointer to the palette of the color maps, `NULL` (default) for the default one*/
+};
+
+typedef struct generatorOptions generatorOptions;
+
+/**
+ * @brief The generator context structure. It holds the keys of the counter-based random generator, and the options of the generation.
+ * The root context is created with `newGeneratorContext`, the chunk and layer ones are derived from it by value.
+ *
+ */
+struct generatorContext
+{
+    uint64_t seed; /**< the seed of the whole generation*/
+    int chunk_x; /**< the width index of the chunk in the map*/
+    int chunk_y; /**< the height index of the chunk in the map*/
+    int layer; /**< the index of the layer in the chunk, or `CHUNK_LAYER_KEY`*/
+    uint64_t key; /**< the hash of the previous keys, computed once when the context is derived*/
+
+    generatorOptions options; /**< the options of the generation, kept by the derived contexts*/
+};
+
+typedef struct generatorContext generatorContext;
+
+// ----- Functions -----
+
+/**
+ * @brief Gets the default generation options : the gradients are stored, the generation runs on a single thread without arena,
+ * the map chunks own their values and keep their whole layers, and the colors use the default palette.
+ *
+ * @return generatorOptions : the default options.
+ */
+generatorOptions getDefaultGeneratorOptions();
+
+/**
+ * @brief Generates a new root generatorContext for the given seed. Its chunk and layer keys are set to `0`, and its options are the default ones
+ * (see `getDefaultGeneratorOptions`).
+ *
+ * @param seed (uint64_t) : the seed of the generation.
+ * @return generatorContext* : the pointer to the new generator context.
+ */
+generatorContext* newGeneratorContext(uint64_t seed);
+
+/**
+ * @brief Derives the context of the chunk at the given map indexes. Its layer key is set to `CHUNK_LAYER_KEY`.
+ *
+ * @param context (generatorContext*) : the pointer to the context to derive from. Its keys are not used, its options are kept.
+ * @param chunk_x (int) : the width index of the chunk in the map. Can be negative (e.g. virtual chunks).
+ * @param chunk_y (int) : the height index of the chunk in the map. Can be negative (e.g. virtual chunks).
+ * @return generatorContext : the chunk context.
+ */
+generatorContext getChunkContext(generatorContext* context, int chunk_x, int chunk_y);
+
+/**
+ * @brief Derives the context of the given layer of the chunk of the given context.
+ *
+ * @param context (generatorContext*) : the pointer to the chunk context to derive from.
+ * @param layer (int) : the index of the layer in the chunk.
+ * @return generatorContext : the layer context.
+ */
+generatorContext getLayerContext(generatorContext* context, int layer);
+
+/**
+ * @brief Derives the context of the gradient lattice of the given octave. The lattice is shared by every chunk : its cells are indexed
+ * by global lattice coordinates rather than by chunk. Its keys are in their own domain (see `LATTICE_DOMAIN_KEY`).
+ *
+ * @param context (generatorContext*) : the pointer to the context to derive from. Its keys are not used, its options are kept.
+ * @param octave (int) : the index of the layer in the chunks.
+ * @return generatorContext : the lattice context.
+ */
+generatorContext getLatticeContext(generatorContext* context, int octave);
+
+/**
+ * @brief Gets the 64 random bits at the given cell of the given context. The same arguments always give the same bits.
+ *
+ * @param context (generatorContext*) : the pointer to the generator context.
+ * @param cell_x (int) : the width index of the cell (e.g. of the gradient vector).
+ * @param cell_y (int) : the height index of the cell (e.g. of the gradient vector).
+ * @param draw (unsigned int) : the index of the draw, to get several independent values for the same cell.
+ * @return uint64_t : the random bits.
+ */
+uint64_t getRandomBits(generatorContext* context, int cell_x, int cell_y, unsigned int draw);
+
+/**
+ * @brief Gets a random double in `[0, 1)` at the given cell of the given context. The same arguments always give the same value.
+ *
+ * @param context (generatorContext*) : the pointer to the generator context.
+ * @param cell_x (int) : the width index of the cell (e.g. of the gradient vector).
+ * @param cell_y (int) : the height index of the cell (e.g. of the gradient vector).
+ * @param draw (unsigned int) : the index of the draw, to get several independent values for the same cell.
+ * @return double : the random value.
+ */
+double getRandomUniform(generatorContext* context, int cell_x, int cell_y, unsigned int draw);
+
+/**
+ * @brief Gets the thread pool to run the tasks of the given context on : its own pool if it has one, a new pool of `nb_workers - 1` threads
+ * (the calling thread being the last worker) if it asks for several workers, `NULL` otherwise (the tasks are then run by the calling thread).
+ *
+ * @param context (generatorContext*) : the pointer to the generator context. If `NULL`, the tasks are run by the calling thread.
+ * @return threadPool* : the pointer to the thread pool, to be released with `releaseThreadPool`.
+ */
+threadPool* acquireThreadPool(generatorContext* context);
+
+/**
+ * @brief Releases the thread pool got from `acquireThreadPool` : it is free'd unless it is the context's own pool.
+ *
+ * @param context (generatorContext*) : the pointer to the generator context.
+ * @param pool (threadPool*) : the pointer to the thread pool.
+ */
+void releaseThreadPool(generatorContext* context, threadPool* pool);
+
+/**
+ * @brief Frees the given root generatorContext structure.
+ *
+ * @param context (generatorContext*) : the pointer to the generator context.
+ */
+void freeGeneratorContext(generatorContext* context);
+
+#endif
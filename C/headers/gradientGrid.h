@@ -10,6 +10,10 @@
 #ifndef GRADIENT_GRID
 #define GRADIENT_GRID
 
+#include "precision.h"
+#include "binaryFormat.h"
+#include "generatorContext.h"
+
 // ----- Structure definition -----
 
 /**
@@ -18,21 +22,28 @@
  */
 struct vector
 {
-    double x; /**< the x coordinate*/
-    double y; /**< the y coordinate*/
+    gradient_t x; /**< the x coordinate*/
+    gradient_t y; /**< the y coordinate*/
 };
 
 typedef struct vector vector;
 
 /**
- * @brief A 2d gradient vector array.
+ * @brief A 2d gradient vector array. A hashed gradient grid does not store its vectors : they are derived on the fly from their
+ * global lattice coordinates (see `newHashedGradGrid`).
  * 
  */
 struct gradientGrid
 {
     int width; /**< the width of the gradientGrid*/
     int height; /**< the height of the gradientGrid*/
-    vector* gradients; /**< the pointer to the array of vectors*/
+    vector* gradients; /**< the pointer to the array of vectors, `NULL` for a hashed or a trimmed gradient grid*/
+    vector* boundaries; /**< the south row then the east column of vectors of a trimmed gradient grid (see `trimGradGrid`), `NULL` otherwise*/
+    int origin_x; /**< the global lattice width index of the first vector (hashed gradient grids only)*/
+    int origin_y; /**< the global lattice height index of the first vector (hashed gradient grids only)*/
+    generatorContext lattice_context; /**< the lattice context the vectors are derived from (hashed gradient grids only)*/
+    memoryArena* arena; /**< the pointer to the arena the gradientGrid is allocated in, `NULL` if it was calloc'd*/
+    mappedBinaryFile* mapped_file; /**< the pointer to the mapped file holding the read-only gradients (see `readGradientGridFile`), `NULL` otherwise*/
 };
 
 typedef struct gradientGrid gradientGrid;
@@ -40,14 +51,19 @@ typedef struct gradientGrid gradientGrid;
 // ----- Functions -----
 
 /**
- * @brief Sets the Random Seed to the given unsigned int.
+ * @brief Gets the random unit vector at the given cell of the given context. It is the vector of the random gradient grids at `(cell_x, cell_y)`,
+ * and of the hashed gradient grids at the global lattice coordinates `(cell_x, cell_y)`.
  * 
- * @param seed (unsigned int) : the seed to setup the random generator.
+ * @param context (generatorContext*) : the pointer to the layer or lattice context.
+ * @param cell_x (int) : the width index of the vector.
+ * @param cell_y (int) : the height index of the vector.
+ * @return vector : the random vector.
  */
-void setRandomSeed(unsigned int seed);
+vector getRandomGradient(generatorContext* context, int cell_x, int cell_y);
 
 /**
- * @brief Gets the Vector from gradGrid at given indexes.
+ * @brief Gets the Vector from gradGrid at given indexes. Hashed gradient grids do not store their vectors : use `getGradient` for them.
+ * Trimmed gradient grids only keep their boundaries : use `getBoundaryGradient` for them.
  * 
  * @param gradGrid (gradientGrid*) : the pointer to the corresponding gradient grid.
  * @param width_idx (int) : the width index of the wanted vector.
@@ -56,17 +72,69 @@ void setRandomSeed(unsigned int seed);
  */
 vector* getVector(gradientGrid* gradGrid, int width_idx, int height_idx);
 
+/**
+ * @brief Gets the Vector from gradGrid at given indexes, without any check on the indexes. Made for the generation loops.
+ * In a `PROCGEN_CHECKED` build, it keeps the validating behaviour of `getVector`.
+ * 
+ * @param gradGrid (gradientGrid*) : the pointer to the corresponding gradient grid.
+ * @param width_idx (int) : the width index of the wanted vector. Should be in `[0, width - 1]`.
+ * @param height_idx (int) : the height index of the wanted vector. Should be in `[0, height - 1]`.
+ * @return vector* : the vector at given indexes
+ */
+static inline vector* getVectorUnchecked(gradientGrid* gradGrid, int width_idx, int height_idx)
+{
+#ifdef PROCGEN_CHECKED
+    return getVector(gradGrid, width_idx, height_idx);
+#else
+    return gradGrid->gradients + height_idx * gradGrid->width + width_idx;
+#endif
+}
+
+/**
+ * @brief Gets a copy of the vector of the given trimmed gradient grid at given indexes. Only its south row and east column are kept.
+ * 
+ * @param gradGrid (gradientGrid*) : the pointer to the trimmed gradient grid.
+ * @param width_idx (int) : the width index of the wanted vector. Should be in `[0, width - 1]`.
+ * @param height_idx (int) : the height index of the wanted vector. Should be in `[0, height - 1]`.
+ * @return vector : the vector at given indexes, a zero vector out of the south row and of the east column.
+ */
+vector getBoundaryGradient(gradientGrid* gradGrid, int width_idx, int height_idx);
+
+/**
+ * @brief Gets a copy of the vector from gradGrid at given indexes, without any check on the indexes. Works for stored, hashed and trimmed
+ * gradient grids.
+ * 
+ * @param gradGrid (gradientGrid*) : the pointer to the corresponding gradient grid.
+ * @param width_idx (int) : the width index of the wanted vector. Should be in `[0, width - 1]`.
+ * @param height_idx (int) : the height index of the wanted vector. Should be in `[0, height - 1]`.
+ * @return vector : the vector at given indexes
+ */
+static inline vector getGradient(gradientGrid* gradGrid, int width_idx, int height_idx)
+{
+    if (gradGrid->gradients == NULL)
+    {
+        if (gradGrid->boundaries != NULL)
+        {
+            return getBoundaryGradient(gradGrid, width_idx, height_idx);
+        }
+        return getRandomGradient(&gradGrid->lattice_context, gradGrid->origin_x + width_idx, gradGrid->origin_y + height_idx);
+    }
+
+    return *getVectorUnchecked(gradGrid, width_idx, height_idx);
+}
+
 
 
 /**
- * @brief Regenerates random vectors in the gradient grid.
+ * @brief Regenerates random vectors in the gradient grid. The vector at indexes `(j, i)` only depends on the given context and on `(j, i)`.
  * 
  * @param gradGrid (gradientGrid*) : the pointer to the corresponding gradient grid.
+ * @param context (generatorContext*) : the pointer to the layer context of the gradient grid.
  * @param display_loading (unsigned int) : the given value defines the behaviour.
  *                                         * If `0` the loading bars won't be printed.
  *                                         * If `> 0` the loading bars will be printed with a number of indent equal to `display_loading - 1`.
  */
-void regenerateRandomGradGrid(gradientGrid* gradGrid, unsigned int display_loading);
+void regenerateRandomGradGrid(gradientGrid* gradGrid, generatorContext* context, unsigned int display_loading);
 
 
 
@@ -76,21 +144,37 @@ void regenerateRandomGradGrid(gradientGrid* gradGrid, unsigned int display_loadi
  * 
  * @param width (int) : the width of the generated gradient grid.
  * @param height (int) : the height of the generated gradient grid.
+ * @param arena (memoryArena*) : the pointer to the arena to allocate the gradient grid in, `NULL` to calloc it.
  * @return gradientGrid* : the pointer to the generated gradient grid.
  */
-gradientGrid* newGradGrid(int width, int height);
+gradientGrid* newGradGrid(int width, int height, memoryArena* arena);
 
 /**
  * @brief Generates a new gradientGrid object with given width and height initialized to random vectors.
  * 
  * @param width (int) : the width of the generated gradient grid.
  * @param height (int) : the height of the generated gradient grid.
+ * @param context (generatorContext*) : the pointer to the layer context of the gradient grid.
  * @param display_loading (unsigned int) : the given value defines the behaviour.
  *                                         * If `0` the loading bars won't be printed.
  *                                         * If `> 0` the loading bars will be printed with a number of indent equal to `display_loading - 1`.
  * @return gradientGrid* : the pointer to the generated gradient grid.
  */
-gradientGrid* newRandomGradGrid(int width, int height, unsigned int display_loading);
+gradientGrid* newRandomGradGrid(int width, int height, generatorContext* context, unsigned int display_loading);
+
+/**
+ * @brief Generates a new hashed gradientGrid object : it does not store any vector, they are derived on the fly from the lattice context
+ * and from their global lattice coordinates `(origin_x + width_idx, origin_y + height_idx)`.
+ * Two hashed gradient grids sharing a lattice context thus agree on their common boundaries by construction.
+ * 
+ * @param width (int) : the width of the generated gradient grid.
+ * @param height (int) : the height of the generated gradient grid.
+ * @param origin_x (int) : the global lattice width index of the first vector.
+ * @param origin_y (int) : the global lattice height index of the first vector.
+ * @param context (generatorContext*) : the pointer to the lattice context of the octave (see `getLatticeContext`). It is copied in the structure.
+ * @return gradientGrid* : the pointer to the generated gradient grid.
+ */
+gradientGrid* newHashedGradGrid(int width, int height, int origin_x, int origin_y, generatorContext* context);
 
 
 
@@ -100,15 +184,26 @@ gradientGrid* newRandomGradGrid(int width, int height, unsigned int display_load
  * 
  * @param north_grid (gradientGrid*) : the pointer to the gradientGrid located at the north (height index < 0)
  * @param west_grid (gradientGrid*) : the pointer to the gradientGrid located at the west (width index < 0)
+ * @param context (generatorContext*) : the pointer to the layer context of the new gradient grid.
  * @param display_loading (unsigned int) : the given value defines the behaviour.
  *                                         * If `0` the loading bars won't be printed.
  *                                         * If `> 0` the loading bars will be printed with a number of indent equal to `display_loading - 1`.
  * @return gradientGrid* : the pointer to the generated gradient grid.
  */
-gradientGrid* newAdjacentGradGrid(gradientGrid* north_grid, gradientGrid* west_grid, unsigned int display_loading);
+gradientGrid* newAdjacentGradGrid(gradientGrid* north_grid, gradientGrid* west_grid, generatorContext* context, unsigned int display_loading);
 
 
 
+/**
+ * @brief Trims the given gradient grid to the vectors its south and east neighbours copy (see `newAdjacentGradGrid`) : its south row
+ * and its east column are kept, the other vectors are free'd. Does nothing for a hashed or an already trimmed gradient grid.
+ * 
+ * @param gradGrid (gradientGrid*) : the pointer to the gradient grid to trim.
+ * 
+ * @note In an arena, the memory of the free'd vectors is only released with the arena.
+ */
+void trimGradGrid(gradientGrid* gradGrid);
+
 /**
  * @brief Makes a deep copy of the given gradientGrid structure.
  * 
@@ -129,6 +224,7 @@ vector* copyVect(vector* vect);
 
 /**
  * @brief Writes the given gradientGrid in a new file at path. If a file already exists, it will be overwritten.
+ * A trimmed gradient grid is refused : its interior vectors are lost.
  * 
  * @param gradGrid (gradientGrid*) : the pointer to the corresponding gradient grid.
  * @param path (char[]) : the path to the file to write.
@@ -136,24 +232,44 @@ vector* copyVect(vector* vect);
 void writeGradientGridFile(gradientGrid* gradGrid, char path[]);
 
 /**
- * @brief TODO : Reads a gradientGrid file and generates the corresponding gradient grid.
+ * @brief Maps a gradientGrid binary file (see `writeGradientGridBinaryFile`) in memory. Only its header is read : the gradients are
+ * read-only and paged in lazily when they are first used.
  * 
  * @param path (char[]) : the path to the file to read.
- * @return gradientGrid* : the pointer to the generated gradient grid.
+ * @return gradientGrid* : the pointer to the generated gradient grid, `NULL` if the file could not be mapped.
  */
 gradientGrid* readGradientGridFile(char path[]);
 
+/**
+ * @brief Writes the given gradientGrid in a new binary file at path (see `binaryFormat.h`). If a file already exists, it will be overwritten.
+ * The vectors of hashed gradient grids are written as `getGradient` reads them. A trimmed gradient grid is refused : its interior vectors are lost.
+ * 
+ * @param gradGrid (gradientGrid*) : the pointer to the corresponding gradient grid.
+ * @param seed (uint64_t) : the seed of the generation, stored in the header.
+ * @param path (char[]) : the path to the file to write.
+ */
+void writeGradientGridBinaryFile(gradientGrid* gradGrid, uint64_t seed, char path[]);
+
+/**
+ * @brief Reads a gradientGrid binary file and generates the corresponding stored gradient grid.
+ * 
+ * @param path (char[]) : the path to the file to read.
+ * @param header (binaryHeader*) : the pointer to the header to fill with the one of the file. Can be `NULL`.
+ * @return gradientGrid* : the pointer to the generated gradient grid, `NULL` if the file could not be read.
+ */
+gradientGrid* readGradientGridBinaryFile(char path[], binaryHeader* header);
+
 
 
 /**
- * @brief Prints in the terminal the given gradient grid.
+ * @brief Prints in the terminal the given gradient grid. A trimmed gradient grid is refused : its interior vectors are lost.
  * 
  * @param gradGrid (gradientGrid*) : the pointer to the corresponding gradient grid.
  */
 void printGradientGrid(gradientGrid* gradGrid);
 
 /**
- * @brief Frees the given gradientGrid structure and every sub-structures.
+ * @brief Frees the given gradientGrid structure and every sub-structures. Does nothing if it is allocated in an arena.
  * 
  * @param gradGrid (gradientGrid*) : the pointer to the corresponding gradient grid.
  */
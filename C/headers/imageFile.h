@@ -0,0 +1,58 @@
+/**
+ * @file imageFile.h
+ * @author Zyno and BlueNZ
+ * @brief Header to the image exporters of the RGB8 color arrays
+ * @version 0.2
+ * @date 2024-06-19
+ *
+ * @note A binary PPM (`P6`) file is a short text header followed by the packed RGB8 colors, written as they are in memory.
+ *
+ * @note A PNG file is written without any external library : the rows are filtered, then compressed in a zlib stream with a built-in
+ * deflate encoder, `IMAGE_BLOCK_SIZE` bytes of rows at a time. Each block is either stored as it is (`PNG_STORED`), or compressed
+ * with a greedy LZ77 pass and Huffman codes built for the block (`PNG_DEFLATE`). The compressed bytes of each block are written in
+ * their own `IDAT` chunk.
+ */
+
+#ifndef IMAGE_FILE
+#define IMAGE_FILE
+
+#include "colorPalette.h"
+
+// ----- Constants -----
+
+#define IMAGE_BLOCK_SIZE (1 << 18)  /**< the number of bytes of filtered rows compressed at a time in a PNG file*/
+
+// Compressions of a PNG file
+
+#define PNG_STORED  0   /**< the rows are stored in the zlib stream as they are*/
+#define PNG_DEFLATE 1   /**< the rows are filtered, and compressed with LZ77 and Huffman codes*/
+
+// ----- Functions -----
+
+/**
+ * @brief Writes the given colors in a binary PPM (`P6`) file at the given path.
+ *
+ * @param colors (color*) : the interleaved RGB8 array of colors, row after row.
+ * @param width (int) : the width of the image.
+ * @param height (int) : the height of the image.
+ * @param path (char[]) : the path of the file to be written.
+ * @return int : `1` if the file was written, `0` otherwise.
+ */
+int writePPMFile(color* colors, int width, int height, char path[]);
+
+/**
+ * @brief Writes the given colors in a 8-bit RGB PNG file at the given path.
+ *
+ * @param colors (color*) : the interleaved RGB8 array of colors, row after row.
+ * @param width (int) : the width of the image.
+ * @param height (int) : the height of the image.
+ * @param compression (int) : `PNG_STORED` or `PNG_DEFLATE`.
+ * @param path (char[]) : the path of the file to be written.
+ * @return int : `1` if the file was written, `0` otherwise.
+ *
+ * @note With `PNG_DEFLATE`, the filter of each row is the one minimizing the sum of the absolute values of its filtered bytes.
+ * The LZ77 matches never cross a block of `IMAGE_BLOCK_SIZE` bytes, so that a block only needs its own rows.
+ */
+int writePNGFile(color* colors, int width, int height, int compression, char path[]);
+
+#endif
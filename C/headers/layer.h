@@ -12,8 +12,53 @@
 
 #include "gradientGrid.h"
 
+// ----- Constants -----
+
+// Row kernels of `perlinRowFromTable` (see `setPerlinRowKernel`)
+
+#define PERLIN_ROW_AUTO     -1  /**< the fastest kernel supported by the running CPU, resolved on the first row (default)*/
+#define PERLIN_ROW_SCALAR   0   /**< the portable kernel, one sample at a time*/
+#define PERLIN_ROW_SSE2     1   /**< the SSE2 kernel, x86 only*/
+#define PERLIN_ROW_AVX2     2   /**< the AVX2 kernel, x86 only*/
+
 // ----- Structure definition -----
 
+/**
+ * @brief The precomputed interpolation weights of a given size factor.
+ * Every gradient cell of a layer has the same `size_factor` fractional offsets, and thus the same smoothstep weights.
+ * 
+ */
+struct perlinTable
+{
+    int size_factor; /**< the size factor the table was computed for*/
+    int length; /**< the number of indexes covered by the table*/
+
+    altitude_t* offsets; /**< the offsets `k/size_factor - (int) (k/size_factor)` to the previous gradient line*/
+    altitude_t* next_offsets; /**< the (negative) offsets to the next gradient line*/
+    altitude_t* weights; /**< the smoothstep weights of the offsets*/
+
+    memoryArena* arena; /**< the pointer to the arena the table is allocated in, `NULL` if it was calloc'd*/
+};
+
+typedef struct perlinTable perlinTable;
+
+
+
+/**
+ * @brief The perlinTable structures of a generation, one per distinct size factor : every layer with this size factor shares it.
+ * The set is only read once built, so that the worker threads share it without locking.
+ * 
+ */
+struct perlinTableSet
+{
+    int nb_tables; /**< the number of tables*/
+    perlinTable** tables; /**< the array of tables, with distinct size factors*/
+};
+
+typedef struct perlinTableSet perlinTableSet;
+
+
+
 /**
  * @brief A layer structure.
  * 
@@ -26,31 +71,52 @@ struct layer
 
     gradientGrid* gradient_grid; /**!< the pointer to the gradientGrid structure used to generate this layer*/
 
-    double* values; /**!< the array of altitude values*/
+    altitude_t* values; /**!< the array of altitude values. It is `NULL` for the layers of fused chunks, whose values are never stored*/
+
+    memoryArena* arena; /**< the pointer to the arena the layer is allocated in (the one of its gradientGrid), `NULL` if it was calloc'd*/
+    mappedBinaryFile* mapped_file; /**< the pointer to the mapped file holding the read-only values (see `readLayerFile`), `NULL` otherwise*/
 };
 
 typedef struct layer layer;
 
+
+
+/**
+ * @brief The corner gradients of a row of gradient cells, expanded on the `size_factor` samples of each cell.
+ * It is loaded once per row of cells and reused by the `size_factor` rows of samples of these cells.
+ * 
+ */
+struct perlinCellRow
+{
+    int width; /**< the number of samples in a row*/
+    int cell_idx; /**< the height index of the loaded row of cells, `-1` if none is loaded*/
+
+    altitude_t* x_terms[4]; /**< the width part of the four corners dot products, in order (north-west, north-east, south-west, south-east)*/
+    altitude_t* y_gradients[4]; /**< the y coordinates of the four corner gradients, in the same order*/
+};
+
+typedef struct perlinCellRow perlinCellRow;
+
 // ----- Functions -----
 
 /**
  * @brief A smoothstep function to smoothly pass from 0 to 1.
  * It uses the function 3w² - 2w³
  * 
- * @param w (double) : the input value
- * @return double : the resulting smoothstep value
+ * @param w (altitude_t) : the input value
+ * @return altitude_t : the resulting smoothstep value
  */
-double smoothstep(double w);
+altitude_t smoothstep(altitude_t w);
 
 /**
  * @brief A smooth interpolating function.
  * 
- * @param a0 (double) : the first value to interpolate from.
- * @param a1 (double) : the second value to interpolate from.
- * @param w (double) : the smoothstep input.
- * @return double : the interpolated value between `a0` and `a1` using the smoothstep input `w`.
+ * @param a0 (altitude_t) : the first value to interpolate from.
+ * @param a1 (altitude_t) : the second value to interpolate from.
+ * @param w (altitude_t) : the smoothstep input.
+ * @return altitude_t : the interpolated value between `a0` and `a1` using the smoothstep input `w`.
  */
-double interpolate(double a0, double a1, double w);
+altitude_t interpolate(altitude_t a0, altitude_t a1, altitude_t w);
 
 
 
@@ -59,22 +125,125 @@ double interpolate(double a0, double a1, double w);
  * 
  * @param ix (int) : the width index to extract the vector from the gradient grid.
  * @param iy (int) : the height index to extract the vector from the gradient grid.
- * @param x (double) : the width position.
- * @param y (double) : the height position.
+ * @param x (altitude_t) : the width position.
+ * @param y (altitude_t) : the height position.
  * @param gradient_grid (gradientGrid*) : the pointer to the gradientGrid structure.
- * @return double : the computed dot product.
+ * @return altitude_t : the computed dot product.
  */
-double dotGridGradient(int ix, int iy, double x, double y, gradientGrid* gradient_grid);
+altitude_t dotGridGradient(int ix, int iy, altitude_t x, altitude_t y, gradientGrid* gradient_grid);
 
 /**
  * @brief Computes the altitude value at position (x, y) from the given gradient grid.
  * 
- * @param x (double) : the width position.
- * @param y (double) : the height position.
+ * @param x (altitude_t) : the width position.
+ * @param y (altitude_t) : the height position.
  * @param gradient_grid (gradientGrid*) : the pointer to the gradientGrid structure.
- * @return double : the final altitude value.
+ * @return altitude_t : the final altitude value.
  */
-double perlin(double x, double y, gradientGrid* gradient_grid);
+altitude_t perlin(altitude_t x, altitude_t y, gradientGrid* gradient_grid);
+
+/**
+ * @brief Generates the perlinTable structure of the given size factor, covering the indexes `[0, length - 1]`.
+ * 
+ * @param size_factor (int) : the size factor of the layers using this table.
+ * @param length (int) : the number of indexes covered by the table. Should be at least the largest dimension of the layers using it.
+ * @param arena (memoryArena*) : the pointer to the arena to allocate the table in, `NULL` to calloc it.
+ * @return perlinTable* : the pointer to the newly generated perlinTable structure.
+ */
+perlinTable* newPerlinTable(int size_factor, int length, memoryArena* arena);
+
+/**
+ * @brief Generates the perlinTableSet structure of the given layers : one table per distinct size factor, covering the indexes `[0, length - 1]`.
+ * 
+ * @param number_of_layers (int) : the number of layers.
+ * @param size_factors (int[]) : the size factors of the layers.
+ * @param length (int) : the number of indexes covered by the tables. Should be at least the largest dimension of the layers.
+ * @return perlinTableSet* : the pointer to the newly generated perlinTableSet structure.
+ */
+perlinTableSet* newPerlinTableSet(int number_of_layers, int size_factors[number_of_layers], int length);
+
+/**
+ * @brief Gets the table of the given size factor in the given set.
+ * 
+ * @param table_set (perlinTableSet*) : the pointer to the set, can be `NULL`.
+ * @param size_factor (int) : the size factor of the layer.
+ * @param length (int) : the number of indexes the table should cover.
+ * @return perlinTable* : the pointer to the table, `NULL` if the set has no table of this size factor covering `length` indexes.
+ */
+perlinTable* getPerlinTable(perlinTableSet* table_set, int size_factor, int length);
+
+/**
+ * @brief Gets the tables of the given layers : the ones of the context if they cover every layer, so that the layers of the running generation
+ * share them, a new set otherwise (see `newPerlinTableSet`).
+ * 
+ * @param context (generatorContext*) : the pointer to the generator context, can be `NULL`.
+ * @param number_of_layers (int) : the number of layers.
+ * @param size_factors (int[]) : the size factors of the layers.
+ * @param length (int) : the number of indexes covered by the tables. Should be at least the largest dimension of the layers.
+ * @return perlinTableSet* : the pointer to the set, to be released with `releasePerlinTables`.
+ */
+perlinTableSet* acquirePerlinTables(generatorContext* context, int number_of_layers, int size_factors[number_of_layers], int length);
+
+/**
+ * @brief Releases the tables got from `acquirePerlinTables` : they are free'd unless they are the context's own ones.
+ * 
+ * @param context (generatorContext*) : the pointer to the generator context, can be `NULL`.
+ * @param table_set (perlinTableSet*) : the pointer to the set.
+ */
+void releasePerlinTables(generatorContext* context, perlinTableSet* table_set);
+
+/**
+ * @brief Generates an empty perlinCellRow structure for layers of the given width.
+ * 
+ * @param width (int) : the width of the layers.
+ * @return perlinCellRow* : the pointer to the newly generated perlinCellRow structure.
+ */
+perlinCellRow* newPerlinCellRow(int width);
+
+/**
+ * @brief Computes a whole row of altitude values of a layer, using the precomputed weights of `table`.
+ * The corners of the row of gradient cells are only loaded in `cell_row` when `height_idx` enters a new row of cells,
+ * and the samples are then computed several at a time by a SIMD kernel (AVX2, then SSE2, then scalar) chosen at runtime (see `setPerlinRowKernel`).
+ * The values are exactly the same as calling `perlin` on each sample.
+ * 
+ * @param row_values (altitude_t*) : the array of `cell_row->width` values to fill.
+ * @param height_idx (int) : the height index of the row in the layer. The samples are located at `(j/size_factor, height_idx/size_factor)`.
+ * @param gradient_grid (gradientGrid*) : the pointer to the gradientGrid structure.
+ * @param table (perlinTable*) : the pointer to the perlinTable structure of the layer's size factor.
+ * @param cell_row (perlinCellRow*) : the pointer to the perlinCellRow structure used for this gradient grid.
+ */
+void perlinRowFromTable(altitude_t* row_values, int height_idx, gradientGrid* gradient_grid, perlinTable* table, perlinCellRow* cell_row);
+
+/**
+ * @brief Forces the row kernel used by `perlinRowFromTable`, e.g. to check every kernel against `perlin`.
+ * 
+ * @param kernel (int) : `PERLIN_ROW_AUTO`, `PERLIN_ROW_SCALAR`, `PERLIN_ROW_SSE2` or `PERLIN_ROW_AVX2`.
+ * @return int : `1` if the kernel is used from now on, `0` if this build or CPU does not support it (the kernel is then left as it was).
+ * 
+ * @note The kernel is shared by every thread : it must not be changed while layers are being generated.
+ */
+int setPerlinRowKernel(int kernel);
+
+/**
+ * @brief Frees the given perlinTable structure. Does nothing if it is allocated in an arena.
+ * 
+ * @param table (perlinTable*) : the pointer to the perlinTable to be free'd.
+ */
+void freePerlinTable(perlinTable* table);
+
+/**
+ * @brief Frees the given perlinTableSet structure and its tables.
+ * 
+ * @param table_set (perlinTableSet*) : the pointer to the perlinTableSet to be free'd.
+ */
+void freePerlinTableSet(perlinTableSet* table_set);
+
+/**
+ * @brief Frees the given perlinCellRow structure.
+ * 
+ * @param cell_row (perlinCellRow*) : the pointer to the perlinCellRow to be free'd.
+ */
+void freePerlinCellRow(perlinCellRow* cell_row);
 
 
 
@@ -84,11 +253,43 @@ double perlin(double x, double y, gradientGrid* gradient_grid);
  * @param layer (layer*) : the pointer to the layer structure.
  * @param width_idx (int) : the width index.
  * @param height_idx (int) : the height index.
- * @return double* : the pointer to the corresponding altitude value.
+ * @return altitude_t* : the pointer to the corresponding altitude value.
+ */
+altitude_t* getLayerValue(layer* layer, int width_idx, int height_idx);
+
+/**
+ * @brief Get the layer altitude pointer at given indexes, without any check on the indexes. Made for the generation loops.
+ * In a `PROCGEN_CHECKED` build, it keeps the validating behaviour of `getLayerValue`.
+ * 
+ * @param layer (layer*) : the pointer to the layer structure.
+ * @param width_idx (int) : the width index. Should be in `[0, width - 1]`.
+ * @param height_idx (int) : the height index. Should be in `[0, height - 1]`.
+ * @return altitude_t* : the pointer to the corresponding altitude value.
  */
-double* getLayerValue(layer* layer, int width_idx, int height_idx);
+static inline altitude_t* getLayerValueUnchecked(layer* layer, int width_idx, int height_idx)
+{
+#ifdef PROCGEN_CHECKED
+    return getLayerValue(layer, width_idx, height_idx);
+#else
+    return layer->values + height_idx * layer->width + width_idx;
+#endif
+}
+
 
 
+/**
+ * @brief Initializes a layer structure from the given gradientGrid and size factor, without allocating nor computing its values.
+ * Such a layer is used by fused chunks, which directly compute their final values from the gradient grids.
+ * 
+ * @param gradient_grid (gradientGrid*) : the pointer to the gradientGrid structure of the layer.
+ * @param size_factor (int) : the size_factor to rescale the layer's dimensions.
+ * @return layer* : the pointer to the newly initialized layer structure, whose `values` are `NULL`.
+ * 
+ * @note Please be aware that the layer's dimensions are `(gradGrid_dimensions - 1) * size_factor`
+ * 
+ * @note The layer is allocated in the arena of its gradient grid, if it has one.
+ */
+layer* initLayer(gradientGrid* gradient_grid, int size_factor);
 
 /**
  * @brief Generates a new layer structure from the given gradientGrid and parameters.
@@ -102,15 +303,31 @@ double* getLayerValue(layer* layer, int width_idx, int height_idx);
  * @return layer* : the pointer to the newly created layer structure.
  * 
  * @note Please be aware that the layer's dimensions are `(gradGrid_dimensions - 1) * size_factor`
+ * 
+ * @note The layer and its values are allocated in the arena of its gradient grid, if it has one.
  */
 layer* newLayerFromGradient(gradientGrid* gradient_grid, int size_factor, unsigned int display_loading);
 
+/**
+ * @brief Generates a new layer structure from the given gradientGrid, with the precomputed weights of its size factor (see `newLayerFromGradient`).
+ *
+ * @param gradient_grid (gradientGrid*) : the pointer to the gradientGrid structure to build the layer from.
+ * @param table (perlinTable*) : the pointer to the perlinTable of the layer's size factor, covering its largest dimension. It is not kept by the layer.
+ * @param display_loading (unsigned int) : the given value defines the behaviour.
+ *                                         * If `0` the loading bars won't be printed.
+ *                                         * If `> 0` the loading bars will be printed with a number of indent equal to `display_loading - 1`.
+ *
+ * @return layer* : the pointer to the newly created layer structure.
+ */
+layer* newLayerFromTable(gradientGrid* gradient_grid, perlinTable* table, unsigned int display_loading);
+
 /**
  * @brief Generates a new layer structure from scratch with the given parameters.
  * 
  * @param gradGrid_width (int) : the width of the gradient grid to generate.
  * @param gradGrid_height (int) : the height of the gradient grid to generate.
  * @param size_factor (int) : the scaling factor to pass to the layer's dimensions.
+ * @param context (generatorContext*) : the pointer to the layer context of the gradient grid to generate.
  * @param display_loading (unsigned int) : the given value defines the behaviour.
  *                                         * If `0` the loading bars won't be printed.
  *                                         * If `> 0` the loading bars will be printed with a number of indent equal to `display_loading - 1`.
@@ -118,10 +335,18 @@ layer* newLayerFromGradient(gradientGrid* gradient_grid, int size_factor, unsign
  * 
  * @note Please be aware that the layer's dimensions are `(gradGrid_dimensions - 1) * size_factor`
  */
-layer* newLayer(int gradGrid_width, int gradGrid_height, int size_factor, unsigned int display_loading);
+layer* newLayer(int gradGrid_width, int gradGrid_height, int size_factor, generatorContext* context, unsigned int display_loading);
 
 
 
+/**
+ * @brief Frees the values of the given layer and trims its gradient grid to the boundaries its neighbours need (see `trimGradGrid`).
+ * The layer can no longer be regenerated.
+ * 
+ * @param layer (layer*) : the pointer to the layer to trim.
+ */
+void trimLayer(layer* layer);
+
 /**
  * @brief Makes a deep copy of the given layer structure.
  * 
@@ -141,13 +366,33 @@ layer* copyLayer(layer * p_layer);
 void writeLayerFile(layer* layer, char path[]);
 
 /**
- * @brief TODO : Reads a layer structure from a file.
+ * @brief Maps a layer binary file (see `writeLayerBinaryFile`) in memory. Only its header is read : the values are read-only and paged
+ * in lazily when they are first used. The layer has no gradient grid, and the files of layers without values can not be mapped.
  * 
  * @param path (char[]) : path to the file to be read.
- * @return layer* : the pointer to the newly generated layer structure.
+ * @return layer* : the pointer to the newly generated layer structure, `NULL` if the file could not be mapped.
  */
 layer* readLayerFile(char path[]);
 
+/**
+ * @brief Writes the given layer in a new binary file at path (see `binaryFormat.h`). The layers of fused chunks have no values :
+ * only their header is written.
+ * 
+ * @param layer (layer*) : the pointer to the layer to write.
+ * @param seed (uint64_t) : the seed of the generation, stored in the header.
+ * @param path (char[]) : the path to the file to write.
+ */
+void writeLayerBinaryFile(layer* layer, uint64_t seed, char path[]);
+
+/**
+ * @brief Reads a layer binary file. The layer has its values, but no gradient grid.
+ * 
+ * @param path (char[]) : path to the file to be read.
+ * @param header (binaryHeader*) : the pointer to the header to fill with the one of the file. Can be `NULL`.
+ * @return layer* : the pointer to the newly generated layer structure, `NULL` if the file could not be read.
+ */
+layer* readLayerBinaryFile(char path[], binaryHeader* header);
+
 
 
 /**
@@ -158,7 +403,7 @@ layer* readLayerFile(char path[]);
 void printLayer(layer* layer);
 
 /**
- * @brief Frees the given layer structure and every sub-structure.
+ * @brief Frees the given layer structure and every sub-structure. Does nothing if it is allocated in an arena.
  * 
  * @param layer (layer*) : pointer to the layer to be free'd.
  * 
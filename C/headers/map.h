@@ -31,11 +31,20 @@ struct map
 
     int chunk_width; /**< the width of each chunk*/
     int chunk_height; /**< the height of each chunk*/
-    double* map_values; /**< the array of altitude values. Its size is `map_width * chunk_width` x `map_height * chunk_height`*/
+    altitude_t* map_values; /**< the array of altitude values. Its size is `map_width * chunk_width` x `map_height * chunk_height`*/
+    memoryArena* arena; /**< the pointer to the arena the map is allocated in, `NULL` if it was calloc'd*/
+    mappedBinaryFile* mapped_file; /**< the pointer to the mapped file holding the read-only values (see `readMapFile`), `NULL` otherwise*/
 };
 
 typedef struct map map;
 
+/**
+ * @brief The signature of the functions receiving the finished rows of a streamed map (see `streamMap`), in order. The row values
+ * are only valid during the call. It returns `0` to stop the stream (e.g. on a write error), `1` otherwise.
+ * 
+ */
+typedef int (*mapRowSink)(void* sink_data, int row_idx, int width, altitude_t* row_values);
+
 // ----- Functions -----
 
 /**
@@ -44,9 +53,27 @@ typedef struct map map;
  * @param map (map*) : the pointer to the map structure.
  * @param width_idx (int) : the width index of the wanted value.
  * @param height_idx (int) : the height index of the wanted value.
- * @return double* : the pointer to the map altitude value.
+ * @return altitude_t* : the pointer to the map altitude value.
  */
-double* getMapValue(map* map, int width_idx, int height_idx);
+altitude_t* getMapValue(map* map, int width_idx, int height_idx);
+
+/**
+ * @brief Get the pointer to the altitude value at given width and height indexes in the given map structure, without any check on the indexes.
+ * Made for the generation loops. In a `PROCGEN_CHECKED` build, it keeps the validating behaviour of `getMapValue`.
+ * 
+ * @param map (map*) : the pointer to the map structure.
+ * @param width_idx (int) : the width index of the wanted value. Should be in `[0, map_width * chunk_width - 1]`.
+ * @param height_idx (int) : the height index of the wanted value. Should be in `[0, map_height * chunk_height - 1]`.
+ * @return altitude_t* : the pointer to the map altitude value.
+ */
+static inline altitude_t* getMapValueUnchecked(map* map, int width_idx, int height_idx)
+{
+#ifdef PROCGEN_CHECKED
+    return getMapValue(map, width_idx, height_idx);
+#else
+    return map->map_values + height_idx * (map->map_width * map->chunk_width) + width_idx;
+#endif
+}
 
 /**
  * @brief Get the Chunk structure at given indexes.
@@ -89,12 +116,13 @@ double interpolate2D(double a1, double a2, double a3, double a4, double x, doubl
  * @brief Modifies the given map to process each chunk's base altitude and adapt the final altitude values of the given map.
  * 
  * @param p_map (map*) : the pointer to the original untreated map.
+ * @param context (generatorContext*) : the pointer to the generator context. The base altitude is added in parallel bands if it has several workers. Can be `NULL`.
  * @param display_loading (unsigned int) : the given value defines the behaviour.
  *                                         * If `0` the loading bars won't be printed.
  *                                         * If `> 0` the loading bars will be printed with a number of indent equal to `display_loading - 1`.
  * @return map* : the pointer to the treated map, which is exactly the same as the given `p_map`.
  */
-map* addMeanAltitude(map* p_map, unsigned int display_loading);
+map* addMeanAltitude(map* p_map, generatorContext* context, unsigned int display_loading);
 
 
 
@@ -105,6 +133,7 @@ map* addMeanAltitude(map* p_map, unsigned int display_loading);
  * @param map_height (int) : number of chunks in height.
  * @param chunks (chunk**) : array of size `map_width * map_height` of pointers to the chunk structures.
  * @param virtual_chunks (chunk**) : array of size `(map_height+2 + map_width+2)*2 - 4` of pointers to the virtual chunk structures.
+ * @param context (generatorContext*) : the pointer to the generator context. The base altitude is added in parallel bands if it has several workers. Can be `NULL`.
  * @param display_loading (unsigned int) : the given value defines the behaviour.
  *                                         * If `0` the loading bars won't be printed.
  *                                         * If `> 0` the loading bars will be printed with a number of indent equal to `display_loading - 1`.
@@ -112,7 +141,7 @@ map* addMeanAltitude(map* p_map, unsigned int display_loading);
  * 
  * @note The chunks array does not need to be dynamically allocated and its content will be copied in the structure.
  */
-map* newMapFromChunks(int map_width, int map_height, chunk* chunks[map_width * map_height], chunk* virtual_chunks[(map_height+2+map_width+2)*2-4], unsigned int display_loading);
+map* newMapFromChunks(int map_width, int map_height, chunk* chunks[map_width * map_height], chunk* virtual_chunks[(map_height+2+map_width+2)*2-4], generatorContext* context, unsigned int display_loading);
 
 /**
  * @brief Creates a new map from scratch with the given parameters.
@@ -124,6 +153,7 @@ map* newMapFromChunks(int map_width, int map_height, chunk* chunks[map_width * m
  * @param layers_factors (double[number_of_layers]) : the array of layers factors.
  * @param map_width (int) : number of chunks in width.
  * @param map_height (int) : number of chunks in height.
+ * @param context (generatorContext*) : the pointer to the root generator context. Every chunk context is derived from it with its map indexes.
  * @param display_loading (unsigned int) : the given value defines the behaviour.
  *                                         * If `0` the loading bars won't be printed.
  *                                         * If `> 0` the loading bars will be printed with a number of indent equal to `display_loading - 1`.
@@ -134,9 +164,104 @@ map* newMapFromChunks(int map_width, int map_height, chunk* chunks[map_width * m
  *          be generated but its dimensions will be wrong : it will simply use the first value. 
  * 
  * @note The arrays does not need to be dynamically allocated and their content will be copied in the structure.
+ * 
+ * @note With a `HASHED_GRADIENTS` context, every chunk is generated on its own : it does not need its north and west neighbours.
+ * 
+ * @note If the context has several workers, the map is generated as a task graph (see `newMapTaskGraph`).
+ * 
+ * @note If the context options have `chunk_views` set, the chunks are generated in place in the map values : their values are views into it
+ *       and nothing is copied. They then hold the final map values, base altitude included.
+ * 
+ * @note If the context has the `KEEP_CHUNK_BOUNDARIES` retention policy, each chunk is trimmed right after its generation (see `trimChunk`).
  */
 map* newMap(int number_of_layers, int gradGrids_width[number_of_layers], int gradGrids_height[number_of_layers],
-                 int size_factors[number_of_layers], double layers_factors[number_of_layers], int map_width, int map_height, unsigned int display_loading);
+                 int size_factors[number_of_layers], double layers_factors[number_of_layers], int map_width, int map_height,
+                 generatorContext* context, unsigned int display_loading);
+
+
+
+/**
+ * @brief Creates a new map whose chunks, values and base altitude are generated by graph tasks queued on the pool of the given context.
+ * Each chunk is generated as soon as its north and west neighbours are (right away with hashed gradients), its values are copied in the map
+ * right after (unless the chunks are views into the map values), and the base altitude of each region between four chunks is added as soon as their values are there. 
+ * The generated map is the same as the one of `newMap`.
+ * 
+ * @param number_of_layers (int) : the number of layers passed.
+ * @param gradGrids_width (int[number_of_layers]) : the array of gradientGrid width to be used to generate the random gradient grids.
+ * @param gradGrids_height (int[number_of_layers]) : the array of gradientGrid height to be used to generate the random gradient grids.
+ * @param size_factors (int[number_of_layers]) : the array of size factors to generate the layers.
+ * @param layers_factors (double[number_of_layers]) : the array of layers factors.
+ * @param map_width (int) : number of chunks in width.
+ * @param map_height (int) : number of chunks in height.
+ * @param context (generatorContext*) : the pointer to the root generator context, with the pool to run the tasks on (can be `NULL`).
+ * @param group (taskGroup*) : the pointer to the group of the tasks.
+ * @param chunks_ready (task*[map_width * map_height]) : the array filled with, for each chunk, the graph task after which its final
+ *                                                     values are ready. Other tasks can wait for them.
+ * @return map* : the pointer to the new map structure, complete once the group is waited for.
+ * 
+ * @warning The arrays and the context should live until the group is waited for.
+ */
+map* newMapTaskGraph(int number_of_layers, int gradGrids_width[number_of_layers], int gradGrids_height[number_of_layers],
+                        int size_factors[number_of_layers], double layers_factors[number_of_layers], int map_width, int map_height,
+                        generatorContext* context, taskGroup* group, task* chunks_ready[map_width * map_height]);
+
+
+
+/**
+ * @brief Generates a map one chunk row at a time, and gives its finished rows to the given sink instead of storing them. The generated
+ * values are the same as the ones of `newMap`.
+ * 
+ * @param number_of_layers (int) : the number of layers passed.
+ * @param gradGrids_width (int[number_of_layers]) : the array of gradientGrid width to be used to generate the random gradient grids.
+ * @param gradGrids_height (int[number_of_layers]) : the array of gradientGrid height to be used to generate the random gradient grids.
+ * @param size_factors (int[number_of_layers]) : the array of size factors to generate the layers.
+ * @param layers_factors (double[number_of_layers]) : the array of layers factors.
+ * @param map_width (int) : number of chunks in width.
+ * @param map_height (int) : number of chunks in height.
+ * @param context (generatorContext*) : the pointer to the root generator context. Its arena, chunk views and retention policy are not used.
+ * @param sink (mapRowSink) : the function receiving the rows, from the first to the last one.
+ * @param sink_data (void*) : the pointer passed to the sink (e.g. a file or an encoder).
+ * @param display_loading (unsigned int) : the given value defines the behaviour.
+ *                                         * If `0` the loading bars won't be printed.
+ *                                         * If `> 0` the loading bars will be printed with a number of indent equal to `display_loading - 1`.
+ * @return int : `1` if every row was given to the sink, `0` if the sink stopped the stream.
+ * 
+ * @note Only two chunk rows are stored at a time : the chunks are generated in place in a window of `2 * chunk_height` map rows, and the
+ * previous chunk row only keeps its gradient grids boundaries and its base altitudes. A row is given to the sink once the base altitude
+ * of the chunk row below it is added, and dropped right after : the memory used is `O(map_width * chunk_width * chunk_height)`,
+ * whatever the map height.
+ * 
+ * @note With a `HASHED_GRADIENTS` context, the chunks of a row are generated in parallel if the context has several workers. Otherwise
+ * each chunk needs its west neighbour : only its layers are generated in parallel.
+ */
+int streamMap(int number_of_layers, int gradGrids_width[number_of_layers], int gradGrids_height[number_of_layers],
+                int size_factors[number_of_layers], double layers_factors[number_of_layers], int map_width, int map_height,
+                generatorContext* context, mapRowSink sink, void* sink_data, unsigned int display_loading);
+
+
+
+/**
+ * @brief Regenerates the chunk at the given indexes of the map `newMap` would generate with the same parameters, without generating
+ * the rest of the map. Its values are the final map values, base altitude included.
+ * 
+ * @param number_of_layers (int) : the number of layers passed.
+ * @param gradGrids_width (int[number_of_layers]) : the array of gradientGrid width to be used to generate the random gradient grids.
+ * @param gradGrids_height (int[number_of_layers]) : the array of gradientGrid height to be used to generate the random gradient grids.
+ * @param size_factors (int[number_of_layers]) : the array of size factors to generate the layers.
+ * @param layers_factors (double[number_of_layers]) : the array of layers factors.
+ * @param map_width (int) : number of chunks in width of the map.
+ * @param map_height (int) : number of chunks in height of the map.
+ * @param chunk_x (int) : the width index of the chunk, in `[0, map_width[`.
+ * @param chunk_y (int) : the height index of the chunk, in `[0, map_height[`.
+ * @param context (generatorContext*) : the pointer to the root generator context of the map. Its arena, chunk views and retention policy are not used.
+ * @return chunk* : the pointer to the newly generated chunk, owning its values and keeping its layers. `NULL` if the indexes are out of the map.
+ * 
+ * @note With `STORED_GRADIENTS`, a chunk copies boundaries its north and west neighbours copied themselves. Those are rebuilt from the random
+ * gradient grids of the north, west and north-west chunks : the cost is the one of a chunk, plus three gradient grids per layer.
+ */
+chunk* regenerateMapChunk(int number_of_layers, int gradGrids_width[number_of_layers], int gradGrids_height[number_of_layers],
+                            int size_factors[number_of_layers], double layers_factors[number_of_layers], int map_width, int map_height,
+                            int chunk_x, int chunk_y, generatorContext* context);
 
 
 
@@ -159,13 +284,89 @@ map* copyMap(map* p_map) ;
 void writeMapFile(map* map, char path[]);
 
 /**
- * @brief TODO : Reads the given file and generates the associated map structure.
+ * @brief Maps a map binary file (see `writeMapBinaryFile`) in memory. Only its header is read : the values are read-only and paged
+ * in lazily when they are first used. As for `readMapBinaryFile`, the map has no chunk structure : `getChunk` can not be used on it.
  * 
  * @param path (char[]) : path to the file to be read.
- * @return map* : the pointer to the generated map structure.
+ * @return map* : the pointer to the generated map structure, `NULL` if the file could not be mapped.
  */
 map* readMapFile(char path[]);
 
+/**
+ * @brief Writes the values of the given map in a new binary file at path (see `binaryFormat.h`), with its chunks geometry.
+ * 
+ * @param map (map*) : pointer to the map structure to write.
+ * @param seed (uint64_t) : the seed of the generation, stored in the header.
+ * @param codec (int) : the codec of the values (e.g. `BINARY_CODEC_QUANTIZED`, with `BINARY_QUANTIZATION_BITS` fractional bits).
+ * @param path (char[]) : writing path for the file.
+ */
+void writeMapBinaryFile(map* map, uint64_t seed, int codec, char path[]);
+
+/**
+ * @brief Generates a map with `streamMap` straight into a new binary file at path, the same as the one `writeMapBinaryFile` writes
+ * for the map of `newMap`. The file is written as the rows are generated : the whole map is never in memory.
+ * 
+ * @param number_of_layers (int) : the number of layers passed.
+ * @param gradGrids_width (int[number_of_layers]) : the array of gradientGrid width to be used to generate the random gradient grids.
+ * @param gradGrids_height (int[number_of_layers]) : the array of gradientGrid height to be used to generate the random gradient grids.
+ * @param size_factors (int[number_of_layers]) : the array of size factors to generate the layers.
+ * @param layers_factors (double[number_of_layers]) : the array of layers factors.
+ * @param map_width (int) : number of chunks in width.
+ * @param map_height (int) : number of chunks in height.
+ * @param context (generatorContext*) : the pointer to the root generator context. Its seed is stored in the header.
+ * @param codec (int) : the codec of the values (e.g. `BINARY_CODEC_PREDICTIVE`).
+ * @param path (char[]) : writing path for the file.
+ * @param display_loading (unsigned int) : the given value defines the behaviour.
+ *                                         * If `0` the loading bars won't be printed.
+ *                                         * If `> 0` the loading bars will be printed with a number of indent equal to `display_loading - 1`.
+ * @return int : `1` if the file was written, `0` otherwise.
+ */
+int streamMapBinaryFile(int number_of_layers, int gradGrids_width[number_of_layers], int gradGrids_height[number_of_layers],
+                            int size_factors[number_of_layers], double layers_factors[number_of_layers], int map_width, int map_height,
+                            generatorContext* context, int codec, char path[], unsigned int display_loading);
+
+/**
+ * @brief Reads a map binary file. The map has its values and its chunks geometry, but no chunk structure : `getChunk` can not be used on it.
+ * 
+ * @param path (char[]) : path to the file to be read.
+ * @param header (binaryHeader*) : the pointer to the header to fill with the one of the file. Can be `NULL`.
+ * @return map* : the pointer to the generated map structure, `NULL` if the file could not be read.
+ */
+map* readMapBinaryFile(char path[], binaryHeader* header);
+
+/**
+ * @brief Writes the chunks of the given map in a new tiled binary file at path : a record file (see `binaryFormat.h`) with one record
+ * per chunk, in row-major order. A record holds the base altitude (f64), the number of layers (u32), 4 reserved bytes, then for each
+ * layer its factor (f64), its size factor (u32) and 4 reserved bytes, and finally the chunk values.
+ * 
+ * @param map (map*) : pointer to the map structure to write. It must have its chunks and its values.
+ * @param seed (uint64_t) : the seed of the generation, stored in the header.
+ * @param path (char[]) : writing path for the file.
+ * 
+ * @note The chunk values are its window of the map values : the final altitudes, base altitude included, as `regenerateMapChunk` gives them.
+ * They do not depend on the `chunk_views` option of the generation.
+ */
+void writeMapTiledFile(map* map, uint64_t seed, char path[]);
+
+/**
+ * @brief Opens a tiled binary file written by `writeMapTiledFile` for random chunk access. It is closed with `closeBinaryRecordFile`.
+ * 
+ * @param path (char[]) : path to the file to be opened.
+ * @return binaryRecordFile* : the pointer to the opened file, whose header holds the map geometry, `NULL` if the file could not be opened.
+ */
+binaryRecordFile* openMapTiledFile(char path[]);
+
+/**
+ * @brief Reads a single chunk of an opened tiled binary file, with a single `pread`. The chunk has its final values (see `writeMapTiledFile`),
+ * its base altitude, its layers factors and layers holding their size factor, but neither layer values nor gradient grids.
+ * 
+ * @param tiled_file (binaryRecordFile*) : the pointer to the file opened with `openMapTiledFile`.
+ * @param width_idx (int) : the width index of the chunk in the map.
+ * @param height_idx (int) : the height index of the chunk in the map.
+ * @return chunk* : the pointer to the read chunk, `NULL` if it could not be read.
+ */
+chunk* readMapTiledChunk(binaryRecordFile* tiled_file, int width_idx, int height_idx);
+
 
 
 /**
@@ -176,7 +377,8 @@ map* readMapFile(char path[]);
 void printMap(map* map);
 
 /**
- * @brief Frees the given map structure and every sub-structures contained.
+ * @brief Frees the given map structure and every sub-structures contained. Does nothing if it is allocated in an arena : the whole map
+ * is then released at once with `freeMemoryArena`.
  * 
  * @param map (map*) : the pointer to the map structure to be free'd.
  * 
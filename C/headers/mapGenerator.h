@@ -10,29 +10,13 @@
 #ifndef MAP_GENERATOR
 #define MAP_GENERATOR
 
+#include "asyncWriter.h"
+#include "colorPalette.h"
+#include "imageFile.h"
 #include "map.h"
 
 // ----- Structure definition -----
 
-/**
- * @brief A color structure containing int and float parameters.
- * 
- */
-struct color
-{
-    int red_int; /**< the red int value in [0, 255]*/
-    int green_int; /**< the green int value in [0, 255]*/
-    int blue_int; /**< the blue int value in [0, 255]*/
-
-    float red_float; /**< the red float value in [0, 1]*/
-    float green_float; /**< the green float value in [0, 1]*/
-    float blue_float; /**< the blue float value in [0, 1]*/
-};
-
-typedef struct color color;
-
-
-
 /**
  * @brief A complete map structure containing an initial map, a sea_map and a color_map.
  * 
@@ -45,13 +29,38 @@ struct completeMap
     int height; /**< the height of the map*/
 
     double sea_level; /**< the sea level of the complete map*/
-    double* sea_values; /**< the array of altitude values of the sea_map where the minimum altitude is `sea_level`*/
+    altitude_t* sea_values; /**< the array of altitude values of the sea_map where the minimum altitude is `sea_level`*/
 
-    color** color_map; /**< the corresponding color map structure*/
+    color* color_map; /**< the corresponding interleaved RGB8 color map, with the same dimensions as the map*/
+
+    mappedBinaryFile* sea_mapped_file; /**< the pointer to the mapped file holding the read-only sea values (see `readCompleteMapFiles`), `NULL` otherwise*/
+    mappedBinaryFile* color_mapped_file; /**< the pointer to the mapped file holding the read-only color map, `NULL` otherwise*/
 };
 
 typedef struct completeMap completeMap;
 
+/**
+ * @brief The recipe of a complete map : the parameters of `fullGen`, and what the generated values depend on. A complete map is
+ * regenerated bit for bit from its recipe, as long as the generator version and the precision of the build are the same.
+ * 
+ */
+struct mapRecipe
+{
+    int generator_version; /**< the version of the generator that wrote the recipe (see `GENERATOR_VERSION`)*/
+    uint64_t seed; /**< the seed of the generation*/
+    int gradient_source; /**< `STORED_GRADIENTS` or `HASHED_GRADIENTS`*/
+    int altitude_dtype; /**< the type of the altitude values of the build that wrote the recipe (see `ALTITUDE_DTYPE`)*/
+    int gradient_dtype; /**< the type of the gradient values of the build that wrote the recipe (see `GRADIENT_DTYPE`)*/
+    int number_of_layers; /**< the number of layers*/
+    int* gradGrids_dimension; /**< the array of the number of cells of the gradient grids of each layer*/
+    double* layers_factors; /**< the array of layers factors*/
+    int map_width; /**< number of chunks in width*/
+    int map_height; /**< number of chunks in height*/
+    double sea_level; /**< the sea level of the complete map*/
+};
+
+typedef struct mapRecipe mapRecipe;
+
 // ----- Functions -----
 
 /**
@@ -89,56 +98,99 @@ int lcmOfArray(int nb, int array[nb]);
  * @param completeMap (completeMap*) : pointer to the completeMap structure.
  * @param width_idx (int) : the width index of the altitude value pointer.
  * @param height_idx (int) : the height index of the altitude value pointer.
- * @return double* : the pointer to the wanted altitude value.
+ * @return altitude_t* : the pointer to the wanted altitude value.
  */
-double* getCompleteMapSeaValue(completeMap* completeMap, int width_idx, int height_idx);
+altitude_t* getCompleteMapSeaValue(completeMap* completeMap, int width_idx, int height_idx);
 
 /**
- * @brief Get the pointer to the color structure at the given indexes in the given completeMap structure.
+ * @brief Get the pointer to the sea altitude value at the given indexes in the given completeMap structure, without any check on the indexes.
+ * Made for the generation loops. In a `PROCGEN_CHECKED` build, it keeps the validating behaviour of `getCompleteMapSeaValue`.
  * 
  * @param completeMap (completeMap*) : pointer to the completeMap structure.
- * @param width_idx (int) : the width index of the color structure.
- * @param height_idx (int) : the height index of the color structure.
- * @return color* : the pointer to the wanted color structure.
+ * @param width_idx (int) : the width index of the altitude value pointer. Should be in `[0, width - 1]`.
+ * @param height_idx (int) : the height index of the altitude value pointer. Should be in `[0, height - 1]`.
+ * @return altitude_t* : the pointer to the wanted altitude value.
+ */
+static inline altitude_t* getCompleteMapSeaValueUnchecked(completeMap* completeMap, int width_idx, int height_idx)
+{
+#ifdef PROCGEN_CHECKED
+    return getCompleteMapSeaValue(completeMap, width_idx, height_idx);
+#else
+    return completeMap->sea_values + height_idx * completeMap->width + width_idx;
+#endif
+}
+
+/**
+ * @brief Get the pointer to the color at the given indexes in the given completeMap structure.
+ * 
+ * @param completeMap (completeMap*) : pointer to the completeMap structure.
+ * @param width_idx (int) : the width index of the color.
+ * @param height_idx (int) : the height index of the color.
+ * @return color* : the pointer to the wanted color, in the color map.
  */
 color* getCompleteMapColor(completeMap* completeMap, int width_idx, int height_idx);
 
 /**
- * @brief Generates a new color structure from the given parameters and returns its pointer.
+ * @brief Get the pointer to the color at the given indexes in the given completeMap structure, without any check on the indexes.
+ * Made for the generation loops. In a `PROCGEN_CHECKED` build, it keeps the validating behaviour of `getCompleteMapColor`.
+ * 
+ * @param completeMap (completeMap*) : pointer to the completeMap structure.
+ * @param width_idx (int) : the width index of the color. Should be in `[0, width - 1]`.
+ * @param height_idx (int) : the height index of the color. Should be in `[0, height - 1]`.
+ * @return color* : the pointer to the wanted color, in the color map.
+ */
+static inline color* getCompleteMapColorUnchecked(completeMap* completeMap, int width_idx, int height_idx)
+{
+#ifdef PROCGEN_CHECKED
+    return getCompleteMapColor(completeMap, width_idx, height_idx);
+#else
+    return completeMap->color_map + height_idx * completeMap->width + width_idx;
+#endif
+}
+
+/**
+ * @brief Computes the exact color of the given altitude value with the default palette (see `getPaletteColor`), without any lookup table.
  * 
  * @param value (double) : the altitude value to generate the color from.
  * @param sea_level (double) : the sea level of the map.
  * @param min_value (double) : the minimum altitude value of the map.
  * @param max_value (double) : the maximum altitude value of the map.
- * @return color* : the pointer to the newly generated color.
+ * @return color : the packed color.
+ * 
+ * @note The color maps of `generateColorMap` are sampled from a lookup table (see `newColorLUT`) : their colors have the same sea or land class
+ *       as the ones of this function, but can differ from them by the quantization of the table.
  */
-color* colorize(double value, double sea_level, double min_value, double max_value);
+color colorize(double value, double sea_level, double min_value, double max_value);
 
 
 
 /**
- * @brief Generates a color_map from the given parameters.
+ * @brief Generates a color_map from the given parameters. The palette of the context is sampled once in a lookup table
+ * spanning the map values (see `newColorLUT`), then every value is colorized with a table load.
  * 
  * @param map (map*) : pointer to the initial map structure.
  * @param sea_level (double) : sea altitude to use.
+ * @param context (generatorContext*) : the pointer to the generator context. Its rows are processed in parallel bands if it has several workers,
+ *                                      and its palette is used. Can be `NULL`.
  * @param display_loading (unsigned int) : the given value defines the behaviour.
  *                                         * If `0` the loading bars won't be printed.
  *                                         * If `> 0` the loading bars will be printed with a number of indent equal to `display_loading - 1`.
- * @return color** : array of pointers to the generated color structures. Color map has the same dimensions as `map`.
+ * @return color* : the interleaved RGB8 array of the generated colors. Color map has the same dimensions as `map`.
  */
-color** generateColorMap(map* map, double sea_level, unsigned int display_loading);
+color* generateColorMap(map* map, double sea_level, generatorContext* context, unsigned int display_loading);
 
 /**
  * @brief Generates a sea_map from the given parameters.
  * 
  * @param map (map*) : pointer to the initial map structure.
  * @param sea_level (double) : sea altitude to use.
+ * @param context (generatorContext*) : the pointer to the generator context. Its rows are processed in parallel bands if it has several workers. Can be `NULL`.
  * @param display_loading (unsigned int) : the given value defines the behaviour.
  *                                         * If `0` the loading bars won't be printed.
  *                                         * If `> 0` the loading bars will be printed with a number of indent equal to `display_loading - 1`.
- * @return double* : array of altitude values where the sea if flat (the minimum value is sea_level). Sea map has the same dimensions as `map`.
+ * @return altitude_t* : array of altitude values where the sea if flat (the minimum value is sea_level). Sea map has the same dimensions as `map`.
  */
-double* setSeaLevel(map* map, double sea_level, unsigned int display_loading);
+altitude_t* setSeaLevel(map* map, double sea_level, generatorContext* context, unsigned int display_loading);
 
 
 
@@ -147,12 +199,13 @@ double* setSeaLevel(map* map, double sea_level, unsigned int display_loading);
  * 
  * @param map (map*) : pointer to the map structure to generate the completeMap from.
  * @param sea_level (double) : sea altitude to use.
+ * @param context (generatorContext*) : the pointer to the generator context. Its rows are processed in parallel bands if it has several workers. Can be `NULL`.
  * @param display_loading (unsigned int) : the given value defines the behaviour.
  *                                         * If `0` the loading bars won't be printed.
  *                                         * If `> 0` the loading bars will be printed with a number of indent equal to `display_loading - 1`.
  * @return completeMap* : pointer to the newly generated completeMap structure.
  */
-completeMap* newCompleteMapFromMap(map* map, double sea_level, unsigned int display_loading);
+completeMap* newCompleteMapFromMap(map* map, double sea_level, generatorContext* context, unsigned int display_loading);
 
 /**
  * @brief Generates a new completeMap structure from scratch with the given parameters.
@@ -165,6 +218,7 @@ completeMap* newCompleteMapFromMap(map* map, double sea_level, unsigned int disp
  * @param map_width (int) : number of chunks in width.
  * @param map_height (int) : number of chunks in height.
  * @param sea_level (double) : sea altitude to use.
+ * @param context (generatorContext*) : the pointer to the root generator context. Every chunk context is derived from it with its map indexes.
  * @param display_loading (unsigned int) : the given value defines the behaviour.
  *                                         * If `0` the loading bars won't be printed.
  *                                         * If `> 0` the loading bars will be printed with a number of indent equal to `display_loading - 1`.
@@ -175,10 +229,14 @@ completeMap* newCompleteMapFromMap(map* map, double sea_level, unsigned int disp
  *          be generated but its dimensions will be wrong : it will simply use the first value. 
  * 
  * @note The arrays does not need to be dynamically allocated and their content will be copied in the structure.
+ * 
+ * @note If the context has several workers, the whole generation runs as a single task graph : the post-processing of each chunk starts
+ * as soon as its final values are ready, and only the colors wait for the whole map (they need its minimum and maximum values).
+ * The result is the same as the sequential one.
  */
 completeMap* newCompleteMap(int number_of_layers, int gradGrids_width[number_of_layers], int gradGrids_height[number_of_layers],
                             int size_factors[number_of_layers], double layers_factors[number_of_layers],
-                            int map_width, int map_height, double sea_level, unsigned int display_loading);
+                            int map_width, int map_height, double sea_level, generatorContext* context, unsigned int display_loading);
 
 
 
@@ -190,6 +248,7 @@ completeMap* newCompleteMap(int number_of_layers, int gradGrids_width[number_of_
  * @param layers_factors (double[number_of_layers]) : the array of layers factors.
  * @param map_width (int) : number of chunks in width.
  * @param map_height (int) : number of chunks in height.
+ * @param context (generatorContext*) : the pointer to the root generator context. Every chunk context is derived from it with its map indexes.
  * @param display_loading (unsigned int) : the given value defines the behaviour.
  *                                         * If `0` the loading bars won't be printed.
  *                                         * If `> 0` the loading bars will be printed with a number of indent equal to `display_loading - 1`.
@@ -200,12 +259,35 @@ completeMap* newCompleteMap(int number_of_layers, int gradGrids_width[number_of_
  * @note The real gradient grids dimensions will be the passed ones + 1 to correctly match the passed dimensions' lcm to the final maps.
  */
 map* get2dMap(int number_of_layers, int gradGrids_dimension[number_of_layers], double layers_factors[number_of_layers],
-                    int map_width, int map_height, unsigned int display_loading);
+                    int map_width, int map_height, generatorContext* context, unsigned int display_loading);
+
+/**
+ * @brief Streams a map with square chunks and automatic size factors (see `get2dMap`) : its rows are given to the sink as soon as
+ * they are finished, and never stored together (see `streamMap`).
+ * 
+ * @param number_of_layers (int) : the number of layers passed.
+ * @param gradGrids_dimension (int[number_of_layers]) : the array of gradientGrid dimensions to be used to generate the random gradient grids.
+ * @param layers_factors (double[number_of_layers]) : the array of layers factors.
+ * @param map_width (int) : number of chunks in width.
+ * @param map_height (int) : number of chunks in height.
+ * @param context (generatorContext*) : the pointer to the root generator context. Every chunk context is derived from it with its map indexes.
+ * @param sink (mapRowSink) : the function receiving the rows, from the first to the last one.
+ * @param sink_data (void*) : the pointer passed to the sink.
+ * @param display_loading (unsigned int) : the given value defines the behaviour.
+ *                                         * If `0` the loading bars won't be printed.
+ *                                         * If `> 0` the loading bars will be printed with a number of indent equal to `display_loading - 1`.
+ * @return int : `1` if every row was given to the sink, `0` if the sink stopped the stream.
+ * 
+ * @note The sea map of a row only needs the sea level, but its colors need the range of the whole map : a color map can not be streamed.
+ */
+int stream2dMap(int number_of_layers, int gradGrids_dimension[number_of_layers], double layers_factors[number_of_layers],
+                    int map_width, int map_height, generatorContext* context, mapRowSink sink, void* sink_data, unsigned int display_loading);
 
 //? Generate square chunks with automatic size factors and creates sea and color maps.
 /**
  * @brief Generates a completeMap structure with square chunks, automatic size factors and the given sea altitude.
  * It consists in generating a new map with the `get2dMap` function, and then creating a new completeMap with the `newCompleteMapFromMap` function.
+ * If the context has several workers, both steps are run as a single task graph (see `newCompleteMap`).
  * 
  * @param number_of_layers (int) : the number of layers passed.
  * @param gradGrids_dimension (int[number_of_layers]) : the array of gradientGrid dimensions to be used to generate the random gradient grids.
@@ -213,13 +295,14 @@ map* get2dMap(int number_of_layers, int gradGrids_dimension[number_of_layers], d
  * @param map_width (int) : number of chunks in width.
  * @param map_height (int) : number of chunks in height.
  * @param sea_level (double) : sea altitude to use.
+ * @param context (generatorContext*) : the pointer to the root generator context. Every chunk context is derived from it with its map indexes.
  * @param display_loading (unsigned int) : the given value defines the behaviour.
  *                                         * If `0` the loading bars won't be printed.
  *                                         * If `> 0` the loading bars will be printed with a number of indent equal to `display_loading - 1`.
  * @return completeMap* : pointer to the newly generated completeMap structure.
  */
 completeMap* fullGen(int number_of_layers, int gradGrids_dimension[number_of_layers], double layers_factors[number_of_layers],
-                         int map_width, int map_height, double sea_level, unsigned int display_loading);
+                         int map_width, int map_height, double sea_level, generatorContext* context, unsigned int display_loading);
 
 
 
@@ -246,10 +329,27 @@ void writeSeaMapFile(completeMap* completeMap, char path[]);
  * 
  * @param width (int) : the width of the color map
  * @param height (int) : the height of the color map.
- * @param color_map (color**) : the array of pointers to the color structures representing the color map.
+ * @param color_map (color[]) : the interleaved RGB8 array of colors representing the color map.
  * @param path (char[]) : the path where the file shall be written.
  */
-void writeColorMapFiles(int width, int height, color* color_map[width * height], char path[]);
+void writeColorMapFiles(int width, int height, color color_map[width * height], char path[]);
+
+/**
+ * @brief Writes the color map in a binary PPM file at the given path (see `writePPMFile`).
+ * 
+ * @param completeMap (completeMap*) : the pointer to the completeMap structure containing the color map to be written.
+ * @param path (char[]) : path of the file to be written.
+ */
+void writeColorMapPPMFile(completeMap* completeMap, char path[]);
+
+/**
+ * @brief Writes the color map in a PNG file at the given path (see `writePNGFile`).
+ * 
+ * @param completeMap (completeMap*) : the pointer to the completeMap structure containing the color map to be written.
+ * @param compression (int) : `PNG_DEFLATE` for a compressed file, or `PNG_STORED` to write it faster.
+ * @param path (char[]) : path of the file to be written.
+ */
+void writeColorMapPNGFile(completeMap* completeMap, int compression, char path[]);
 
 /**
  * @brief Writes every required files to save the completeMap structure.
@@ -260,15 +360,152 @@ void writeColorMapFiles(int width, int height, color* color_map[width * height],
 void writeCompleteMapFiles(completeMap* complete_map, char path[]);
 
 /**
- * @brief TODO : Generates the completeMap structure saved in the given file.
+ * @brief Writes every required files to save the completeMap structure (see `writeCompleteMapFiles`), through the given writer :
+ * the files are formatted by its formatting thread and written by its writer thread, while the calling thread goes on.
+ * 
+ * @param complete_map (completeMap*) : the pointer to the colorMap to be saved. It should not be modified nor free'd until
+ * `waitAsyncWriter` returns.
+ * @param path (char[]) : the path to the folder where the files shall be written.
+ * @param writer (asyncWriter*) : the pointer to the writer. If `NULL`, the files are written synchronously before returning.
+ */
+void writeCompleteMapFilesAsync(completeMap* complete_map, char path[], asyncWriter* writer);
+
+/**
+ * @brief Maps the binary files written by `writeCompleteMapBinaryFiles` in memory. Only their headers are read : the map, the sea map
+ * and the color map are read-only and paged in lazily when they are first used. The map has no chunk structure (see `readMapFile`).
  * 
- * @param path (char[]) : path to the file to be read.
- * @return completeMap* : the pointer to the newly generated completeMap structure.
+ * @param path (char[]) : the path to the folder of the files.
+ * @return completeMap* : the pointer to the newly generated completeMap structure, `NULL` if a file could not be mapped.
  */
 completeMap* readCompleteMapFiles(char path[]);
 
 
 
+/**
+ * @brief Writes the sea map in a binary file at the given path (see `binaryFormat.h`), with the sea level and the chunks geometry.
+ * 
+ * @param completeMap (completeMap*) : the pointer to the completeMap structure containing the sea map to be written.
+ * @param seed (uint64_t) : the seed of the generation, stored in the header.
+ * @param codec (int) : the codec of the values (e.g. `BINARY_CODEC_QUANTIZED`, with `BINARY_QUANTIZATION_BITS` fractional bits).
+ * @param path (char[]) : path of the file to be written.
+ */
+void writeSeaMapBinaryFile(completeMap* completeMap, uint64_t seed, int codec, char path[]);
+
+/**
+ * @brief Writes the RGB8 color map in a binary file at the given path (see `binaryFormat.h`).
+ * 
+ * @param completeMap (completeMap*) : the pointer to the completeMap structure containing the color map to be written.
+ * @param seed (uint64_t) : the seed of the generation, stored in the header.
+ * @param path (char[]) : path of the file to be written.
+ */
+void writeColorMapBinaryFile(completeMap* completeMap, uint64_t seed, char path[]);
+
+/**
+ * @brief Writes the map, the sea map and the color map of the given completeMap structure in the `map.bin`, `sea_map.bin`
+ * and `color_map.bin` binary files of the given folder.
+ * 
+ * @param complete_map (completeMap*) : the pointer to the completeMap to be saved.
+ * @param seed (uint64_t) : the seed of the generation, stored in the headers.
+ * @param codec (int) : the codec of the map and sea map files (e.g. `BINARY_CODEC_RAW` to map them in place with `readCompleteMapFiles`).
+ * The color map is always raw.
+ * @param folder_path (char[]) : the path to the folder where the files shall be written.
+ */
+void writeCompleteMapBinaryFiles(completeMap* complete_map, uint64_t seed, int codec, char folder_path[]);
+
+/**
+ * @brief Reads the binary files written by `writeCompleteMapBinaryFiles`. The map has no chunk structure (see `readMapBinaryFile`).
+ * 
+ * @param folder_path (char[]) : the path to the folder of the files.
+ * @param header (binaryHeader*) : the pointer to the header to fill with the one of the map file. Can be `NULL`.
+ * @return completeMap* : the pointer to the newly generated completeMap structure, `NULL` if a file could not be read.
+ */
+completeMap* readCompleteMapBinaryFiles(char folder_path[], binaryHeader* header);
+
+
+
+/**
+ * @brief Creates the recipe of the complete map `fullGen` generates with the given parameters.
+ * 
+ * @param number_of_layers (int) : the number of layers.
+ * @param gradGrids_dimension (int[number_of_layers]) : the array of the number of cells of the gradient grids.
+ * @param layers_factors (double[number_of_layers]) : the array of layers factors.
+ * @param map_width (int) : number of chunks in width.
+ * @param map_height (int) : number of chunks in height.
+ * @param sea_level (double) : the sea level.
+ * @param context (generatorContext*) : the pointer to the root generator context, whose seed and gradient source are kept.
+ * @return mapRecipe* : the pointer to the new recipe.
+ * 
+ * @note The arrays are copied in the structure.
+ */
+mapRecipe* newMapRecipe(int number_of_layers, int gradGrids_dimension[number_of_layers], double layers_factors[number_of_layers],
+                            int map_width, int map_height, double sea_level, generatorContext* context);
+
+/**
+ * @brief Writes the given recipe in a binary file (`BINARY_RECIPE`) at the given path : a header, then the generator version, the
+ * gradient source and the gradient type (u16 each, 2 reserved bytes), then the dimension (u32) and the factor (f64) of each layer.
+ * The header holds the seed, the dimensions, the number of layers, the sea level and the altitude type.
+ * 
+ * @param recipe (mapRecipe*) : the pointer to the recipe.
+ * @param path (char[]) : the path of the file to be written.
+ */
+void writeMapRecipeFile(mapRecipe* recipe, char path[]);
+
+/**
+ * @brief Reads a recipe written by `writeMapRecipeFile`.
+ * 
+ * @param path (char[]) : the path of the file.
+ * @return mapRecipe* : the pointer to the read recipe, `NULL` if the file could not be read, or if its number of layers or its gradient source
+ *                       is invalid.
+ */
+mapRecipe* readMapRecipeFile(char path[]);
+
+/**
+ * @brief Regenerates the complete map of the given recipe, as `fullGen` generated it.
+ * 
+ * @param recipe (mapRecipe*) : the pointer to the recipe.
+ * @param context (generatorContext*) : the pointer to a generator context for the number of workers, the arena, the chunks options and the
+ *                                      palette. Its seed and gradient source are replaced by the ones of the recipe. Can be `NULL`.
+ * @param display_loading (unsigned int) : the given value defines the behaviour.
+ *                                         * If `0` the loading bars won't be printed.
+ *                                         * If `> 0` the loading bars will be printed with a number of indent equal to `display_loading - 1`.
+ * @return completeMap* : the pointer to the regenerated completeMap structure, `NULL` if the recipe comes from another generator version
+ *                        or from a build with another precision.
+ */
+completeMap* generateRecipeMap(mapRecipe* recipe, generatorContext* context, unsigned int display_loading);
+
+/**
+ * @brief Reads the recipe file at the given path and regenerates its complete map (see `generateRecipeMap`).
+ * 
+ * @param path (char[]) : the path of the recipe file.
+ * @param context (generatorContext*) : the pointer to a generator context for the generation options (see `generateRecipeMap`). Can be `NULL`.
+ * @param display_loading (unsigned int) : the given value defines the behaviour.
+ *                                         * If `0` the loading bars won't be printed.
+ *                                         * If `> 0` the loading bars will be printed with a number of indent equal to `display_loading - 1`.
+ * @return completeMap* : the pointer to the regenerated completeMap structure, `NULL` if it could not be regenerated.
+ */
+completeMap* loadMapRecipeFile(char path[], generatorContext* context, unsigned int display_loading);
+
+/**
+ * @brief Regenerates a single chunk of the map of the given recipe, without the rest of the map (see `regenerateMapChunk`). Its values
+ * are the final map values : the sea map values follow from them and from the sea level, but the colors need the whole map range.
+ * 
+ * @param recipe (mapRecipe*) : the pointer to the recipe.
+ * @param chunk_x (int) : the width index of the chunk.
+ * @param chunk_y (int) : the height index of the chunk.
+ * @param context (generatorContext*) : the pointer to a generator context for the number of workers (see `generateRecipeMap`). Can be `NULL`.
+ * @return chunk* : the pointer to the regenerated chunk, `NULL` if it is out of the map or if the recipe can not be regenerated by this build.
+ */
+chunk* regenerateRecipeChunk(mapRecipe* recipe, int chunk_x, int chunk_y, generatorContext* context);
+
+/**
+ * @brief Frees the given recipe.
+ * 
+ * @param recipe (mapRecipe*) : the pointer to the recipe to be free'd.
+ */
+void freeMapRecipe(mapRecipe* recipe);
+
+
+
 /**
  * @brief Frees the given completeMap structure and every sub-structures contained.
  * 
@@ -0,0 +1,83 @@
+/**
+ * @file memoryArena.h
+ * @author Zyno and BlueNZ
+ * @brief Header to the memory arena structure and functions
+ * @version 0.2
+ * @date 2024-06-19
+ *
+ * @note A structure allocated in an arena belongs to it : its free function does nothing, and the arena releases all of its structures
+ * at once with `freeMemoryArena`. The structures given to a constructor working in an arena (e.g. the layers of `initChunk`) should
+ * live in the same arena.
+ */
+
+#ifndef MEMORY_ARENA
+#define MEMORY_ARENA
+
+#include <stddef.h>
+#include <pthread.h>
+
+// ----- Constants -----
+
+#define ARENA_ALIGNMENT 64                  /**< the alignment of every allocation of an arena, in bytes (a cache line)*/
+#define DEFAULT_ARENA_BLOCK_SIZE (1 << 20)  /**< the default size of the blocks of an arena, in bytes*/
+
+// ----- Structure definition -----
+
+/**
+ * @brief A block of memory of an arena, cut into allocations from its start.
+ *
+ */
+struct arenaBlock
+{
+    struct arenaBlock* previous; /**< the pointer to the previously allocated block, `NULL` for the first one*/
+    unsigned char* data; /**< the aligned start of the block memory*/
+    size_t size; /**< the size of the block memory, in bytes*/
+    size_t used; /**< the number of bytes of the block already allocated*/
+};
+
+typedef struct arenaBlock arenaBlock;
+
+/**
+ * @brief A memory arena : a few large blocks that every allocation is taken from, released all at once.
+ * It can be shared by several threads.
+ *
+ */
+struct memoryArena
+{
+    size_t block_size; /**< the size of the blocks, in bytes. Bigger allocations get their own block*/
+    arenaBlock* current_block; /**< the pointer to the block the allocations are taken from, `NULL` before the first one*/
+    int nb_blocks; /**< the number of allocated blocks*/
+    size_t nb_bytes; /**< the total size of the blocks, in bytes*/
+    pthread_mutex_t mutex; /**< the mutex protecting the blocks*/
+};
+
+typedef struct memoryArena memoryArena;
+
+// ----- Functions -----
+
+/**
+ * @brief Generates a new empty memoryArena structure.
+ *
+ * @param block_size (size_t) : the size of its blocks, in bytes. If `0`, `DEFAULT_ARENA_BLOCK_SIZE` is used.
+ * @return memoryArena* : the pointer to the new memory arena.
+ */
+memoryArena* newMemoryArena(size_t block_size);
+
+/**
+ * @brief Allocates a zeroed array of `ARENA_ALIGNMENT`-aligned memory in the given arena. It is only free'd with the arena.
+ *
+ * @param arena (memoryArena*) : the pointer to the memory arena. If `NULL`, the memory is calloc'd.
+ * @param nb_elements (size_t) : the number of elements of the array.
+ * @param element_size (size_t) : the size of each element, in bytes.
+ * @return void* : the pointer to the allocated memory, `NULL` if the allocation failed.
+ */
+void* arenaCalloc(memoryArena* arena, size_t nb_elements, size_t element_size);
+
+/**
+ * @brief Frees the given memoryArena structure and every structure allocated in it.
+ *
+ * @param arena (memoryArena*) : the pointer to the memory arena.
+ */
+void freeMemoryArena(memoryArena* arena);
+
+#endif
@@ -0,0 +1,29 @@
+/**
+ * @file precision.h
+ * @author Zyno and BlueNZ
+ * @brief Header to the build-time precision of the altitude values and of the gradient vectors
+ * @version 0.2
+ * @date 2024-06-19
+ * 
+ * @note Define `PROCGEN_FLOAT_ALTITUDE` and/or `PROCGEN_FLOAT_GRADIENT` when compiling (see the `PRECISION_FLAGS` of the Makefile)
+ * to get a float32 build : every altitude array (layers, chunks, map, sea map) then takes half the memory.
+ */
+
+#ifndef PRECISION
+#define PRECISION
+
+// ----- Type definitions -----
+
+#ifdef PROCGEN_FLOAT_ALTITUDE
+    typedef float altitude_t;   /**< the type of every altitude value, and of the perlin noise computations*/
+#else
+    typedef double altitude_t;  /**< the type of every altitude value, and of the perlin noise computations*/
+#endif
+
+#ifdef PROCGEN_FLOAT_GRADIENT
+    typedef float gradient_t;   /**< the type of the gradient vectors coordinates*/
+#else
+    typedef double gradient_t;  /**< the type of the gradient vectors coordinates*/
+#endif
+
+#endif
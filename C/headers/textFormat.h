@@ -0,0 +1,135 @@
+/**
+ * @file textFormat.h
+ * @author Zyno and BlueNZ
+ * @brief Header to the fast number formatting of the text files
+ * @version 0.2
+ * @date 2024-06-19
+ *
+ * @note The values of the text files are formatted by hand rather than by `fprintf` : a fixed-precision value is rounded exactly from the
+ * bits of the double with integer arithmetic, half to even, which is what the C library does. The text is then the same byte for byte,
+ * `"% .8lf"` for `formatFixed(buffer, value, 8, 1)`. Values whose magnitude is above `TEXT_FAST_LIMIT`, infinities and NaNs are left to `snprintf`.
+ *
+ * @note A text file is written one row at a time : its values are appended to a textRow buffer, which is written with a single `fwrite`.
+ */
+
+#ifndef TEXT_FORMAT
+#define TEXT_FORMAT
+
+#include <stddef.h>
+#include <stdio.h>
+
+// ----- Constants -----
+
+#define TEXT_MAX_DECIMALS 9             /**< the maximum number of decimals of `formatFixed`*/
+#define TEXT_NUMBER_MAX_LENGTH 330      /**< the maximum number of characters written by `formatFixed` (the largest double with 9 decimals)*/
+#define TEXT_FAST_LIMIT 1e9             /**< the magnitude below which the values are formatted without `snprintf`*/
+#define TEXT_VALUE_LENGTH 16            /**< the usual number of characters of a `"% .8lf"` value and its separator, to size the row buffers*/
+
+// ----- Structure definition -----
+
+/**
+ * @brief A growing buffer of characters, holding a row of a text file until it is written.
+ *
+ */
+struct textRow
+{
+    char* chars; /**< the characters of the row, not `'\0'` terminated*/
+    size_t nb_chars; /**< the number of characters in the row*/
+    size_t capacity; /**< the allocated size of `chars`*/
+};
+
+typedef struct textRow textRow;
+
+/**
+ * @brief The type of the functions writing the characters of a row somewhere (see `flushTextRow`).
+ *
+ * @param destination (void*) : the pointer to where the characters are written (e.g. a file).
+ * @param chars (const char*) : the characters.
+ * @param nb_chars (size_t) : the number of characters.
+ * @return int : `1` if the characters were written, `0` otherwise.
+ */
+typedef int (*textWriteFunction)(void* destination, const char* chars, size_t nb_chars);
+
+// ----- Functions -----
+
+/**
+ * @brief Formats the given value with the given number of decimals, as `printf` does with `"%.*f"` (or `"% .*f"` with a space sign).
+ *
+ * @param buffer (char*) : the buffer to write the characters in, of at least `TEXT_NUMBER_MAX_LENGTH` characters. It is not `'\0'` terminated.
+ * @param value (double) : the value.
+ * @param nb_decimals (int) : the number of decimals, in `[0, TEXT_MAX_DECIMALS]`.
+ * @param space_sign (int) : `1` to write a space before the positive values, as the `' '` flag of `printf` does, `0` otherwise.
+ * @return int : the number of characters written.
+ */
+int formatFixed(char* buffer, double value, int nb_decimals, int space_sign);
+
+/**
+ * @brief Formats the given integer, as `printf` does with `"%d"`.
+ *
+ * @param buffer (char*) : the buffer to write the characters in, of at least 11 characters. It is not `'\0'` terminated.
+ * @param value (int) : the integer.
+ * @return int : the number of characters written.
+ */
+int formatInteger(char* buffer, int value);
+
+/**
+ * @brief Creates a new empty row buffer.
+ *
+ * @param capacity (size_t) : the initial capacity of the buffer (e.g. the expected length of a row). It grows when needed.
+ * @return textRow* : the pointer to the new row buffer.
+ */
+textRow* newTextRow(size_t capacity);
+
+/**
+ * @brief Appends a character to the row.
+ *
+ * @param row (textRow*) : the pointer to the row buffer.
+ * @param character (char) : the character.
+ */
+void appendTextChar(textRow* row, char character);
+
+/**
+ * @brief Appends a value with the given number of decimals to the row (see `formatFixed`).
+ *
+ * @param row (textRow*) : the pointer to the row buffer.
+ * @param value (double) : the value.
+ * @param nb_decimals (int) : the number of decimals, in `[0, TEXT_MAX_DECIMALS]`.
+ * @param space_sign (int) : `1` to write a space before the positive values, `0` otherwise.
+ */
+void appendTextFixed(textRow* row, double value, int nb_decimals, int space_sign);
+
+/**
+ * @brief Appends an integer to the row (see `formatInteger`).
+ *
+ * @param row (textRow*) : the pointer to the row buffer.
+ * @param value (int) : the integer.
+ */
+void appendTextInteger(textRow* row, int value);
+
+/**
+ * @brief Gives the characters of the row to the given write function in a single call, and empties the row.
+ *
+ * @param row (textRow*) : the pointer to the row buffer.
+ * @param write_chars (textWriteFunction) : the function writing the characters.
+ * @param destination (void*) : the pointer given to the write function.
+ * @return int : the result of the write function, `1` if the row was written, `0` otherwise.
+ */
+int flushTextRow(textRow* row, textWriteFunction write_chars, void* destination);
+
+/**
+ * @brief Writes the characters of the row in the given file with a single `fwrite`, and empties the row (see `flushTextRow`).
+ *
+ * @param row (textRow*) : the pointer to the row buffer.
+ * @param f (FILE*) : the file, opened in writing mode.
+ * @return int : `1` if the row was written, `0` otherwise.
+ */
+int writeTextRow(textRow* row, FILE* f);
+
+/**
+ * @brief Frees the given row buffer.
+ *
+ * @param row (textRow*) : the pointer to the row buffer to be free'd.
+ */
+void freeTextRow(textRow* row);
+
+#endif
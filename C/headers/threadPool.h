@@ -0,0 +1,192 @@
+/**
+ * @file threadPool.h
+ * @author Zyno and BlueNZ
+ * @brief Header to the thread pool structure and functions
+ * @version 0.2
+ * @date 2024-06-19
+ *
+ * @note A thread waiting for a task group runs the queued tasks itself instead of sleeping. A task can thus submit and wait for
+ * its own sub-tasks on the same pool without any deadlock.
+ * 
+ * @note Every worker thread owns a deque : the tasks it queues are pushed at its bottom and it runs them back from there (last in,
+ * first out, while their data is still in cache). An idle thread runs the tasks queued by the other threads, then steals from the top
+ * of the workers deques. The generation tasks are coarse (a chunk, a layer, a band of rows) : the deques share the pool mutex.
+ * 
+ * @note Graph tasks (`newGraphTask`) only start once all their predecessors (`addTaskDependency`) are done, so that whole pipelines
+ * can be queued at once without any barrier between their steps.
+ */
+
+#ifndef THREAD_POOL
+#define THREAD_POOL
+
+#include <pthread.h>
+
+// ----- Structure definition -----
+
+/**
+ * @brief The signature of the functions run by the thread pool.
+ *
+ */
+typedef void (*taskFunction)(void* argument);
+
+/**
+ * @brief The signature of the functions run on a band of rows by `parallelRowBands`.
+ *
+ */
+typedef void (*rowBandFunction)(void* argument, int band_idx, int first_row, int end_row);
+
+/**
+ * @brief A group of tasks that can be waited for together.
+ *
+ */
+struct taskGroup
+{
+    int remaining; /**< the number of submitted tasks of the group that are not done yet*/
+    struct task* graph_tasks; /**< the list of the graph tasks of the group, free'd once the group is waited for*/
+};
+
+typedef struct taskGroup taskGroup;
+
+/**
+ * @brief A queued task : the function to run, its argument and its group.
+ *
+ */
+struct task
+{
+    taskFunction function; /**< the function to run*/
+    void* argument; /**< the argument to pass to the function*/
+    taskGroup* group; /**< the pointer to the group of the task*/
+    struct task* next; /**< the pointer to the next task in the queue*/
+
+    int is_graph_task; /**< `1` for the tasks created with `newGraphTask`, `0` otherwise*/
+    int nb_dependencies; /**< the number of predecessors that are not done yet, plus one until the task is launched*/
+    int done; /**< set to `1` once the task has run*/
+    struct task** successors; /**< the array of pointers to the tasks waiting for this one*/
+    int nb_successors; /**< the number of successors*/
+    int successors_capacity; /**< the allocated size of the successors array*/
+    struct task* next_graph_task; /**< the pointer to the next graph task of the group*/
+};
+
+typedef struct task task;
+
+/**
+ * @brief The deque of the tasks queued by a worker thread : a ring buffer, its owner works at the bottom, the thieves at the top.
+ *
+ */
+struct taskDeque
+{
+    struct threadPool* pool; /**< the pointer to the pool of the worker*/
+    int worker_idx; /**< the index of the worker owning the deque*/
+    task** tasks; /**< the ring buffer of pointers to the queued tasks*/
+    int top; /**< the index of the oldest task in the buffer*/
+    int nb_tasks; /**< the number of queued tasks*/
+    int capacity; /**< the allocated size of the buffer*/
+};
+
+typedef struct taskDeque taskDeque;
+
+/**
+ * @brief A pool of worker threads with work-stealing deques.
+ *
+ */
+struct threadPool
+{
+    int nb_threads; /**< the number of worker threads*/
+    pthread_t* threads; /**< the array of worker threads*/
+    taskDeque* deques; /**< the array of deques of the worker threads*/
+    pthread_key_t worker_key; /**< the key of the deque of the current thread, `NULL` outside of the workers*/
+    task* first_task; /**< the pointer to the next task queued by a thread outside of the pool, `NULL` if this queue is empty*/
+    task* last_task; /**< the pointer to the last task queued by a thread outside of the pool*/
+    int stop; /**< set to `1` to make the workers exit*/
+    pthread_mutex_t mutex; /**< the mutex protecting the queues, the deques, the tasks and the task groups*/
+    pthread_cond_t state_changed; /**< broadcast when a task is queued, when a task is done or when the pool stops*/
+};
+
+typedef struct threadPool threadPool;
+
+// ----- Functions -----
+
+/**
+ * @brief Generates a new threadPool structure and starts its worker threads.
+ *
+ * @param nb_threads (int) : the number of worker threads. With `0` threads, the tasks are only run by the threads waiting for them.
+ * @return threadPool* : the pointer to the new thread pool.
+ */
+threadPool* newThreadPool(int nb_threads);
+
+/**
+ * @brief Queues a task in the given thread pool. If the pool is `NULL`, the task is run right away by the calling thread.
+ *
+ * @param pool (threadPool*) : the pointer to the thread pool.
+ * @param group (taskGroup*) : the pointer to the group of the task, to wait for it with `waitTaskGroup`.
+ * @param function (taskFunction) : the function to run.
+ * @param argument (void*) : the argument to pass to the function. It should live until the task is done.
+ */
+void submitTask(threadPool* pool, taskGroup* group, taskFunction function, void* argument);
+
+/**
+ * @brief Creates a graph task in the given group. It is only queued once it is launched with `launchGraphTask`
+ * and once all its predecessors are done.
+ *
+ * @param pool (threadPool*) : the pointer to the thread pool. If `NULL`, the task is run by the thread that makes it ready.
+ * @param group (taskGroup*) : the pointer to the group of the task, to wait for it with `waitTaskGroup`.
+ * @param function (taskFunction) : the function to run.
+ * @param argument (void*) : the argument to pass to the function. It should live until the task is done.
+ * @return task* : the pointer to the graph task, valid until its group is waited for.
+ */
+task* newGraphTask(threadPool* pool, taskGroup* group, taskFunction function, void* argument);
+
+/**
+ * @brief Makes the given graph task wait for the given predecessor. Does nothing if the predecessor is already done.
+ *
+ * @param pool (threadPool*) : the pointer to the thread pool of both tasks.
+ * @param predecessor (task*) : the pointer to the graph task to wait for.
+ * @param successor (task*) : the pointer to the graph task that waits. It should not be launched yet.
+ */
+void addTaskDependency(threadPool* pool, task* predecessor, task* successor);
+
+/**
+ * @brief Launches the given graph task : it is queued as soon as all its predecessors are done, right away if they already are.
+ *
+ * @param pool (threadPool*) : the pointer to the thread pool of the task.
+ * @param graph_task (task*) : the pointer to the graph task.
+ */
+void launchGraphTask(threadPool* pool, task* graph_task);
+
+/**
+ * @brief Waits until every task of the given group is done. Meanwhile, the calling thread runs the queued tasks.
+ *
+ * @param pool (threadPool*) : the pointer to the thread pool.
+ * @param group (taskGroup*) : the pointer to the group to wait for. Its graph tasks are free'd.
+ */
+void waitTaskGroup(threadPool* pool, taskGroup* group);
+
+/**
+ * @brief Gets the number of row bands `parallelRowBands` splits the given number of rows in : a few bands per thread to balance the load,
+ * and a single band without any pool.
+ *
+ * @param pool (threadPool*) : the pointer to the thread pool, can be `NULL`.
+ * @param nb_rows (int) : the number of rows to split.
+ * @return int : the number of row bands, in `[1, max(nb_rows, 1)]`.
+ */
+int countRowBands(threadPool* pool, int nb_rows);
+
+/**
+ * @brief Runs the given function on every band of rows of `[0, nb_rows)`, in parallel on the given pool, and waits for all of them.
+ * The bands are contiguous, ordered, and there are `countRowBands(pool, nb_rows)` of them.
+ *
+ * @param pool (threadPool*) : the pointer to the thread pool. If `NULL`, the function is run once on every row by the calling thread.
+ * @param nb_rows (int) : the number of rows.
+ * @param function (rowBandFunction) : the function to run on each band, with its index and its rows `[first_row, end_row)`.
+ * @param argument (void*) : the argument to pass to the function.
+ */
+void parallelRowBands(threadPool* pool, int nb_rows, rowBandFunction function, void* argument);
+
+/**
+ * @brief Stops the worker threads and frees the given threadPool structure. The queued tasks should all be done.
+ *
+ * @param pool (threadPool*) : the pointer to the thread pool.
+ */
+void freeThreadPool(threadPool* pool);
+
+#endif
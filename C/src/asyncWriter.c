@@ -0,0 +1,589 @@
+/**
+ * @file asyncWriter.c
+ * @author Zyno and BlueNZ
+ * @brief asyncWriter structure implementation
+ * @version 0.2
+ * @date 2024-06-19
+ *
+ */
+
+// fsync and fileno are not part of C99
+#define _POSIX_C_SOURCE 200809L
+
+#include <malloc.h>
+#include <stdarg.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "loadingBar.h"
+#include "asyncWriter.h"
+
+/**
+ * @brief Syncs the given file to the disk, once the bytes buffered by the C library are flushed.
+ *
+ * @param f (FILE*) : the file.
+ * @return int : `1` if the file was synced, `0` otherwise.
+ */
+static int syncFile(FILE* f)
+{
+    return fflush(f) == 0 && fsync(fileno(f)) == 0;
+}
+
+/**
+ * @brief Writes the filled bytes of the given buffer in its file, then syncs or closes the file as asked.
+ * Prints an error if a write failed.
+ *
+ * @param buffer (asyncBuffer*) : the pointer to the buffer.
+ * @param sync_policy (int) : the sync policy of the writer, `ASYNC_SYNC_NEVER` for the synchronous files.
+ * @return int : `1` if every write succeeded, `0` otherwise.
+ */
+static int writeBuffer(asyncBuffer* buffer, int sync_policy)
+{
+    asyncFile* file = buffer->file;
+
+    int success = fwrite(buffer->bytes, 1, buffer->nb_bytes, file->f) == buffer->nb_bytes;
+    buffer->nb_bytes = 0;
+
+    if (sync_policy == ASYNC_SYNC_EACH_BUFFER || (buffer->closes_file && sync_policy == ASYNC_SYNC_ON_CLOSE))
+    {
+        success = syncFile(file->f) && success;
+    }
+
+    if (buffer->closes_file)
+    {
+        success = fclose(file->f) == 0 && success;
+        file->f = NULL;
+    }
+
+    if (!success)
+    {
+        printf("%sERROR : could not write file at path '%s'%s\n", RED_COLOR, file->path, DEFAULT_COLOR);
+    }
+
+    return success;
+}
+
+/**
+ * @brief The loop of the writer thread : writes the queued buffers in order, until the writer stops and the queue is empty.
+ *
+ * @param argument (void*) : the pointer to the asyncWriter structure.
+ * @return void* : `NULL`.
+ */
+static void* writerLoop(void* argument)
+{
+    asyncWriter* writer = argument;
+
+    pthread_mutex_lock(&writer->mutex);
+
+    while (1)
+    {
+        if (writer->nb_queued > 0)
+        {
+            asyncBuffer* buffer = writer->queue[writer->queue_start];
+
+            writer->queue_start = (writer->queue_start + 1) % writer->nb_buffers;
+            writer->nb_queued -= 1;
+            writer->nb_writing = 1;
+
+            pthread_mutex_unlock(&writer->mutex);
+
+            asyncFile* written_file = buffer->file;
+            asyncFile* closed_file = buffer->closes_file ? buffer->file : NULL;
+            int success = writeBuffer(buffer, writer->sync_policy);
+
+            if (closed_file != NULL)
+            {
+                free(closed_file->path);
+                free(closed_file);
+            }
+
+            buffer->file = NULL;
+            buffer->closes_file = 0;
+
+            pthread_mutex_lock(&writer->mutex);
+
+            writer->success = writer->success && success;
+            // The failure is also marked on the file for its next writes to report it, unless the file is already free'd
+            if (!success && closed_file == NULL)
+            {
+                written_file->success = 0;
+            }
+            writer->free_buffers[writer->nb_free] = buffer;
+            writer->nb_free += 1;
+            writer->nb_writing = 0;
+
+            pthread_cond_broadcast(&writer->progressed);
+        }
+        else if (writer->stop)
+        {
+            break;
+        }
+        else
+        {
+            pthread_cond_wait(&writer->buffer_queued, &writer->mutex);
+        }
+    }
+
+    pthread_mutex_unlock(&writer->mutex);
+
+    return NULL;
+}
+
+/**
+ * @brief The loop of the formatting thread : runs the queued jobs in order, until the writer stops and the queue is empty.
+ *
+ * @param argument (void*) : the pointer to the asyncWriter structure.
+ * @return void* : `NULL`.
+ */
+static void* formattingLoop(void* argument)
+{
+    asyncWriter* writer = argument;
+
+    pthread_mutex_lock(&writer->mutex);
+
+    while (1)
+    {
+        if (writer->first_job != NULL)
+        {
+            asyncJob* job = writer->first_job;
+
+            writer->first_job = job->next;
+            if (writer->first_job == NULL)
+            {
+                writer->last_job = NULL;
+            }
+            writer->nb_running_jobs = 1;
+
+            pthread_mutex_unlock(&writer->mutex);
+
+            job->function(job->argument);
+            free(job);
+
+            pthread_mutex_lock(&writer->mutex);
+
+            writer->nb_running_jobs = 0;
+
+            pthread_cond_broadcast(&writer->progressed);
+        }
+        else if (writer->stop)
+        {
+            break;
+        }
+        else
+        {
+            pthread_cond_wait(&writer->job_queued, &writer->mutex);
+        }
+    }
+
+    pthread_mutex_unlock(&writer->mutex);
+
+    return NULL;
+}
+
+/**
+ * @brief Gets whether every write of the given file succeeded so far. The writer thread marks the failures of an asynchronous file
+ * under the mutex of its writer.
+ *
+ * @param file (asyncFile*) : the pointer to the file, not closed yet.
+ * @return int : `0` if a write of the file failed, `1` otherwise.
+ */
+static int getFileSuccess(asyncFile* file)
+{
+    if (file->writer == NULL)
+    {
+        return file->success;
+    }
+
+    pthread_mutex_lock(&file->writer->mutex);
+    int success = file->success;
+    pthread_mutex_unlock(&file->writer->mutex);
+
+    return success;
+}
+
+/**
+ * @brief Takes a free buffer of the writer for the given file, waiting for one to be written if they are all used.
+ *
+ * @param file (asyncFile*) : the pointer to the file, written by a writer.
+ */
+static void takeBuffer(asyncFile* file)
+{
+    asyncWriter* writer = file->writer;
+
+    pthread_mutex_lock(&writer->mutex);
+
+    // Backpressure : the formatting waits for the writes when every buffer is queued
+    while (writer->nb_free == 0)
+    {
+        pthread_cond_wait(&writer->progressed, &writer->mutex);
+    }
+
+    writer->nb_free -= 1;
+    file->buffer = writer->free_buffers[writer->nb_free];
+
+    pthread_mutex_unlock(&writer->mutex);
+
+    file->buffer->file = file;
+    file->buffer->nb_bytes = 0;
+    file->buffer->closes_file = 0;
+}
+
+/**
+ * @brief Hands the filled buffer of the given file over : queues it for the writer thread, or writes it right away for a synchronous file.
+ *
+ * @param file (asyncFile*) : the pointer to the file.
+ * @param closes_file (int) : `1` if the file is closed once the buffer is written.
+ */
+static void flushBuffer(asyncFile* file, int closes_file)
+{
+    asyncBuffer* buffer = file->buffer;
+    buffer->closes_file = closes_file;
+
+    if (file->writer == NULL)
+    {
+        file->success = writeBuffer(buffer, ASYNC_SYNC_NEVER) && file->success;
+        return;
+    }
+
+    asyncWriter* writer = file->writer;
+
+    // The buffer now belongs to the writer thread : a full buffer is never kept while waiting for a free one.
+    // Once queued, a closing buffer may free the file at any time.
+    file->buffer = NULL;
+
+    pthread_mutex_lock(&writer->mutex);
+
+    writer->queue[(writer->queue_start + writer->nb_queued) % writer->nb_buffers] = buffer;
+    writer->nb_queued += 1;
+
+    pthread_cond_broadcast(&writer->buffer_queued);
+    pthread_mutex_unlock(&writer->mutex);
+}
+
+/**
+ * @brief Gets the buffer being filled of the given file, and makes sure it is not full.
+ *
+ * @param file (asyncFile*) : the pointer to the file.
+ * @param buffer_size (size_t) : the size of the buffer.
+ * @return asyncBuffer* : the pointer to the buffer, with at least one free byte.
+ */
+static asyncBuffer* getFreeBuffer(asyncFile* file, size_t buffer_size)
+{
+    if (file->buffer != NULL && file->buffer->nb_bytes == buffer_size)
+    {
+        flushBuffer(file, 0);
+    }
+
+    if (file->buffer == NULL)
+    {
+        takeBuffer(file);
+    }
+
+    return file->buffer;
+}
+
+/**
+ * @brief Gets the size of the buffers of the given file.
+ *
+ * @param file (asyncFile*) : the pointer to the file.
+ * @return size_t : the size of the buffers, in bytes.
+ */
+static size_t getBufferSize(asyncFile* file)
+{
+    return file->writer != NULL ? file->writer->buffer_size : ASYNC_BUFFER_SIZE;
+}
+
+/**
+ * @brief Frees the given writer, its buffers and its synchronization objects. Its threads should not be running.
+ *
+ * @param writer (asyncWriter*) : the pointer to the writer.
+ */
+static void destroyAsyncWriter(asyncWriter* writer)
+{
+    pthread_mutex_destroy(&writer->mutex);
+    pthread_cond_destroy(&writer->buffer_queued);
+    pthread_cond_destroy(&writer->job_queued);
+    pthread_cond_destroy(&writer->progressed);
+
+    for (int k = 0; k < writer->nb_buffers; k++)
+    {
+        free(writer->buffers[k].bytes);
+    }
+
+    free(writer->buffers);
+    free(writer->queue);
+    free(writer->free_buffers);
+    free(writer);
+}
+
+
+
+
+
+asyncWriter* newAsyncWriter(int nb_buffers, size_t buffer_size, int sync_policy)
+{
+    asyncWriter* new_writer = calloc(1, sizeof(asyncWriter));
+
+    new_writer->sync_policy = sync_policy;
+    new_writer->nb_buffers = nb_buffers > 0 ? nb_buffers : 1;
+    new_writer->buffer_size = buffer_size > 0 ? buffer_size : ASYNC_BUFFER_SIZE;
+
+    new_writer->buffers = calloc(new_writer->nb_buffers, sizeof(asyncBuffer));
+    new_writer->queue = calloc(new_writer->nb_buffers, sizeof(asyncBuffer*));
+    new_writer->free_buffers = calloc(new_writer->nb_buffers, sizeof(asyncBuffer*));
+
+    for (int k = 0; k < new_writer->nb_buffers; k++)
+    {
+        new_writer->buffers[k].bytes = malloc(new_writer->buffer_size);
+        new_writer->free_buffers[k] = new_writer->buffers + k;
+    }
+
+    new_writer->nb_free = new_writer->nb_buffers;
+    new_writer->success = 1;
+
+    pthread_mutex_init(&new_writer->mutex, NULL);
+    pthread_cond_init(&new_writer->buffer_queued, NULL);
+    pthread_cond_init(&new_writer->job_queued, NULL);
+    pthread_cond_init(&new_writer->progressed, NULL);
+
+    if (pthread_create(&new_writer->writer_thread, NULL, writerLoop, new_writer) != 0)
+    {
+        printf("%sERROR : could not start the writer thread. The files will be written synchronously.%s\n", RED_COLOR, DEFAULT_COLOR);
+
+        destroyAsyncWriter(new_writer);
+        return NULL;
+    }
+
+    if (pthread_create(&new_writer->formatting_thread, NULL, formattingLoop, new_writer) != 0)
+    {
+        printf("%sERROR : could not start the formatting thread. The files will be written synchronously.%s\n", RED_COLOR, DEFAULT_COLOR);
+
+        pthread_mutex_lock(&new_writer->mutex);
+        new_writer->stop = 1;
+        pthread_cond_broadcast(&new_writer->buffer_queued);
+        pthread_mutex_unlock(&new_writer->mutex);
+
+        pthread_join(new_writer->writer_thread, NULL);
+
+        destroyAsyncWriter(new_writer);
+        return NULL;
+    }
+
+    return new_writer;
+}
+
+
+
+asyncFile* openAsyncFile(asyncWriter* writer, char path[])
+{
+    FILE* f = fopen(path, "wb");
+
+    if (f == NULL)
+    {
+        printf("%sERROR : could not open file in writing mode at path '%s'%s\n", RED_COLOR, path, DEFAULT_COLOR);
+        return NULL;
+    }
+
+    asyncFile* new_file = calloc(1, sizeof(asyncFile));
+
+    new_file->writer = writer;
+    new_file->f = f;
+    new_file->path = calloc(strlen(path) + 1, sizeof(char));
+    strcpy(new_file->path, path);
+    new_file->success = 1;
+
+    // A synchronous file has its own buffer
+    if (writer == NULL)
+    {
+        new_file->buffer = calloc(1, sizeof(asyncBuffer));
+        new_file->buffer->bytes = malloc(ASYNC_BUFFER_SIZE);
+        new_file->buffer->file = new_file;
+    }
+
+    return new_file;
+}
+
+
+
+int writeAsyncFile(asyncFile* file, const void* bytes, size_t nb_bytes)
+{
+    const unsigned char* remaining_bytes = bytes;
+    size_t buffer_size = getBufferSize(file);
+
+    while (nb_bytes > 0)
+    {
+        asyncBuffer* buffer = getFreeBuffer(file, buffer_size);
+
+        size_t nb_copied = buffer_size - buffer->nb_bytes;
+        if (nb_copied > nb_bytes)
+        {
+            nb_copied = nb_bytes;
+        }
+
+        memcpy(buffer->bytes + buffer->nb_bytes, remaining_bytes, nb_copied);
+        buffer->nb_bytes += nb_copied;
+
+        remaining_bytes += nb_copied;
+        nb_bytes -= nb_copied;
+    }
+
+    return getFileSuccess(file);
+}
+
+
+
+int printAsyncFile(asyncFile* file, const char* format, ...)
+{
+    size_t buffer_size = getBufferSize(file);
+    asyncBuffer* buffer = getFreeBuffer(file, buffer_size);
+
+    va_list values;
+    va_start(values, format);
+
+    // The text is formatted right in the buffer, unless it does not fit in what is left of it
+    va_list first_values;
+    va_copy(first_values, values);
+    size_t nb_left = buffer_size - buffer->nb_bytes;
+    int length = vsnprintf((char*) buffer->bytes + buffer->nb_bytes, nb_left, format, first_values);
+    va_end(first_values);
+
+    if (length < 0)
+    {
+        va_end(values);
+        return 0;
+    }
+
+    if ((size_t) length < nb_left)
+    {
+        buffer->nb_bytes += length;
+    }
+    else
+    {
+        char* text = malloc(length + 1);
+        vsnprintf(text, length + 1, format, values);
+        writeAsyncFile(file, text, length);
+        free(text);
+    }
+
+    va_end(values);
+
+    return getFileSuccess(file);
+}
+
+
+
+int closeAsyncFile(asyncFile* file)
+{
+    if (file == NULL)
+    {
+        return 0;
+    }
+
+    if (file->writer != NULL)
+    {
+        // Even an empty last buffer goes through the queue, so that the file is closed after its previous buffers are written
+        if (file->buffer == NULL)
+        {
+            takeBuffer(file);
+        }
+
+        // Read before the last buffer is queued, as the writer thread may free the file right after
+        int success = getFileSuccess(file);
+
+        flushBuffer(file, 1);
+        return success;
+    }
+
+    flushBuffer(file, 1);
+
+    int success = file->success;
+
+    free(file->buffer->bytes);
+    free(file->buffer);
+    free(file->path);
+    free(file);
+
+    return success;
+}
+
+
+
+void submitAsyncJob(asyncWriter* writer, taskFunction function, void* argument)
+{
+    if (writer == NULL)
+    {
+        function(argument);
+        return;
+    }
+
+    asyncJob* new_job = calloc(1, sizeof(asyncJob));
+
+    new_job->function = function;
+    new_job->argument = argument;
+    new_job->next = NULL;
+
+    pthread_mutex_lock(&writer->mutex);
+
+    if (writer->last_job == NULL)
+    {
+        writer->first_job = new_job;
+    }
+    else
+    {
+        writer->last_job->next = new_job;
+    }
+    writer->last_job = new_job;
+
+    pthread_cond_broadcast(&writer->job_queued);
+    pthread_mutex_unlock(&writer->mutex);
+}
+
+
+
+int waitAsyncWriter(asyncWriter* writer)
+{
+    if (writer == NULL)
+    {
+        return 1;
+    }
+
+    pthread_mutex_lock(&writer->mutex);
+
+    while (writer->first_job != NULL || writer->nb_running_jobs > 0 || writer->nb_queued > 0 || writer->nb_writing > 0)
+    {
+        pthread_cond_wait(&writer->progressed, &writer->mutex);
+    }
+
+    int success = writer->success;
+    writer->success = 1;
+
+    pthread_mutex_unlock(&writer->mutex);
+
+    return success;
+}
+
+
+
+int freeAsyncWriter(asyncWriter* writer)
+{
+    if (writer == NULL)
+    {
+        return 1;
+    }
+
+    int success = waitAsyncWriter(writer);
+
+    pthread_mutex_lock(&writer->mutex);
+    writer->stop = 1;
+    pthread_cond_broadcast(&writer->buffer_queued);
+    pthread_cond_broadcast(&writer->job_queued);
+    pthread_mutex_unlock(&writer->mutex);
+
+    pthread_join(writer->writer_thread, NULL);
+    pthread_join(writer->formatting_thread, NULL);
+
+    destroyAsyncWriter(writer);
+
+    return success;
+}
@@ -0,0 +1,1259 @@
+/**
+ * @file binaryFormat.c
+ * @author Zyno and BlueNZ
+ * @brief binary container format implementation
+ * @version 0.2
+ * @date 2024-06-19
+ *
+ */
+
+// pread is not part of C99
+#define _POSIX_C_SOURCE 200809L
+
+#include <fcntl.h>
+#include <limits.h>
+#include <malloc.h>
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "loadingBar.h"
+#include "binaryFormat.h"
+
+/**
+ * @brief The size of the buffer of the samples that need a conversion, in bytes.
+ *
+ */
+#define BINARY_BUFFER_SIZE (1 << 16)
+
+
+
+/**
+ * @brief Checks the byte order of the machine.
+ *
+ * @return int : `1` on a little-endian machine, `0` otherwise.
+ */
+static int isLittleEndian()
+{
+    uint16_t one = 1;
+    unsigned char first_byte = 0;
+
+    memcpy(&first_byte, &one, 1);
+
+    return first_byte == 1;
+}
+
+
+
+
+
+/**
+ * @brief Loads a little-endian float sample of the given type from the given bytes.
+ *
+ * @param bytes (unsigned char*) : the bytes of the sample.
+ * @param dtype (int) : `BINARY_FLOAT32` or `BINARY_FLOAT64`.
+ * @return double : the value of the sample.
+ */
+static double getFloatSample(unsigned char* bytes, int dtype)
+{
+    if (dtype == BINARY_FLOAT32)
+    {
+        uint32_t bits = (uint32_t) getBinaryInteger(bytes, 4);
+
+        float value = 0.f;
+        memcpy(&value, &bits, sizeof(float));
+
+        return value;
+    }
+
+    return getBinaryDouble(bytes);
+}
+
+/**
+ * @brief Reverses the bytes of every sample of the given array.
+ *
+ * @param bytes (unsigned char*) : the array of samples.
+ * @param sample_size (size_t) : the size of a sample.
+ * @param nb_samples (size_t) : the number of samples.
+ */
+static void swapSamplesBytes(unsigned char* bytes, size_t sample_size, size_t nb_samples)
+{
+    for (size_t k = 0; k < nb_samples; k++)
+    {
+        unsigned char* sample = bytes + k * sample_size;
+
+        for (size_t b = 0; b < sample_size / 2; b++)
+        {
+            unsigned char tmp = sample[b];
+            sample[b] = sample[sample_size - 1 - b];
+            sample[sample_size - 1 - b] = tmp;
+        }
+    }
+}
+
+
+/**
+ * @brief Gets the integer views of a row of samples. For the predictive codec, the view of a float is its bits, with the sign bit flipped
+ * for the positive ones and every bit flipped for the negative ones, so that close values have close views. For the quantized codec, it
+ * is the two's complement of the value rounded to a multiple of `2^-quantization_bits`.
+ *
+ * @param row (void*) : the pointer to the samples of the row.
+ * @param row_length (int) : the number of samples of the row.
+ * @param dtype (int) : the type of the samples.
+ * @param codec (int) : `BINARY_CODEC_PREDICTIVE` or `BINARY_CODEC_QUANTIZED`.
+ * @param quantization_bits (int) : the number of fractional bits kept by the quantized codec.
+ * @param keys (uint64_t*) : the array of integer views to fill.
+ * @return int : `1` on success, `0` if a sample can not be quantized : it is not finite or it does not fit in 62 bits once scaled.
+ */
+static int getRowKeys(void* row, int row_length, int dtype, int codec, int quantization_bits, uint64_t* keys)
+{
+    if (codec == BINARY_CODEC_QUANTIZED)
+    {
+        double scale = ldexp(1., quantization_bits);
+        double max_scaled_value = ldexp(1., 62);
+
+        for (int k = 0; k < row_length; k++)
+        {
+            double value = dtype == BINARY_FLOAT32 ? ((float*) row)[k] : ((double*) row)[k];
+            double scaled_value = value * scale;
+
+            // Also false for NaN
+            if (!(fabs(scaled_value) <= max_scaled_value))
+            {
+                return 0;
+            }
+
+            keys[k] = (uint64_t) llround(scaled_value);
+        }
+    }
+    else if (dtype == BINARY_UINT8)
+    {
+        for (int k = 0; k < row_length; k++)
+        {
+            keys[k] = ((uint8_t*) row)[k];
+        }
+    }
+    else if (dtype == BINARY_FLOAT32)
+    {
+        for (int k = 0; k < row_length; k++)
+        {
+            uint32_t bits = 0;
+            memcpy(&bits, (float*) row + k, sizeof(float));
+
+            keys[k] = (bits >> 31) ? (uint32_t) ~bits : bits | 0x80000000u;
+        }
+    }
+    else
+    {
+        for (int k = 0; k < row_length; k++)
+        {
+            uint64_t bits = 0;
+            memcpy(&bits, (double*) row + k, sizeof(double));
+
+            keys[k] = (bits >> 63) ? ~bits : bits | 0x8000000000000000u;
+        }
+    }
+
+    return 1;
+}
+
+/**
+ * @brief Stores the samples of the given integer views (see `getRowKeys`), converted to their type in memory.
+ *
+ * @param keys (uint64_t*) : the integer views of the samples of the row.
+ * @param row_length (int) : the number of samples of the row.
+ * @param key_dtype (int) : the type of the samples the views were taken from.
+ * @param codec (int) : `BINARY_CODEC_PREDICTIVE` or `BINARY_CODEC_QUANTIZED`.
+ * @param quantization_bits (int) : the number of fractional bits kept by the quantized codec.
+ * @param row (void*) : the pointer to the samples of the row to fill.
+ * @param dtype (int) : the type of the samples in memory, of the same family (integers or floats) as `key_dtype`.
+ */
+static void setRowFromKeys(uint64_t* keys, int row_length, int key_dtype, int codec, int quantization_bits, void* row, int dtype)
+{
+    for (int k = 0; k < row_length; k++)
+    {
+        double value = 0.;
+
+        if (key_dtype == BINARY_UINT8)
+        {
+            ((uint8_t*) row)[k] = (uint8_t) keys[k];
+            continue;
+        }
+
+        if (codec == BINARY_CODEC_QUANTIZED)
+        {
+            value = ldexp((double) (int64_t) keys[k], -quantization_bits);
+        }
+        else if (key_dtype == BINARY_FLOAT32)
+        {
+            uint32_t bits = (keys[k] >> 31) ? (uint32_t) keys[k] & 0x7fffffffu : (uint32_t) ~keys[k];
+
+            float float_value = 0.f;
+            memcpy(&float_value, &bits, sizeof(float));
+
+            value = float_value;
+        }
+        else
+        {
+            uint64_t bits = (keys[k] >> 63) ? keys[k] & 0x7fffffffffffffffu : ~keys[k];
+
+            memcpy(&value, &bits, sizeof(double));
+        }
+
+        if (dtype == BINARY_FLOAT32)
+        {
+            ((float*) row)[k] = (float) value;
+        }
+        else
+        {
+            ((double*) row)[k] = value;
+        }
+    }
+}
+
+/**
+ * @brief Computes the prediction `left + up - upleft` of a sample from the integer views of its neighbours of the same component. The
+ * missing neighbours of the first row and column count as `0`.
+ *
+ * @param keys (uint64_t*) : the integer views of the current row, up to the sample.
+ * @param previous_keys (uint64_t*) : the integer views of the previous row, `NULL` for the first row.
+ * @param idx (int) : the index of the sample in its row.
+ * @param nb_components (int) : the number of samples per value.
+ * @param mask (uint64_t) : the mask of the bits of the integer views.
+ * @return uint64_t : the prediction of the integer view of the sample.
+ */
+static uint64_t predictKey(uint64_t* keys, uint64_t* previous_keys, int idx, int nb_components, uint64_t mask)
+{
+    uint64_t left = idx >= nb_components ? keys[idx - nb_components] : 0;
+    uint64_t up = previous_keys != NULL ? previous_keys[idx] : 0;
+    uint64_t up_left = previous_keys != NULL && idx >= nb_components ? previous_keys[idx - nb_components] : 0;
+
+    return (left + up - up_left) & mask;
+}
+
+/**
+ * @brief Gets the mask of the bits of the integer views of the samples of the given type.
+ *
+ * @param dtype (int) : the type of the samples.
+ * @param codec (int) : `BINARY_CODEC_PREDICTIVE` or `BINARY_CODEC_QUANTIZED`.
+ * @return uint64_t : the mask.
+ */
+static uint64_t getKeyMask(int dtype, int codec)
+{
+    size_t sample_size = getBinarySampleSize(dtype);
+
+    // Quantized values are 64 bits integers
+    if (codec == BINARY_CODEC_QUANTIZED || sample_size == 8)
+    {
+        return ~(uint64_t) 0;
+    }
+
+    return ((uint64_t) 1 << (8 * sample_size)) - 1;
+}
+
+/**
+ * @brief Gets the next byte of the payload of the given decoder, reading the next part of the file when needed.
+ *
+ * @param decoder (binaryDecoder*) : the pointer to the decoder.
+ * @return int : the byte, `-1` at the end of the payload.
+ */
+static int getDecoderByte(binaryDecoder* decoder)
+{
+    if (decoder->position == decoder->nb_bytes)
+    {
+        if (decoder->f == NULL)
+        {
+            return -1;
+        }
+
+        decoder->nb_bytes = fread(decoder->bytes, 1, BINARY_BUFFER_SIZE, decoder->f);
+        decoder->position = 0;
+
+        if (decoder->nb_bytes == 0)
+        {
+            return -1;
+        }
+    }
+
+    return decoder->bytes[decoder->position++];
+}
+
+
+
+/**
+ * @brief Decodes the next LEB128 varint of the payload of the given decoder.
+ *
+ * @param decoder (binaryDecoder*) : the pointer to the decoder.
+ * @param value (uint64_t*) : the pointer to the value to fill.
+ * @return int : `1` on success, `0` if the payload is truncated or invalid.
+ */
+static int getDecoderVarint(binaryDecoder* decoder, uint64_t* value)
+{
+    uint64_t result = 0;
+
+    for (int shift = 0; shift < 70; shift += 7)
+    {
+        int byte = 0;
+
+        // Fast path : the byte is already buffered
+        if (decoder->position < decoder->nb_bytes)
+        {
+            byte = decoder->bytes[decoder->position++];
+        }
+        else
+        {
+            byte = getDecoderByte(decoder);
+
+            if (byte < 0)
+            {
+                return 0;
+            }
+        }
+
+        result |= (uint64_t) (byte & 0x7f) << shift;
+
+        if (byte < 0x80)
+        {
+            *value = result;
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+
+
+/**
+ * @brief Reads a 4 bytes dimension of a header (e.g. its width), which should fit in an int.
+ *
+ * @param bytes (unsigned char*) : the bytes of the dimension.
+ * @param dimension (int*) : the pointer to the dimension to fill, with `0` if it does not fit.
+ * @return int : `1` if the dimension fits in an int, `0` otherwise.
+ */
+static int getBinaryDimension(unsigned char* bytes, int* dimension)
+{
+    uint64_t value = getBinaryInteger(bytes, 4);
+
+    *dimension = value <= INT_MAX ? (int) value : 0;
+
+    return value <= INT_MAX;
+}
+
+/**
+ * @brief Decodes and checks the given header bytes.
+ *
+ * @param bytes (unsigned char*) : the `BINARY_HEADER_SIZE` bytes of the header.
+ * @param kind (int) : the expected kind of structure.
+ * @param header (binaryHeader*) : the pointer to the header to fill.
+ * @return int : `1` on success, `0` if the bytes are not the header of a binary file of the given kind and of a supported version.
+ */
+static int decodeBinaryHeader(unsigned char* bytes, int kind, binaryHeader* header)
+{
+    if (memcmp(bytes, BINARY_MAGIC, 4) != 0)
+    {
+        printf("%sERROR : not a binary file of the generator%s\n", RED_COLOR, DEFAULT_COLOR);
+        return 0;
+    }
+
+    header->version = (int) getBinaryInteger(bytes + 4, 2);
+    header->kind = (int) getBinaryInteger(bytes + 6, 2);
+    header->dtype = (int) getBinaryInteger(bytes + 8, 2);
+    header->nb_components = (int) getBinaryInteger(bytes + 10, 2);
+
+    int valid_dimensions = getBinaryDimension(bytes + 12, &header->width);
+    valid_dimensions &= getBinaryDimension(bytes + 16, &header->height);
+    valid_dimensions &= getBinaryDimension(bytes + 20, &header->map_width);
+    valid_dimensions &= getBinaryDimension(bytes + 24, &header->map_height);
+    valid_dimensions &= getBinaryDimension(bytes + 28, &header->chunk_width);
+    valid_dimensions &= getBinaryDimension(bytes + 32, &header->chunk_height);
+    valid_dimensions &= getBinaryDimension(bytes + 36, &header->number_of_layers);
+    valid_dimensions &= getBinaryDimension(bytes + 40, &header->size_factor);
+    valid_dimensions &= getBinaryDimension(bytes + 44, &header->nb_records);
+
+    header->sea_level = getBinaryDouble(bytes + 48);
+    header->base_altitude = getBinaryDouble(bytes + 56);
+    header->seed = getBinaryInteger(bytes + 64, 8);
+    header->codec = (int) getBinaryInteger(bytes + 72, 2);
+    header->quantization_bits = (int) getBinaryInteger(bytes + 74, 2);
+
+    if (header->version < 1 || header->version > BINARY_VERSION)
+    {
+        printf("%sERROR : unsupported binary file version %d (the latest is %d)%s\n", RED_COLOR, header->version, BINARY_VERSION, DEFAULT_COLOR);
+        return 0;
+    }
+
+    if (header->kind != kind)
+    {
+        printf("%sERROR : the binary file holds a structure of kind %d instead of %d%s\n", RED_COLOR, header->kind, kind, DEFAULT_COLOR);
+        return 0;
+    }
+
+    if (header->nb_components != 0 && getBinarySampleSize(header->dtype) == 0)
+    {
+        printf("%sERROR : unknown sample type %d in the binary file%s\n", RED_COLOR, header->dtype, DEFAULT_COLOR);
+        return 0;
+    }
+
+    if (header->codec < BINARY_CODEC_RAW || header->codec > BINARY_CODEC_QUANTIZED || (header->codec == BINARY_CODEC_QUANTIZED
+            && (header->dtype == BINARY_UINT8 || header->quantization_bits > BINARY_MAX_QUANTIZATION_BITS)))
+    {
+        printf("%sERROR : unknown codec %d in the binary file%s\n", RED_COLOR, header->codec, DEFAULT_COLOR);
+        return 0;
+    }
+
+    // The rows and the chunks geometry are indexed with ints, and the samples should fit in memory whatever their type in it
+    if (!valid_dimensions || (int64_t) header->width * header->nb_components > INT_MAX
+            || (int64_t) header->map_width * header->chunk_width > INT_MAX || (int64_t) header->map_height * header->chunk_height > INT_MAX
+            || getBinaryNbSamples(header) > SIZE_MAX / sizeof(double))
+    {
+        printf("%sERROR : invalid dimensions in the binary file%s\n", RED_COLOR, DEFAULT_COLOR);
+        return 0;
+    }
+
+    return 1;
+}
+
+
+
+
+binaryHeader initBinaryHeader(int kind, int dtype, int nb_components, int width, int height, uint64_t seed)
+{
+    binaryHeader header;
+
+    memset(&header, 0, sizeof(binaryHeader));
+
+    header.version = BINARY_VERSION;
+    header.kind = kind;
+    header.dtype = dtype;
+    header.nb_components = nb_components;
+    header.width = width;
+    header.height = height;
+    header.seed = seed;
+
+    return header;
+}
+
+
+
+size_t getBinarySampleSize(int dtype)
+{
+    switch (dtype)
+    {
+        case BINARY_UINT8:
+            return 1;
+        case BINARY_FLOAT32:
+            return 4;
+        case BINARY_FLOAT64:
+            return 8;
+        default:
+            return 0;
+    }
+}
+
+
+
+
+
+void putBinaryInteger(unsigned char* bytes, uint64_t value, int nb_bytes)
+{
+    for (int b = 0; b < nb_bytes; b++)
+    {
+        bytes[b] = (unsigned char) (value >> (8 * b));
+    }
+}
+
+
+
+uint64_t getBinaryInteger(unsigned char* bytes, int nb_bytes)
+{
+    uint64_t value = 0;
+
+    for (int b = 0; b < nb_bytes; b++)
+    {
+        value |= (uint64_t) bytes[b] << (8 * b);
+    }
+
+    return value;
+}
+
+
+
+void putBinaryDouble(unsigned char* bytes, double value)
+{
+    uint64_t bits = 0;
+    memcpy(&bits, &value, sizeof(double));
+
+    putBinaryInteger(bytes, bits, 8);
+}
+
+
+
+double getBinaryDouble(unsigned char* bytes)
+{
+    uint64_t bits = getBinaryInteger(bytes, 8);
+
+    double value = 0.;
+    memcpy(&value, &bits, sizeof(double));
+
+    return value;
+}
+
+
+
+
+
+int writeBinaryHeader(FILE* f, binaryHeader* header)
+{
+    unsigned char bytes[BINARY_HEADER_SIZE];
+
+    memset(bytes, 0, BINARY_HEADER_SIZE);
+    memcpy(bytes, BINARY_MAGIC, 4);
+
+    putBinaryInteger(bytes + 4, header->version, 2);
+    putBinaryInteger(bytes + 6, header->kind, 2);
+    putBinaryInteger(bytes + 8, header->dtype, 2);
+    putBinaryInteger(bytes + 10, header->nb_components, 2);
+    putBinaryInteger(bytes + 12, header->width, 4);
+    putBinaryInteger(bytes + 16, header->height, 4);
+    putBinaryInteger(bytes + 20, header->map_width, 4);
+    putBinaryInteger(bytes + 24, header->map_height, 4);
+    putBinaryInteger(bytes + 28, header->chunk_width, 4);
+    putBinaryInteger(bytes + 32, header->chunk_height, 4);
+    putBinaryInteger(bytes + 36, header->number_of_layers, 4);
+    putBinaryInteger(bytes + 40, header->size_factor, 4);
+    putBinaryInteger(bytes + 44, header->nb_records, 4);
+    putBinaryDouble(bytes + 48, header->sea_level);
+    putBinaryDouble(bytes + 56, header->base_altitude);
+    putBinaryInteger(bytes + 64, header->seed, 8);
+    putBinaryInteger(bytes + 72, header->codec, 2);
+    putBinaryInteger(bytes + 74, header->quantization_bits, 2);
+
+    return fwrite(bytes, 1, BINARY_HEADER_SIZE, f) == BINARY_HEADER_SIZE;
+}
+
+
+
+int readBinaryHeader(FILE* f, int kind, binaryHeader* header)
+{
+    unsigned char bytes[BINARY_HEADER_SIZE];
+
+    if (fread(bytes, 1, BINARY_HEADER_SIZE, f) != BINARY_HEADER_SIZE)
+    {
+        printf("%sERROR : not a binary file of the generator%s\n", RED_COLOR, DEFAULT_COLOR);
+        return 0;
+    }
+
+    if (!decodeBinaryHeader(bytes, kind, header))
+    {
+        return 0;
+    }
+
+    // The readers allocate the samples from the header : a regular file should hold at least their bytes
+    struct stat file_stat;
+    long position = ftell(f);
+
+    if (kind != BINARY_TILED_MAP && position >= 0 && fstat(fileno(f), &file_stat) == 0 && S_ISREG(file_stat.st_mode)
+            && (uint64_t) file_stat.st_size - (uint64_t) position < getBinaryMinimumPayloadSize(header))
+    {
+        printf("%sERROR : truncated binary file, %lld bytes for a payload of at least %llu bytes%s\n", RED_COLOR,
+                    (long long) file_stat.st_size - position, (unsigned long long) getBinaryMinimumPayloadSize(header), DEFAULT_COLOR);
+        return 0;
+    }
+
+    return 1;
+}
+
+
+
+uint64_t getBinaryNbSamples(binaryHeader* header)
+{
+    return (uint64_t) header->width * header->height * header->nb_components;
+}
+
+
+
+uint64_t getBinaryMinimumPayloadSize(binaryHeader* header)
+{
+    // Every encoded sample takes at least one varint byte
+    uint64_t sample_size = header->codec == BINARY_CODEC_RAW ? getBinarySampleSize(header->dtype) : 1;
+
+    return getBinaryNbSamples(header) * sample_size;
+}
+
+
+
+
+
+int writeBinarySamples(FILE* f, int dtype, void* samples, size_t nb_samples)
+{
+    size_t sample_size = getBinarySampleSize(dtype);
+
+    if (sample_size == 0)
+    {
+        return 0;
+    }
+
+    // The memory layout already is the file one : a single write
+    if (sample_size == 1 || isLittleEndian())
+    {
+        return fwrite(samples, sample_size, nb_samples, f) == nb_samples;
+    }
+
+    unsigned char buffer[BINARY_BUFFER_SIZE];
+    size_t samples_per_buffer = BINARY_BUFFER_SIZE / sample_size;
+
+    for (size_t start = 0; start < nb_samples; start += samples_per_buffer)
+    {
+        size_t nb = nb_samples - start < samples_per_buffer ? nb_samples - start : samples_per_buffer;
+
+        memcpy(buffer, (unsigned char*) samples + start * sample_size, nb * sample_size);
+        swapSamplesBytes(buffer, sample_size, nb);
+
+        if (fwrite(buffer, sample_size, nb, f) != nb)
+        {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+
+
+int readBinarySamples(FILE* f, int file_dtype, int dtype, void* samples, size_t nb_samples)
+{
+    size_t file_sample_size = getBinarySampleSize(file_dtype);
+    size_t sample_size = getBinarySampleSize(dtype);
+
+    if (file_sample_size == 0 || sample_size == 0 || (file_dtype == BINARY_UINT8) != (dtype == BINARY_UINT8))
+    {
+        printf("%sERROR : can not convert binary samples of type %d to type %d%s\n", RED_COLOR, file_dtype, dtype, DEFAULT_COLOR);
+        return 0;
+    }
+
+    // Same type : a single read, and the bytes swapped in place on a big-endian machine
+    if (file_dtype == dtype)
+    {
+        if (fread(samples, sample_size, nb_samples, f) != nb_samples)
+        {
+            return 0;
+        }
+
+        if (sample_size > 1 && !isLittleEndian())
+        {
+            swapSamplesBytes(samples, sample_size, nb_samples);
+        }
+
+        return 1;
+    }
+
+    // Float precision conversion, through a buffer
+    unsigned char buffer[BINARY_BUFFER_SIZE];
+    size_t samples_per_buffer = BINARY_BUFFER_SIZE / file_sample_size;
+
+    for (size_t start = 0; start < nb_samples; start += samples_per_buffer)
+    {
+        size_t nb = nb_samples - start < samples_per_buffer ? nb_samples - start : samples_per_buffer;
+
+        if (fread(buffer, file_sample_size, nb, f) != nb)
+        {
+            return 0;
+        }
+
+        decodeBinarySamples(buffer, file_dtype, dtype, (unsigned char*) samples + start * sample_size, nb);
+    }
+
+    return 1;
+}
+
+
+
+void decodeBinarySamples(unsigned char* bytes, int file_dtype, int dtype, void* samples, size_t nb_samples)
+{
+    if (file_dtype == dtype)
+    {
+        size_t sample_size = getBinarySampleSize(dtype);
+
+        memcpy(samples, bytes, nb_samples * sample_size);
+
+        if (sample_size > 1 && !isLittleEndian())
+        {
+            swapSamplesBytes(samples, sample_size, nb_samples);
+        }
+
+        return;
+    }
+
+    size_t file_sample_size = getBinarySampleSize(file_dtype);
+
+    for (size_t k = 0; k < nb_samples; k++)
+    {
+        double value = getFloatSample(bytes + k * file_sample_size, file_dtype);
+
+        if (dtype == BINARY_FLOAT32)
+        {
+            ((float*) samples)[k] = (float) value;
+        }
+        else
+        {
+            ((double*) samples)[k] = value;
+        }
+    }
+}
+
+
+
+binaryEncoder* newBinaryEncoder(FILE* f, binaryHeader* header)
+{
+    binaryEncoder* encoder = calloc(1, sizeof(binaryEncoder));
+
+    encoder->f = f;
+    encoder->dtype = header->dtype;
+    encoder->codec = header->codec;
+    encoder->quantization_bits = header->quantization_bits;
+    encoder->nb_components = header->nb_components;
+    encoder->row_length = header->width * header->nb_components;
+    encoder->success = 1;
+
+    if (encoder->codec == BINARY_CODEC_QUANTIZED && (encoder->quantization_bits < 0 || encoder->quantization_bits > BINARY_MAX_QUANTIZATION_BITS))
+    {
+        printf("%sERROR : invalid number of quantization bits %d. Should be in range [0, %d]%s\n", RED_COLOR, encoder->quantization_bits,
+                    BINARY_MAX_QUANTIZATION_BITS, DEFAULT_COLOR);
+        encoder->success = 0;
+    }
+
+    if (encoder->codec != BINARY_CODEC_RAW)
+    {
+        encoder->previous_keys = calloc(encoder->row_length, sizeof(uint64_t));
+        encoder->keys = calloc(encoder->row_length, sizeof(uint64_t));
+
+        // A varint takes at most 10 bytes
+        encoder->buffer = calloc(BINARY_BUFFER_SIZE + 10, 1);
+    }
+
+    return encoder;
+}
+
+
+
+int encodeBinaryRow(binaryEncoder* encoder, void* row)
+{
+    if (!encoder->success)
+    {
+        return 0;
+    }
+
+    if (encoder->codec == BINARY_CODEC_RAW)
+    {
+        encoder->success = writeBinarySamples(encoder->f, encoder->dtype, row, encoder->row_length);
+        encoder->nb_rows += 1;
+
+        return encoder->success;
+    }
+
+    uint64_t mask = getKeyMask(encoder->dtype, encoder->codec);
+    uint64_t sign_bit = (mask >> 1) + 1;
+    uint64_t* previous_keys = encoder->nb_rows > 0 ? encoder->previous_keys : NULL;
+
+    if (!getRowKeys(row, encoder->row_length, encoder->dtype, encoder->codec, encoder->quantization_bits, encoder->keys))
+    {
+        printf("%sERROR : the quantized codec can not encode a non-finite sample, nor one beyond 2^%d in magnitude%s\n", RED_COLOR,
+                    62 - encoder->quantization_bits, DEFAULT_COLOR);
+        encoder->success = 0;
+
+        return 0;
+    }
+
+    for (int k = 0; k < encoder->row_length; k++)
+    {
+        // The residual, sign extended from the bits of the views, then zigzag encoded
+        uint64_t residual = (encoder->keys[k] - predictKey(encoder->keys, previous_keys, k, encoder->nb_components, mask)) & mask;
+        uint64_t zigzag = (residual & sign_bit) ? ((~residual & mask) << 1) | 1 : residual << 1;
+
+        while (zigzag >= 0x80)
+        {
+            encoder->buffer[encoder->buffer_used++] = (unsigned char) (zigzag | 0x80);
+            zigzag >>= 7;
+        }
+        encoder->buffer[encoder->buffer_used++] = (unsigned char) zigzag;
+
+        if (encoder->buffer_used >= BINARY_BUFFER_SIZE)
+        {
+            encoder->success = encoder->success && fwrite(encoder->buffer, 1, encoder->buffer_used, encoder->f) == encoder->buffer_used;
+            encoder->buffer_used = 0;
+        }
+    }
+
+    uint64_t* tmp = encoder->previous_keys;
+    encoder->previous_keys = encoder->keys;
+    encoder->keys = tmp;
+
+    encoder->nb_rows += 1;
+
+    return encoder->success;
+}
+
+
+
+int freeBinaryEncoder(binaryEncoder* encoder)
+{
+    int success = encoder->success;
+
+    if (encoder->buffer_used > 0)
+    {
+        success = success && fwrite(encoder->buffer, 1, encoder->buffer_used, encoder->f) == encoder->buffer_used;
+    }
+
+    free(encoder->previous_keys);
+    free(encoder->keys);
+    free(encoder->buffer);
+    free(encoder);
+
+    return success;
+}
+
+
+
+/**
+ * @brief Creates a decoder, without its source of bytes.
+ *
+ * @param header (binaryHeader*) : the pointer to the header of the file.
+ * @param dtype (int) : the type of the samples in memory.
+ * @return binaryDecoder* : the pointer to the new decoder.
+ */
+static binaryDecoder* initBinaryDecoder(binaryHeader* header, int dtype)
+{
+    binaryDecoder* decoder = calloc(1, sizeof(binaryDecoder));
+
+    decoder->file_dtype = header->dtype;
+    decoder->dtype = dtype;
+    decoder->codec = header->codec;
+    decoder->quantization_bits = header->quantization_bits;
+    decoder->nb_components = header->nb_components;
+    decoder->row_length = header->width * header->nb_components;
+
+    if (decoder->codec != BINARY_CODEC_RAW)
+    {
+        decoder->previous_keys = calloc(decoder->row_length, sizeof(uint64_t));
+        decoder->keys = calloc(decoder->row_length, sizeof(uint64_t));
+    }
+
+    return decoder;
+}
+
+
+
+binaryDecoder* newBinaryDecoder(FILE* f, binaryHeader* header, int dtype)
+{
+    binaryDecoder* decoder = initBinaryDecoder(header, dtype);
+
+    decoder->f = f;
+
+    // Raw rows are read directly from the file
+    if (decoder->codec != BINARY_CODEC_RAW)
+    {
+        decoder->bytes = calloc(BINARY_BUFFER_SIZE, 1);
+    }
+
+    return decoder;
+}
+
+
+
+binaryDecoder* newBinaryMemoryDecoder(unsigned char* bytes, size_t nb_bytes, binaryHeader* header, int dtype)
+{
+    binaryDecoder* decoder = initBinaryDecoder(header, dtype);
+
+    decoder->bytes = bytes;
+    decoder->nb_bytes = nb_bytes;
+
+    return decoder;
+}
+
+
+
+int decodeBinaryRow(binaryDecoder* decoder, void* row)
+{
+    if (decoder->codec == BINARY_CODEC_RAW)
+    {
+        decoder->nb_rows += 1;
+
+        if (decoder->f != NULL)
+        {
+            return readBinarySamples(decoder->f, decoder->file_dtype, decoder->dtype, row, decoder->row_length);
+        }
+
+        size_t row_size = decoder->row_length * getBinarySampleSize(decoder->file_dtype);
+
+        if (decoder->nb_bytes - decoder->position < row_size)
+        {
+            return 0;
+        }
+
+        decodeBinarySamples(decoder->bytes + decoder->position, decoder->file_dtype, decoder->dtype, row, decoder->row_length);
+        decoder->position += row_size;
+
+        return 1;
+    }
+
+    uint64_t mask = getKeyMask(decoder->file_dtype, decoder->codec);
+    uint64_t* previous_keys = decoder->nb_rows > 0 ? decoder->previous_keys : NULL;
+
+    for (int k = 0; k < decoder->row_length; k++)
+    {
+        uint64_t zigzag = 0;
+
+        if (!getDecoderVarint(decoder, &zigzag))
+        {
+            return 0;
+        }
+
+        uint64_t residual = (zigzag & 1) ? ~(zigzag >> 1) : zigzag >> 1;
+
+        decoder->keys[k] = (predictKey(decoder->keys, previous_keys, k, decoder->nb_components, mask) + residual) & mask;
+    }
+
+    setRowFromKeys(decoder->keys, decoder->row_length, decoder->file_dtype, decoder->codec, decoder->quantization_bits, row, decoder->dtype);
+
+    uint64_t* tmp = decoder->previous_keys;
+    decoder->previous_keys = decoder->keys;
+    decoder->keys = tmp;
+
+    decoder->nb_rows += 1;
+
+    return 1;
+}
+
+
+
+void freeBinaryDecoder(binaryDecoder* decoder)
+{
+    // The bytes in memory belong to the caller
+    if (decoder->f != NULL)
+    {
+        free(decoder->bytes);
+    }
+
+    free(decoder->previous_keys);
+    free(decoder->keys);
+    free(decoder);
+}
+
+
+
+int writeBinaryPayload(FILE* f, binaryHeader* header, void* samples)
+{
+    size_t nb_samples = (size_t) header->width * header->height * header->nb_components;
+
+    if (header->codec == BINARY_CODEC_RAW)
+    {
+        return writeBinarySamples(f, header->dtype, samples, nb_samples);
+    }
+
+    binaryEncoder* encoder = newBinaryEncoder(f, header);
+    size_t row_size = (size_t) encoder->row_length * getBinarySampleSize(header->dtype);
+
+    for (int i = 0; i < header->height; i++)
+    {
+        encodeBinaryRow(encoder, (unsigned char*) samples + i * row_size);
+    }
+
+    return freeBinaryEncoder(encoder);
+}
+
+
+
+int readBinaryPayload(FILE* f, binaryHeader* header, int dtype, void* samples)
+{
+    size_t nb_samples = (size_t) header->width * header->height * header->nb_components;
+
+    if (header->codec == BINARY_CODEC_RAW)
+    {
+        return readBinarySamples(f, header->dtype, dtype, samples, nb_samples);
+    }
+
+    binaryDecoder* decoder = newBinaryDecoder(f, header, dtype);
+    size_t row_size = (size_t) decoder->row_length * getBinarySampleSize(dtype);
+    int success = 1;
+
+    for (int i = 0; i < header->height && success; i++)
+    {
+        success = decodeBinaryRow(decoder, (unsigned char*) samples + i * row_size);
+    }
+
+    freeBinaryDecoder(decoder);
+
+    return success;
+}
+
+
+
+mappedBinaryFile* mapBinaryFile(char path[], int kind, int dtype, int nb_components)
+{
+    int fd = open(path, O_RDONLY);
+
+    if (fd < 0)
+    {
+        printf("%sERROR : could not open file in reading mode at path '%s'%s\n", RED_COLOR, path, DEFAULT_COLOR);
+        return NULL;
+    }
+
+    struct stat file_stat;
+
+    if (fstat(fd, &file_stat) != 0 || (size_t) file_stat.st_size < BINARY_HEADER_SIZE)
+    {
+        printf("%sERROR : not a binary file of the generator at path '%s'%s\n", RED_COLOR, path, DEFAULT_COLOR);
+        close(fd);
+        return NULL;
+    }
+
+    size_t size = (size_t) file_stat.st_size;
+    void* address = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+    // The mapping stays valid once the file is closed
+    close(fd);
+
+    if (address == MAP_FAILED)
+    {
+        printf("%sERROR : could not map the file at path '%s' in memory%s\n", RED_COLOR, path, DEFAULT_COLOR);
+        return NULL;
+    }
+
+    mappedBinaryFile* mapped_file = calloc(1, sizeof(mappedBinaryFile));
+
+    mapped_file->address = address;
+    mapped_file->size = size;
+
+    binaryHeader* header = &mapped_file->header;
+
+    if (!decodeBinaryHeader(address, kind, header))
+    {
+        unmapBinaryFile(mapped_file);
+        return NULL;
+    }
+
+    if (header->nb_components != nb_components || (header->dtype == BINARY_UINT8) != (dtype == BINARY_UINT8))
+    {
+        printf("%sERROR : the binary file at path '%s' holds %d samples of type %d per value instead of %d of type %d%s\n", RED_COLOR, path,
+                    header->nb_components, header->dtype, nb_components, dtype, DEFAULT_COLOR);
+        unmapBinaryFile(mapped_file);
+        return NULL;
+    }
+
+    size_t nb_samples = (size_t) header->width * header->height * nb_components;
+    unsigned char* payload = (unsigned char*) address + BINARY_HEADER_SIZE;
+
+    // Checked before any allocation from the header
+    if (size - BINARY_HEADER_SIZE < getBinaryMinimumPayloadSize(header))
+    {
+        printf("%sERROR : truncated binary file at path '%s'%s\n", RED_COLOR, path, DEFAULT_COLOR);
+        unmapBinaryFile(mapped_file);
+        return NULL;
+    }
+
+    // Encoded samples are decoded once
+    if (header->codec != BINARY_CODEC_RAW)
+    {
+        binaryDecoder* decoder = newBinaryMemoryDecoder(payload, size - BINARY_HEADER_SIZE, header, dtype);
+        size_t row_size = (size_t) decoder->row_length * getBinarySampleSize(dtype);
+        int success = 1;
+
+        mapped_file->samples = calloc(nb_samples, getBinarySampleSize(dtype));
+
+        for (int i = 0; i < header->height && success; i++)
+        {
+            success = decodeBinaryRow(decoder, (unsigned char*) mapped_file->samples + i * row_size);
+        }
+
+        freeBinaryDecoder(decoder);
+
+        munmap(address, size);
+        mapped_file->address = NULL;
+
+        if (!success)
+        {
+            printf("%sERROR : truncated binary file at path '%s'%s\n", RED_COLOR, path, DEFAULT_COLOR);
+            unmapBinaryFile(mapped_file);
+            return NULL;
+        }
+
+        return mapped_file;
+    }
+
+    // The header size keeps the payload aligned for every type : the samples are used in place
+    if (header->dtype == dtype && (dtype == BINARY_UINT8 || isLittleEndian()))
+    {
+        mapped_file->samples = payload;
+    }
+    else
+    {
+        mapped_file->samples = calloc(nb_samples, getBinarySampleSize(dtype));
+        decodeBinarySamples(payload, header->dtype, dtype, mapped_file->samples, nb_samples);
+
+        munmap(address, size);
+        mapped_file->address = NULL;
+    }
+
+    return mapped_file;
+}
+
+
+
+void unmapBinaryFile(mappedBinaryFile* mapped_file)
+{
+    if (mapped_file != NULL)
+    {
+        if (mapped_file->address != NULL)
+        {
+            munmap(mapped_file->address, mapped_file->size);
+        }
+        else
+        {
+            free(mapped_file->samples);
+        }
+
+        free(mapped_file);
+    }
+}
+
+
+
+
+
+int writeBinaryIndex(FILE* f, int nb_records, uint64_t offsets[nb_records], uint64_t sizes[nb_records])
+{
+    unsigned char* bytes = calloc(nb_records, 16);
+
+    for (int k = 0; k < nb_records; k++)
+    {
+        putBinaryInteger(bytes + 16 * k, offsets[k], 8);
+        putBinaryInteger(bytes + 16 * k + 8, sizes[k], 8);
+    }
+
+    int success = fwrite(bytes, 16, nb_records, f) == (size_t) nb_records;
+
+    free(bytes);
+
+    return success;
+}
+
+
+
+binaryRecordFile* openBinaryRecordFile(char path[], int kind)
+{
+    int fd = open(path, O_RDONLY);
+
+    if (fd < 0)
+    {
+        printf("%sERROR : could not open file in reading mode at path '%s'%s\n", RED_COLOR, path, DEFAULT_COLOR);
+        return NULL;
+    }
+
+    unsigned char header_bytes[BINARY_HEADER_SIZE];
+    binaryHeader header;
+
+    if (pread(fd, header_bytes, BINARY_HEADER_SIZE, 0) != BINARY_HEADER_SIZE || !decodeBinaryHeader(header_bytes, kind, &header))
+    {
+        printf("%sERROR : invalid record file at path '%s'%s\n", RED_COLOR, path, DEFAULT_COLOR);
+        close(fd);
+        return NULL;
+    }
+
+    struct stat file_stat;
+    size_t index_size = 16 * (size_t) header.nb_records;
+
+    // Checked before allocating the index from the header
+    if (fstat(fd, &file_stat) != 0 || (size_t) file_stat.st_size - BINARY_HEADER_SIZE < index_size)
+    {
+        printf("%sERROR : truncated index in the record file at path '%s'%s\n", RED_COLOR, path, DEFAULT_COLOR);
+        close(fd);
+        return NULL;
+    }
+
+    unsigned char* index_bytes = calloc(index_size + 1, 1);
+
+    if (pread(fd, index_bytes, index_size, BINARY_HEADER_SIZE) != (ssize_t) index_size)
+    {
+        printf("%sERROR : truncated index in the record file at path '%s'%s\n", RED_COLOR, path, DEFAULT_COLOR);
+        free(index_bytes);
+        close(fd);
+        return NULL;
+    }
+
+    // A record is allocated from its size when it is read : it should lie in the file
+    uint64_t file_size = (uint64_t) file_stat.st_size;
+
+    for (int k = 0; k < header.nb_records; k++)
+    {
+        uint64_t offset = getBinaryInteger(index_bytes + 16 * k, 8);
+        uint64_t size = getBinaryInteger(index_bytes + 16 * k + 8, 8);
+
+        if (offset > file_size || size > file_size - offset)
+        {
+            printf("%sERROR : record %d out of the record file at path '%s'%s\n", RED_COLOR, k, path, DEFAULT_COLOR);
+            free(index_bytes);
+            close(fd);
+            return NULL;
+        }
+    }
+
+    binaryRecordFile* record_file = calloc(1, sizeof(binaryRecordFile));
+
+    record_file->header = header;
+    record_file->fd = fd;
+    record_file->offsets = calloc(header.nb_records, sizeof(uint64_t));
+    record_file->sizes = calloc(header.nb_records, sizeof(uint64_t));
+
+    for (int k = 0; k < header.nb_records; k++)
+    {
+        record_file->offsets[k] = getBinaryInteger(index_bytes + 16 * k, 8);
+        record_file->sizes[k] = getBinaryInteger(index_bytes + 16 * k + 8, 8);
+    }
+
+    free(index_bytes);
+
+    return record_file;
+}
+
+
+
+unsigned char* readBinaryRecord(binaryRecordFile* record_file, int record_idx)
+{
+    if (record_idx < 0 || record_idx >= record_file->header.nb_records)
+    {
+        printf("%sERROR : invalid record_idx = %d when reading a record. Should be in range [0, %d]%s\n", RED_COLOR, record_idx,
+                    record_file->header.nb_records - 1, DEFAULT_COLOR);
+        return NULL;
+    }
+
+    size_t size = record_file->sizes[record_idx];
+    unsigned char* bytes = calloc(size + 1, 1);
+
+    // pread does not move the file position : the reads of several threads do not interfere
+    if (pread(record_file->fd, bytes, size, (off_t) record_file->offsets[record_idx]) != (ssize_t) size)
+    {
+        printf("%sERROR : truncated record %d in a record file%s\n", RED_COLOR, record_idx, DEFAULT_COLOR);
+        free(bytes);
+        return NULL;
+    }
+
+    return bytes;
+}
+
+
+
+void closeBinaryRecordFile(binaryRecordFile* record_file)
+{
+    if (record_file != NULL)
+    {
+        close(record_file->fd);
+
+        free(record_file->offsets);
+        free(record_file->sizes);
+        free(record_file);
+    }
+}
@@ -16,10 +16,11 @@
 #include "gradientGrid.h"
 #include "layer.h"
 #include "chunk.h"
+#include "textFormat.h"
 
-double* getChunkValue(chunk* chunk, int width_idx, int height_idx)
+altitude_t* getChunkValue(chunk* chunk, int width_idx, int height_idx)
 {
-    double* chunk_value = NULL;
+    altitude_t* chunk_value = NULL;
 
     if (chunk != NULL)
     {
@@ -38,7 +39,7 @@ double* getChunkValue(chunk* chunk, int width_idx, int height_idx)
             return NULL;
         }
 
-        chunk_value = (chunk->chunk_values) + height_idx * width + width_idx;
+        chunk_value = (chunk->chunk_values) + height_idx * chunk->values_stride + width_idx;
     }
 
     return chunk_value;
@@ -46,17 +47,33 @@ double* getChunkValue(chunk* chunk, int width_idx, int height_idx)
 
 
 
-chunk* initChunk(int width, int height, int number_of_layers, double layers_factors[number_of_layers], layer* layers[number_of_layers])
+chunk* initChunk(int width, int height, int number_of_layers, double layers_factors[number_of_layers], layer* layers[number_of_layers],
+                    altitude_t* chunk_values, int values_stride, generatorContext* context)
 {
-    chunk* new_chunk = calloc(1, sizeof(chunk));
+    memoryArena* arena = context != NULL ? context->options.arena : NULL;
+
+    chunk* new_chunk = arenaCalloc(arena, 1, sizeof(chunk));
 
-    double* chunk_values = calloc(width * height, sizeof(double));
+    // The values are either a view into a bigger buffer (e.g. the map values) or owned by the chunk
+    if (chunk_values != NULL)
+    {
+        new_chunk->chunk_values = chunk_values;
+        new_chunk->values_stride = values_stride;
+        new_chunk->owns_values = 0;
+    }
+    else
+    {
+        new_chunk->chunk_values = arenaCalloc(arena, width * height, sizeof(altitude_t));
+        new_chunk->values_stride = width;
+        new_chunk->owns_values = 1;
+    }
 
+    new_chunk->arena = arena;
     new_chunk->number_of_layers = number_of_layers;
 
 
     // Copy layer factors to ensure dynamic allocation
-    double* factors = calloc(number_of_layers, sizeof(double));
+    double* factors = arenaCalloc(arena, number_of_layers, sizeof(double));
     for (int i = 0; i < number_of_layers; i++)
     {
         factors[i] = layers_factors[i];
@@ -65,7 +82,7 @@ chunk* initChunk(int width, int height, int number_of_layers, double layers_fact
 
 
     // Copy layers list to ensure dynamic allocation
-    layer** layers_list = calloc(number_of_layers, sizeof(layer*));
+    layer** layers_list = arenaCalloc(arena, number_of_layers, sizeof(layer*));
     for (int i = 0; i < number_of_layers; i++)
     {
         layers_list[i] = layers[i];
@@ -75,7 +92,6 @@ chunk* initChunk(int width, int height, int number_of_layers, double layers_fact
 
     new_chunk->width = width;
     new_chunk->height = height;
-    new_chunk->chunk_values = chunk_values;
 
     new_chunk->base_altitude=0;
 
@@ -86,8 +102,37 @@ chunk* initChunk(int width, int height, int number_of_layers, double layers_fact
 
 
 
-void regenerateChunk(chunk* chunk, unsigned int display_loading)
+/**
+ * @brief Checks whether the given chunk was trimmed (see `trimChunk`) : its layers have no values, and their gradient grids only keep
+ * their boundaries, so that its values can no longer be computed from them.
+ * 
+ * @param chunk (chunk*) : the pointer to the chunk.
+ * @return int : `1` if one of its layers was trimmed, `0` otherwise.
+ */
+static int isChunkTrimmed(chunk* chunk)
+{
+    for (int k = 0; k < chunk->number_of_layers && chunk->layers != NULL; k++)
+    {
+        if (chunk->layers[k]->values == NULL && chunk->layers[k]->gradient_grid->boundaries != NULL)
+        {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+
+
+void regenerateChunk(chunk* chunk, generatorContext* context, unsigned int display_loading)
 {
+    if (isChunkTrimmed(chunk))
+    {
+        printf("%sERROR : a trimmed chunk can not be regenerated, its layers only keep their gradient grids boundaries%s\n", RED_COLOR,
+                    DEFAULT_COLOR);
+        return;
+    }
+
     clock_t start_time = clock();
 
     int width = chunk->width;
@@ -111,33 +156,180 @@ void regenerateChunk(chunk* chunk, unsigned int display_loading)
         return;
     }
 
+    // Layers without stored values are computed on the fly, one row at a time, from their gradient grid and the weights table of their size factor.
+    // The tables are the ones of the running generation when it has them.
+    int computed_size_factors[nblayers];
+    int nb_computed = 0;
+    int length = width > height ? width : height;
+
+    for (int k = 0; k < nblayers; k++)
+    {
+        if (layers[k]->values == NULL)
+        {
+            computed_size_factors[nb_computed] = layers[k]->size_factor;
+            nb_computed += 1;
+        }
+    }
+
+    perlinTableSet* table_set = nb_computed > 0 ? acquirePerlinTables(context, nb_computed, computed_size_factors, length) : NULL;
+    perlinTable* tables[nblayers];
+    perlinCellRow* cell_rows[nblayers];
+
+    for (int k = 0; k < nblayers; k++)
+    {
+        tables[k] = NULL;
+        cell_rows[k] = NULL;
+
+        if (layers[k]->values == NULL)
+        {
+            tables[k] = getPerlinTable(table_set, layers[k]->size_factor, length);
+            cell_rows[k] = newPerlinCellRow(width);
+        }
+    }
+
+    altitude_t* layer_row = calloc(width, sizeof(altitude_t));
+
     for (int i = 0; i < height; i++)
     {
+        altitude_t* chunk_row = getChunkValueUnchecked(chunk, 0, i);
+
         for (int j = 0; j < width; j++)
         {
-            double* value = getChunkValue(chunk, j, i);
+            chunk_row[j] = 0.;
+        }
+
+        // Accumulating every layer in the chunk row, in the layers order.
+        for (int k = 0; k < nblayers; k++)
+        {
+            altitude_t* row = NULL;
 
-            for (int k = 0; k < nblayers; k++)
+            if (layers[k]->values != NULL)
             {
-                double layer_value = *(getLayerValue(layers[k], j, i));
+                row = getLayerValueUnchecked(layers[k], 0, i);
+            }
+            else
+            {
+                perlinRowFromTable(layer_row, i, layers[k]->gradient_grid, tables[k], cell_rows[k]);
+                row = layer_row;
+            }
 
-                *value += factors[k] * layer_value;
-                
-                if (display_loading != 0)
-                {
-                    int nb_indents = display_loading - 1;
+            altitude_t factor = (altitude_t) factors[k];
 
-                    char base_str[100] = "Generating chunk values...         ";
+            for (int j = 0; j < width; j++)
+            {
+                chunk_row[j] += factor * row[j];
+            }
+        }
+
+        altitude_t altitude_divisor = (altitude_t) divisor;
+
+        for (int j = 0; j < width; j++)
+        {
+            chunk_row[j] /= altitude_divisor;
+        }
 
+        if (display_loading != 0)
+        {
+            int nb_indents = display_loading - 1;
+
+            char base_str[100] = "Generating chunk values...         ";
+
+            for (int j = 0; j < width; j++)
+            {
+                for (int k = 0; k < nblayers; k++)
+                {
                     predefined_loading_bar((i * width + j) * nblayers + k, width * height * nblayers - 1, NUMBER_OF_SEGMENTS,
                                                 base_str, nb_indents, start_time);
                 }
             }
-
-            *value /= divisor;
         }
     }
-    chunk->base_altitude=-0.5+2*rand()*1./RAND_MAX;
+
+    free(layer_row);
+
+    for (int k = 0; k < nblayers; k++)
+    {
+        freePerlinCellRow(cell_rows[k]);
+    }
+
+    if (table_set != NULL)
+    {
+        releasePerlinTables(context, table_set);
+    }
+
+    chunk->base_altitude=-0.5+2*getRandomUniform(context, 0, 0, 0);
+}
+
+
+
+
+
+/**
+ * @brief Generates the hashed gradient grid of the given octave for the chunk of the given context. Its origin is the chunk's
+ * first lattice point, so that two adjacent chunks share their boundary vectors.
+ * 
+ * @param width (int) : the width of the gradient grid.
+ * @param height (int) : the height of the gradient grid.
+ * @param octave (int) : the index of the layer in the chunk.
+ * @param context (generatorContext*) : the pointer to the context of the chunk.
+ * @return gradientGrid* : the pointer to the generated gradient grid.
+ */
+static gradientGrid* newChunkHashedGradGrid(int width, int height, int octave, generatorContext* context)
+{
+    generatorContext lattice_context = getLatticeContext(context, octave);
+
+    return newHashedGradGrid(width, height, context->chunk_x * (width - 1), context->chunk_y * (height - 1), &lattice_context);
+}
+
+
+
+/**
+ * @brief The parameters to generate the gradient grid or the values of one layer of a chunk, so that it can be run as a thread pool task.
+ * Every task writes its own result : the join does not depend on the order the tasks were run in.
+ * 
+ */
+struct chunkLayerTask
+{
+    int layer_idx; /**< the index of the layer in the chunk*/
+    int gradGrid_width; /**< the width of the gradient grid to generate*/
+    int gradGrid_height; /**< the height of the gradient grid to generate*/
+    gradientGrid* gradient_grid; /**< the generated gradient grid, or the one to generate the layer values from*/
+    perlinTable* table; /**< the pointer to the weights table of the layer's size factor, shared with the other layers*/
+    layer* layer; /**< the generated layer*/
+    generatorContext* context; /**< the pointer to the context of the chunk*/
+    unsigned int display_loading; /**< the display_loading value of the generation, `0` when run by a worker thread*/
+};
+
+/**
+ * @brief Generates the gradient grid of the layer of the given task.
+ * 
+ * @param argument (void*) : the pointer to the chunkLayerTask structure.
+ */
+static void generateChunkGradGrid(void* argument)
+{
+    struct chunkLayerTask* task = argument;
+
+    if (task->context->options.gradient_source == HASHED_GRADIENTS)
+    {
+        task->gradient_grid = newChunkHashedGradGrid(task->gradGrid_width, task->gradGrid_height, task->layer_idx, task->context);
+    }
+    else
+    {
+        generatorContext layer_context = getLayerContext(task->context, task->layer_idx);
+        task->gradient_grid = newRandomGradGrid(task->gradGrid_width, task->gradGrid_height, &layer_context, task->display_loading);
+    }
+}
+
+/**
+ * @brief Generates the layer values of the given task from its gradient grid.
+ * 
+ * @param argument (void*) : the pointer to the chunkLayerTask structure.
+ */
+static void generateChunkLayer(void* argument)
+{
+    struct chunkLayerTask* task = argument;
+
+    task->layer = newLayerFromTable(task->gradient_grid, task->table, task->display_loading);
 }
 
 
@@ -145,11 +337,11 @@ void regenerateChunk(chunk* chunk, unsigned int display_loading)
 
 
 chunk* newChunkFromLayers(int width, int height, int number_of_layers, double layers_factors[number_of_layers], layer* layers[number_of_layers],
-                             unsigned int display_loading)
+                             altitude_t* chunk_values, int values_stride, generatorContext* context, unsigned int display_loading)
 {
-    chunk* new_chunk = initChunk(width, height, number_of_layers, layers_factors, layers);
+    chunk* new_chunk = initChunk(width, height, number_of_layers, layers_factors, layers, chunk_values, values_stride, context);
 
-    regenerateChunk(new_chunk, display_loading);
+    regenerateChunk(new_chunk, context, display_loading);
 
     return new_chunk;
 }
@@ -157,13 +349,41 @@ chunk* newChunkFromLayers(int width, int height, int number_of_layers, double la
 
 
 chunk* newChunkFromGradients(int width, int height, int number_of_layers, gradientGrid* gradient_grids[number_of_layers], 
-                                int size_factors[number_of_layers], double layers_factors[number_of_layers], unsigned int display_loading)
+                                int size_factors[number_of_layers], double layers_factors[number_of_layers], int keep_layers_values,
+                                altitude_t* chunk_values, int values_stride, generatorContext* context, unsigned int display_loading)
 {
     layer* layers[number_of_layers];
 
-    int g_loading = display_loading;
+    // The layers are independent from each other : they are generated in parallel when the context has several workers.
+    threadPool* pool = acquireThreadPool(context);
 
-    if (display_loading != 0)
+    generatorContext pool_context = *context;
+    pool_context.options.pool = pool;
+
+    // The layers with the same size factor share their weights table, covering the largest layer
+    int length = width > height ? width : height;
+
+    for (int i = 0; i < number_of_layers; i++)
+    {
+        int layer_width = (gradient_grids[i]->width - 1) * size_factors[i];
+        int layer_height = (gradient_grids[i]->height - 1) * size_factors[i];
+
+        length = layer_width > length ? layer_width : length;
+        length = layer_height > length ? layer_height : length;
+    }
+
+    perlinTableSet* table_set = acquirePerlinTables(context, number_of_layers, size_factors, length);
+    pool_context.options.perlin_tables = table_set;
+
+    struct chunkLayerTask tasks[number_of_layers];
+    taskGroup layers_group = {0};
+
+    // The workers loading bars would be mixed up
+    unsigned int l_loading = pool == NULL ? display_loading : 0;
+
+    int g_loading = l_loading;
+
+    if (l_loading != 0)
     {
         // Indenting once more the layer generation
         g_loading += 1;
@@ -172,71 +392,135 @@ chunk* newChunkFromGradients(int width, int height, int number_of_layers, gradie
     // Generating the required layers
     for (int i = 0; i < number_of_layers; i++)
     {
-        if (display_loading != 0)
+        if (l_loading != 0 && keep_layers_values)
         {
             char to_print[200] = "";
             snprintf(to_print, sizeof(to_print), "Generating layer %d/%d from gradient grid...\n", i + 1, number_of_layers);
 
-            indent_print(display_loading - 1, to_print);
+            indent_print(l_loading - 1, to_print);
         }
 
         // Size_factors should match gradient_grids dimensions - 1
-        layers[i] = newLayerFromGradient(gradient_grids[i], size_factors[i], g_loading);
+        if (keep_layers_values)
+        {
+            tasks[i].layer_idx = i;
+            tasks[i].gradient_grid = gradient_grids[i];
+            tasks[i].table = getPerlinTable(table_set, size_factors[i], length);
+            tasks[i].layer = NULL;
+            tasks[i].context = &pool_context;
+            tasks[i].display_loading = g_loading;
+
+            submitTask(pool, &layers_group, generateChunkLayer, tasks + i);
+        }
+        else
+        {
+            // Fused chunk : the layer values will be computed while generating the chunk values
+            layers[i] = initLayer(gradient_grids[i], size_factors[i]);
+        }
 
 
-        if (display_loading != 0)
+        if (l_loading != 0 && keep_layers_values)
         {
-            indent_print(display_loading - 1, "\n");
+            indent_print(l_loading - 1, "\n");
         }
     }
 
-    // Generating the chunk
-    return newChunkFromLayers(width, height, number_of_layers, layers_factors, layers, display_loading);
+    // Joining the layers, in the layers order
+    waitTaskGroup(pool, &layers_group);
+
+    for (int i = 0; i < number_of_layers && keep_layers_values; i++)
+    {
+        layers[i] = tasks[i].layer;
+    }
+
+    releaseThreadPool(context, pool);
+
+    // Generating the chunk, its fused layers with the same tables (the pool is released)
+    pool_context.options.pool = context->options.pool;
+
+    chunk* new_chunk = newChunkFromLayers(width, height, number_of_layers, layers_factors, layers, chunk_values, values_stride, &pool_context,
+                                            display_loading);
+
+    releasePerlinTables(context, table_set);
+
+    return new_chunk;
 }
 
 
 
 chunk* newChunk(int number_of_layers, int gradGrids_width[number_of_layers], int gradGrids_height[number_of_layers], int size_factors[number_of_layers], 
-                        double layers_factors[number_of_layers], unsigned int display_loading)
+                        double layers_factors[number_of_layers], int keep_layers_values, altitude_t* chunk_values, int values_stride,
+                        generatorContext* context, unsigned int display_loading)
 {
     clock_t start_time = clock();
 
-    layer* layers[number_of_layers];
+    gradientGrid* gradient_grids[number_of_layers];
 
-    int l_loading = display_loading;
+    // The gradient grids are independent from each other : they are generated in parallel when the context has several workers.
+    // The pool is then shared with the layers generation.
+    threadPool* pool = acquireThreadPool(context);
 
-    if (display_loading != 0)
+    generatorContext pool_context = *context;
+    pool_context.options.pool = pool;
+
+    struct chunkLayerTask tasks[number_of_layers];
+    taskGroup grids_group = {0};
+
+    // The workers loading bars would be mixed up
+    unsigned int l_loading = pool == NULL ? display_loading : 0;
+
+    int g_loading = l_loading;
+
+    if (l_loading != 0)
     {
-        // Indenting two times more the layer generation
-        l_loading += 2;
-        indent_print(display_loading - 1, "Layer generation before generating chunk...\n");
+        // Indenting two times more the gradient grids generation
+        g_loading += 2;
+        indent_print(l_loading - 1, "Gradient grids generation before generating chunk...\n");
     }
 
-    // Generating the layers from scratch with the given parameters
+    // Generating the gradient grids from scratch with the given parameters
     for (int i = 0; i < number_of_layers; i++)
     {
-        if (display_loading != 0)
+        if (l_loading != 0)
         {
             char to_print[200] = "";
-            snprintf(to_print, sizeof(to_print), "Generating layer %d/%d...\n", i + 1, number_of_layers);
+            snprintf(to_print, sizeof(to_print), "Generating gradient grid %d/%d...\n", i + 1, number_of_layers);
 
-            indent_print(display_loading, to_print);
+            indent_print(l_loading, to_print);
         }
 
-        layers[i] = newLayer(gradGrids_width[i], gradGrids_height[i], size_factors[i], l_loading);
+        tasks[i].layer_idx = i;
+        tasks[i].gradGrid_width = gradGrids_width[i];
+        tasks[i].gradGrid_height = gradGrids_height[i];
+        tasks[i].gradient_grid = NULL;
+        tasks[i].context = &pool_context;
+        tasks[i].display_loading = g_loading;
 
-        if (display_loading != 0)
+        submitTask(pool, &grids_group, generateChunkGradGrid, tasks + i);
+
+        if (l_loading != 0)
         {
-            indent_print(display_loading, "\n");
+            indent_print(l_loading, "\n");
         }
     }
 
+    // Joining the gradient grids, in the layers order
+    waitTaskGroup(pool, &grids_group);
+
+    for (int i = 0; i < number_of_layers; i++)
+    {
+        gradient_grids[i] = tasks[i].gradient_grid;
+    }
+
     // Size_factors should match gradient_grids dimensions - 1
     int width = (gradGrids_width[0] - 1) * size_factors[0];
     int height = (gradGrids_height[0] - 1) * size_factors[0];
     
-    // Generating the chunk
-    chunk* new_chunk = newChunkFromLayers(width, height, number_of_layers, layers_factors, layers, display_loading);
+    // Generating the layers and the chunk
+    chunk* new_chunk = newChunkFromGradients(width, height, number_of_layers, gradient_grids, size_factors, layers_factors, keep_layers_values,
+                                                chunk_values, values_stride, &pool_context, display_loading);
+
+    releaseThreadPool(context, pool);
 
     // Printing the time elapsed
     if (display_loading == 1)
@@ -257,10 +541,11 @@ chunk* newChunk(int number_of_layers, int gradGrids_width[number_of_layers], int
 
 
 //TODO ? signature could be changed to avoid passing useless parameters -> `chunk_width` and `chunk_height` instead of `gradGrids_width`, `gradGrids_height` and `size_factors`
-chunk* newVirtualChunk(int number_of_layers, int gradGrids_width[number_of_layers], int gradGrids_height[number_of_layers], int size_factors[number_of_layers], double layers_factors[number_of_layers])
+chunk* newVirtualChunk(int number_of_layers, int gradGrids_width[number_of_layers], int gradGrids_height[number_of_layers], int size_factors[number_of_layers], double layers_factors[number_of_layers], generatorContext* context)
 {
-    chunk* new_chunk = calloc(1, sizeof(chunk));
+    chunk* new_chunk = arenaCalloc(context->options.arena, 1, sizeof(chunk));
 
+    new_chunk->arena = context->options.arena;
     new_chunk->number_of_layers = number_of_layers;
 
     // size_factors should match gradient_grids dimensions - 1
@@ -270,7 +555,7 @@ chunk* newVirtualChunk(int number_of_layers, int gradGrids_width[number_of_layer
     new_chunk->height = height;
 
     // copy layer factors to ensure dynamic allocation
-    double* factors = calloc(number_of_layers, sizeof(double));
+    double* factors = arenaCalloc(context->options.arena, number_of_layers, sizeof(double));
     for (int i = 0; i < number_of_layers; i++)
     {
         factors[i] = layers_factors[i];
@@ -278,10 +563,12 @@ chunk* newVirtualChunk(int number_of_layers, int gradGrids_width[number_of_layer
     new_chunk->layers_factors = factors;
 
     new_chunk->chunk_values = NULL;
+    new_chunk->values_stride = width;
+    new_chunk->owns_values = 1;
 
     new_chunk->layers = NULL;
 
-    new_chunk->base_altitude=-0.5+2*rand()*1./RAND_MAX;
+    new_chunk->base_altitude=-0.5+2*getRandomUniform(context, 0, 0, 0);
 
     return new_chunk;
 }
@@ -289,7 +576,8 @@ chunk* newVirtualChunk(int number_of_layers, int gradGrids_width[number_of_layer
 
 
 
-chunk* newAdjacentChunk(chunk* north_chunk, chunk* west_chunk, unsigned int display_loading)
+chunk* newAdjacentChunk(chunk* north_chunk, chunk* west_chunk, int keep_layers_values, altitude_t* chunk_values, int values_stride,
+                            generatorContext* context, unsigned int display_loading)
 {
     clock_t start_time = clock();
 
@@ -401,7 +689,17 @@ chunk* newAdjacentChunk(chunk* north_chunk, chunk* west_chunk, unsigned int disp
             size_factors[k] = west_chunk->layers[k]->size_factor;
         }
 
-        gradientGrids[k] = newAdjacentGradGrid(north_grid, west_grid, c_loading);
+        if (context->options.gradient_source == HASHED_GRADIENTS)
+        {
+            // Hashed gradients agree on the boundaries by construction : the neighbours only give the dimensions.
+            gradientGrid* grid = north_grid != NULL ? north_grid : west_grid;
+            gradientGrids[k] = newChunkHashedGradGrid(grid->width, grid->height, k, context);
+        }
+        else
+        {
+            generatorContext layer_context = getLayerContext(context, k);
+            gradientGrids[k] = newAdjacentGradGrid(north_grid, west_grid, &layer_context, c_loading);
+        }
 
         if (display_loading != 0)
         {
@@ -410,7 +708,8 @@ chunk* newAdjacentChunk(chunk* north_chunk, chunk* west_chunk, unsigned int disp
     }
 
     // Chunk generation
-    chunk* new_chunk = newChunkFromGradients(width, height, nb_layers, gradientGrids, size_factors, factors, c_loading);
+    chunk* new_chunk = newChunkFromGradients(width, height, nb_layers, gradientGrids, size_factors, factors, keep_layers_values,
+                                                chunk_values, values_stride, context, c_loading);
 
     // Printing the time elapsed
     if (display_loading == 1)
@@ -432,8 +731,30 @@ chunk* newAdjacentChunk(chunk* north_chunk, chunk* west_chunk, unsigned int disp
 
 
 
+void trimChunk(chunk* chunk)
+{
+    // Virtual chunks have no layer
+    if (chunk->layers == NULL)
+    {
+        return;
+    }
+
+    for (int k = 0; k < chunk->number_of_layers; k++)
+    {
+        trimLayer(chunk->layers[k]);
+    }
+}
+
+
+
 chunk* copyChunk(chunk* p_chunk)
 {
+    if (isChunkTrimmed(p_chunk))
+    {
+        printf("%sERROR : a trimmed chunk can not be copied, its layers only keep their gradient grids boundaries%s\n", RED_COLOR, DEFAULT_COLOR);
+        return NULL;
+    }
+
     chunk* res = calloc(1,sizeof(chunk));
 
     res->width=p_chunk->width;
@@ -456,12 +777,15 @@ chunk* copyChunk(chunk* p_chunk)
         res->layers[i]=copyLayer(p_chunk->layers[i]);
     }
 
-    res->chunk_values = calloc(n*m, sizeof(double));
+    // The copy owns its values, even when copied from a view
+    res->chunk_values = calloc(n*m, sizeof(altitude_t));
+    res->values_stride = n;
+    res->owns_values = 1;
     for (int i=0; i<n; i++)
     {
         for (int j=0; j<m; j++) 
         {
-            *getChunkValue(res,i,j)=*getChunkValue(p_chunk,i,j);
+            *getChunkValueUnchecked(res,i,j)=*getChunkValueUnchecked(p_chunk,i,j);
         }
     }
 
@@ -492,28 +816,35 @@ void writeChunkFile(chunk* chunk, char path[])
 
         fprintf(f, "number_of_layers=%d\nwidth=%d\nheight=%d\nbase_altitude=%8lf\n", number_of_layers, width, height, base_altitude);
 
-        // Writing the values
+        int success = 1;
+
+        // Writing the values, one row at a time
         if (chunk->chunk_values!=NULL)
         {
-            for (int i = 0; i < height; i++)
+            textRow* row = newTextRow(TEXT_VALUE_LENGTH * width);
+
+            for (int i = 0; i < height && success; i++)
             {
                 for (int j = 0; j < width; j++)
                 {
-                    double value = *getChunkValue(chunk, j, i);
-
-                    if (j != width - 1)
-                    {
-                        fprintf(f, "% .8lf\t", value);
-                    }
-                    else
-                    {
-                        fprintf(f, "% .8lf\n", value);
-                    }
+                    altitude_t value = *getChunkValueUnchecked(chunk, j, i);
+
+                    appendTextFixed(row, value, 8, 1);
+                    appendTextChar(row, j != width - 1 ? '\t' : '\n');
                 }
+
+                success = writeTextRow(row, f);
             }
+
+            freeTextRow(row);
         }
 
-        fclose(f);
+        success = fclose(f) == 0 && success;
+
+        if (!success)
+        {
+            printf("%sERROR : could not write the chunk at path '%s'%s\n", RED_COLOR, path, DEFAULT_COLOR);
+        }
     }
     else
     {
@@ -524,7 +855,122 @@ void writeChunkFile(chunk* chunk, char path[])
 
 
 
-chunk* readChunkFile(char path[]);
+chunk* readChunkFile(char path[])
+{
+    mappedBinaryFile* mapped_file = mapBinaryFile(path, BINARY_CHUNK, ALTITUDE_DTYPE, 1);
+
+    if (mapped_file == NULL)
+    {
+        return NULL;
+    }
+
+    chunk* new_chunk = calloc(1, sizeof(chunk));
+
+    new_chunk->width = mapped_file->header.width;
+    new_chunk->height = mapped_file->header.height;
+    new_chunk->base_altitude = mapped_file->header.base_altitude;
+    new_chunk->chunk_values = mapped_file->samples;
+    new_chunk->values_stride = mapped_file->header.width;
+    new_chunk->owns_values = 0;
+    new_chunk->mapped_file = mapped_file;
+
+    return new_chunk;
+}
+
+
+
+void writeChunkBinaryFile(chunk* chunk, uint64_t seed, char path[])
+{
+    FILE* f = fopen(path, "wb");
+
+    if (f == NULL)
+    {
+        printf("%sERROR : could not open file in writing mode at path '%s'%s\n", RED_COLOR, path, DEFAULT_COLOR);
+        return;
+    }
+
+    int width = chunk->width;
+    int height = chunk->height;
+
+    binaryHeader header = initBinaryHeader(BINARY_CHUNK, ALTITUDE_DTYPE, chunk->chunk_values != NULL ? 1 : 0, width, height, seed);
+    header.chunk_width = width;
+    header.chunk_height = height;
+    header.number_of_layers = chunk->number_of_layers;
+    header.base_altitude = chunk->base_altitude;
+
+    int success = writeBinaryHeader(f, &header);
+
+    if (chunk->chunk_values != NULL)
+    {
+        if (chunk->values_stride == width)
+        {
+            success = success && writeBinarySamples(f, ALTITUDE_DTYPE, chunk->chunk_values, (size_t) width * height);
+        }
+        else
+        {
+            // A view : one row at a time
+            for (int i = 0; i < height && success; i++)
+            {
+                success = writeBinarySamples(f, ALTITUDE_DTYPE, getChunkValueUnchecked(chunk, 0, i), width);
+            }
+        }
+    }
+
+    if (!success)
+    {
+        printf("%sERROR : could not write the chunk at path '%s'%s\n", RED_COLOR, path, DEFAULT_COLOR);
+    }
+
+    fclose(f);
+}
+
+
+
+chunk* readChunkBinaryFile(char path[], binaryHeader* header)
+{
+    FILE* f = fopen(path, "rb");
+
+    if (f == NULL)
+    {
+        printf("%sERROR : could not open file in reading mode at path '%s'%s\n", RED_COLOR, path, DEFAULT_COLOR);
+        return NULL;
+    }
+
+    binaryHeader file_header = initBinaryHeader(BINARY_CHUNK, 0, 0, 0, 0, 0);
+    chunk* new_chunk = NULL;
+
+    if (readBinaryHeader(f, BINARY_CHUNK, &file_header))
+    {
+        new_chunk = calloc(1, sizeof(chunk));
+
+        new_chunk->width = file_header.width;
+        new_chunk->height = file_header.height;
+        new_chunk->base_altitude = file_header.base_altitude;
+        new_chunk->values_stride = file_header.width;
+        new_chunk->owns_values = 1;
+
+        if (file_header.nb_components == 1)
+        {
+            new_chunk->chunk_values = calloc((size_t) file_header.width * file_header.height, sizeof(altitude_t));
+
+            if (!readBinaryPayload(f, &file_header, ALTITUDE_DTYPE, new_chunk->chunk_values))
+            {
+                printf("%sERROR : truncated chunk binary file at path '%s'%s\n", RED_COLOR, path, DEFAULT_COLOR);
+                freeChunk(new_chunk);
+                new_chunk = NULL;
+            }
+        }
+    }
+
+    fclose(f);
+
+    if (header != NULL)
+    {
+        *header = file_header;
+    }
+
+    return new_chunk;
+}
 
 
 
@@ -561,7 +1007,7 @@ void printChunk(chunk* chunk)
     {
         for (int j = 0; j < width; j++)
         {
-            double* value = getChunkValue(chunk, j, i);
+            altitude_t* value = getChunkValueUnchecked(chunk, j, i);
 
             printf("%lf   ", *value);
         }
@@ -575,14 +1021,19 @@ void printChunk(chunk* chunk)
 
 void freeChunk(chunk* chunk)
 {
-    if (chunk != NULL)
+    // The arena owns its structures
+    if (chunk != NULL && chunk->arena == NULL)
     {
         if (chunk->layers_factors != NULL)
         {
             free(chunk->layers_factors);
         }
 
-        if (chunk->chunk_values != NULL)
+        if (chunk->mapped_file != NULL)
+        {
+            unmapBinaryFile(chunk->mapped_file);
+        }
+        else if (chunk->chunk_values != NULL && chunk->owns_values)
         {
             free(chunk->chunk_values);
         }
@@ -0,0 +1,236 @@
+/**
+ * @file colorPalette.c
+ * @author Zyno and BlueNZ
+ * @brief color palette and color lookup table structures and functions implementation
+ * @version 0.2
+ * @date 2024-06-19
+ *
+ */
+
+#include <malloc.h>
+#include <math.h>
+#include <stdlib.h>
+
+#include "colorPalette.h"
+
+/**
+ * @brief The stops of the default sea gradient.
+ *
+ */
+static paletteStop default_sea_stops[2] = {{0., {50, 50, 0}}, {1., {50, 50, 200}}};
+
+/**
+ * @brief The stops of the default land gradient.
+ *
+ */
+static paletteStop default_land_stops[2] = {{0., {50, 0, 50}}, {1., {50, 255, 50}}};
+
+/**
+ * @brief The default palette, used when none is given. Its land gradient spans the whole altitude range : a map starts its land at the green
+ * `(sea_level - min_value) * 255 / (max_value - min_value)`, as the original color maps did.
+ *
+ */
+static colorPalette default_palette = {2, default_sea_stops, 2, default_land_stops, 1, 1, {255, 0, 0}};
+
+
+
+/**
+ * @brief Linearly interpolates the color of the given gradient at the given position.
+ *
+ * @param nb_stops (int) : the number of stops of the gradient.
+ * @param stops (paletteStop[]) : the stops of the gradient, by increasing position.
+ * @param position (double) : the position in the gradient. Out of the stops range, the color of the nearest stop is used.
+ * @return color : the interpolated color, black if the gradient has no stop.
+ */
+static color gradientColor(int nb_stops, paletteStop stops[nb_stops], double position)
+{
+    color black = {0, 0, 0};
+
+    if (nb_stops == 0)
+    {
+        return black;
+    }
+
+    if (position <= stops[0].position)
+    {
+        return stops[0].color;
+    }
+
+    for (int k = 0; k < nb_stops - 1; k++)
+    {
+        if (position < stops[k + 1].position)
+        {
+            color c1 = stops[k].color;
+            color c2 = stops[k + 1].color;
+            double t = (position - stops[k].position) / (stops[k + 1].position - stops[k].position);
+
+            color res;
+
+            res.red = (uint8_t) (c1.red + t * (c2.red - c1.red) + 0.5);
+            res.green = (uint8_t) (c1.green + t * (c2.green - c1.green) + 0.5);
+            res.blue = (uint8_t) (c1.blue + t * (c2.blue - c1.blue) + 0.5);
+
+            return res;
+        }
+    }
+
+    return stops[nb_stops - 1].color;
+}
+
+
+
+
+
+colorPalette* newColorPalette(int nb_sea_stops, paletteStop sea_stops[nb_sea_stops], int nb_land_stops, paletteStop land_stops[nb_land_stops])
+{
+    colorPalette* new_palette = calloc(1, sizeof(colorPalette));
+
+    new_palette->nb_sea_stops = nb_sea_stops;
+    new_palette->nb_land_stops = nb_land_stops;
+
+    // Copy the stops to ensure dynamic allocation
+    new_palette->sea_stops = calloc(nb_sea_stops, sizeof(paletteStop));
+    for (int k = 0; k < nb_sea_stops; k++)
+    {
+        new_palette->sea_stops[k] = sea_stops[k];
+    }
+
+    new_palette->land_stops = calloc(nb_land_stops, sizeof(paletteStop));
+    for (int k = 0; k < nb_land_stops; k++)
+    {
+        new_palette->land_stops[k] = land_stops[k];
+    }
+
+    return new_palette;
+}
+
+
+
+colorPalette* newDefaultColorPalette()
+{
+    colorPalette* new_palette = newColorPalette(default_palette.nb_sea_stops, default_palette.sea_stops, default_palette.nb_land_stops,
+                                                    default_palette.land_stops);
+
+    new_palette->land_from_min = default_palette.land_from_min;
+    new_palette->marks_zero = default_palette.marks_zero;
+    new_palette->zero_color = default_palette.zero_color;
+
+    return new_palette;
+}
+
+
+
+
+
+color getPaletteColor(colorPalette* palette, double value, double sea_level, double min_value, double max_value)
+{
+    if (palette == NULL)
+    {
+        palette = &default_palette;
+    }
+
+    if (palette->marks_zero && value == 0)
+    {
+        return palette->zero_color;
+    }
+
+    if (value <= sea_level)
+    {
+        double position = sea_level > min_value ? (value - min_value) / (sea_level - min_value) : 1.;
+
+        return gradientColor(palette->nb_sea_stops, palette->sea_stops, position);
+    }
+    else
+    {
+        double land_start = palette->land_from_min ? min_value : sea_level;
+        double position = max_value > land_start ? (value - land_start) / (max_value - land_start) : 0.;
+
+        return gradientColor(palette->nb_land_stops, palette->land_stops, position);
+    }
+}
+
+
+
+colorLUT* newColorLUT(colorPalette* palette, int nb_entries, double sea_level, double min_value, double max_value)
+{
+    colorLUT* new_lut = calloc(1, sizeof(colorLUT));
+
+    // Same resolution on both ranges, with at least one entry for each
+    int nb_sea_entries = nb_entries / 2;
+
+    if (max_value > min_value)
+    {
+        double sea_fraction = (sea_level - min_value) / (max_value - min_value);
+
+        sea_fraction = sea_fraction < 0. ? 0. : sea_fraction;
+        sea_fraction = sea_fraction > 1. ? 1. : sea_fraction;
+
+        nb_sea_entries = (int) (sea_fraction * nb_entries + 0.5);
+    }
+
+    nb_sea_entries = nb_sea_entries > nb_entries - 1 ? nb_entries - 1 : nb_sea_entries;
+    nb_sea_entries = nb_sea_entries < 1 ? 1 : nb_sea_entries;
+
+    int nb_land_entries = nb_entries - nb_sea_entries;
+
+    new_lut->nb_entries = nb_entries;
+    new_lut->nb_sea_entries = nb_sea_entries;
+    new_lut->entries = calloc(nb_entries, sizeof(color));
+    new_lut->min_value = min_value;
+    new_lut->sea_level = sea_level;
+
+    colorPalette* marks_palette = palette != NULL ? palette : &default_palette;
+    new_lut->marks_zero = marks_palette->marks_zero;
+    new_lut->zero_color = marks_palette->zero_color;
+
+    // An empty range only needs its first entry
+    new_lut->sea_scale = sea_level > min_value ? nb_sea_entries / (sea_level - min_value) : 0.;
+    new_lut->land_scale = max_value > sea_level ? nb_land_entries / (max_value - sea_level) : 0.;
+
+    for (int k = 0; k < nb_sea_entries; k++)
+    {
+        double value = sea_level > min_value ? min_value + (k + 0.5) / new_lut->sea_scale : sea_level;
+
+        new_lut->entries[k] = getPaletteColor(palette, value, sea_level, min_value, max_value);
+    }
+
+    for (int k = 0; k < nb_land_entries; k++)
+    {
+        double value = max_value > sea_level ? sea_level + (k + 0.5) / new_lut->land_scale : max_value;
+
+        // A land entry is never sampled on the sea level itself
+        if (value <= sea_level)
+        {
+            value = nextafter(sea_level, INFINITY);
+        }
+
+        new_lut->entries[nb_sea_entries + k] = getPaletteColor(palette, value, sea_level, min_value, max_value);
+    }
+
+    return new_lut;
+}
+
+
+
+
+
+void freeColorPalette(colorPalette* palette)
+{
+    if (palette != NULL)
+    {
+        free(palette->sea_stops);
+        free(palette->land_stops);
+        free(palette);
+    }
+}
+
+
+
+void freeColorLUT(colorLUT* lut)
+{
+    if (lut != NULL)
+    {
+        free(lut->entries);
+        free(lut);
+    }
+}
@@ -0,0 +1,199 @@
+/**
+ * @file generatorContext.c
+ * @author Zyno and BlueNZ
+ * @brief generatorContext structure and counter-based random functions implementation
+ * @version 0.2
+ * @date 2024-06-19
+ *
+ */
+
+#include <malloc.h>
+#include <stdlib.h>
+
+#include "generatorContext.h"
+
+/**
+ * @brief The golden ratio increment of SplitMix64.
+ *
+ */
+#define GOLDEN_GAMMA 0x9e3779b97f4a7c15ULL
+
+
+
+/**
+ * @brief The SplitMix64 finalizer : a bijective mix of the 64 bits of z.
+ *
+ * @param z (uint64_t) : the value to mix.
+ * @return uint64_t : the mixed value.
+ */
+static uint64_t mix64(uint64_t z)
+{
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+/**
+ * @brief Folds one more key in the given hash. Two different keys always give two different results for the same hash.
+ *
+ * @param hash (uint64_t) : the hash of the previous keys.
+ * @param key (int) : the key to fold in. Can be negative.
+ * @return uint64_t : the new hash.
+ */
+static uint64_t combineKey(uint64_t hash, int key)
+{
+    return mix64(hash + GOLDEN_GAMMA + (uint64_t) (uint32_t) key);
+}
+
+/**
+ * @brief Builds a context from the given one with new keys, and computes its hash. The options are kept.
+ *
+ * @param base (generatorContext*) : the pointer to the context to derive from.
+ * @param chunk_x (int) : the width index of the chunk.
+ * @param chunk_y (int) : the height index of the chunk.
+ * @param layer (int) : the index of the layer.
+ * @return generatorContext : the context.
+ */
+static generatorContext buildContext(generatorContext* base, int chunk_x, int chunk_y, int layer)
+{
+    generatorContext context = *base;
+    uint64_t seed = context.seed;
+
+    context.chunk_x = chunk_x;
+    context.chunk_y = chunk_y;
+    context.layer = layer;
+
+    uint64_t key = mix64(seed + GOLDEN_GAMMA);
+    key = combineKey(key, chunk_x);
+    key = combineKey(key, chunk_y);
+    key = combineKey(key, layer);
+    context.key = key;
+
+    return context;
+}
+
+
+
+
+
+generatorOptions getDefaultGeneratorOptions()
+{
+    generatorOptions options;
+
+    options.gradient_source = STORED_GRADIENTS;
+    options.nb_workers = 1;
+    options.pool = NULL;
+    options.perlin_tables = NULL;
+    options.arena = NULL;
+    options.chunk_views = 0;
+    options.chunk_retention = KEEP_FULL_CHUNKS;
+    options.palette = NULL;
+
+    return options;
+}
+
+
+
+generatorContext* newGeneratorContext(uint64_t seed)
+{
+    generatorContext* new_context = calloc(1, sizeof(generatorContext));
+
+    new_context->seed = seed;
+    new_context->options = getDefaultGeneratorOptions();
+
+    *new_context = buildContext(new_context, 0, 0, 0);
+
+    return new_context;
+}
+
+
+
+generatorContext getChunkContext(generatorContext* context, int chunk_x, int chunk_y)
+{
+    return buildContext(context, chunk_x, chunk_y, CHUNK_LAYER_KEY);
+}
+
+
+
+generatorContext getLayerContext(generatorContext* context, int layer)
+{
+    return buildContext(context, context->chunk_x, context->chunk_y, layer);
+}
+
+
+
+generatorContext getLatticeContext(generatorContext* context, int octave)
+{
+    generatorContext lattice_context = buildContext(context, 0, 0, octave);
+
+    // Otherwise the lattice of an octave would draw the same values as the layer of the chunk (0, 0)
+    lattice_context.key = combineKey(lattice_context.key, LATTICE_DOMAIN_KEY);
+
+    return lattice_context;
+}
+
+
+
+
+
+uint64_t getRandomBits(generatorContext* context, int cell_x, int cell_y, unsigned int draw)
+{
+    uint64_t bits = combineKey(context->key, cell_x);
+    bits = combineKey(bits, cell_y);
+
+    return mix64(bits + (uint64_t) draw * GOLDEN_GAMMA);
+}
+
+
+
+double getRandomUniform(generatorContext* context, int cell_x, int cell_y, unsigned int draw)
+{
+    // The 53 upper bits fill exactly the mantissa of a double.
+    return (double) (getRandomBits(context, cell_x, cell_y, draw) >> 11) * (1. / 9007199254740992.);
+}
+
+
+
+
+
+threadPool* acquireThreadPool(generatorContext* context)
+{
+    if (context == NULL)
+    {
+        return NULL;
+    }
+
+    if (context->options.pool != NULL)
+    {
+        return context->options.pool;
+    }
+
+    if (context->options.nb_workers > 1)
+    {
+        return newThreadPool(context->options.nb_workers - 1);
+    }
+
+    return NULL;
+}
+
+
+
+void releaseThreadPool(generatorContext* context, threadPool* pool)
+{
+    if (context == NULL || pool != context->options.pool)
+    {
+        freeThreadPool(pool);
+    }
+}
+
+
+
+
+
+void freeGeneratorContext(generatorContext* context)
+{
+    if (context != NULL)
+    {
+        free(context);
+    }
+}
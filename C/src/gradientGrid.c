@@ -14,10 +14,22 @@
 
 #include "loadingBar.h"
 #include "gradientGrid.h"
+#include "textFormat.h"
 
-void setRandomSeed(unsigned int seed)
+vector getRandomGradient(generatorContext* context, int cell_x, int cell_y)
 {
-    srand(seed);
+    vector v;
+
+    // The first draw gives the random signs for x and y values, the second one the x value
+    uint64_t signs = getRandomBits(context, cell_x, cell_y, 0);
+
+    int sign_x = 1 - 2 * (int) (signs & 1);
+    v.x = (gradient_t) (sign_x * getRandomUniform(context, cell_x, cell_y, 1));
+
+    int sign_y = 1 - 2 * (int) ((signs >> 1) & 1);
+    v.y = (gradient_t) (sign_y * sqrt(1. - (double) v.x * v.x));
+
+    return v;
 }
 
 
@@ -31,6 +43,18 @@ vector* getVector(gradientGrid* gradGrid, int width_idx, int height_idx)
         int width = gradGrid->width;
         int height = gradGrid->height;
 
+        if (gradGrid->boundaries != NULL)
+        {
+            printf("%sERROR : a trimmed gradient grid only keeps its boundaries. Use getBoundaryGradient instead.%s\n", RED_COLOR, DEFAULT_COLOR);
+            return NULL;
+        }
+
+        if (gradGrid->gradients == NULL)
+        {
+            printf("%sERROR : a hashed gradient grid does not store its vectors. Use getGradient instead.%s\n", RED_COLOR, DEFAULT_COLOR);
+            return NULL;
+        }
+
         if (width_idx < 0 || width_idx >= width)
         {
             printf("%sERROR : invalid width_idx = %d when reading gradient grid vector. Should be in range [0, %d]%s\n", RED_COLOR, width_idx, width - 1, DEFAULT_COLOR);
@@ -53,10 +77,22 @@ vector* getVector(gradientGrid* gradGrid, int width_idx, int height_idx)
 
 
 
-void regenerateRandomGradGrid(gradientGrid* gradGrid, unsigned int display_loading)
+void regenerateRandomGradGrid(gradientGrid* gradGrid, generatorContext* context, unsigned int display_loading)
 {
     clock_t start_time = clock();
 
+    if (gradGrid->boundaries != NULL)
+    {
+        printf("%sERROR : a trimmed gradient grid only keeps its boundaries : it can not be regenerated.%s\n", RED_COLOR, DEFAULT_COLOR);
+        return;
+    }
+
+    if (gradGrid->gradients == NULL)
+    {
+        printf("%sERROR : a hashed gradient grid does not store any vector to regenerate.%s\n", RED_COLOR, DEFAULT_COLOR);
+        return;
+    }
+
     int width = gradGrid->width;
     int height = gradGrid->height;
 
@@ -65,15 +101,7 @@ void regenerateRandomGradGrid(gradientGrid* gradGrid, unsigned int display_loadi
     {
         for (int j = 0; j < width; j++)
         {
-            vector* v = getVector(gradGrid, j, i);
-
-            // Generating a random sign for x value
-            int sign_x = 1 - 2 * (rand()%2);
-            v->x = sign_x * (double) rand()/RAND_MAX;
-
-            // Generating a random sign for y value
-            int sign_y = 1 - 2 * (rand()%2);
-            v->y = sign_y * sqrt(1. - v->x * v->x);
+            *getVectorUnchecked(gradGrid, j, i) = getRandomGradient(context, j, i);
 
             if (display_loading != 0)
             {
@@ -92,12 +120,13 @@ void regenerateRandomGradGrid(gradientGrid* gradGrid, unsigned int display_loadi
 
 
 
-gradientGrid* newGradGrid(int width, int height)
+gradientGrid* newGradGrid(int width, int height, memoryArena* arena)
 {
-    gradientGrid* new_grad_grid = calloc(1, sizeof(gradientGrid));
+    gradientGrid* new_grad_grid = arenaCalloc(arena, 1, sizeof(gradientGrid));
 
-    vector* gradients = calloc(width * height, sizeof(vector));
+    vector* gradients = arenaCalloc(arena, width * height, sizeof(vector));
 
+    new_grad_grid->arena = arena;
     new_grad_grid->width = width;
     new_grad_grid->height = height;
 
@@ -109,13 +138,32 @@ gradientGrid* newGradGrid(int width, int height)
 
 
 
-gradientGrid* newRandomGradGrid(int width, int height, unsigned int display_loading)
+gradientGrid* newRandomGradGrid(int width, int height, generatorContext* context, unsigned int display_loading)
 {
     // Generating a new gradientGrid with not initialized vectors
-    gradientGrid* new_grad_grid = newGradGrid(width, height);
+    gradientGrid* new_grad_grid = newGradGrid(width, height, context->options.arena);
 
     // Initializing vectors to random ones
-    regenerateRandomGradGrid(new_grad_grid, display_loading);
+    regenerateRandomGradGrid(new_grad_grid, context, display_loading);
+
+    return new_grad_grid;
+}
+
+
+
+gradientGrid* newHashedGradGrid(int width, int height, int origin_x, int origin_y, generatorContext* context)
+{
+    gradientGrid* new_grad_grid = arenaCalloc(context->options.arena, 1, sizeof(gradientGrid));
+
+    new_grad_grid->arena = context->options.arena;
+    new_grad_grid->width = width;
+    new_grad_grid->height = height;
+
+    // No vector is stored : they are derived from the lattice context
+    new_grad_grid->gradients = NULL;
+    new_grad_grid->origin_x = origin_x;
+    new_grad_grid->origin_y = origin_y;
+    new_grad_grid->lattice_context = *context;
 
     return new_grad_grid;
 }
@@ -124,7 +172,7 @@ gradientGrid* newRandomGradGrid(int width, int height, unsigned int display_load
 
 
 
-gradientGrid* newAdjacentGradGrid(gradientGrid* north_grid, gradientGrid* west_grid, unsigned int display_loading)
+gradientGrid* newAdjacentGradGrid(gradientGrid* north_grid, gradientGrid* west_grid, generatorContext* context, unsigned int display_loading)
 {
     clock_t start_time = clock();
 
@@ -193,7 +241,7 @@ gradientGrid* newAdjacentGradGrid(gradientGrid* north_grid, gradientGrid* west_g
     }
 
     // First generates a random grid
-    gradientGrid* new_grad_grid = newRandomGradGrid(width, height, display_grad_grid);
+    gradientGrid* new_grad_grid = newRandomGradGrid(width, height, context, display_grad_grid);
 
     // Then applies boundary conditions for the newly generated grid
     if (north_grid != NULL)
@@ -201,11 +249,7 @@ gradientGrid* newAdjacentGradGrid(gradientGrid* north_grid, gradientGrid* west_g
         clock_t north_start_time = clock();
         for (int j = 0; j < width; j++)
         {
-            vector* vec = getVector(new_grad_grid, j, 0);
-            vector* north_vec = getVector(north_grid, j, height - 1);
-
-            vec->x = north_vec->x;
-            vec->y = north_vec->y;
+            *getVectorUnchecked(new_grad_grid, j, 0) = getGradient(north_grid, j, height - 1);
 
             if (display_loading != 0)
             {
@@ -224,11 +268,7 @@ gradientGrid* newAdjacentGradGrid(gradientGrid* north_grid, gradientGrid* west_g
         clock_t west_start_time = clock();
         for (int i = 0; i < height; i++)
         {
-            vector* vec = getVector(new_grad_grid, 0, i);
-            vector* west_vec = getVector(west_grid, width - 1, i);
-
-            vec->x = west_vec->x;
-            vec->y = west_vec->y;
+            *getVectorUnchecked(new_grad_grid, 0, i) = getGradient(west_grid, width - 1, i);
 
             if (display_loading != 0)
             {
@@ -262,20 +302,99 @@ gradientGrid* newAdjacentGradGrid(gradientGrid* north_grid, gradientGrid* west_g
 
 
 
+vector getBoundaryGradient(gradientGrid* gradGrid, int width_idx, int height_idx)
+{
+    if (height_idx == gradGrid->height - 1)
+    {
+        return gradGrid->boundaries[width_idx];
+    }
+
+    if (width_idx == gradGrid->width - 1)
+    {
+        return gradGrid->boundaries[gradGrid->width + height_idx];
+    }
+
+    vector zero = {0., 0.};
+    return zero;
+}
+
+
+
+void trimGradGrid(gradientGrid* gradGrid)
+{
+    if (gradGrid == NULL || gradGrid->gradients == NULL)
+    {
+        return;
+    }
+
+    int width = gradGrid->width;
+    int height = gradGrid->height;
+
+    // The south row, then the east column
+    vector* boundaries = arenaCalloc(gradGrid->arena, width + height, sizeof(vector));
+
+    for (int j = 0; j < width; j++)
+    {
+        boundaries[j] = *getVectorUnchecked(gradGrid, j, height - 1);
+    }
+
+    for (int i = 0; i < height; i++)
+    {
+        boundaries[width + i] = *getVectorUnchecked(gradGrid, width - 1, i);
+    }
+
+    // The arena owns its structures, and the mapped gradients are unmapped
+    if (gradGrid->mapped_file != NULL)
+    {
+        unmapBinaryFile(gradGrid->mapped_file);
+        gradGrid->mapped_file = NULL;
+    }
+    else if (gradGrid->arena == NULL)
+    {
+        free(gradGrid->gradients);
+    }
+
+    gradGrid->gradients = NULL;
+    gradGrid->boundaries = boundaries;
+}
+
+
+
 gradientGrid* copyGrad(gradientGrid* grad) 
 {
     gradientGrid* res = calloc(1,sizeof(gradientGrid));
 
     res->width=grad->width;
     res->height=grad->height;
+    res->origin_x=grad->origin_x;
+    res->origin_y=grad->origin_y;
+    res->lattice_context=grad->lattice_context;
+
+    if (grad->boundaries != NULL)
+    {
+        // Trimmed gradient grid : only its boundaries to copy
+        res->boundaries = calloc(res->width + res->height, sizeof(vector));
+        for (int k = 0; k < res->width + res->height; k++)
+        {
+            res->boundaries[k] = grad->boundaries[k];
+        }
+
+        return res;
+    }
+
+    if (grad->gradients == NULL)
+    {
+        // Hashed gradient grid : nothing more to copy
+        return res;
+    }
 
     res->gradients = calloc(res->width*res->height,sizeof(vector));
     for (int i=0; i<res->width; i++)
     {
         for (int j=0; j<res->height; j++)
         {
-            vector* vect=copyVect(getVector(grad,i,j));
-            *getVector(res,i,j)=*vect;
+            vector* vect=copyVect(getVectorUnchecked(grad,i,j));
+            *getVectorUnchecked(res,i,j)=*vect;
             free(vect);
         }
     }
@@ -302,6 +421,12 @@ vector* copyVect(vector* vect)
 
 void writeGradientGridFile(gradientGrid* gradGrid, char path[])
 {
+    if (gradGrid->boundaries != NULL)
+    {
+        printf("%sERROR : a trimmed gradient grid only keeps its boundaries : it can not be written at path '%s'%s\n", RED_COLOR, path, DEFAULT_COLOR);
+        return;
+    }
+
     FILE* f = NULL;
 
     f = fopen(path, "w");
@@ -316,25 +441,36 @@ void writeGradientGridFile(gradientGrid* gradGrid, char path[])
 
         fprintf(f, "width=%d\nheight=%d\n", width, height);
 
-        // Writing the values
-        for (int i = 0; i < height; i++)
+        int success = 1;
+
+        // Writing the values, one row at a time
+        textRow* row = newTextRow(2 * TEXT_VALUE_LENGTH * width);
+
+        for (int i = 0; i < height && success; i++)
         {
             for (int j = 0; j < width; j++)
             {
-                vector* vec = getVector(gradGrid, j, i);
-
-                if (j != width - 1)
-                {
-                    fprintf(f, "(% .8lf,% .8lf)\t", vec->x, vec->y);
-                }
-                else
-                {
-                    fprintf(f, "(% .8lf,% .8lf)\n", vec->x, vec->y);
-                }
+                vector vec = getGradient(gradGrid, j, i);
+
+                appendTextChar(row, '(');
+                appendTextFixed(row, vec.x, 8, 1);
+                appendTextChar(row, ',');
+                appendTextFixed(row, vec.y, 8, 1);
+                appendTextChar(row, ')');
+                appendTextChar(row, j != width - 1 ? '\t' : '\n');
             }
+
+            success = writeTextRow(row, f);
         }
 
-        fclose(f);
+        freeTextRow(row);
+
+        success = fclose(f) == 0 && success;
+
+        if (!success)
+        {
+            printf("%sERROR : could not write the gradient grid at path '%s'%s\n", RED_COLOR, path, DEFAULT_COLOR);
+        }
     }
     else
     {
@@ -345,8 +481,116 @@ void writeGradientGridFile(gradientGrid* gradGrid, char path[])
 
 
 
-// TODO : implement reading function if required.
-gradientGrid* readGradientGridFile(char path[]);
+gradientGrid* readGradientGridFile(char path[])
+{
+    mappedBinaryFile* mapped_file = mapBinaryFile(path, BINARY_GRADIENT_GRID, GRADIENT_DTYPE, 2);
+
+    if (mapped_file == NULL)
+    {
+        return NULL;
+    }
+
+    gradientGrid* gradGrid = calloc(1, sizeof(gradientGrid));
+
+    gradGrid->width = mapped_file->header.width;
+    gradGrid->height = mapped_file->header.height;
+    gradGrid->gradients = mapped_file->samples;
+    gradGrid->mapped_file = mapped_file;
+
+    return gradGrid;
+}
+
+
+
+void writeGradientGridBinaryFile(gradientGrid* gradGrid, uint64_t seed, char path[])
+{
+    if (gradGrid->boundaries != NULL)
+    {
+        printf("%sERROR : a trimmed gradient grid only keeps its boundaries : it can not be written at path '%s'%s\n", RED_COLOR, path, DEFAULT_COLOR);
+        return;
+    }
+
+    FILE* f = fopen(path, "wb");
+
+    if (f == NULL)
+    {
+        printf("%sERROR : could not open file in writing mode at path '%s'%s\n", RED_COLOR, path, DEFAULT_COLOR);
+        return;
+    }
+
+    int width = gradGrid->width;
+    int height = gradGrid->height;
+
+    binaryHeader header = initBinaryHeader(BINARY_GRADIENT_GRID, GRADIENT_DTYPE, 2, width, height, seed);
+
+    int success = writeBinaryHeader(f, &header);
+
+    if (gradGrid->gradients != NULL)
+    {
+        success = success && writeBinarySamples(f, GRADIENT_DTYPE, gradGrid->gradients, 2 * (size_t) width * height);
+    }
+    else
+    {
+        // Hashed gradient grid : the vectors are gathered one row at a time
+        vector* row = calloc(width, sizeof(vector));
+
+        for (int i = 0; i < height && success; i++)
+        {
+            for (int j = 0; j < width; j++)
+            {
+                row[j] = getGradient(gradGrid, j, i);
+            }
+
+            success = writeBinarySamples(f, GRADIENT_DTYPE, row, 2 * (size_t) width);
+        }
+
+        free(row);
+    }
+
+    if (!success)
+    {
+        printf("%sERROR : could not write the gradient grid at path '%s'%s\n", RED_COLOR, path, DEFAULT_COLOR);
+    }
+
+    fclose(f);
+}
+
+
+
+gradientGrid* readGradientGridBinaryFile(char path[], binaryHeader* header)
+{
+    FILE* f = fopen(path, "rb");
+
+    if (f == NULL)
+    {
+        printf("%sERROR : could not open file in reading mode at path '%s'%s\n", RED_COLOR, path, DEFAULT_COLOR);
+        return NULL;
+    }
+
+    binaryHeader file_header = initBinaryHeader(BINARY_GRADIENT_GRID, 0, 0, 0, 0, 0);
+    gradientGrid* gradGrid = NULL;
+
+    if (readBinaryHeader(f, BINARY_GRADIENT_GRID, &file_header) && file_header.nb_components == 2)
+    {
+        gradGrid = newGradGrid(file_header.width, file_header.height, NULL);
+
+        if (!readBinaryPayload(f, &file_header, GRADIENT_DTYPE, gradGrid->gradients))
+        {
+            printf("%sERROR : truncated gradient grid binary file at path '%s'%s\n", RED_COLOR, path, DEFAULT_COLOR);
+            freeGradGrid(gradGrid);
+            gradGrid = NULL;
+        }
+    }
+
+    fclose(f);
+
+    if (header != NULL)
+    {
+        *header = file_header;
+    }
+
+    return gradGrid;
+}
 
 
 
@@ -354,6 +598,12 @@ gradientGrid* readGradientGridFile(char path[]);
 
 void printGradientGrid(gradientGrid* gradGrid)
 {
+    if (gradGrid->boundaries != NULL)
+    {
+        printf("%sERROR : a trimmed gradient grid only keeps its boundaries : it can not be printed.%s\n", RED_COLOR, DEFAULT_COLOR);
+        return;
+    }
+
     int width = gradGrid->width;
     int height = gradGrid->height;
 
@@ -364,9 +614,9 @@ void printGradientGrid(gradientGrid* gradGrid)
     {
         for (int j = 0; j < width; j++)
         {
-            vector* v = getVector(gradGrid, j, i);
+            vector v = getGradient(gradGrid, j, i);
 
-            printf("(%lf, %lf)   ", v->x, v->y);
+            printf("(%lf, %lf)   ", v.x, v.y);
         }
         printf("\n");
     }
@@ -378,14 +628,24 @@ void printGradientGrid(gradientGrid* gradGrid)
 
 void freeGradGrid(gradientGrid* gradGrid)
 {
-    if (gradGrid != NULL)
+    // The arena owns its structures
+    if (gradGrid != NULL && gradGrid->arena == NULL)
     {
-        // Every gradients will be free'd.
-        if (gradGrid->gradients != NULL)
+        // Every gradients will be free'd, or unmapped.
+        if (gradGrid->mapped_file != NULL)
+        {
+            unmapBinaryFile(gradGrid->mapped_file);
+        }
+        else if (gradGrid->gradients != NULL)
         {
             free(gradGrid->gradients);
         }
 
+        if (gradGrid->boundaries != NULL)
+        {
+            free(gradGrid->boundaries);
+        }
+
         free(gradGrid);
     }
 }
@@ -0,0 +1,1022 @@
+/**
+ * @file imageFile.c
+ * @author Zyno and BlueNZ
+ * @brief image exporters of the RGB8 color arrays implementation
+ * @version 0.2
+ * @date 2024-06-19
+ *
+ */
+
+#include <malloc.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "loadingBar.h"
+#include "imageFile.h"
+
+int writePPMFile(color* colors, int width, int height, char path[])
+{
+    FILE* f = fopen(path, "wb");
+
+    if (f == NULL)
+    {
+        printf("%sERROR : could not open file in writing mode at path '%s'%s\n", RED_COLOR, path, DEFAULT_COLOR);
+        return 0;
+    }
+
+    fprintf(f, "P6\n%d %d\n255\n", width, height);
+
+    // The colors are packed bytes in the order of the format : they are written in a single block
+    size_t nb_colors = (size_t) width * height;
+    int success = fwrite(colors, sizeof(color), nb_colors, f) == nb_colors;
+
+    if (fclose(f) != 0 || !success)
+    {
+        printf("%sERROR : could not write the file at path '%s'%s\n", RED_COLOR, path, DEFAULT_COLOR);
+        return 0;
+    }
+
+    return 1;
+}
+
+
+
+
+
+#define PNG_HASH_SIZE (1 << 15) /**< the number of entries of the hash table of the LZ77 matches*/
+#define PNG_WINDOW_SIZE 32768   /**< the maximum distance of a deflate match*/
+#define PNG_MAX_CHAIN 8         /**< the maximum number of previous positions tried for a match*/
+#define PNG_MAX_SYMBOLS 286     /**< the number of symbols of the largest deflate alphabet, the literals and lengths one*/
+#define PNG_MATCH_TOKEN (1u << 31)  /**< the flag of the LZ77 tokens that are matches, and not literals*/
+
+/**
+ * @brief The base lengths of the deflate length symbols, from 257 to 285.
+ *
+ */
+static const int length_bases[29] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131,
+                                     163, 195, 227, 258};
+
+/**
+ * @brief The numbers of extra bits of the deflate length symbols, from 257 to 285.
+ *
+ */
+static const int length_extra_bits[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+
+/**
+ * @brief The base distances of the deflate distance symbols.
+ *
+ */
+static const int distance_bases[30] = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537,
+                                       2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+
+/**
+ * @brief The numbers of extra bits of the deflate distance symbols.
+ *
+ */
+static const int distance_extra_bits[30] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12,
+                                            13, 13};
+
+/**
+ * @brief A PNG file being written : the bit stream of the compressed image data of its current `IDAT` chunk, and the checksums.
+ *
+ */
+struct pngWriter
+{
+    FILE* f; /**< the file, opened in binary writing mode*/
+    uint32_t crc_table[256]; /**< the CRC-32 of every byte, for the checksums of the chunks*/
+    uint32_t adler_a; /**< the first sum of the Adler-32 checksum of the uncompressed data*/
+    uint32_t adler_b; /**< the second sum of the Adler-32 checksum of the uncompressed data*/
+    unsigned char* buffer; /**< the compressed bytes of the current chunk*/
+    size_t buffer_used; /**< the number of bytes in the buffer*/
+    uint32_t bit_buffer; /**< the bits not forming a whole byte yet, first ones in the lowest bits*/
+    int nb_bits; /**< the number of bits in the bit buffer*/
+    int success; /**< `0` once a write failed*/
+};
+
+
+
+/**
+ * @brief Fills the CRC-32 table of the PNG chunks (reflected polynomial `0xEDB88320`).
+ *
+ * @param table (uint32_t[256]) : the table to fill.
+ */
+static void initCrcTable(uint32_t table[256])
+{
+    for (uint32_t n = 0; n < 256; n++)
+    {
+        uint32_t c = n;
+
+        for (int k = 0; k < 8; k++)
+        {
+            c = c & 1 ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+        }
+
+        table[n] = c;
+    }
+}
+
+
+
+/**
+ * @brief Updates a running CRC-32 with the given bytes. The running CRC starts at `0xFFFFFFFF`, and is inverted at the end.
+ *
+ * @param table (uint32_t[256]) : the CRC-32 table.
+ * @param crc (uint32_t) : the running CRC.
+ * @param bytes (const unsigned char*) : the bytes.
+ * @param nb_bytes (size_t) : the number of bytes.
+ * @return uint32_t : the updated running CRC.
+ */
+static uint32_t updateCrc(uint32_t table[256], uint32_t crc, const unsigned char* bytes, size_t nb_bytes)
+{
+    for (size_t k = 0; k < nb_bytes; k++)
+    {
+        crc = table[(crc ^ bytes[k]) & 0xFF] ^ (crc >> 8);
+    }
+
+    return crc;
+}
+
+
+
+/**
+ * @brief Updates the Adler-32 checksum of the writer with the given uncompressed bytes.
+ *
+ * @param writer (struct pngWriter*) : the pointer to the writer.
+ * @param bytes (const unsigned char*) : the bytes.
+ * @param nb_bytes (size_t) : the number of bytes.
+ */
+static void updateAdler(struct pngWriter* writer, const unsigned char* bytes, size_t nb_bytes)
+{
+    uint32_t a = writer->adler_a;
+    uint32_t b = writer->adler_b;
+
+    while (nb_bytes > 0)
+    {
+        // 5552 is the largest number of bytes whose sums can not overflow before the modulo
+        size_t nb_summed = nb_bytes < 5552 ? nb_bytes : 5552;
+
+        for (size_t k = 0; k < nb_summed; k++)
+        {
+            a += bytes[k];
+            b += a;
+        }
+
+        a %= 65521;
+        b %= 65521;
+
+        bytes += nb_summed;
+        nb_bytes -= nb_summed;
+    }
+
+    writer->adler_a = a;
+    writer->adler_b = b;
+}
+
+
+
+/**
+ * @brief Puts the given unsigned integer in big-endian, the order of every number of a PNG file.
+ *
+ * @param bytes (unsigned char[4]) : the destination bytes.
+ * @param value (uint32_t) : the integer.
+ */
+static void putBigEndian32(unsigned char bytes[4], uint32_t value)
+{
+    bytes[0] = value >> 24;
+    bytes[1] = value >> 16;
+    bytes[2] = value >> 8;
+    bytes[3] = value;
+}
+
+
+
+/**
+ * @brief Writes a PNG chunk : its length, its type, its data and the CRC-32 of its type and data.
+ *
+ * @param writer (struct pngWriter*) : the pointer to the writer.
+ * @param type (const char[]) : the 4 letters type of the chunk.
+ * @param data (const unsigned char*) : the data of the chunk. Can be `NULL` if it is empty.
+ * @param nb_bytes (size_t) : the number of bytes of the data.
+ */
+static void writePNGChunk(struct pngWriter* writer, const char type[], const unsigned char* data, size_t nb_bytes)
+{
+    unsigned char length[4];
+    unsigned char crc_bytes[4];
+
+    putBigEndian32(length, (uint32_t) nb_bytes);
+
+    uint32_t crc = updateCrc(writer->crc_table, 0xFFFFFFFFu, (const unsigned char*) type, 4);
+    crc = updateCrc(writer->crc_table, crc, data, nb_bytes);
+    putBigEndian32(crc_bytes, crc ^ 0xFFFFFFFFu);
+
+    if (fwrite(length, 1, 4, writer->f) != 4 || fwrite(type, 1, 4, writer->f) != 4
+        || (nb_bytes > 0 && fwrite(data, 1, nb_bytes, writer->f) != nb_bytes) || fwrite(crc_bytes, 1, 4, writer->f) != 4)
+    {
+        writer->success = 0;
+    }
+}
+
+
+
+/**
+ * @brief Appends bits to the compressed stream, first bit first (the order of the deflate headers and extra bits).
+ *
+ * @param writer (struct pngWriter*) : the pointer to the writer.
+ * @param bits (uint32_t) : the bits, first one in the lowest bit.
+ * @param nb_bits (int) : the number of bits, at most 16.
+ */
+static void putBits(struct pngWriter* writer, uint32_t bits, int nb_bits)
+{
+    writer->bit_buffer |= bits << writer->nb_bits;
+    writer->nb_bits += nb_bits;
+
+    while (writer->nb_bits >= 8)
+    {
+        writer->buffer[writer->buffer_used++] = writer->bit_buffer & 0xFF;
+        writer->bit_buffer >>= 8;
+        writer->nb_bits -= 8;
+    }
+}
+
+
+
+/**
+ * @brief Pads the compressed stream with zero bits up to the next byte.
+ *
+ * @param writer (struct pngWriter*) : the pointer to the writer.
+ */
+static void alignBits(struct pngWriter* writer)
+{
+    if (writer->nb_bits > 0)
+    {
+        putBits(writer, 0, 8 - writer->nb_bits);
+    }
+}
+
+
+
+/**
+ * @brief Appends a Huffman code to the compressed stream. Unlike the other bits, the codes are packed from their most significant bit.
+ *
+ * @param writer (struct pngWriter*) : the pointer to the writer.
+ * @param code (uint32_t) : the code.
+ * @param length (int) : the number of bits of the code.
+ */
+static void putHuffmanCode(struct pngWriter* writer, uint32_t code, int length)
+{
+    uint32_t reversed = 0;
+
+    for (int k = 0; k < length; k++)
+    {
+        reversed = (reversed << 1) | ((code >> k) & 1);
+    }
+
+    putBits(writer, reversed, length);
+}
+
+
+
+/**
+ * @brief Builds the lengths of the Huffman codes of the given symbol frequencies, by merging the two least frequent nodes until a single
+ * tree remains. While the longest code exceeds the given maximum length, the frequencies are halved and the tree is built again.
+ *
+ * @param frequencies (const int*) : the frequency of each symbol.
+ * @param nb_symbols (int) : the number of symbols, at most `PNG_MAX_SYMBOLS`.
+ * @param max_length (int) : the maximum length of a code.
+ * @param lengths (int*) : the destination lengths, `0` for the symbols that do not appear.
+ *
+ * @note At least two symbols get a code, so that every code is complete.
+ */
+static void buildCodeLengths(const int* frequencies, int nb_symbols, int max_length, int* lengths)
+{
+    int weights[2 * PNG_MAX_SYMBOLS];
+    int parents[2 * PNG_MAX_SYMBOLS];
+    int nodes[PNG_MAX_SYMBOLS];
+    int nb_used = 0;
+
+    for (int s = 0; s < nb_symbols; s++)
+    {
+        weights[s] = frequencies[s];
+        nb_used += frequencies[s] > 0;
+    }
+
+    for (int s = 0; s < nb_symbols && nb_used < 2; s++)
+    {
+        if (weights[s] == 0)
+        {
+            weights[s] = 1;
+            nb_used += 1;
+        }
+    }
+
+    while (1)
+    {
+        int nb_nodes = 0;
+
+        for (int s = 0; s < nb_symbols; s++)
+        {
+            parents[s] = -1;
+
+            if (weights[s] > 0)
+            {
+                nodes[nb_nodes++] = s;
+            }
+        }
+
+        int new_node = nb_symbols;
+
+        while (nb_nodes > 1)
+        {
+            // The indexes in `nodes` of the two lightest nodes
+            int first = weights[nodes[0]] <= weights[nodes[1]] ? 0 : 1;
+            int second = 1 - first;
+
+            for (int k = 2; k < nb_nodes; k++)
+            {
+                if (weights[nodes[k]] < weights[nodes[first]])
+                {
+                    second = first;
+                    first = k;
+                }
+                else if (weights[nodes[k]] < weights[nodes[second]])
+                {
+                    second = k;
+                }
+            }
+
+            weights[new_node] = weights[nodes[first]] + weights[nodes[second]];
+            parents[new_node] = -1;
+            parents[nodes[first]] = new_node;
+            parents[nodes[second]] = new_node;
+
+            // The new node replaces the first one, and the last node the second one
+            nodes[first] = new_node;
+            nodes[second] = nodes[nb_nodes - 1];
+            nb_nodes -= 1;
+            new_node += 1;
+        }
+
+        int longest = 0;
+
+        for (int s = 0; s < nb_symbols; s++)
+        {
+            lengths[s] = 0;
+
+            if (weights[s] > 0)
+            {
+                for (int node = s; parents[node] >= 0; node = parents[node])
+                {
+                    lengths[s] += 1;
+                }
+
+                longest = lengths[s] > longest ? lengths[s] : longest;
+            }
+        }
+
+        if (longest <= max_length)
+        {
+            return;
+        }
+
+        for (int s = 0; s < nb_symbols; s++)
+        {
+            weights[s] = (weights[s] + 1) / 2;
+        }
+    }
+}
+
+
+
+/**
+ * @brief Builds the canonical Huffman codes of deflate from their lengths : the codes of a given length are consecutive, by increasing
+ * symbol, and follow the codes of the shorter lengths.
+ *
+ * @param lengths (const int*) : the length of the code of each symbol, at most 15.
+ * @param nb_symbols (int) : the number of symbols.
+ * @param codes (uint32_t*) : the destination codes.
+ */
+static void buildCanonicalCodes(const int* lengths, int nb_symbols, uint32_t* codes)
+{
+    int nb_codes[16] = {0};
+    uint32_t next_codes[16] = {0};
+
+    for (int s = 0; s < nb_symbols; s++)
+    {
+        nb_codes[lengths[s]] += 1;
+    }
+
+    nb_codes[0] = 0;
+
+    for (int length = 1; length < 16; length++)
+    {
+        next_codes[length] = (next_codes[length - 1] + nb_codes[length - 1]) << 1;
+    }
+
+    for (int s = 0; s < nb_symbols; s++)
+    {
+        if (lengths[s] > 0)
+        {
+            codes[s] = next_codes[lengths[s]]++;
+        }
+    }
+}
+
+
+
+/**
+ * @brief Gets the index of the deflate length symbol of the given match length (the symbol is `257 +` the index).
+ *
+ * @param length (int) : the length of the match, in `[3, 258]`.
+ * @return int : the index of the symbol, in `[0, 28]`.
+ */
+static int getLengthIdx(int length)
+{
+    int length_idx = 28;
+
+    while (length_bases[length_idx] > length)
+    {
+        length_idx -= 1;
+    }
+
+    return length_idx;
+}
+
+
+
+/**
+ * @brief Gets the deflate distance symbol of the given match distance.
+ *
+ * @param distance (int) : the distance of the match, in `[1, PNG_WINDOW_SIZE]`.
+ * @return int : the symbol, in `[0, 29]`.
+ */
+static int getDistanceIdx(int distance)
+{
+    int distance_idx = 29;
+
+    while (distance_bases[distance_idx] > distance)
+    {
+        distance_idx -= 1;
+    }
+
+    return distance_idx;
+}
+
+
+
+/**
+ * @brief Appends the given bytes to the compressed stream as stored deflate blocks, of at most 65535 bytes each.
+ *
+ * @param writer (struct pngWriter*) : the pointer to the writer.
+ * @param bytes (const unsigned char*) : the bytes.
+ * @param nb_bytes (size_t) : the number of bytes.
+ * @param is_last (int) : whether they end the stream.
+ */
+static void deflateStored(struct pngWriter* writer, const unsigned char* bytes, size_t nb_bytes, int is_last)
+{
+    do
+    {
+        uint32_t block_size = nb_bytes < 65535 ? nb_bytes : 65535;
+
+        putBits(writer, is_last && block_size == nb_bytes, 1);
+        putBits(writer, 0, 2);
+        alignBits(writer);
+
+        putBits(writer, block_size, 16);
+        putBits(writer, ~block_size & 0xFFFF, 16);
+
+        memcpy(writer->buffer + writer->buffer_used, bytes, block_size);
+        writer->buffer_used += block_size;
+
+        bytes += block_size;
+        nb_bytes -= block_size;
+    } while (nb_bytes > 0);
+}
+
+
+
+/**
+ * @brief Gets the hash of the 3 bytes starting at the given position, the key of the LZ77 matches.
+ *
+ * @param bytes (const unsigned char*) : the pointer to the first byte.
+ * @return int : the hash, in `[0, PNG_HASH_SIZE - 1]`.
+ */
+static int getMatchHash(const unsigned char* bytes)
+{
+    return ((bytes[0] << 10) ^ (bytes[1] << 5) ^ bytes[2]) & (PNG_HASH_SIZE - 1);
+}
+
+
+
+/**
+ * @brief Finds the LZ77 matches of the given bytes greedily : each position takes the longest match among the last `PNG_MAX_CHAIN`
+ * positions sharing its hash.
+ *
+ * @param bytes (const unsigned char*) : the bytes.
+ * @param nb_bytes (int) : the number of bytes.
+ * @param head (int[PNG_HASH_SIZE]) : the last position of each hash.
+ * @param previous (int*) : the previous position of the same hash of each position, `nb_bytes` entries.
+ * @param tokens (uint32_t*) : the destination tokens, `nb_bytes` entries at most : a literal byte, or `PNG_MATCH_TOKEN` with
+ * the length of the match shifted by 16 bits and its distance.
+ * @return int : the number of tokens.
+ */
+static int findMatches(const unsigned char* bytes, int nb_bytes, int head[PNG_HASH_SIZE], int* previous, uint32_t* tokens)
+{
+    for (int k = 0; k < PNG_HASH_SIZE; k++)
+    {
+        head[k] = -1;
+    }
+
+    int nb_tokens = 0;
+    int position = 0;
+
+    while (position < nb_bytes)
+    {
+        int best_length = 0;
+        int best_distance = 0;
+
+        if (position + 3 <= nb_bytes)
+        {
+            int hash = getMatchHash(bytes + position);
+            int candidate = head[hash];
+            int max_length = nb_bytes - position < 258 ? nb_bytes - position : 258;
+
+            for (int depth = 0; depth < PNG_MAX_CHAIN && candidate >= 0 && position - candidate <= PNG_WINDOW_SIZE; depth++)
+            {
+                int length = 0;
+
+                while (length < max_length && bytes[candidate + length] == bytes[position + length])
+                {
+                    length += 1;
+                }
+
+                if (length > best_length)
+                {
+                    best_length = length;
+                    best_distance = position - candidate;
+
+                    if (length == max_length)
+                    {
+                        break;
+                    }
+                }
+
+                candidate = previous[candidate];
+            }
+
+            previous[position] = head[hash];
+            head[hash] = position;
+        }
+
+        if (best_length >= 3)
+        {
+            tokens[nb_tokens++] = PNG_MATCH_TOKEN | best_length << 16 | best_distance;
+
+            // The positions inside the match can still start later matches
+            for (int k = position + 1; k < position + best_length && k + 3 <= nb_bytes; k++)
+            {
+                int hash = getMatchHash(bytes + k);
+
+                previous[k] = head[hash];
+                head[hash] = k;
+            }
+
+            position += best_length;
+        }
+        else
+        {
+            tokens[nb_tokens++] = bytes[position];
+            position += 1;
+        }
+    }
+
+    return nb_tokens;
+}
+
+
+
+/**
+ * @brief The order in which the lengths of the code length codes are written in a deflate block header.
+ *
+ */
+static const int code_length_order[19] = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+
+/**
+ * @brief Appends the given bytes to the compressed stream as a single deflate block with Huffman codes built for it, after a LZ77 pass
+ * (see `findMatches`). The block is stored instead if it would be smaller.
+ *
+ * @param writer (struct pngWriter*) : the pointer to the writer.
+ * @param bytes (const unsigned char*) : the bytes.
+ * @param nb_bytes (size_t) : the number of bytes.
+ * @param is_last (int) : whether they end the stream.
+ * @param head (int[PNG_HASH_SIZE]) : the hash table of the LZ77 pass.
+ * @param previous (int*) : the chains of the LZ77 pass, `nb_bytes` entries.
+ * @param tokens (uint32_t*) : the tokens of the LZ77 pass, `nb_bytes` entries.
+ */
+static void deflateHuffman(struct pngWriter* writer, const unsigned char* bytes, size_t nb_bytes, int is_last,
+                            int head[PNG_HASH_SIZE], int* previous, uint32_t* tokens)
+{
+    int nb_tokens = findMatches(bytes, (int) nb_bytes, head, previous, tokens);
+
+    int literal_frequencies[286] = {0};
+    int distance_frequencies[30] = {0};
+
+    for (int k = 0; k < nb_tokens; k++)
+    {
+        if (tokens[k] & PNG_MATCH_TOKEN)
+        {
+            literal_frequencies[257 + getLengthIdx(tokens[k] >> 16 & 0x1FF)] += 1;
+            distance_frequencies[getDistanceIdx(tokens[k] & 0xFFFF)] += 1;
+        }
+        else
+        {
+            literal_frequencies[tokens[k]] += 1;
+        }
+    }
+
+    literal_frequencies[256] = 1;
+
+    // Both alphabets have their lengths written one after the other : lengths = literal and length codes, then distance codes
+    int lengths[286 + 30];
+    uint32_t literal_codes[286];
+    uint32_t distance_codes[30];
+
+    buildCodeLengths(literal_frequencies, 286, 15, lengths);
+    buildCodeLengths(distance_frequencies, 30, 15, lengths + 286);
+
+    int nb_literal_codes = 286;
+    int nb_distance_codes = 30;
+
+    while (nb_literal_codes > 257 && lengths[nb_literal_codes - 1] == 0)
+    {
+        nb_literal_codes -= 1;
+    }
+
+    while (nb_distance_codes > 1 && lengths[286 + nb_distance_codes - 1] == 0)
+    {
+        nb_distance_codes -= 1;
+    }
+
+    buildCanonicalCodes(lengths, 286, literal_codes);
+    buildCanonicalCodes(lengths + 286, 30, distance_codes);
+
+    // The written lengths, with the runs encoded by the symbols 16 (repeat the previous length), 17 and 18 (repeat a zero length)
+    int written_lengths[286 + 30];
+    int nb_written = 0;
+
+    for (int k = 0; k < nb_literal_codes; k++)
+    {
+        written_lengths[nb_written++] = lengths[k];
+    }
+
+    for (int k = 0; k < nb_distance_codes; k++)
+    {
+        written_lengths[nb_written++] = lengths[286 + k];
+    }
+
+    int run_symbols[286 + 30];
+    int run_extras[286 + 30];
+    int nb_runs = 0;
+
+    for (int k = 0; k < nb_written;)
+    {
+        int run = 1;
+
+        while (k + run < nb_written && written_lengths[k + run] == written_lengths[k])
+        {
+            run += 1;
+        }
+
+        if (written_lengths[k] == 0 && run >= 3)
+        {
+            run = run < 138 ? run : 138;
+            run_symbols[nb_runs] = run >= 11 ? 18 : 17;
+            run_extras[nb_runs++] = run >= 11 ? run - 11 : run - 3;
+        }
+        else if (written_lengths[k] != 0 && run >= 4)
+        {
+            run = run < 7 ? run : 7;
+            run_symbols[nb_runs] = written_lengths[k];
+            run_extras[nb_runs++] = 0;
+            run_symbols[nb_runs] = 16;
+            run_extras[nb_runs++] = run - 4;
+        }
+        else
+        {
+            run = 1;
+            run_symbols[nb_runs] = written_lengths[k];
+            run_extras[nb_runs++] = 0;
+        }
+
+        k += run;
+    }
+
+    int run_frequencies[19] = {0};
+    int run_lengths[19];
+    uint32_t run_codes[19];
+
+    for (int k = 0; k < nb_runs; k++)
+    {
+        run_frequencies[run_symbols[k]] += 1;
+    }
+
+    buildCodeLengths(run_frequencies, 19, 7, run_lengths);
+    buildCanonicalCodes(run_lengths, 19, run_codes);
+
+    int nb_run_codes = 19;
+
+    while (nb_run_codes > 4 && run_lengths[code_length_order[nb_run_codes - 1]] == 0)
+    {
+        nb_run_codes -= 1;
+    }
+
+    static const int run_extra_bits[19] = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2, 3, 7};
+
+    // Size of the compressed block, in bits, to fall back to stored blocks when they are smaller
+    size_t nb_bits = 3 + 14 + 3 * nb_run_codes + lengths[256];
+
+    for (int k = 0; k < nb_runs; k++)
+    {
+        nb_bits += run_lengths[run_symbols[k]] + run_extra_bits[run_symbols[k]];
+    }
+
+    for (int s = 0; s < 286; s++)
+    {
+        nb_bits += (size_t) literal_frequencies[s] * lengths[s];
+    }
+
+    for (int s = 0; s < 29; s++)
+    {
+        nb_bits += (size_t) literal_frequencies[257 + s] * length_extra_bits[s];
+    }
+
+    for (int s = 0; s < 30; s++)
+    {
+        nb_bits += (size_t) distance_frequencies[s] * (lengths[286 + s] + distance_extra_bits[s]);
+    }
+
+    if (nb_bits >= 8 * (nb_bytes + 5 * (nb_bytes / 65535 + 1)))
+    {
+        deflateStored(writer, bytes, nb_bytes, is_last);
+        return;
+    }
+
+    putBits(writer, is_last, 1);
+    putBits(writer, 2, 2);
+    putBits(writer, nb_literal_codes - 257, 5);
+    putBits(writer, nb_distance_codes - 1, 5);
+    putBits(writer, nb_run_codes - 4, 4);
+
+    for (int k = 0; k < nb_run_codes; k++)
+    {
+        putBits(writer, run_lengths[code_length_order[k]], 3);
+    }
+
+    for (int k = 0; k < nb_runs; k++)
+    {
+        putHuffmanCode(writer, run_codes[run_symbols[k]], run_lengths[run_symbols[k]]);
+        putBits(writer, run_extras[k], run_extra_bits[run_symbols[k]]);
+    }
+
+    for (int k = 0; k < nb_tokens; k++)
+    {
+        if (tokens[k] & PNG_MATCH_TOKEN)
+        {
+            int length = tokens[k] >> 16 & 0x1FF;
+            int distance = tokens[k] & 0xFFFF;
+            int length_idx = getLengthIdx(length);
+            int distance_idx = getDistanceIdx(distance);
+
+            putHuffmanCode(writer, literal_codes[257 + length_idx], lengths[257 + length_idx]);
+            putBits(writer, length - length_bases[length_idx], length_extra_bits[length_idx]);
+            putHuffmanCode(writer, distance_codes[distance_idx], lengths[286 + distance_idx]);
+            putBits(writer, distance - distance_bases[distance_idx], distance_extra_bits[distance_idx]);
+        }
+        else
+        {
+            putHuffmanCode(writer, literal_codes[tokens[k]], lengths[tokens[k]]);
+        }
+    }
+
+    putHuffmanCode(writer, literal_codes[256], lengths[256]);
+}
+
+
+
+/**
+ * @brief The Paeth predictor of the PNG filters : the one of the left, up and upper left bytes that is closest to `left + up - upleft`.
+ *
+ * @param left (int) : the byte on the left.
+ * @param up (int) : the byte above.
+ * @param up_left (int) : the byte above on the left.
+ * @return int : the predicted byte.
+ */
+static int paethPredictor(int left, int up, int up_left)
+{
+    int estimate = left + up - up_left;
+    int left_distance = abs(estimate - left);
+    int up_distance = abs(estimate - up);
+    int up_left_distance = abs(estimate - up_left);
+
+    if (left_distance <= up_distance && left_distance <= up_left_distance)
+    {
+        return left;
+    }
+    else if (up_distance <= up_left_distance)
+    {
+        return up;
+    }
+
+    return up_left;
+}
+
+
+
+/**
+ * @brief Filters a byte of a row with the given PNG filter.
+ *
+ * @param filter (int) : the filter, in `[0, 4]` (none, sub, up, average, Paeth).
+ * @param row (const unsigned char*) : the row.
+ * @param prior (const unsigned char*) : the previous row, `NULL` for the first one.
+ * @param idx (int) : the index of the byte in the row.
+ * @return unsigned char : the filtered byte.
+ */
+static unsigned char filterByte(int filter, const unsigned char* row, const unsigned char* prior, int idx)
+{
+    int left = idx >= 3 ? row[idx - 3] : 0;
+    int up = prior != NULL ? prior[idx] : 0;
+    int up_left = prior != NULL && idx >= 3 ? prior[idx - 3] : 0;
+
+    switch (filter)
+    {
+        case 1:
+            return row[idx] - left;
+        case 2:
+            return row[idx] - up;
+        case 3:
+            return row[idx] - (left + up) / 2;
+        case 4:
+            return row[idx] - paethPredictor(left, up, up_left);
+        default:
+            return row[idx];
+    }
+}
+
+
+
+/**
+ * @brief Writes the filter byte and the filtered bytes of a row of the image data.
+ *
+ * @param row (const unsigned char*) : the RGB8 bytes of the row.
+ * @param prior (const unsigned char*) : the RGB8 bytes of the previous row, `NULL` for the first one.
+ * @param row_size (int) : the number of bytes of the row.
+ * @param adaptive (int) : if `0` the row is not filtered, otherwise it takes the filter minimizing the sum of the absolute values
+ * of its filtered bytes.
+ * @param filtered (unsigned char*) : the `row_size + 1` destination bytes.
+ */
+static void filterRow(const unsigned char* row, const unsigned char* prior, int row_size, int adaptive, unsigned char* filtered)
+{
+    int best_filter = 0;
+
+    if (adaptive)
+    {
+        long best_sum = -1;
+
+        for (int filter = 0; filter < 5; filter++)
+        {
+            long sum = 0;
+
+            for (int k = 0; k < row_size; k++)
+            {
+                sum += abs((signed char) filterByte(filter, row, prior, k));
+            }
+
+            if (best_sum < 0 || sum < best_sum)
+            {
+                best_sum = sum;
+                best_filter = filter;
+            }
+        }
+    }
+
+    filtered[0] = best_filter;
+
+    for (int k = 0; k < row_size; k++)
+    {
+        filtered[k + 1] = filterByte(best_filter, row, prior, k);
+    }
+}
+
+
+
+int writePNGFile(color* colors, int width, int height, int compression, char path[])
+{
+    FILE* f = fopen(path, "wb");
+
+    if (f == NULL)
+    {
+        printf("%sERROR : could not open file in writing mode at path '%s'%s\n", RED_COLOR, path, DEFAULT_COLOR);
+        return 0;
+    }
+
+    struct pngWriter writer = {0};
+    writer.f = f;
+    writer.adler_a = 1;
+    writer.success = 1;
+    initCrcTable(writer.crc_table);
+
+    // A block holds as many whole filtered rows as possible, at least one
+    int row_size = 3 * width;
+    int nb_block_rows = IMAGE_BLOCK_SIZE / (row_size + 1) > 0 ? IMAGE_BLOCK_SIZE / (row_size + 1) : 1;
+    size_t block_size = (size_t) nb_block_rows * (row_size + 1);
+
+    // A block is never larger than its stored blocks, with 5 bytes of header each, and the zlib header and checksum
+    size_t buffer_size = block_size + 5 * (block_size / 65535 + 1) + 16;
+
+    unsigned char* block = calloc(block_size, sizeof(unsigned char));
+    writer.buffer = calloc(buffer_size, sizeof(unsigned char));
+
+    int* head = NULL;
+    int* previous = NULL;
+    uint32_t* tokens = NULL;
+
+    if (compression == PNG_DEFLATE)
+    {
+        head = calloc(PNG_HASH_SIZE, sizeof(int));
+        previous = calloc(block_size, sizeof(int));
+        tokens = calloc(block_size, sizeof(uint32_t));
+    }
+
+    static const unsigned char signature[8] = {137, 'P', 'N', 'G', '\r', '\n', 26, '\n'};
+
+    if (fwrite(signature, 1, 8, f) != 8)
+    {
+        writer.success = 0;
+    }
+
+    // Dimensions, 8 bits per channel, RGB colors, deflate, adaptive filtering and no interlacing
+    unsigned char image_header[13] = {0, 0, 0, 0, 0, 0, 0, 0, 8, 2, 0, 0, 0};
+    putBigEndian32(image_header, width);
+    putBigEndian32(image_header + 4, height);
+    writePNGChunk(&writer, "IHDR", image_header, 13);
+
+    // zlib header : deflate with a 32 KiB window, and no preset dictionary
+    putBits(&writer, 0x78, 8);
+    putBits(&writer, 0x01, 8);
+
+    for (int first_row = 0; first_row < height; first_row += nb_block_rows)
+    {
+        int end_row = first_row + nb_block_rows < height ? first_row + nb_block_rows : height;
+        size_t nb_bytes = 0;
+
+        for (int i = first_row; i < end_row; i++)
+        {
+            const unsigned char* row = (const unsigned char*) (colors + (size_t) i * width);
+            const unsigned char* prior = i > 0 ? row - row_size : NULL;
+
+            filterRow(row, prior, row_size, compression == PNG_DEFLATE, block + nb_bytes);
+            nb_bytes += row_size + 1;
+        }
+
+        updateAdler(&writer, block, nb_bytes);
+
+        int is_last = end_row == height;
+
+        if (compression == PNG_DEFLATE)
+        {
+            deflateHuffman(&writer, block, nb_bytes, is_last, head, previous, tokens);
+        }
+        else
+        {
+            deflateStored(&writer, block, nb_bytes, is_last);
+        }
+
+        if (is_last)
+        {
+            alignBits(&writer);
+            putBits(&writer, writer.adler_b >> 8 & 0xFF, 8);
+            putBits(&writer, writer.adler_b & 0xFF, 8);
+            putBits(&writer, writer.adler_a >> 8 & 0xFF, 8);
+            putBits(&writer, writer.adler_a & 0xFF, 8);
+        }
+
+        // The bits of an unfinished byte stay in the bit buffer, for the next chunk
+        writePNGChunk(&writer, "IDAT", writer.buffer, writer.buffer_used);
+        writer.buffer_used = 0;
+    }
+
+    writePNGChunk(&writer, "IEND", NULL, 0);
+
+    free(tokens);
+    free(previous);
+    free(head);
+    free(writer.buffer);
+    free(block);
+
+    if (fclose(f) != 0 || !writer.success)
+    {
+        printf("%sERROR : could not write the file at path '%s'%s\n", RED_COLOR, path, DEFAULT_COLOR);
+        return 0;
+    }
+
+    return 1;
+}
@@ -8,12 +8,59 @@
  */
 
 #include <malloc.h>
+#include <pthread.h>
 #include <time.h>
 
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    #define PERLIN_X86_KERNELS   /**< defined when the SSE2 / AVX2 row kernels can be compiled and dispatched at runtime*/
+    #include <immintrin.h>
+
+    //? The SIMD kernels are written once with these macros, for the `altitude_t` type of the build :
+    //? a float32 build computes twice as many samples per instruction.
+    #ifdef PROCGEN_FLOAT_ALTITUDE
+        #define SSE_VECTOR  __m128
+        #define SSE_LANES   4
+        #define SSE_LOAD    _mm_loadu_ps
+        #define SSE_STORE   _mm_storeu_ps
+        #define SSE_SET1    _mm_set1_ps
+        #define SSE_ADD     _mm_add_ps
+        #define SSE_SUB     _mm_sub_ps
+        #define SSE_MUL     _mm_mul_ps
+
+        #define AVX_VECTOR  __m256
+        #define AVX_LANES   8
+        #define AVX_LOAD    _mm256_loadu_ps
+        #define AVX_STORE   _mm256_storeu_ps
+        #define AVX_SET1    _mm256_set1_ps
+        #define AVX_ADD     _mm256_add_ps
+        #define AVX_SUB     _mm256_sub_ps
+        #define AVX_MUL     _mm256_mul_ps
+    #else
+        #define SSE_VECTOR  __m128d
+        #define SSE_LANES   2
+        #define SSE_LOAD    _mm_loadu_pd
+        #define SSE_STORE   _mm_storeu_pd
+        #define SSE_SET1    _mm_set1_pd
+        #define SSE_ADD     _mm_add_pd
+        #define SSE_SUB     _mm_sub_pd
+        #define SSE_MUL     _mm_mul_pd
+
+        #define AVX_VECTOR  __m256d
+        #define AVX_LANES   4
+        #define AVX_LOAD    _mm256_loadu_pd
+        #define AVX_STORE   _mm256_storeu_pd
+        #define AVX_SET1    _mm256_set1_pd
+        #define AVX_ADD     _mm256_add_pd
+        #define AVX_SUB     _mm256_sub_pd
+        #define AVX_MUL     _mm256_mul_pd
+    #endif
+#endif
+
 #include "loadingBar.h"
 #include "layer.h"
+#include "textFormat.h"
 
-double smoothstep(double w)
+altitude_t smoothstep(altitude_t w)
 {
     if (w > 1)
     {
@@ -24,12 +71,12 @@ double smoothstep(double w)
         w = 0;
     }
 
-    return w * w * (3.0 - 2.0 * w);
+    return w * w * ((altitude_t) 3.0 - (altitude_t) 2.0 * w);
 }
 
 
 
-double interpolate(double a0, double a1, double w)
+altitude_t interpolate(altitude_t a0, altitude_t a1, altitude_t w)
 {
     // Smooth interpolation.
     return a0 + (a1 - a0) * smoothstep(w);
@@ -39,20 +86,21 @@ double interpolate(double a0, double a1, double w)
 
 
 
-double dotGridGradient(int ix, int iy, double x, double y, gradientGrid* gradient_grid)
+altitude_t dotGridGradient(int ix, int iy, altitude_t x, altitude_t y, gradientGrid* gradient_grid)
 {
     // Differential vector
-    double dx = x - (double) ix;
-    double dy = y - (double) iy;
+    altitude_t dx = x - (altitude_t) ix;
+    altitude_t dy = y - (altitude_t) iy;
 
-    vector* v = getVector(gradient_grid, ix, iy);
+    vector v = getGradient(gradient_grid, ix, iy);
 
-    return dx * v->x + dy * v->y;
+    // Gradients are converted to the altitude precision before any computation
+    return dx * (altitude_t) v.x + dy * (altitude_t) v.y;
 }
 
 
 
-double perlin(double x, double y, gradientGrid* gradient_grid)
+altitude_t perlin(altitude_t x, altitude_t y, gradientGrid* gradient_grid)
 {
     // Perlin noise formula
 
@@ -62,18 +110,18 @@ double perlin(double x, double y, gradientGrid* gradient_grid)
     int x1 = x0 + 1;
     int y1 = y0 + 1;
 
-    double sx = x - x0;
-    double sy = y - y0;
+    altitude_t sx = x - (altitude_t) x0;
+    altitude_t sy = y - (altitude_t) y0;
 
-    double n0 = dotGridGradient(x0, y0, x, y, gradient_grid);
-    double n1 = dotGridGradient(x1, y0, x, y, gradient_grid);
-    double ix0 = interpolate(n0, n1, sx);
+    altitude_t n0 = dotGridGradient(x0, y0, x, y, gradient_grid);
+    altitude_t n1 = dotGridGradient(x1, y0, x, y, gradient_grid);
+    altitude_t ix0 = interpolate(n0, n1, sx);
 
     n0 = dotGridGradient(x0, y1, x, y, gradient_grid);
     n1 = dotGridGradient(x1, y1, x, y, gradient_grid);
-    double ix1 = interpolate(n0, n1, sx);
+    altitude_t ix1 = interpolate(n0, n1, sx);
 
-    double value = interpolate(ix0, ix1, sy);
+    altitude_t value = interpolate(ix0, ix1, sy);
 
     return value;
 }
@@ -82,9 +130,456 @@ double perlin(double x, double y, gradientGrid* gradient_grid)
 
 
 
-double* getLayerValue(layer* layer, int width_idx, int height_idx)
+perlinTable* newPerlinTable(int size_factor, int length, memoryArena* arena)
+{
+    perlinTable* table = arenaCalloc(arena, 1, sizeof(perlinTable));
+
+    // A single allocation holds the three arrays
+    altitude_t* values = arenaCalloc(arena, 3 * length, sizeof(altitude_t));
+
+    table->arena = arena;
+    table->size_factor = size_factor;
+    table->length = length;
+
+    table->offsets = values;
+    table->next_offsets = values + length;
+    table->weights = values + 2 * length;
+
+    for (int k = 0; k < length; k++)
+    {
+        // Same expressions as in `perlin` and `dotGridGradient`, so that the tables give the exact same values.
+        altitude_t x = (altitude_t) k/size_factor;
+        int x0 = (int) x;
+
+        table->offsets[k] = x - (altitude_t) x0;
+        table->next_offsets[k] = x - (altitude_t) (x0 + 1);
+        table->weights[k] = smoothstep(x - (altitude_t) x0);
+    }
+
+    return table;
+}
+
+
+
+perlinTableSet* newPerlinTableSet(int number_of_layers, int size_factors[number_of_layers], int length)
+{
+    perlinTableSet* table_set = calloc(1, sizeof(perlinTableSet));
+
+    table_set->tables = calloc(number_of_layers, sizeof(perlinTable*));
+    table_set->nb_tables = 0;
+
+    for (int k = 0; k < number_of_layers; k++)
+    {
+        // The layers with the same size factor share their table
+        if (getPerlinTable(table_set, size_factors[k], length) == NULL)
+        {
+            table_set->tables[table_set->nb_tables] = newPerlinTable(size_factors[k], length, NULL);
+            table_set->nb_tables += 1;
+        }
+    }
+
+    return table_set;
+}
+
+
+
+perlinTable* getPerlinTable(perlinTableSet* table_set, int size_factor, int length)
+{
+    for (int k = 0; table_set != NULL && k < table_set->nb_tables; k++)
+    {
+        if (table_set->tables[k]->size_factor == size_factor && table_set->tables[k]->length >= length)
+        {
+            return table_set->tables[k];
+        }
+    }
+
+    return NULL;
+}
+
+
+
+perlinTableSet* acquirePerlinTables(generatorContext* context, int number_of_layers, int size_factors[number_of_layers], int length)
+{
+    if (context != NULL && context->options.perlin_tables != NULL)
+    {
+        int covered = 1;
+
+        for (int k = 0; k < number_of_layers && covered; k++)
+        {
+            covered = getPerlinTable(context->options.perlin_tables, size_factors[k], length) != NULL;
+        }
+
+        if (covered)
+        {
+            return context->options.perlin_tables;
+        }
+    }
+
+    return newPerlinTableSet(number_of_layers, size_factors, length);
+}
+
+
+
+void releasePerlinTables(generatorContext* context, perlinTableSet* table_set)
+{
+    if (context == NULL || table_set != context->options.perlin_tables)
+    {
+        freePerlinTableSet(table_set);
+    }
+}
+
+
+
+perlinCellRow* newPerlinCellRow(int width)
+{
+    perlinCellRow* cell_row = calloc(1, sizeof(perlinCellRow));
+
+    // A single allocation holds the eight arrays
+    altitude_t* values = calloc(8 * width, sizeof(altitude_t));
+
+    cell_row->width = width;
+    cell_row->cell_idx = -1;
+
+    for (int c = 0; c < 4; c++)
+    {
+        cell_row->x_terms[c] = values + c * width;
+        cell_row->y_gradients[c] = values + (4 + c) * width;
+    }
+
+    return cell_row;
+}
+
+
+
+/**
+ * @brief Loads once the four corner gradients of every cell of the given row of gradient cells,
+ * and expands them on the `size_factor` samples of each cell.
+ * 
+ * @param cell_row (perlinCellRow*) : the pointer to the perlinCellRow structure to fill.
+ * @param cell_idx (int) : the height index of the row of gradient cells.
+ * @param gradient_grid (gradientGrid*) : the pointer to the gradientGrid structure.
+ * @param table (perlinTable*) : the pointer to the perlinTable structure of the layer's size factor.
+ */
+static void loadPerlinCellRow(perlinCellRow* cell_row, int cell_idx, gradientGrid* gradient_grid, perlinTable* table)
+{
+    int size_factor = table->size_factor;
+    int nb_cells = gradient_grid->width - 1;
+
+    altitude_t* offsets = table->offsets;
+    altitude_t* next_offsets = table->next_offsets;
+
+    for (int cx = 0; cx < nb_cells; cx++)
+    {
+        // The four corners of the cell
+        vector g00 = getGradient(gradient_grid, cx, cell_idx);
+        vector g10 = getGradient(gradient_grid, cx + 1, cell_idx);
+        vector g01 = getGradient(gradient_grid, cx, cell_idx + 1);
+        vector g11 = getGradient(gradient_grid, cx + 1, cell_idx + 1);
+
+        for (int r = 0; r < size_factor; r++)
+        {
+            int j = cx * size_factor + r;
+
+            // Width halves of the dot products : they do not depend on the row inside the cell.
+            cell_row->x_terms[0][j] = offsets[j] * (altitude_t) g00.x;
+            cell_row->x_terms[1][j] = next_offsets[j] * (altitude_t) g10.x;
+            cell_row->x_terms[2][j] = offsets[j] * (altitude_t) g01.x;
+            cell_row->x_terms[3][j] = next_offsets[j] * (altitude_t) g11.x;
+
+            cell_row->y_gradients[0][j] = (altitude_t) g00.y;
+            cell_row->y_gradients[1][j] = (altitude_t) g10.y;
+            cell_row->y_gradients[2][j] = (altitude_t) g01.y;
+            cell_row->y_gradients[3][j] = (altitude_t) g11.y;
+        }
+    }
+
+    cell_row->cell_idx = cell_idx;
+}
+
+
+
+/**
+ * @brief Signature shared by every row kernel. A kernel computes one row of samples from an already loaded perlinCellRow.
+ * 
+ * @param row_values (altitude_t*) : the array of `width` values to fill.
+ * @param width (int) : the number of samples in the row.
+ * @param dy0 (altitude_t) : the height offset to the north corners.
+ * @param dy1 (altitude_t) : the height offset to the south corners.
+ * @param wy (altitude_t) : the smoothstep weight of the height offset.
+ * @param weights (altitude_t*) : the smoothstep weights of the width offsets.
+ * @param cell_row (perlinCellRow*) : the pointer to the loaded perlinCellRow structure.
+ */
+typedef void (*perlinRowKernel)(altitude_t* row_values, int width, altitude_t dy0, altitude_t dy1, altitude_t wy, altitude_t* weights, perlinCellRow* cell_row);
+
+//? Every kernel below uses exactly the same operations, in the same order, as `perlin`, `dotGridGradient` and `interpolate`
+//? (no fused multiply-add), so that their results are bit for bit identical to the scalar `perlin` function.
+
+/**
+ * @brief Computes the samples from `first_idx` to `width - 1` of a row, one at a time. See `perlinRowKernel` for the parameters.
+ * 
+ */
+static void perlinRowTail(altitude_t* row_values, int first_idx, int width, altitude_t dy0, altitude_t dy1, altitude_t wy, altitude_t* weights, perlinCellRow* cell_row)
+{
+    altitude_t** x_terms = cell_row->x_terms;
+    altitude_t** y_gradients = cell_row->y_gradients;
+
+    for (int j = first_idx; j < width; j++)
+    {
+        altitude_t n00 = x_terms[0][j] + dy0 * y_gradients[0][j];
+        altitude_t n10 = x_terms[1][j] + dy0 * y_gradients[1][j];
+        altitude_t n01 = x_terms[2][j] + dy1 * y_gradients[2][j];
+        altitude_t n11 = x_terms[3][j] + dy1 * y_gradients[3][j];
+
+        altitude_t ix0 = n00 + (n10 - n00) * weights[j];
+        altitude_t ix1 = n01 + (n11 - n01) * weights[j];
+
+        row_values[j] = ix0 + (ix1 - ix0) * wy;
+    }
+}
+
+
+
+/**
+ * @brief The portable row kernel. See `perlinRowKernel` for the parameters.
+ * 
+ */
+static void perlinRowScalar(altitude_t* row_values, int width, altitude_t dy0, altitude_t dy1, altitude_t wy, altitude_t* weights, perlinCellRow* cell_row)
+{
+    perlinRowTail(row_values, 0, width, dy0, dy1, wy, weights, cell_row);
+}
+
+
+
+#ifdef PERLIN_X86_KERNELS
+
+/**
+ * @brief The SSE2 row kernel, computing 2 adjacent samples at a time (4 in a float32 build). See `perlinRowKernel` for the parameters.
+ * 
+ */
+__attribute__((target("sse2")))
+static void perlinRowSSE2(altitude_t* row_values, int width, altitude_t dy0, altitude_t dy1, altitude_t wy, altitude_t* weights, perlinCellRow* cell_row)
+{
+    altitude_t** x_terms = cell_row->x_terms;
+    altitude_t** y_gradients = cell_row->y_gradients;
+
+    SSE_VECTOR v_dy0 = SSE_SET1(dy0);
+    SSE_VECTOR v_dy1 = SSE_SET1(dy1);
+    SSE_VECTOR v_wy = SSE_SET1(wy);
+
+    int j = 0;
+    for (; j + SSE_LANES <= width; j += SSE_LANES)
+    {
+        SSE_VECTOR wx = SSE_LOAD(weights + j);
+
+        // Dot products
+        SSE_VECTOR n00 = SSE_ADD(SSE_LOAD(x_terms[0] + j), SSE_MUL(v_dy0, SSE_LOAD(y_gradients[0] + j)));
+        SSE_VECTOR n10 = SSE_ADD(SSE_LOAD(x_terms[1] + j), SSE_MUL(v_dy0, SSE_LOAD(y_gradients[1] + j)));
+        SSE_VECTOR n01 = SSE_ADD(SSE_LOAD(x_terms[2] + j), SSE_MUL(v_dy1, SSE_LOAD(y_gradients[2] + j)));
+        SSE_VECTOR n11 = SSE_ADD(SSE_LOAD(x_terms[3] + j), SSE_MUL(v_dy1, SSE_LOAD(y_gradients[3] + j)));
+
+        // Interpolations
+        SSE_VECTOR ix0 = SSE_ADD(n00, SSE_MUL(SSE_SUB(n10, n00), wx));
+        SSE_VECTOR ix1 = SSE_ADD(n01, SSE_MUL(SSE_SUB(n11, n01), wx));
+
+        SSE_STORE(row_values + j, SSE_ADD(ix0, SSE_MUL(SSE_SUB(ix1, ix0), v_wy)));
+    }
+
+    // Remaining samples
+    perlinRowTail(row_values, j, width, dy0, dy1, wy, weights, cell_row);
+}
+
+
+
+/**
+ * @brief The AVX2 row kernel, computing 4 adjacent samples at a time (8 in a float32 build). See `perlinRowKernel` for the parameters.
+ * 
+ */
+__attribute__((target("avx2")))
+static void perlinRowAVX2(altitude_t* row_values, int width, altitude_t dy0, altitude_t dy1, altitude_t wy, altitude_t* weights, perlinCellRow* cell_row)
+{
+    altitude_t** x_terms = cell_row->x_terms;
+    altitude_t** y_gradients = cell_row->y_gradients;
+
+    AVX_VECTOR v_dy0 = AVX_SET1(dy0);
+    AVX_VECTOR v_dy1 = AVX_SET1(dy1);
+    AVX_VECTOR v_wy = AVX_SET1(wy);
+
+    int j = 0;
+    for (; j + AVX_LANES <= width; j += AVX_LANES)
+    {
+        AVX_VECTOR wx = AVX_LOAD(weights + j);
+
+        // Dot products
+        AVX_VECTOR n00 = AVX_ADD(AVX_LOAD(x_terms[0] + j), AVX_MUL(v_dy0, AVX_LOAD(y_gradients[0] + j)));
+        AVX_VECTOR n10 = AVX_ADD(AVX_LOAD(x_terms[1] + j), AVX_MUL(v_dy0, AVX_LOAD(y_gradients[1] + j)));
+        AVX_VECTOR n01 = AVX_ADD(AVX_LOAD(x_terms[2] + j), AVX_MUL(v_dy1, AVX_LOAD(y_gradients[2] + j)));
+        AVX_VECTOR n11 = AVX_ADD(AVX_LOAD(x_terms[3] + j), AVX_MUL(v_dy1, AVX_LOAD(y_gradients[3] + j)));
+
+        // Interpolations
+        AVX_VECTOR ix0 = AVX_ADD(n00, AVX_MUL(AVX_SUB(n10, n00), wx));
+        AVX_VECTOR ix1 = AVX_ADD(n01, AVX_MUL(AVX_SUB(n11, n01), wx));
+
+        AVX_STORE(row_values + j, AVX_ADD(ix0, AVX_MUL(AVX_SUB(ix1, ix0), v_wy)));
+    }
+
+    // Remaining samples
+    perlinRowTail(row_values, j, width, dy0, dy1, wy, weights, cell_row);
+}
+
+#endif
+
+
+
+/**
+ * @brief The row kernel used by `perlinRowFromTable`, resolved once by `selectPerlinRowKernel`.
+ * 
+ */
+static perlinRowKernel perlin_row_kernel = perlinRowScalar;
+
+/**
+ * @brief Guards the single resolution of `perlin_row_kernel`, as the rows of several layers can be computed by several threads at once.
+ * 
+ */
+static pthread_once_t perlin_row_kernel_once = PTHREAD_ONCE_INIT;
+
+/**
+ * @brief Selects the fastest row kernel supported by the running CPU and stores it in `perlin_row_kernel`.
+ * 
+ */
+static void selectPerlinRowKernel()
+{
+    perlin_row_kernel = perlinRowScalar;
+
+#ifdef PERLIN_X86_KERNELS
+    __builtin_cpu_init();
+
+    if (__builtin_cpu_supports("avx2"))
+    {
+        perlin_row_kernel = perlinRowAVX2;
+    }
+    else if (__builtin_cpu_supports("sse2"))
+    {
+        perlin_row_kernel = perlinRowSSE2;
+    }
+#endif
+}
+
+
+
+void perlinRowFromTable(altitude_t* row_values, int height_idx, gradientGrid* gradient_grid, perlinTable* table, perlinCellRow* cell_row)
+{
+    int width = cell_row->width;
+    int size_factor = table->size_factor;
+
+    // The corners are only loaded when entering a new row of gradient cells
+    int cell_idx = height_idx / size_factor;
+
+    if (cell_row->cell_idx != cell_idx)
+    {
+        loadPerlinCellRow(cell_row, cell_idx, gradient_grid, table);
+    }
+
+    // The CPU features are only checked on the first row
+    pthread_once(&perlin_row_kernel_once, selectPerlinRowKernel);
+
+    perlin_row_kernel(row_values, width, table->offsets[height_idx], table->next_offsets[height_idx], table->weights[height_idx], table->weights, cell_row);
+}
+
+
+
+int setPerlinRowKernel(int kernel)
+{
+    // Resolved first, so that the first row does not replace the forced kernel
+    pthread_once(&perlin_row_kernel_once, selectPerlinRowKernel);
+
+    if (kernel == PERLIN_ROW_AUTO)
+    {
+        selectPerlinRowKernel();
+        return 1;
+    }
+
+    if (kernel == PERLIN_ROW_SCALAR)
+    {
+        perlin_row_kernel = perlinRowScalar;
+        return 1;
+    }
+
+#ifdef PERLIN_X86_KERNELS
+    __builtin_cpu_init();
+
+    if (kernel == PERLIN_ROW_SSE2 && __builtin_cpu_supports("sse2"))
+    {
+        perlin_row_kernel = perlinRowSSE2;
+        return 1;
+    }
+
+    if (kernel == PERLIN_ROW_AVX2 && __builtin_cpu_supports("avx2"))
+    {
+        perlin_row_kernel = perlinRowAVX2;
+        return 1;
+    }
+#endif
+
+    return 0;
+}
+
+
+
+void freePerlinTable(perlinTable* table)
+{
+    // The arena owns its structures
+    if (table != NULL && table->arena == NULL)
+    {
+        // The three arrays share the same allocation.
+        if (table->offsets != NULL)
+        {
+            free(table->offsets);
+        }
+
+        free(table);
+    }
+}
+
+
+
+void freePerlinTableSet(perlinTableSet* table_set)
+{
+    if (table_set != NULL)
+    {
+        for (int k = 0; k < table_set->nb_tables; k++)
+        {
+            freePerlinTable(table_set->tables[k]);
+        }
+
+        free(table_set->tables);
+        free(table_set);
+    }
+}
+
+
+
+void freePerlinCellRow(perlinCellRow* cell_row)
 {
-    double* layer_value = NULL;
+    if (cell_row != NULL)
+    {
+        // The eight arrays share the same allocation.
+        if (cell_row->x_terms[0] != NULL)
+        {
+            free(cell_row->x_terms[0]);
+        }
+
+        free(cell_row);
+    }
+}
+
+
+
+
+
+
+altitude_t* getLayerValue(layer* layer, int width_idx, int height_idx)
+{
+    altitude_t* layer_value = NULL;
 
     if (layer != NULL)
     {
@@ -113,10 +608,53 @@ double* getLayerValue(layer* layer, int width_idx, int height_idx)
 
 
 
+layer* initLayer(gradientGrid* gradient_grid, int size_factor)
+{
+    // Size layer must be applied **between** gradient grids points.
+    int width = (gradient_grid->width - 1) * size_factor;
+    int height = (gradient_grid->height - 1) * size_factor;
+
+    layer* new_layer = arenaCalloc(gradient_grid->arena, 1, sizeof(layer));
+
+    new_layer->arena = gradient_grid->arena;
+    new_layer->width = width;
+    new_layer->height = height;
+    new_layer->size_factor = size_factor;
+
+    new_layer->gradient_grid = gradient_grid;
+
+    //! Values are not allocated here
+    new_layer->values = NULL;
+
+    return new_layer;
+}
+
+
+
 layer* newLayerFromGradient(gradientGrid* gradient_grid, int size_factor, unsigned int display_loading)
+{
+    // Size layer must be applied **between** gradient grids points.
+    int width = (gradient_grid->width - 1) * size_factor;
+    int height = (gradient_grid->height - 1) * size_factor;
+
+    // Precomputed weights for this size factor
+    perlinTable* table = newPerlinTable(size_factor, width > height ? width : height, NULL);
+
+    layer* new_layer = newLayerFromTable(gradient_grid, table, display_loading);
+
+    freePerlinTable(table);
+
+    return new_layer;
+}
+
+
+
+layer* newLayerFromTable(gradientGrid* gradient_grid, perlinTable* table, unsigned int display_loading)
 {
     clock_t start_time = clock();
 
+    int size_factor = table->size_factor;
+
     int gradGridWidth = gradient_grid->width;
     int gradGridHeight = gradient_grid->height;
 
@@ -125,49 +663,47 @@ layer* newLayerFromGradient(gradientGrid* gradient_grid, int size_factor, unsign
     int height = (gradGridHeight - 1) * size_factor;
 
     // Initialization
-    layer* new_layer = calloc(1, sizeof(layer));
-    double* values = calloc(width * height, sizeof(double));
-
-    new_layer->width = width;
-    new_layer->height = height;
-    new_layer->size_factor = size_factor;
-
-    new_layer->gradient_grid = gradient_grid;
+    layer* new_layer = initLayer(gradient_grid, size_factor);
+    altitude_t* values = arenaCalloc(new_layer->arena, width * height, sizeof(altitude_t));
 
     new_layer->values = values;
 
-    // Setting correct double values
+    // The corners of the current row of gradient cells
+    perlinCellRow* cell_row = newPerlinCellRow(width);
+
+    // Setting correct altitude values, one row of gradient cells after the other.
+    // Each cell's corners are loaded once for its `size_factor x size_factor` block of samples.
     for (int i = 0; i < height; i++)
     {
-        for (int j = 0; j < width; j++)
+        perlinRowFromTable(getLayerValueUnchecked(new_layer, 0, i), i, gradient_grid, table, cell_row);
+
+        if (display_loading != 0)
         {
-            double* value = getLayerValue(new_layer, j, i);
+            int nb_indents = display_loading - 1;
 
-            *value = perlin((double) j/size_factor, (double) i/size_factor, gradient_grid);
+            char base_str[100] = "Generating layer...                ";
 
-            if (display_loading != 0)
+            for (int j = 0; j < width; j++)
             {
-                int nb_indents = display_loading - 1;
-
-                char base_str[100] = "Generating layer...                ";
-
                 predefined_loading_bar(j + i * width, width * height - 1, NUMBER_OF_SEGMENTS, base_str, nb_indents, start_time);
             }
         }
     }
 
+    freePerlinCellRow(cell_row);
+
     return new_layer;
 }
 
 
 
-layer* newLayer(int gradGrid_width, int gradGrid_height, int size_factor, unsigned int display_loading)
+layer* newLayer(int gradGrid_width, int gradGrid_height, int size_factor, generatorContext* context, unsigned int display_loading)
 {
     int g_loading = display_loading;
 
     // Generating a random gradientGrid
     // Size Factor should be set to match gradGrid_width - 1 and gradGrid_height - 1
-    gradientGrid* gradient_grid = newRandomGradGrid(gradGrid_width, gradGrid_height, g_loading);
+    gradientGrid* gradient_grid = newRandomGradGrid(gradGrid_width, gradGrid_height, context, g_loading);
 
     // Generating layer from the new gradientGrid
     return newLayerFromGradient(gradient_grid, size_factor, g_loading);
@@ -177,6 +713,29 @@ layer* newLayer(int gradGrid_width, int gradGrid_height, int size_factor, unsign
 
 
 
+void trimLayer(layer* layer)
+{
+    if (layer->values != NULL)
+    {
+        // The arena owns its structures, and the mapped values are unmapped
+        if (layer->mapped_file != NULL)
+        {
+            unmapBinaryFile(layer->mapped_file);
+            layer->mapped_file = NULL;
+        }
+        else if (layer->arena == NULL)
+        {
+            free(layer->values);
+        }
+
+        layer->values = NULL;
+    }
+
+    trimGradGrid(layer->gradient_grid);
+}
+
+
+
 layer* copyLayer(layer * p_layer)
 {
     layer* res = calloc(1, sizeof(layer));
@@ -188,12 +747,16 @@ layer* copyLayer(layer * p_layer)
 
     res->gradient_grid=copyGrad(p_layer->gradient_grid);
 
-    res->values = calloc(res->width*res->height, sizeof(double));
-    for (int i=0; i<res->width; i++)
+    // Layers of fused chunks do not have any values to copy
+    if (p_layer->values != NULL)
     {
-        for (int j=0; j<res->height; j++)
+        res->values = calloc(res->width*res->height, sizeof(altitude_t));
+        for (int i=0; i<res->width; i++)
         {
-            *getLayerValue(res,i,j)=*getLayerValue(p_layer,i,j);
+            for (int j=0; j<res->height; j++)
+            {
+                *getLayerValueUnchecked(res,i,j)=*getLayerValueUnchecked(p_layer,i,j);
+            }
         }
     }
 
@@ -221,25 +784,35 @@ void writeLayerFile(layer* layer, char path[])
 
         fprintf(f, "width=%d\nheight=%d\nsize_factor=%d\n", width, height, size_factor);
 
-        // Writing the values
-        for (int i = 0; i < height; i++)
+        int success = 1;
+
+        // Writing the values, one row at a time
+        if (layer->values != NULL)
         {
-            for (int j = 0; j < width; j++)
-            {
-                double value = *getLayerValue(layer, j, i);
+            textRow* row = newTextRow(TEXT_VALUE_LENGTH * width);
 
-                if (j != width - 1)
-                {
-                    fprintf(f, "% .8lf\t", value);
-                }
-                else
+            for (int i = 0; i < height && success; i++)
+            {
+                for (int j = 0; j < width; j++)
                 {
-                    fprintf(f, "% .8lf\n", value);
+                    altitude_t value = *getLayerValueUnchecked(layer, j, i);
+
+                    appendTextFixed(row, value, 8, 1);
+                    appendTextChar(row, j != width - 1 ? '\t' : '\n');
                 }
+
+                success = writeTextRow(row, f);
             }
+
+            freeTextRow(row);
         }
 
-        fclose(f);
+        success = fclose(f) == 0 && success;
+
+        if (!success)
+        {
+            printf("%sERROR : could not write the layer at path '%s'%s\n", RED_COLOR, path, DEFAULT_COLOR);
+        }
     }
     else
     {
@@ -250,7 +823,104 @@ void writeLayerFile(layer* layer, char path[])
 
 
 
-layer* readLayerFile(char path[]);
+layer* readLayerFile(char path[])
+{
+    mappedBinaryFile* mapped_file = mapBinaryFile(path, BINARY_LAYER, ALTITUDE_DTYPE, 1);
+
+    if (mapped_file == NULL)
+    {
+        return NULL;
+    }
+
+    layer* new_layer = calloc(1, sizeof(layer));
+
+    new_layer->width = mapped_file->header.width;
+    new_layer->height = mapped_file->header.height;
+    new_layer->size_factor = mapped_file->header.size_factor;
+    new_layer->values = mapped_file->samples;
+    new_layer->mapped_file = mapped_file;
+
+    return new_layer;
+}
+
+
+
+void writeLayerBinaryFile(layer* layer, uint64_t seed, char path[])
+{
+    FILE* f = fopen(path, "wb");
+
+    if (f == NULL)
+    {
+        printf("%sERROR : could not open file in writing mode at path '%s'%s\n", RED_COLOR, path, DEFAULT_COLOR);
+        return;
+    }
+
+    int width = layer->width;
+    int height = layer->height;
+
+    binaryHeader header = initBinaryHeader(BINARY_LAYER, ALTITUDE_DTYPE, layer->values != NULL ? 1 : 0, width, height, seed);
+    header.size_factor = layer->size_factor;
+
+    int success = writeBinaryHeader(f, &header);
+
+    if (layer->values != NULL)
+    {
+        success = success && writeBinarySamples(f, ALTITUDE_DTYPE, layer->values, (size_t) width * height);
+    }
+
+    if (!success)
+    {
+        printf("%sERROR : could not write the layer at path '%s'%s\n", RED_COLOR, path, DEFAULT_COLOR);
+    }
+
+    fclose(f);
+}
+
+
+
+layer* readLayerBinaryFile(char path[], binaryHeader* header)
+{
+    FILE* f = fopen(path, "rb");
+
+    if (f == NULL)
+    {
+        printf("%sERROR : could not open file in reading mode at path '%s'%s\n", RED_COLOR, path, DEFAULT_COLOR);
+        return NULL;
+    }
+
+    binaryHeader file_header = initBinaryHeader(BINARY_LAYER, 0, 0, 0, 0, 0);
+    layer* new_layer = NULL;
+
+    if (readBinaryHeader(f, BINARY_LAYER, &file_header))
+    {
+        new_layer = calloc(1, sizeof(layer));
+
+        new_layer->width = file_header.width;
+        new_layer->height = file_header.height;
+        new_layer->size_factor = file_header.size_factor;
+
+        if (file_header.nb_components == 1)
+        {
+            new_layer->values = calloc((size_t) file_header.width * file_header.height, sizeof(altitude_t));
+
+            if (!readBinaryPayload(f, &file_header, ALTITUDE_DTYPE, new_layer->values))
+            {
+                printf("%sERROR : truncated layer binary file at path '%s'%s\n", RED_COLOR, path, DEFAULT_COLOR);
+                freeLayer(new_layer);
+                new_layer = NULL;
+            }
+        }
+    }
+
+    fclose(f);
+
+    if (header != NULL)
+    {
+        *header = file_header;
+    }
+
+    return new_layer;
+}
 
 
 
@@ -264,11 +934,17 @@ void printLayer(layer* layer)
     printf("-------------------------------------------\n");
     printf("Printing layer of size = (%d, %d)\n\n", height, width);
 
+    if (layer->values == NULL)
+    {
+        printf("This layer has no values : it was only used to generate a fused chunk.\n");
+        height = 0;
+    }
+
     for (int i = 0; i < height; i++)
     {
         for (int j = 0; j < width; j++)
         {
-            double* value = getLayerValue(layer, j, i);
+            altitude_t* value = getLayerValueUnchecked(layer, j, i);
 
             printf("%lf   ", *value);
         }
@@ -282,9 +958,14 @@ void printLayer(layer* layer)
 
 void freeLayer(layer* layer)
 {
-    if (layer != NULL)
+    // The arena owns its structures
+    if (layer != NULL && layer->arena == NULL)
     {
-        if (layer->values != NULL)
+        if (layer->mapped_file != NULL)
+        {
+            unmapBinaryFile(layer->mapped_file);
+        }
+        else if (layer->values != NULL)
         {
             free(layer->values);
         }
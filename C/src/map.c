@@ -9,6 +9,7 @@
 
 #include <stdio.h>
 #include <malloc.h>
+#include <string.h>
 #include <time.h>
 
 #include "loadingBar.h"
@@ -16,10 +17,11 @@
 #include "layer.h"
 #include "chunk.h"
 #include "map.h"
+#include "textFormat.h"
 
-double* getMapValue(map* map, int width_idx, int height_idx)
+altitude_t* getMapValue(map* map, int width_idx, int height_idx)
 {
-    double* map_value = NULL;
+    altitude_t* map_value = NULL;
 
     if (map != NULL)
     {
@@ -92,7 +94,109 @@ double interpolate2D(double a1, double a2, double a3, double a4, double x, doubl
 
 
 
-map* addMeanAltitude(map* p_map, unsigned int display_loading) 
+/**
+ * @brief Adds the base altitude interpolated between the centers of four adjacent chunks on the pixels of the region between them.
+ * 
+ * @param res (map*) : the pointer to the map to modify. Its values only hold the window `[first_col, end_col) x [first_row, end_row)` of the
+ *                     map pixels, row by row.
+ * @param first_col (int) : the map column stored first in the map values : `0` for a whole map or a band, the first column of a chunk.
+ * @param first_row (int) : the map row stored first in the map values : `0` for a whole map, the first row of a band or of a chunk.
+ * @param end_col (int) : the map column after the last one stored in the map values.
+ * @param end_row (int) : the map row after the last one stored in the map values. The pixels of the region out of the window are skipped.
+ * @param i (int) : the width index of the region, in `[0, map_width]`. The region `(i, j)` lies between the chunks `(i-1, j-1)` and `(i, j)`.
+ * @param j (int) : the height index of the region, in `[0, map_height]`.
+ * @param a1 (double) : the base altitude of the chunk `(i-1, j-1)`.
+ * @param a2 (double) : the base altitude of the chunk `(i, j-1)`.
+ * @param a3 (double) : the base altitude of the chunk `(i-1, j)`.
+ * @param a4 (double) : the base altitude of the chunk `(i, j)`.
+ */
+static void addRegionAltitude(map* res, int first_col, int first_row, int end_col, int end_row, int i, int j,
+                                double a1, double a2, double a3, double a4)
+{
+    int chunk_width = res->chunk_width;
+    int chunk_height = res->chunk_height;
+    int map_width = res->map_width;
+    int map_height = res->map_height;
+    int window_width = end_col - first_col;
+
+    for (int pi=0; pi<chunk_width; pi++)
+    {
+        for (int pj=0; pj<chunk_height; pj++)
+        {
+            if ((i<map_width || pi<chunk_width*0.5) && (j<map_height || pj<chunk_height*0.5)
+                    && (i!=0 || pi>=chunk_width*0.5) && (j!=0 || pj>=chunk_height*0.5)) 
+            {
+                int ii=(int)(pi+(i-0.5)*chunk_width);
+                int jj=(int)(pj+(j-0.5)*chunk_height);
+
+                if (ii < first_col || ii >= end_col || jj < first_row || jj >= end_row)
+                {
+                    continue;
+                }
+
+                double x=pi*1./chunk_width;
+                double y=pj*1./chunk_height;
+                double alt = interpolate2D(a1,a2,a3,a4,x,y);
+                res->map_values[ii - first_col + (jj - first_row) * window_width]+=alt;
+            }
+        }
+    }
+}
+
+/**
+ * @brief The parameters of the altitude adding pass of `addMeanAltitude`, shared by its row bands.
+ * 
+ */
+struct meanAltitudePass
+{
+    map* map; /**< the pointer to the map to modify*/
+    void* altitude; /**< the `(map_width+2) x (map_height+2)` array of base altitude values, virtual chunks included*/
+    unsigned int display_loading; /**< the display_loading value of the pass, `0` when run in parallel*/
+    clock_t start_time; /**< the start time of the pass, for the loading bars*/
+};
+
+/**
+ * @brief Adds the interpolated base altitude on the pixels of the given band of regions rows. A region is the square between the centers
+ * of four adjacent chunks : the regions are disjoint, so are the pixels of two bands.
+ * 
+ * @param argument (void*) : the pointer to the meanAltitudePass structure.
+ * @param band_idx (int) : the index of the row band (unused).
+ * @param first_row (int) : the first region row of the band.
+ * @param end_row (int) : the region row after the last one of the band.
+ */
+static void meanAltitudeRowBand(void* argument, int band_idx, int first_row, int end_row)
+{
+    struct meanAltitudePass* pass = argument;
+
+    map* res = pass->map;
+    int map_width = res->map_width;
+    int map_height = res->map_height;
+
+    double (*altitude)[map_height+2] = pass->altitude;
+
+    for (int j=first_row; j<end_row; j++)
+    {
+        for (int i=0; i<map_width+1; i++)
+        {
+            addRegionAltitude(res, 0, 0, map_width * res->chunk_width, map_height * res->chunk_height, i, j,
+                                altitude[i][j], altitude[i+1][j], altitude[i][j+1], altitude[i+1][j+1]);
+
+            if (pass->display_loading != 0)
+            {
+                int nb_indents = pass->display_loading - 1;
+
+                char base_str[100] = "Adding altitude values...                   ";
+
+                predefined_loading_bar(i + j * (map_width+1), (map_width+1) * (map_height+1) - 1,
+                                        NUMBER_OF_SEGMENTS, base_str, nb_indents, pass->start_time);
+            }
+        }
+    }
+}
+
+
+
+map* addMeanAltitude(map* p_map, generatorContext* context, unsigned int display_loading) 
 {
     if (display_loading != 0)
     {
@@ -100,8 +204,6 @@ map* addMeanAltitude(map* p_map, unsigned int display_loading)
         display_loading += 2;
     }
 
-    int chunk_width = p_map->chunk_width;
-    int chunk_height = p_map->chunk_height;
     int map_width = p_map->map_width;
     int map_height = p_map->map_height;
 
@@ -159,44 +261,32 @@ map* addMeanAltitude(map* p_map, unsigned int display_loading)
 
 
     clock_t start_adding_time = clock();
-    for (int i=0; i<map_width+1; i++)
-    {
-        for (int j=0; j<map_height+1; j++)
-        {
-            double a1=altitude[i][j];
-            double a2=altitude[i+1][j];
-            double a3=altitude[i][j+1];
-            double a4=altitude[i+1][j+1];
 
-            for (int pi=0; pi<chunk_width; pi++)
-            {
-                for (int pj=0; pj<chunk_height; pj++)
-                {
-                    if ((i<map_width || pi<chunk_width*0.5) && (j<map_height || pj<chunk_height*0.5)
-                            && (i!=0 || pi>=chunk_width*0.5) && (j!=0 || pj>=chunk_height*0.5)) 
-                    {
-                        int ii=(int)(pi+(i-0.5)*chunk_width);
-                        int jj=(int)(pj+(j-0.5)*chunk_height);
-                        double x=pi*1./chunk_width;
-                        double y=pj*1./chunk_height;
-                        double alt = interpolate2D(a1,a2,a3,a4,x,y);
-                        *getMapValue(res,ii,jj)+=alt;
-                    }
-                }
-            }
-            if (display_loading != 0)
-            {
-                int nb_indents = display_loading - 1;
+    // The regions rows are split in bands, run in parallel when the context has several workers.
+    threadPool* pool = acquireThreadPool(context);
 
-                char base_str[100] = "Adding altitude values...                   ";
+    struct meanAltitudePass pass;
 
-                predefined_loading_bar(j + i * (map_height+1), (map_width+1) * (map_height+1) - 1,
-                                        NUMBER_OF_SEGMENTS, base_str, nb_indents, start_adding_time);
-            }
-        }
+    pass.map = res;
+    pass.altitude = altitude;
+    pass.display_loading = pool == NULL ? display_loading : 0;
+    pass.start_time = start_adding_time;
+
+    parallelRowBands(pool, map_height+1, meanAltitudeRowBand, &pass);
+
+    if (pool != NULL && display_loading != 0)
+    {
+        char base_str[100] = "Adding altitude values...                   ";
+
+        predefined_loading_bar(1, 1, NUMBER_OF_SEGMENTS, base_str, display_loading - 1, start_adding_time);
     }
 
-    display_loading-=2;
+    releaseThreadPool(context, pool);
+
+    if (display_loading != 0)
+    {
+        display_loading-=2;
+    }
     if (display_loading != 0)
     {
         double total_time = (double) (clock() - start_time)/CLOCKS_PER_SEC;
@@ -219,19 +309,74 @@ map* addMeanAltitude(map* p_map, unsigned int display_loading)
 
 
 
-map* newMapFromChunks(int map_width, int map_height, chunk* chunks[map_width * map_height], chunk* virtual_chunks[(map_height+2+map_width+2)*2-4], unsigned int display_loading)
+/**
+ * @brief The parameters of the values copying pass of `newMapFromChunks`, shared by its row bands.
+ * 
+ */
+struct mapValuesPass
+{
+    map* map; /**< the pointer to the map to fill*/
+    unsigned int display_loading; /**< the display_loading value of the pass, `0` when run in parallel*/
+    clock_t start_time; /**< the start time of the pass, for the loading bars*/
+};
+
+/**
+ * @brief Copies the chunks values on the given band of map rows.
+ * 
+ * @param argument (void*) : the pointer to the mapValuesPass structure.
+ * @param band_idx (int) : the index of the row band (unused).
+ * @param first_row (int) : the first row of the band.
+ * @param end_row (int) : the row after the last one of the band.
+ */
+static void mapValuesRowBand(void* argument, int band_idx, int first_row, int end_row)
+{
+    struct mapValuesPass* pass = argument;
+
+    map* new_map = pass->map;
+    int chunk_width = new_map->chunk_width;
+    int chunk_height = new_map->chunk_height;
+    int width = new_map->map_width * chunk_width;
+    int height = new_map->map_height * chunk_height;
+
+    for (int i = first_row; i < end_row; i++)
+    {
+        for (int j = 0; j < width; j++)
+        {
+            altitude_t* value = getMapValueUnchecked(new_map, j, i);
+            chunk* current_chunk = getChunk(new_map, j/chunk_width, i/chunk_height);
+
+            *value = *getChunkValueUnchecked(current_chunk, j%chunk_width, i%chunk_height);
+            
+            if (pass->display_loading != 0)
+            {
+                int nb_indents = pass->display_loading - 1;
+
+                char base_str[100] = "Generating map values...           ";
+
+                predefined_loading_bar(j + i * width, width * height - 1, NUMBER_OF_SEGMENTS, base_str, nb_indents, pass->start_time);
+            }
+        }
+    }
+}
+
+
+
+map* newMapFromChunks(int map_width, int map_height, chunk* chunks[map_width * map_height], chunk* virtual_chunks[(map_height+2+map_width+2)*2-4], generatorContext* context, unsigned int display_loading)
 {
     clock_t start_time = clock();
 
     if (chunks != NULL && map_width > 0 && map_height > 0)
     {
-        map* new_map = calloc(1, sizeof(map));
+        memoryArena* arena = context != NULL ? context->options.arena : NULL;
 
+        map* new_map = arenaCalloc(arena, 1, sizeof(map));
+
+        new_map->arena = arena;
         new_map->map_width = map_width;
         new_map->map_height = map_height;
 
         // Copy chunks list to ensure dynamic allocation
-        chunk** chunks_list = calloc(map_width * map_height, sizeof(chunk*));
+        chunk** chunks_list = arenaCalloc(arena, map_width * map_height, sizeof(chunk*));
         for (int i = 0; i < map_width * map_height; i++)
         {
             // chunks_list[i] = copyChunk(chunks[i]);
@@ -241,7 +386,7 @@ map* newMapFromChunks(int map_width, int map_height, chunk* chunks[map_width * m
         new_map->chunks = chunks_list;
 
         // copy virtual chunks list to ensure dynamic allocation
-        chunk** v_chunks_list = calloc((map_height+2+map_width+2)*2-4, sizeof(chunk*));
+        chunk** v_chunks_list = arenaCalloc(arena, (map_height+2+map_width+2)*2-4, sizeof(chunk*));
         for (int i = 0; i < (map_height+2+map_width+2)*2-4; i++)
         {
             // v_chunks_list[i] = copyChunk(virtual_chunks[i]);
@@ -262,33 +407,32 @@ map* newMapFromChunks(int map_width, int map_height, chunk* chunks[map_width * m
 
         int width = map_width * chunk_width;
         int height = map_height * chunk_height;
-        double* map_values = calloc(width * height, sizeof(double));
+        altitude_t* map_values = arenaCalloc(arena, width * height, sizeof(altitude_t));
 
         new_map->map_values = map_values;
 
-        // Copy the correct altitude values
-        for (int i = 0; i < height; i++)
-        {
-            for (int j = 0; j < width; j++)
-            {
-                double* value = getMapValue(new_map, j, i);
-                chunk* current_chunk = getChunk(new_map, j/chunk_width, i/chunk_height);
+        // Copy the correct altitude values, in row bands run in parallel when the context has several workers
+        threadPool* pool = acquireThreadPool(context);
 
-                *value = *getChunkValue(current_chunk, j%chunk_width, i%chunk_height);
-                
-                if (display_loading != 0)
-                {
-                    int nb_indents = display_loading - 1;
+        struct mapValuesPass pass;
 
-                    char base_str[100] = "Generating map values...           ";
+        pass.map = new_map;
+        pass.display_loading = pool == NULL ? display_loading : 0;
+        pass.start_time = start_time;
 
-                    predefined_loading_bar(j + i * width, width * height - 1, NUMBER_OF_SEGMENTS, base_str, nb_indents, start_time);
-                }
-            }
+        parallelRowBands(pool, height, mapValuesRowBand, &pass);
+
+        if (pool != NULL && display_loading != 0)
+        {
+            char base_str[100] = "Generating map values...           ";
+
+            predefined_loading_bar(1, 1, NUMBER_OF_SEGMENTS, base_str, display_loading - 1, start_time);
         }
 
+        releaseThreadPool(context, pool);
 
-        new_map = addMeanAltitude(new_map,display_loading);
+
+        new_map = addMeanAltitude(new_map, context, display_loading);
 
         return new_map;
     }
@@ -300,167 +444,1027 @@ map* newMapFromChunks(int map_width, int map_height, chunk* chunks[map_width * m
 
 
 
-map* newMap(int number_of_layers, int gradGrids_width[number_of_layers], int gradGrids_height[number_of_layers],
-                 int size_factors[number_of_layers], double layers_factors[number_of_layers], int map_width, int map_height, unsigned int display_loading)
+/**
+ * @brief Allocates a map whose chunks and values are to be filled by the generation : its chunks arrays are empty and its values are `0`.
+ * 
+ * @param map_width (int) : number of chunks in width.
+ * @param map_height (int) : number of chunks in height.
+ * @param chunk_width (int) : the width of the chunks.
+ * @param chunk_height (int) : the height of the chunks.
+ * @param arena (memoryArena*) : the pointer to the arena to allocate the map in, `NULL` to calloc it.
+ * @return map* : the pointer to the new map.
+ */
+static map* initMap(int map_width, int map_height, int chunk_width, int chunk_height, memoryArena* arena)
 {
-    clock_t start_time = clock();
+    map* new_map = arenaCalloc(arena, 1, sizeof(map));
 
-    chunk* chunks[map_width * map_height];
-    chunk* virtual_chunks[(map_height+2+map_width+2)*2-4];
+    new_map->arena = arena;
+    new_map->map_width = map_width;
+    new_map->map_height = map_height;
+    new_map->chunks = arenaCalloc(arena, map_width * map_height, sizeof(chunk*));
+    new_map->virtual_chunks = arenaCalloc(arena, (map_height+2+map_width+2)*2-4, sizeof(chunk*));
 
-    int c_loading = display_loading;
-    
-    if (display_loading != 0)
+    new_map->chunk_width = chunk_width;
+    new_map->chunk_height = chunk_height;
+    new_map->map_values = arenaCalloc(arena, map_width * chunk_width * map_height * chunk_height, sizeof(altitude_t));
+
+    return new_map;
+}
+
+
+
+/**
+ * @brief Gets the map indexes of the virtual chunk stored at the given index of the virtual chunks array (see `getVirtualChunk`).
+ * The virtual chunks surround the map, so their indexes range from `-1` to `map_dimension`.
+ * 
+ * @param virtual_idx (int) : the index in the virtual chunks array.
+ * @param map_width (int) : number of chunks in width.
+ * @param map_height (int) : number of chunks in height.
+ * @param chunk_x (int*) : the pointer to store the width index in.
+ * @param chunk_y (int*) : the pointer to store the height index in.
+ */
+static void virtualChunkIndexes(int virtual_idx, int map_width, int map_height, int* chunk_x, int* chunk_y)
+{
+    int width = map_width + 2;
+    int height = map_height + 2;
+
+    int width_idx = 0;
+    int height_idx = 0;
+
+    if (virtual_idx < height)
     {
-        indent_print(display_loading - 1, "Chunks generation before generating map...\n");
-        // Chunks loading bars will be indenting twice more.
-        c_loading += 2;
+        height_idx = virtual_idx;
     }
-
-    // Generates the chunks
-    for (int i = 0; i < map_height; i++)
+    else if (virtual_idx < 2 * height)
     {
-        for (int j = 0; j < map_width; j++)
-        {
-            clock_t chunk_start_time = clock();
+        width_idx = width - 1;
+        height_idx = virtual_idx - height;
+    }
+    else if (virtual_idx < 2 * height + width - 2)
+    {
+        width_idx = virtual_idx - (2 * height - 1);
+    }
+    else
+    {
+        width_idx = virtual_idx - (2 * height + width - 3);
+        height_idx = height - 1;
+    }
 
-            chunk* current_chunk = NULL;
+    // Virtual chunks indexes are shifted by one compared to the map ones
+    *chunk_x = width_idx - 1;
+    *chunk_y = height_idx - 1;
+}
 
-            if (display_loading != 0)
-            {
-                char to_print[200] = "";
-                snprintf(to_print, sizeof(to_print), "Generating chunk %d/%d...\n", i * map_width + j + 1, map_width * map_height);
 
-                indent_print(display_loading, to_print);
-            }
 
-            if (i == 0 && j == 0)
-            {
-                // First chunk
-                current_chunk = newChunk(number_of_layers, gradGrids_width, gradGrids_height, size_factors, layers_factors, c_loading);
-            }
-            else
-            {
-                // Others : adjacent chunks
-                chunk* north_chunk = NULL;
-                chunk* west_chunk = NULL;
+/**
+ * @brief The parameters to generate one chunk of a map, so that it can be run as a thread pool task.
+ * 
+ */
+struct mapChunkTask
+{
+    int number_of_layers; /**< the number of layers of the chunks*/
+    int* gradGrids_width; /**< the array of gradientGrid width*/
+    int* gradGrids_height; /**< the array of gradientGrid height*/
+    int* size_factors; /**< the array of size factors*/
+    double* layers_factors; /**< the array of layers factors*/
+    int map_width; /**< number of chunks in width*/
+    int width_idx; /**< the width index of the chunk to generate*/
+    int height_idx; /**< the height index of the chunk to generate*/
+    int first_chunk_row; /**< the chunk row stored first in `map_values`, and at the index `0` of `chunks` : `0` for a whole map, the current row
+                              for a streamed one (its previous row is then at the negative indexes of `chunks`)*/
+    chunk** chunks; /**< the array of the map chunks, where the chunk is stored*/
+    altitude_t* map_values; /**< the map values the chunk is generated in as a view, `NULL` if the chunk owns its values*/
+    generatorContext* context; /**< the pointer to the root generator context*/
+    unsigned int display_loading; /**< the display_loading value of the chunk generation*/
+};
 
-                if (j > 0)
-                {
-                    west_chunk = chunks[i * map_width + j - 1];
-                }
-                if (i > 0)
-                {
-                    north_chunk = chunks[(i - 1) * map_width + j];
-                }
+/**
+ * @brief Generates the chunk of the given task. Its north and west neighbours should already be generated, unless the gradients are hashed.
+ * 
+ * @param argument (void*) : the pointer to the mapChunkTask structure.
+ */
+static void generateMapChunk(void* argument)
+{
+    struct mapChunkTask* task = argument;
 
-                current_chunk = newAdjacentChunk(north_chunk, west_chunk, c_loading);
-            }
+    int i = task->height_idx;
+    int j = task->width_idx;
+    int map_width = task->map_width;
 
-            chunks[i * map_width + j] = current_chunk;
-            
-            if (display_loading != 0)
-            {
-                double total_time = (double) (clock() - chunk_start_time)/CLOCKS_PER_SEC;
-                char final_string[200] = "";
+    // The row of the chunk in the stored rows
+    int row = i - task->first_chunk_row;
 
-                snprintf(final_string, sizeof(final_string), "%sSUCCESS :%s The chunk generation took a total of %.4lf second(s) in CPU time.\n",
-                                        GREEN_COLOR, DEFAULT_COLOR, total_time);
-                
-                int nb_indents = display_loading;
-                indent_print(nb_indents, final_string);
+    generatorContext chunk_context = getChunkContext(task->context, j, i);
 
-                indent_print(display_loading, "\n");
-            }
-        }
-    }    
+    // The chunk values are either placed in the map values, or owned by the chunk
+    altitude_t* chunk_values = NULL;
+    int values_stride = 0;
 
-    clock_t v_start_time=clock();
-    for (int j = 0; j < (map_height+2+map_width+2)*2-4; j++)
+    if (task->map_values != NULL)
     {
-        chunk* current_chunk = NULL;
-        
-        if (display_loading != 0)
-        {
-            int nb_indents = display_loading - 1;
-
-            char base_str[100] = "Generating virtual chunks...       ";
+        // size_factors should match gradient_grids dimensions - 1
+        int chunk_width = (task->gradGrids_width[0] - 1) * task->size_factors[0];
+        int chunk_height = (task->gradGrids_height[0] - 1) * task->size_factors[0];
 
-            predefined_loading_bar(j+1,(map_height+2+map_width+2)*2-4, NUMBER_OF_SEGMENTS, base_str, nb_indents, v_start_time);
-        }
+        chunk_values = task->map_values + (row * chunk_height) * (map_width * chunk_width) + j * chunk_width;
+        values_stride = map_width * chunk_width;
+    }
 
-        current_chunk = newVirtualChunk(number_of_layers, gradGrids_width, gradGrids_height, size_factors, layers_factors);
+    chunk* current_chunk = NULL;
 
-        virtual_chunks[j] = current_chunk;
+    if ((i == 0 && j == 0) || chunk_context.options.gradient_source == HASHED_GRADIENTS)
+    {
+        // First chunk, or hashed gradients : the chunk does not depend on its neighbours
+        // Map chunks are fused : their layers values are never needed once the chunk values are computed.
+        current_chunk = newChunk(task->number_of_layers, task->gradGrids_width, task->gradGrids_height, task->size_factors, task->layers_factors,
+                                    0, chunk_values, values_stride, &chunk_context, task->display_loading);
     }
+    else
+    {
+        // Others : adjacent chunks
+        chunk* north_chunk = NULL;
+        chunk* west_chunk = NULL;
 
-    // Generating the map from the new chunks
-    map* new_map = newMapFromChunks(map_width, map_height, chunks, virtual_chunks, display_loading);
+        if (j > 0)
+        {
+            west_chunk = task->chunks[row * map_width + j - 1];
+        }
+        if (i > 0)
+        {
+            north_chunk = task->chunks[(row - 1) * map_width + j];
+        }
 
-    if (display_loading == 1)
-    {
-        double total_time = (double) (clock() - start_time)/CLOCKS_PER_SEC;
-        char final_string[200] = "";
+        current_chunk = newAdjacentChunk(north_chunk, west_chunk, 0, chunk_values, values_stride, &chunk_context, task->display_loading);
+    }
 
-        snprintf(final_string, sizeof(final_string), "%sSUCCESS :%s The map generation took a total of %.4lf second(s) in CPU time.\n",
-                                GREEN_COLOR, DEFAULT_COLOR, total_time);
-        
-        int nb_indents = display_loading - 1;
-        indent_print(nb_indents, final_string);
+    // The south and east neighbours only need the boundaries of the gradient grids
+    if (chunk_context.options.chunk_retention == KEEP_CHUNK_BOUNDARIES)
+    {
+        trimChunk(current_chunk);
     }
 
-    return new_map;
+    task->chunks[row * map_width + j] = current_chunk;
 }
 
+/**
+ * @brief Generates the virtual chunk stored at the given index of the virtual chunks array.
+ * 
+ * @param task (struct mapChunkTask*) : the pointer to the task holding the map parameters. Its indexes are not used.
+ * @param virtual_chunks (chunk**) : the array of the virtual chunks, where the chunk is stored.
+ * @param map_height (int) : number of chunks in height.
+ * @param virtual_idx (int) : the index in the virtual chunks array.
+ */
+static void generateMapVirtualChunk(struct mapChunkTask* task, chunk** virtual_chunks, int map_height, int virtual_idx)
+{
+    int chunk_x = 0;
+    int chunk_y = 0;
+    virtualChunkIndexes(virtual_idx, task->map_width, map_height, &chunk_x, &chunk_y);
 
+    generatorContext chunk_context = getChunkContext(task->context, chunk_x, chunk_y);
 
+    virtual_chunks[virtual_idx] = newVirtualChunk(task->number_of_layers, task->gradGrids_width, task->gradGrids_height, task->size_factors,
+                                                    task->layers_factors, &chunk_context);
+}
 
-
-map* copyMap(map* p_map) 
+/**
+ * @brief Gets the base altitude of the chunk at the given map indexes, which can be a virtual one.
+ * 
+ * @param p_map (map*) : the pointer to the map structure.
+ * @param chunk_x (int) : the width index of the chunk, in `[-1, map_width]`.
+ * @param chunk_y (int) : the height index of the chunk, in `[-1, map_height]`.
+ * @return double : the base altitude of the chunk.
+ */
+static double getBaseAltitude(map* p_map, int chunk_x, int chunk_y)
 {
-    map* res = calloc(1, sizeof(map));
-
-    res->map_width=p_map->map_width;
-    res->map_height=p_map->map_height;
-    res->chunk_width=p_map->chunk_width;
-    res->chunk_height=p_map->chunk_height;
+    chunk* current_chunk = getChunk(p_map, chunk_x, chunk_y);
 
-    res->chunks = calloc(res->chunk_width*res->chunk_height,sizeof(chunk*));
-    for (int i=0; i<res->map_width; i++)
+    if (current_chunk == NULL)
     {
-        for (int j=0; j<res->map_height; j++)
-        {
-            res->chunks[i*res->map_width+j]=copyChunk(p_map->chunks[i*p_map->map_width+j]);
-        }
+        current_chunk = getVirtualChunk(p_map, chunk_x + 1, chunk_y + 1);
     }
 
-    int n = res->chunk_width*res->map_width;
-    int m = res->chunk_height*res->map_height;
+    return current_chunk->base_altitude;
+}
+
+/**
+ * @brief A task of the map task graph working on one chunk, or on one region between four chunks.
+ * 
+ */
+struct mapCellTask
+{
+    map* map; /**< the pointer to the map*/
+    int width_idx; /**< the width index of the chunk or of the region*/
+    int height_idx; /**< the height index of the chunk or of the region*/
+};
 
-    res->map_values = calloc(n*m, sizeof(double));
+/**
+ * @brief Copies the values of the chunk of the given task in the map values.
+ * 
+ * @param argument (void*) : the pointer to the mapCellTask structure.
+ */
+static void copyMapChunkValues(void* argument)
+{
+    struct mapCellTask* task = argument;
 
-    for (int i=0; i<n; i++)
+    map* p_map = task->map;
+    int chunk_width = p_map->chunk_width;
+    int chunk_height = p_map->chunk_height;
+
+    chunk* current_chunk = getChunk(p_map, task->width_idx, task->height_idx);
+
+    for (int i = 0; i < chunk_height; i++)
     {
-        for (int j=0; j<m; j++)
+        altitude_t* map_row = getMapValueUnchecked(p_map, task->width_idx * chunk_width, task->height_idx * chunk_height + i);
+
+        for (int j = 0; j < chunk_width; j++)
         {
-            *getMapValue(res,i,j)=*getMapValue(p_map,i,j);
+            map_row[j] = *getChunkValueUnchecked(current_chunk, j, i);
         }
     }
-
-    return res;
 }
 
+/**
+ * @brief Adds the base altitude on the region of the given task (see `addMeanAltitude`).
+ * 
+ * @param argument (void*) : the pointer to the mapCellTask structure.
+ */
+static void addMapRegionAltitude(void* argument)
+{
+    struct mapCellTask* task = argument;
 
+    int i = task->width_idx;
+    int j = task->height_idx;
+    int width = task->map->map_width * task->map->chunk_width;
+    int height = task->map->map_height * task->map->chunk_height;
 
+    addRegionAltitude(task->map, 0, 0, width, height, i, j, getBaseAltitude(task->map, i-1, j-1), getBaseAltitude(task->map, i, j-1),
+                        getBaseAltitude(task->map, i-1, j), getBaseAltitude(task->map, i, j));
+}
 
-
-void writeMapFile(map* map, char path[])
+/**
+ * @brief Marks that the final values of a chunk are ready. It does nothing : the post-processing tasks of the chunk wait for it.
+ * 
+ * @param argument (void*) : unused.
+ */
+static void markMapChunkReady(void* argument)
 {
-    FILE* f = NULL;
+    (void) argument;
+}
 
-    f = fopen(path, "w");
+/**
+ * @brief The arguments of the tasks of a map task graph, free'd by its last task.
+ * 
+ */
+struct mapTaskGraph
+{
+    struct mapChunkTask* chunk_tasks; /**< the arguments of the chunk generation tasks*/
+    struct mapCellTask* copy_tasks; /**< the arguments of the values copying tasks*/
+    struct mapCellTask* region_tasks; /**< the arguments of the base altitude tasks*/
+};
 
-    if (f != NULL)
+/**
+ * @brief Frees the given mapTaskGraph structure, once every other task of the graph is done.
+ * 
+ * @param argument (void*) : the pointer to the mapTaskGraph structure.
+ */
+static void freeMapTaskGraph(void* argument)
+{
+    struct mapTaskGraph* graph = argument;
+
+    free(graph->chunk_tasks);
+    free(graph->copy_tasks);
+    free(graph->region_tasks);
+    free(graph);
+}
+
+
+
+map* newMapTaskGraph(int number_of_layers, int gradGrids_width[number_of_layers], int gradGrids_height[number_of_layers],
+                        int size_factors[number_of_layers], double layers_factors[number_of_layers], int map_width, int map_height,
+                        generatorContext* context, taskGroup* group, task* chunks_ready[map_width * map_height])
+{
+    threadPool* pool = context->options.pool;
+    int nb_chunks = map_width * map_height;
+    int nb_virtual_chunks = (map_height+2+map_width+2)*2-4;
+
+    // Initialize the map : its chunks and values are filled by the tasks
+    // size_factors should match gradient_grids dimensions - 1
+    int chunk_width = (gradGrids_width[0] - 1) * size_factors[0];
+    int chunk_height = (gradGrids_height[0] - 1) * size_factors[0];
+
+    map* new_map = initMap(map_width, map_height, chunk_width, chunk_height, context->options.arena);
+
+    struct mapTaskGraph* graph = calloc(1, sizeof(struct mapTaskGraph));
+
+    graph->chunk_tasks = calloc(nb_chunks, sizeof(struct mapChunkTask));
+    graph->copy_tasks = calloc(nb_chunks, sizeof(struct mapCellTask));
+    graph->region_tasks = calloc((map_width+1) * (map_height+1), sizeof(struct mapCellTask));
+
+    struct mapChunkTask base_task;
+
+    base_task.number_of_layers = number_of_layers;
+    base_task.gradGrids_width = gradGrids_width;
+    base_task.gradGrids_height = gradGrids_height;
+    base_task.size_factors = size_factors;
+    base_task.layers_factors = layers_factors;
+    base_task.map_width = map_width;
+    base_task.first_chunk_row = 0;
+    base_task.chunks = new_map->chunks;
+    base_task.map_values = context->options.chunk_views ? new_map->map_values : NULL;
+    base_task.context = context;
+    // The workers loading bars would be mixed up
+    base_task.display_loading = 0;
+
+    // The virtual chunks only hold a base altitude : they are generated right away
+    for (int k = 0; k < nb_virtual_chunks; k++)
+    {
+        generateMapVirtualChunk(&base_task, new_map->virtual_chunks, map_height, k);
+    }
+
+    task* generation_tasks[nb_chunks];
+    task* copy_tasks[nb_chunks];
+    // The tasks after which the chunk values are in the map : the copy tasks, or the generation ones for views
+    task* values_ready[nb_chunks];
+
+    // Chunks generation, each one waiting for its north and west neighbours unless the gradients are hashed, then the values copy
+    for (int i = 0; i < map_height; i++)
+    {
+        for (int j = 0; j < map_width; j++)
+        {
+            int k = i * map_width + j;
+
+            graph->chunk_tasks[k] = base_task;
+            graph->chunk_tasks[k].width_idx = j;
+            graph->chunk_tasks[k].height_idx = i;
+
+            generation_tasks[k] = newGraphTask(pool, group, generateMapChunk, graph->chunk_tasks + k);
+
+            if (context->options.gradient_source != HASHED_GRADIENTS)
+            {
+                if (j > 0)
+                {
+                    addTaskDependency(pool, generation_tasks[k - 1], generation_tasks[k]);
+                }
+                if (i > 0)
+                {
+                    addTaskDependency(pool, generation_tasks[k - map_width], generation_tasks[k]);
+                }
+            }
+
+            copy_tasks[k] = NULL;
+            values_ready[k] = generation_tasks[k];
+
+            if (!context->options.chunk_views)
+            {
+                graph->copy_tasks[k].map = new_map;
+                graph->copy_tasks[k].width_idx = j;
+                graph->copy_tasks[k].height_idx = i;
+
+                copy_tasks[k] = newGraphTask(pool, group, copyMapChunkValues, graph->copy_tasks + k);
+                addTaskDependency(pool, generation_tasks[k], copy_tasks[k]);
+                values_ready[k] = copy_tasks[k];
+            }
+
+            chunks_ready[k] = newGraphTask(pool, group, markMapChunkReady, NULL);
+        }
+    }
+
+    // Base altitude regions, each one waiting for the values of the chunks it lies on. A chunk is ready once its four regions are done.
+    task* free_task = newGraphTask(pool, group, freeMapTaskGraph, graph);
+
+    for (int j = 0; j < map_height+1; j++)
+    {
+        for (int i = 0; i < map_width+1; i++)
+        {
+            struct mapCellTask* region = graph->region_tasks + j * (map_width+1) + i;
+
+            region->map = new_map;
+            region->width_idx = i;
+            region->height_idx = j;
+
+            task* region_task = newGraphTask(pool, group, addMapRegionAltitude, region);
+
+            for (int y = j-1; y <= j; y++)
+            {
+                for (int x = i-1; x <= i; x++)
+                {
+                    if (x >= 0 && x < map_width && y >= 0 && y < map_height)
+                    {
+                        addTaskDependency(pool, values_ready[y * map_width + x], region_task);
+                        addTaskDependency(pool, region_task, chunks_ready[y * map_width + x]);
+                    }
+                }
+            }
+
+            addTaskDependency(pool, region_task, free_task);
+            launchGraphTask(pool, region_task);
+        }
+    }
+
+    for (int k = 0; k < nb_chunks; k++)
+    {
+        launchGraphTask(pool, generation_tasks[k]);
+        if (copy_tasks[k] != NULL)
+        {
+            launchGraphTask(pool, copy_tasks[k]);
+        }
+        launchGraphTask(pool, chunks_ready[k]);
+    }
+
+    launchGraphTask(pool, free_task);
+
+    return new_map;
+}
+
+
+
+map* newMap(int number_of_layers, int gradGrids_width[number_of_layers], int gradGrids_height[number_of_layers],
+                 int size_factors[number_of_layers], double layers_factors[number_of_layers], int map_width, int map_height,
+                 generatorContext* context, unsigned int display_loading)
+{
+    clock_t start_time = clock();
+
+    chunk* chunks[map_width * map_height];
+    chunk* virtual_chunks[(map_height+2+map_width+2)*2-4];
+
+    int c_loading = display_loading;
+    
+    if (display_loading != 0)
+    {
+        indent_print(display_loading - 1, "Chunks generation before generating map...\n");
+        // Chunks loading bars will be indenting twice more.
+        c_loading += 2;
+    }
+
+    struct mapChunkTask chunk_task;
+
+    chunk_task.number_of_layers = number_of_layers;
+    chunk_task.gradGrids_width = gradGrids_width;
+    chunk_task.gradGrids_height = gradGrids_height;
+    chunk_task.size_factors = size_factors;
+    chunk_task.layers_factors = layers_factors;
+    chunk_task.map_width = map_width;
+    chunk_task.first_chunk_row = 0;
+    chunk_task.chunks = chunks;
+    chunk_task.map_values = NULL;
+    chunk_task.display_loading = c_loading;
+
+    // Every chunk shares the weights tables of the size factors
+    // size_factors should match gradient_grids dimensions - 1
+    int chunk_width = (gradGrids_width[0] - 1) * size_factors[0];
+    int chunk_height = (gradGrids_height[0] - 1) * size_factors[0];
+
+    generatorContext tables_context = *context;
+    tables_context.options.perlin_tables = acquirePerlinTables(context, number_of_layers, size_factors,
+                                                                chunk_width > chunk_height ? chunk_width : chunk_height);
+    chunk_task.context = &tables_context;
+
+    map* new_map = NULL;
+
+    if (context->options.nb_workers > 1)
+    {
+        // Generates the chunks, the map values and the base altitude as a task graph on several threads
+        generatorContext pool_context = tables_context;
+        threadPool* pool = acquireThreadPool(&pool_context);
+        pool_context.options.pool = pool;
+
+        taskGroup group = {0};
+        task* chunks_ready[map_width * map_height];
+
+        new_map = newMapTaskGraph(number_of_layers, gradGrids_width, gradGrids_height, size_factors, layers_factors, map_width, map_height,
+                                    &pool_context, &group, chunks_ready);
+
+        waitTaskGroup(pool, &group);
+
+        releaseThreadPool(context, pool);
+
+        if (display_loading != 0)
+        {
+            char base_str[100] = "Running the map task graph...      ";
+
+            predefined_loading_bar(1, 1, NUMBER_OF_SEGMENTS, base_str, display_loading - 1, start_time);
+        }
+    }
+    else
+    {
+        chunk** virtual_chunks_list = virtual_chunks;
+
+        if (context->options.chunk_views)
+        {
+            // The chunks are generated in place, as views into the map values : nothing is copied afterwards
+            new_map = initMap(map_width, map_height, chunk_width, chunk_height, context->options.arena);
+
+            virtual_chunks_list = new_map->virtual_chunks;
+            chunk_task.chunks = new_map->chunks;
+            chunk_task.map_values = new_map->map_values;
+        }
+
+        // Generates the chunks in raster order
+        for (int i = 0; i < map_height; i++)
+        {
+            for (int j = 0; j < map_width; j++)
+            {
+                clock_t chunk_start_time = clock();
+
+                if (display_loading != 0)
+                {
+                    char to_print[200] = "";
+                    snprintf(to_print, sizeof(to_print), "Generating chunk %d/%d...\n", i * map_width + j + 1, map_width * map_height);
+
+                    indent_print(display_loading, to_print);
+                }
+
+                chunk_task.width_idx = j;
+                chunk_task.height_idx = i;
+
+                generateMapChunk(&chunk_task);
+            
+                if (display_loading != 0)
+                {
+                    double total_time = (double) (clock() - chunk_start_time)/CLOCKS_PER_SEC;
+                    char final_string[200] = "";
+
+                    snprintf(final_string, sizeof(final_string), "%sSUCCESS :%s The chunk generation took a total of %.4lf second(s) in CPU time.\n",
+                                            GREEN_COLOR, DEFAULT_COLOR, total_time);
+                
+                    int nb_indents = display_loading;
+                    indent_print(nb_indents, final_string);
+
+                    indent_print(display_loading, "\n");
+                }
+            }
+        }    
+
+        clock_t v_start_time=clock();
+        for (int j = 0; j < (map_height+2+map_width+2)*2-4; j++)
+        {
+            if (display_loading != 0)
+            {
+                int nb_indents = display_loading - 1;
+
+                char base_str[100] = "Generating virtual chunks...       ";
+
+                predefined_loading_bar(j+1,(map_height+2+map_width+2)*2-4, NUMBER_OF_SEGMENTS, base_str, nb_indents, v_start_time);
+            }
+
+            generateMapVirtualChunk(&chunk_task, virtual_chunks_list, map_height, j);
+        }
+
+        if (new_map != NULL)
+        {
+            // The map values are already the chunks ones
+            new_map = addMeanAltitude(new_map, context, display_loading);
+        }
+        else
+        {
+            // Generating the map from the new chunks
+            new_map = newMapFromChunks(map_width, map_height, chunks, virtual_chunks, context, display_loading);
+        }
+    }
+
+    releasePerlinTables(context, tables_context.options.perlin_tables);
+
+    if (display_loading == 1)
+    {
+        double total_time = (double) (clock() - start_time)/CLOCKS_PER_SEC;
+        char final_string[200] = "";
+
+        snprintf(final_string, sizeof(final_string), "%sSUCCESS :%s The map generation took a total of %.4lf second(s) in CPU time.\n",
+                                GREEN_COLOR, DEFAULT_COLOR, total_time);
+        
+        int nb_indents = display_loading - 1;
+        indent_print(nb_indents, final_string);
+    }
+
+    return new_map;
+}
+
+
+
+
+
+/**
+ * @brief Gets the base altitude of the virtual chunk at the given map indexes, without keeping the chunk.
+ * 
+ * @param task (struct mapChunkTask*) : the pointer to the task holding the map parameters. Its indexes are not used.
+ * @param chunk_x (int) : the width index of the virtual chunk, in `[-1, map_width]`.
+ * @param chunk_y (int) : the height index of the virtual chunk, in `[-1, map_height]`.
+ * @return double : the base altitude of the virtual chunk.
+ */
+static double getVirtualBaseAltitude(struct mapChunkTask* task, int chunk_x, int chunk_y)
+{
+    generatorContext chunk_context = getChunkContext(task->context, chunk_x, chunk_y);
+
+    chunk* virtual_chunk = newVirtualChunk(task->number_of_layers, task->gradGrids_width, task->gradGrids_height, task->size_factors,
+                                            task->layers_factors, &chunk_context);
+
+    double base_altitude = virtual_chunk->base_altitude;
+    freeChunk(virtual_chunk);
+
+    return base_altitude;
+}
+
+/**
+ * @brief Generates the chunks of the given columns of the current row of a streamed map. With hashed gradients, the chunks of a row
+ * are independent : the columns are then split in bands, run in parallel.
+ * 
+ * @param argument (void*) : the pointer to the mapChunkTask structure of the row. It is copied for each chunk.
+ * @param band_idx (int) : the index of the band (unused).
+ * @param first_col (int) : the first chunk column of the band.
+ * @param end_col (int) : the chunk column after the last one of the band.
+ */
+static void generateStreamChunksBand(void* argument, int band_idx, int first_col, int end_col)
+{
+    for (int j = first_col; j < end_col; j++)
+    {
+        struct mapChunkTask chunk_task = *(struct mapChunkTask*) argument;
+        chunk_task.width_idx = j;
+
+        generateMapChunk(&chunk_task);
+    }
+}
+
+
+
+int streamMap(int number_of_layers, int gradGrids_width[number_of_layers], int gradGrids_height[number_of_layers],
+                int size_factors[number_of_layers], double layers_factors[number_of_layers], int map_width, int map_height,
+                generatorContext* context, mapRowSink sink, void* sink_data, unsigned int display_loading)
+{
+    clock_t start_time = clock();
+
+    if (display_loading != 0)
+    {
+        indent_print(display_loading - 1, "Streaming the map rows...\n");
+    }
+
+    // size_factors should match gradient_grids dimensions - 1
+    int chunk_width = (gradGrids_width[0] - 1) * size_factors[0];
+    int chunk_height = (gradGrids_height[0] - 1) * size_factors[0];
+    int width = map_width * chunk_width;
+
+    // The chunks are generated in place in the window, freed once their south neighbours are, and only keep their gradient grids boundaries
+    generatorContext stream_context = *context;
+    stream_context.options.arena = NULL;
+    stream_context.options.chunk_views = 1;
+    stream_context.options.chunk_retention = KEEP_CHUNK_BOUNDARIES;
+
+    threadPool* pool = acquireThreadPool(context);
+    stream_context.options.pool = pool;
+
+    // Every chunk shares the weights tables of the size factors
+    stream_context.options.perlin_tables = acquirePerlinTables(context, number_of_layers, size_factors,
+                                                                chunk_width > chunk_height ? chunk_width : chunk_height);
+
+    // The window is a ring of two bands of chunk rows : the previous one, finished by the base altitude of the current one, and the current one.
+    // The chunk row y is in the band y % 2 : a band is only generated again once its rows were given to the sink and its chunks free'd,
+    // so the views of the retained chunks stay valid and no value is moved.
+    altitude_t* window_values = calloc(2 * chunk_height * width, sizeof(altitude_t));
+    altitude_t* bands[2] = {window_values, window_values + chunk_height * width};
+
+    // The previous row chunks, then the current row ones
+    chunk** window_chunks = calloc(2 * map_width, sizeof(chunk*));
+
+    // The base altitudes of the previous and current chunk rows, virtual chunks included : the chunk x is at the index x + 1
+    double* north_altitudes = calloc(map_width + 2, sizeof(double));
+    double* altitudes = calloc(map_width + 2, sizeof(double));
+
+    // The views of the two bands as maps, each one holding the rows of its chunk row
+    map north_band = {0};
+
+    north_band.map_width = map_width;
+    north_band.map_height = map_height;
+    north_band.chunk_width = chunk_width;
+    north_band.chunk_height = chunk_height;
+
+    map south_band = north_band;
+
+    struct mapChunkTask chunk_task;
+
+    chunk_task.number_of_layers = number_of_layers;
+    chunk_task.gradGrids_width = gradGrids_width;
+    chunk_task.gradGrids_height = gradGrids_height;
+    chunk_task.size_factors = size_factors;
+    chunk_task.layers_factors = layers_factors;
+    chunk_task.map_width = map_width;
+    chunk_task.chunks = window_chunks + map_width;
+    chunk_task.context = &stream_context;
+    // The workers loading bars would be mixed up
+    chunk_task.display_loading = 0;
+
+    for (int x = -1; x < map_width + 1; x++)
+    {
+        north_altitudes[x + 1] = getVirtualBaseAltitude(&chunk_task, x, -1);
+    }
+
+    int success = 1;
+
+    // The last row is the virtual one : its base altitude finishes the last chunk row
+    for (int y = 0; y < map_height + 1 && success; y++)
+    {
+        chunk_task.height_idx = y;
+        chunk_task.first_chunk_row = y;
+        chunk_task.map_values = bands[y % 2];
+
+        if (y < map_height)
+        {
+            if (stream_context.options.gradient_source == HASHED_GRADIENTS)
+            {
+                parallelRowBands(pool, map_width, generateStreamChunksBand, &chunk_task);
+            }
+            else
+            {
+                // Each chunk needs its west neighbour : its layers are generated in parallel instead
+                generateStreamChunksBand(&chunk_task, 0, 0, map_width);
+            }
+
+            for (int x = 0; x < map_width; x++)
+            {
+                altitudes[x + 1] = window_chunks[map_width + x]->base_altitude;
+            }
+
+            altitudes[0] = getVirtualBaseAltitude(&chunk_task, -1, y);
+            altitudes[map_width + 1] = getVirtualBaseAltitude(&chunk_task, map_width, y);
+        }
+        else
+        {
+            for (int x = -1; x < map_width + 1; x++)
+            {
+                altitudes[x + 1] = getVirtualBaseAltitude(&chunk_task, x, y);
+            }
+        }
+
+        // The regions between the two rows : the bottom half of the previous row and the top half of the current one, each in its band
+        north_band.map_values = bands[(y + 1) % 2];
+        south_band.map_values = bands[y % 2];
+
+        for (int i = 0; i < map_width + 1; i++)
+        {
+            addRegionAltitude(&north_band, 0, (y - 1) * chunk_height, width, y * chunk_height, i, y, north_altitudes[i], north_altitudes[i+1],
+                                altitudes[i], altitudes[i+1]);
+            addRegionAltitude(&south_band, 0, y * chunk_height, width, (y + 1) * chunk_height, i, y, north_altitudes[i], north_altitudes[i+1],
+                                altitudes[i], altitudes[i+1]);
+        }
+
+        // The previous row is finished
+        for (int r = 0; r < chunk_height && y > 0 && success; r++)
+        {
+            success = sink(sink_data, (y - 1) * chunk_height + r, width, north_band.map_values + r * width);
+        }
+
+        // The current row becomes the previous one : its chunks keep their views into their band, which the next row does not use
+        for (int x = 0; x < map_width; x++)
+        {
+            freeChunk(window_chunks[x]);
+            window_chunks[x] = window_chunks[map_width + x];
+            window_chunks[map_width + x] = NULL;
+        }
+
+        double* previous_altitudes = north_altitudes;
+        north_altitudes = altitudes;
+        altitudes = previous_altitudes;
+
+        if (display_loading != 0)
+        {
+            char base_str[100] = "Streaming the chunk rows...        ";
+
+            predefined_loading_bar(y + 1, map_height + 1, NUMBER_OF_SEGMENTS, base_str, display_loading - 1, start_time);
+        }
+    }
+
+    for (int k = 0; k < 2 * map_width; k++)
+    {
+        freeChunk(window_chunks[k]);
+    }
+
+    free(altitudes);
+    free(north_altitudes);
+    free(window_chunks);
+    free(window_values);
+
+    releasePerlinTables(context, stream_context.options.perlin_tables);
+    releaseThreadPool(context, pool);
+
+    if (!success)
+    {
+        printf("%sERROR : the map stream was stopped by its sink%s\n", RED_COLOR, DEFAULT_COLOR);
+    }
+    else if (display_loading == 1)
+    {
+        double total_time = (double) (clock() - start_time)/CLOCKS_PER_SEC;
+        char final_string[200] = "";
+
+        snprintf(final_string, sizeof(final_string), "%sSUCCESS :%s The map streaming took a total of %.4lf second(s) in CPU time.\n",
+                                GREEN_COLOR, DEFAULT_COLOR, total_time);
+
+        indent_print(display_loading - 1, final_string);
+    }
+
+    return success;
+}
+
+
+
+
+
+/**
+ * @brief Generates the gradient grids of a layer of the chunk at the given map indexes with stored gradients, without generating its neighbours :
+ * the north and west boundaries are rebuilt from the random grids of the north, west and north-west chunks. The boundary rows and columns
+ * a chunk hands over are its own random vectors, but for the corner the west chunk copies from the north-west one.
+ * 
+ * @param task (struct mapChunkTask*) : the pointer to the task holding the map parameters and the chunk indexes.
+ * @param chunk_context (generatorContext*) : the pointer to the context of the chunk.
+ * @param layer_idx (int) : the index of the layer.
+ * @return gradientGrid* : the pointer to the gradient grid of the layer, the same as the one of the generated map.
+ */
+static gradientGrid* regenerateStoredGradGrid(struct mapChunkTask* task, generatorContext* chunk_context, int layer_idx)
+{
+    int chunk_x = task->width_idx;
+    int chunk_y = task->height_idx;
+    int width = task->gradGrids_width[layer_idx];
+    int height = task->gradGrids_height[layer_idx];
+
+    gradientGrid* north_grid = NULL;
+    gradientGrid* west_grid = NULL;
+
+    if (chunk_y > 0)
+    {
+        generatorContext north_context = getChunkContext(task->context, chunk_x, chunk_y - 1);
+        generatorContext layer_context = getLayerContext(&north_context, layer_idx);
+        north_grid = newRandomGradGrid(width, height, &layer_context, 0);
+    }
+
+    if (chunk_x > 0)
+    {
+        generatorContext west_context = getChunkContext(task->context, chunk_x - 1, chunk_y);
+        generatorContext layer_context = getLayerContext(&west_context, layer_idx);
+        west_grid = newRandomGradGrid(width, height, &layer_context, 0);
+
+        if (chunk_y > 0)
+        {
+            generatorContext north_west_context = getChunkContext(task->context, chunk_x - 1, chunk_y - 1);
+            generatorContext north_west_layer_context = getLayerContext(&north_west_context, layer_idx);
+            gradientGrid* north_west_grid = newRandomGradGrid(width, height, &north_west_layer_context, 0);
+
+            *getVectorUnchecked(west_grid, width - 1, 0) = getGradient(north_west_grid, width - 1, height - 1);
+
+            freeGradGrid(north_west_grid);
+        }
+    }
+
+    generatorContext layer_context = getLayerContext(chunk_context, layer_idx);
+    gradientGrid* gradient_grid = newAdjacentGradGrid(north_grid, west_grid, &layer_context, 0);
+
+    freeGradGrid(north_grid);
+    freeGradGrid(west_grid);
+
+    return gradient_grid;
+}
+
+chunk* regenerateMapChunk(int number_of_layers, int gradGrids_width[number_of_layers], int gradGrids_height[number_of_layers],
+                            int size_factors[number_of_layers], double layers_factors[number_of_layers], int map_width, int map_height,
+                            int chunk_x, int chunk_y, generatorContext* context)
+{
+    if (chunk_x < 0 || chunk_x >= map_width || chunk_y < 0 || chunk_y >= map_height)
+    {
+        printf("%sERROR : the chunk (%d, %d) is out of the map of %d x %d chunks%s\n", RED_COLOR, chunk_x, chunk_y, map_width, map_height, DEFAULT_COLOR);
+        return NULL;
+    }
+
+    // The chunk owns its values and keeps its layers, whatever the map does
+    generatorContext root_context = *context;
+    root_context.options.arena = NULL;
+    root_context.options.chunk_views = 0;
+    root_context.options.chunk_retention = KEEP_FULL_CHUNKS;
+
+    struct mapChunkTask chunk_task;
+    memset(&chunk_task, 0, sizeof(struct mapChunkTask));
+
+    chunk_task.number_of_layers = number_of_layers;
+    chunk_task.gradGrids_width = gradGrids_width;
+    chunk_task.gradGrids_height = gradGrids_height;
+    chunk_task.size_factors = size_factors;
+    chunk_task.layers_factors = layers_factors;
+    chunk_task.map_width = map_width;
+    chunk_task.width_idx = chunk_x;
+    chunk_task.height_idx = chunk_y;
+    chunk_task.context = &root_context;
+
+    generatorContext chunk_context = getChunkContext(&root_context, chunk_x, chunk_y);
+    chunk* new_chunk = NULL;
+
+    if ((chunk_x == 0 && chunk_y == 0) || root_context.options.gradient_source == HASHED_GRADIENTS)
+    {
+        new_chunk = newChunk(number_of_layers, gradGrids_width, gradGrids_height, size_factors, layers_factors, 0, NULL, 0, &chunk_context, 0);
+    }
+    else
+    {
+        gradientGrid* gradient_grids[number_of_layers];
+
+        for (int k = 0; k < number_of_layers; k++)
+        {
+            gradient_grids[k] = regenerateStoredGradGrid(&chunk_task, &chunk_context, k);
+        }
+
+        // size_factors should match gradient_grids dimensions - 1
+        int chunk_width = (gradGrids_width[0] - 1) * size_factors[0];
+        int chunk_height = (gradGrids_height[0] - 1) * size_factors[0];
+
+        new_chunk = newChunkFromGradients(chunk_width, chunk_height, number_of_layers, gradient_grids, size_factors, layers_factors, 0,
+                                            NULL, 0, &chunk_context, 0);
+    }
+
+    // The base altitudes of the neighbours, virtual ones included
+    double altitudes[3][3];
+
+    for (int dx = -1; dx <= 1; dx++)
+    {
+        for (int dy = -1; dy <= 1; dy++)
+        {
+            if (dx == 0 && dy == 0)
+            {
+                altitudes[1][1] = new_chunk->base_altitude;
+            }
+            else
+            {
+                altitudes[1 + dx][1 + dy] = getVirtualBaseAltitude(&chunk_task, chunk_x + dx, chunk_y + dy);
+            }
+        }
+    }
+
+    // The chunk is a window of one chunk on the map : only the quarters of the four regions overlapping it are added
+    map chunk_window = {0};
+    chunk_window.map_width = map_width;
+    chunk_window.map_height = map_height;
+    chunk_window.chunk_width = new_chunk->width;
+    chunk_window.chunk_height = new_chunk->height;
+    chunk_window.map_values = new_chunk->chunk_values;
+
+    int first_col = chunk_x * new_chunk->width;
+    int first_row = chunk_y * new_chunk->height;
+
+    for (int i = chunk_x; i < chunk_x + 2; i++)
+    {
+        for (int j = chunk_y; j < chunk_y + 2; j++)
+        {
+            addRegionAltitude(&chunk_window, first_col, first_row, first_col + new_chunk->width, first_row + new_chunk->height, i, j,
+                                altitudes[i - chunk_x][j - chunk_y], altitudes[i - chunk_x + 1][j - chunk_y],
+                                altitudes[i - chunk_x][j - chunk_y + 1], altitudes[i - chunk_x + 1][j - chunk_y + 1]);
+        }
+    }
+
+    return new_chunk;
+}
+
+
+
+
+
+map* copyMap(map* p_map) 
+{
+    map* res = calloc(1, sizeof(map));
+
+    res->map_width=p_map->map_width;
+    res->map_height=p_map->map_height;
+    res->chunk_width=p_map->chunk_width;
+    res->chunk_height=p_map->chunk_height;
+
+    res->chunks = calloc(res->chunk_width*res->chunk_height,sizeof(chunk*));
+    for (int i=0; i<res->map_width; i++)
+    {
+        for (int j=0; j<res->map_height; j++)
+        {
+            res->chunks[i*res->map_width+j]=copyChunk(p_map->chunks[i*p_map->map_width+j]);
+        }
+    }
+
+    int n = res->chunk_width*res->map_width;
+    int m = res->chunk_height*res->map_height;
+
+    res->map_values = calloc(n*m, sizeof(altitude_t));
+
+    for (int i=0; i<n; i++)
+    {
+        for (int j=0; j<m; j++)
+        {
+            *getMapValueUnchecked(res,i,j)=*getMapValueUnchecked(p_map,i,j);
+        }
+    }
+
+    return res;
+}
+
+
+
+
+
+void writeMapFile(map* map, char path[])
+{
+    FILE* f = NULL;
+
+    f = fopen(path, "w");
+
+    if (f != NULL)
     {
         fprintf(f, "Map\n");
 
@@ -475,25 +1479,32 @@ void writeMapFile(map* map, char path[])
         int width = map_width * chunk_width;
         int height = map_height * chunk_height;
 
-        // Writing the values
-        for (int i = 0; i < height; i++)
+        int success = 1;
+
+        // Writing the values, one row at a time
+        textRow* row = newTextRow(TEXT_VALUE_LENGTH * width);
+
+        for (int i = 0; i < height && success; i++)
         {
             for (int j = 0; j < width; j++)
             {
-                double value = *getMapValue(map, j, i);
+                altitude_t value = *getMapValueUnchecked(map, j, i);
 
-                if (j != width - 1)
-                {
-                    fprintf(f, "% .8lf\t", value);
-                }
-                else
-                {
-                    fprintf(f, "% .8lf\n", value);
-                }
+                appendTextFixed(row, value, 8, 1);
+                appendTextChar(row, j != width - 1 ? '\t' : '\n');
             }
+
+            success = writeTextRow(row, f);
         }
 
-        fclose(f);
+        freeTextRow(row);
+
+        success = fclose(f) == 0 && success;
+
+        if (!success)
+        {
+            printf("%sERROR : could not write the map at path '%s'%s\n", RED_COLOR, path, DEFAULT_COLOR);
+        }
     }
     else
     {
@@ -504,9 +1515,352 @@ void writeMapFile(map* map, char path[])
 
 
 
-map* readMapFile(char path[]);
+map* readMapFile(char path[])
+{
+    mappedBinaryFile* mapped_file = mapBinaryFile(path, BINARY_MAP, ALTITUDE_DTYPE, 1);
+
+    if (mapped_file == NULL)
+    {
+        return NULL;
+    }
+
+    binaryHeader* header = &mapped_file->header;
+
+    // The values are indexed through the chunks geometry
+    if (header->width != header->map_width * header->chunk_width || header->height != header->map_height * header->chunk_height)
+    {
+        printf("%sERROR : inconsistent chunks geometry in the map binary file at path '%s'%s\n", RED_COLOR, path, DEFAULT_COLOR);
+        unmapBinaryFile(mapped_file);
+        return NULL;
+    }
+
+    map* new_map = calloc(1, sizeof(map));
+
+    new_map->map_width = header->map_width;
+    new_map->map_height = header->map_height;
+    new_map->chunk_width = header->chunk_width;
+    new_map->chunk_height = header->chunk_height;
+    new_map->map_values = mapped_file->samples;
+    new_map->mapped_file = mapped_file;
+
+    return new_map;
+}
+
+
+
+/**
+ * @brief Gets the header of a map binary file, with the chunks geometry of the map.
+ * 
+ * @param map_width (int) : number of chunks in width.
+ * @param map_height (int) : number of chunks in height.
+ * @param chunk_width (int) : the width of the chunks.
+ * @param chunk_height (int) : the height of the chunks.
+ * @param seed (uint64_t) : the seed of the generation.
+ * @param codec (int) : the codec of the values.
+ * @return binaryHeader : the header.
+ */
+static binaryHeader initMapBinaryHeader(int map_width, int map_height, int chunk_width, int chunk_height, uint64_t seed, int codec)
+{
+    binaryHeader header = initBinaryHeader(BINARY_MAP, ALTITUDE_DTYPE, 1, map_width * chunk_width, map_height * chunk_height, seed);
+
+    header.map_width = map_width;
+    header.map_height = map_height;
+    header.chunk_width = chunk_width;
+    header.chunk_height = chunk_height;
+    header.codec = codec;
+    header.quantization_bits = codec == BINARY_CODEC_QUANTIZED ? BINARY_QUANTIZATION_BITS : 0;
+
+    return header;
+}
+
+
+
+void writeMapBinaryFile(map* map, uint64_t seed, int codec, char path[])
+{
+    FILE* f = fopen(path, "wb");
+
+    if (f == NULL)
+    {
+        printf("%sERROR : could not open file in writing mode at path '%s'%s\n", RED_COLOR, path, DEFAULT_COLOR);
+        return;
+    }
+
+    binaryHeader header = initMapBinaryHeader(map->map_width, map->map_height, map->chunk_width, map->chunk_height, seed, codec);
+
+    if (!writeBinaryHeader(f, &header) || !writeBinaryPayload(f, &header, map->map_values))
+    {
+        printf("%sERROR : could not write the map at path '%s'%s\n", RED_COLOR, path, DEFAULT_COLOR);
+    }
+
+    fclose(f);
+}
+
+
+
+/**
+ * @brief Encodes a row of a streamed map in a binary file (a `mapRowSink`).
+ * 
+ * @param sink_data (void*) : the pointer to the binaryEncoder of the file.
+ * @param row_idx (int) : the index of the row (unused : the rows come in order).
+ * @param width (int) : the number of values of the row (unused).
+ * @param row_values (altitude_t*) : the values of the row.
+ * @return int : `1` if the row was encoded, `0` otherwise.
+ */
+static int encodeStreamedMapRow(void* sink_data, int row_idx, int width, altitude_t* row_values)
+{
+    return encodeBinaryRow(sink_data, row_values);
+}
+
+
+
+int streamMapBinaryFile(int number_of_layers, int gradGrids_width[number_of_layers], int gradGrids_height[number_of_layers],
+                            int size_factors[number_of_layers], double layers_factors[number_of_layers], int map_width, int map_height,
+                            generatorContext* context, int codec, char path[], unsigned int display_loading)
+{
+    FILE* f = fopen(path, "wb");
+
+    if (f == NULL)
+    {
+        printf("%sERROR : could not open file in writing mode at path '%s'%s\n", RED_COLOR, path, DEFAULT_COLOR);
+        return 0;
+    }
+
+    // size_factors should match gradient_grids dimensions - 1
+    binaryHeader header = initMapBinaryHeader(map_width, map_height, (gradGrids_width[0] - 1) * size_factors[0],
+                                                (gradGrids_height[0] - 1) * size_factors[0], context->seed, codec);
+
+    int success = writeBinaryHeader(f, &header);
+
+    if (success)
+    {
+        binaryEncoder* encoder = newBinaryEncoder(f, &header);
+
+        success = streamMap(number_of_layers, gradGrids_width, gradGrids_height, size_factors, layers_factors, map_width, map_height,
+                                context, encodeStreamedMapRow, encoder, display_loading);
+        success = freeBinaryEncoder(encoder) && success;
+    }
+
+    if (!success)
+    {
+        printf("%sERROR : could not write the map at path '%s'%s\n", RED_COLOR, path, DEFAULT_COLOR);
+    }
+
+    fclose(f);
+
+    return success;
+}
+
+
+
+map* readMapBinaryFile(char path[], binaryHeader* header)
+{
+    FILE* f = fopen(path, "rb");
+
+    if (f == NULL)
+    {
+        printf("%sERROR : could not open file in reading mode at path '%s'%s\n", RED_COLOR, path, DEFAULT_COLOR);
+        return NULL;
+    }
+
+    binaryHeader file_header = initBinaryHeader(BINARY_MAP, 0, 0, 0, 0, 0);
+    map* new_map = NULL;
+
+    if (readBinaryHeader(f, BINARY_MAP, &file_header) && file_header.nb_components == 1)
+    {
+        new_map = calloc(1, sizeof(map));
+
+        new_map->map_width = file_header.map_width;
+        new_map->map_height = file_header.map_height;
+        new_map->chunk_width = file_header.chunk_width;
+        new_map->chunk_height = file_header.chunk_height;
+        new_map->map_values = calloc((size_t) file_header.width * file_header.height, sizeof(altitude_t));
+
+        if (!readBinaryPayload(f, &file_header, ALTITUDE_DTYPE, new_map->map_values))
+        {
+            printf("%sERROR : truncated map binary file at path '%s'%s\n", RED_COLOR, path, DEFAULT_COLOR);
+            freeMap(new_map);
+            new_map = NULL;
+        }
+    }
+
+    fclose(f);
+
+    if (header != NULL)
+    {
+        *header = file_header;
+    }
+
+    return new_map;
+}
+
+
+
+
+
+/**
+ * @brief Computes the size of the fixed part of a chunk record of a tiled binary file, before its values.
+ * 
+ * @param number_of_layers (int) : the number of layers of the chunk.
+ * @return size_t : the size in bytes. It keeps the values aligned for every sample type.
+ */
+static size_t getTiledChunkRecordHeaderSize(int number_of_layers)
+{
+    return 16 + 16 * (size_t) number_of_layers;
+}
+
+
+
+void writeMapTiledFile(map* map, uint64_t seed, char path[])
+{
+    FILE* f = fopen(path, "wb");
+
+    if (f == NULL)
+    {
+        printf("%sERROR : could not open file in writing mode at path '%s'%s\n", RED_COLOR, path, DEFAULT_COLOR);
+        return;
+    }
+
+    int map_width = map->map_width;
+    int map_height = map->map_height;
+    int chunk_width = map->chunk_width;
+    int chunk_height = map->chunk_height;
+    int nb_records = map_width * map_height;
+
+    binaryHeader header = initBinaryHeader(BINARY_TILED_MAP, ALTITUDE_DTYPE, 1, map_width * chunk_width, map_height * chunk_height, seed);
+    header.map_width = map_width;
+    header.map_height = map_height;
+    header.chunk_width = chunk_width;
+    header.chunk_height = chunk_height;
+    header.number_of_layers = getChunk(map, 0, 0)->number_of_layers;
+    header.nb_records = nb_records;
+
+    uint64_t* offsets = calloc(nb_records, sizeof(uint64_t));
+    uint64_t* sizes = calloc(nb_records, sizeof(uint64_t));
+
+    // The index is written once the records are placed
+    int success = writeBinaryHeader(f, &header) && writeBinaryIndex(f, nb_records, offsets, sizes);
+
+    uint64_t offset = BINARY_HEADER_SIZE + 16 * (uint64_t) nb_records;
+    size_t values_size = (size_t) chunk_width * chunk_height * getBinarySampleSize(ALTITUDE_DTYPE);
+
+    for (int k = 0; k < nb_records && success; k++)
+    {
+        chunk* current_chunk = map->chunks[k];
+        int number_of_layers = current_chunk->number_of_layers;
+        size_t record_header_size = getTiledChunkRecordHeaderSize(number_of_layers);
+
+        unsigned char* record_header = calloc(record_header_size, 1);
+
+        putBinaryDouble(record_header, current_chunk->base_altitude);
+        putBinaryInteger(record_header + 8, number_of_layers, 4);
+
+        for (int l = 0; l < number_of_layers; l++)
+        {
+            putBinaryDouble(record_header + 16 + 16 * l, current_chunk->layers_factors[l]);
+            putBinaryInteger(record_header + 24 + 16 * l, current_chunk->layers[l]->size_factor, 4);
+        }
+
+        success = fwrite(record_header, 1, record_header_size, f) == record_header_size;
+        free(record_header);
+
+        // The window of the chunk in the map values, one row at a time : they hold the final altitudes whether the chunk is a view or not
+        int chunk_x = k % map_width;
+        int chunk_y = k / map_width;
+
+        for (int i = 0; i < chunk_height && success; i++)
+        {
+            success = writeBinarySamples(f, ALTITUDE_DTYPE, getMapValueUnchecked(map, chunk_x * chunk_width, chunk_y * chunk_height + i), chunk_width);
+        }
+
+        offsets[k] = offset;
+        sizes[k] = record_header_size + values_size;
+        offset += sizes[k];
+    }
+
+    success = success && fseek(f, BINARY_HEADER_SIZE, SEEK_SET) == 0 && writeBinaryIndex(f, nb_records, offsets, sizes);
+
+    if (!success)
+    {
+        printf("%sERROR : could not write the tiled map at path '%s'%s\n", RED_COLOR, path, DEFAULT_COLOR);
+    }
+
+    free(offsets);
+    free(sizes);
+
+    fclose(f);
+}
+
+
+
+binaryRecordFile* openMapTiledFile(char path[])
+{
+    return openBinaryRecordFile(path, BINARY_TILED_MAP);
+}
+
+
+
+chunk* readMapTiledChunk(binaryRecordFile* tiled_file, int width_idx, int height_idx)
+{
+    binaryHeader* header = &tiled_file->header;
+
+    if (width_idx < 0 || width_idx >= header->map_width || height_idx < 0 || height_idx >= header->map_height)
+    {
+        printf("%sERROR : invalid chunk (%d, %d) when reading a tiled map of (%d, %d) chunks%s\n", RED_COLOR, width_idx, height_idx,
+                    header->map_width, header->map_height, DEFAULT_COLOR);
+        return NULL;
+    }
+
+    int record_idx = height_idx * header->map_width + width_idx;
+    unsigned char* record = readBinaryRecord(tiled_file, record_idx);
+
+    if (record == NULL)
+    {
+        return NULL;
+    }
+
+    int width = header->chunk_width;
+    int height = header->chunk_height;
+    int number_of_layers = (int) getBinaryInteger(record + 8, 4);
+
+    size_t record_header_size = getTiledChunkRecordHeaderSize(number_of_layers);
+    size_t nb_values = (size_t) width * height;
+
+    if (tiled_file->sizes[record_idx] != record_header_size + nb_values * getBinarySampleSize(header->dtype))
+    {
+        printf("%sERROR : invalid record for the chunk (%d, %d) of a tiled map%s\n", RED_COLOR, width_idx, height_idx, DEFAULT_COLOR);
+        free(record);
+        return NULL;
+    }
+
+    chunk* new_chunk = calloc(1, sizeof(chunk));
+
+    new_chunk->width = width;
+    new_chunk->height = height;
+    new_chunk->base_altitude = getBinaryDouble(record);
+    new_chunk->number_of_layers = number_of_layers;
+    new_chunk->layers_factors = calloc(number_of_layers, sizeof(double));
+    new_chunk->layers = calloc(number_of_layers, sizeof(layer*));
+
+    for (int l = 0; l < number_of_layers; l++)
+    {
+        new_chunk->layers_factors[l] = getBinaryDouble(record + 16 + 16 * l);
+
+        new_chunk->layers[l] = calloc(1, sizeof(layer));
+        new_chunk->layers[l]->width = width;
+        new_chunk->layers[l]->height = height;
+        new_chunk->layers[l]->size_factor = (int) getBinaryInteger(record + 24 + 16 * l, 4);
+    }
+
+    new_chunk->chunk_values = calloc(nb_values, sizeof(altitude_t));
+    new_chunk->values_stride = width;
+    new_chunk->owns_values = 1;
+
+    decodeBinarySamples(record + record_header_size, header->dtype, ALTITUDE_DTYPE, new_chunk->chunk_values, nb_values);
 
+    free(record);
 
+    return new_chunk;
+}
 
 
 
@@ -525,7 +1879,7 @@ void printMap(map* map)
     {
         for (int j = 0; j < map_width * chunk_width; j++)
         {
-            double* value = getMapValue(map, j, i);
+            altitude_t* value = getMapValueUnchecked(map, j, i);
 
             if (j != 0 && j%chunk_width == 0)
             {
@@ -557,12 +1911,17 @@ void printMap(map* map)
 
 void freeMap(map* map)
 {
-    if (map != NULL)
+    // The arena owns its structures
+    if (map != NULL && map->arena == NULL)
     {
         int map_width = map->map_width;
         int map_height = map->map_height;
 
-        if (map->map_values != NULL)
+        if (map->mapped_file != NULL)
+        {
+            unmapBinaryFile(map->mapped_file);
+        }
+        else if (map->map_values != NULL)
         {
             free(map->map_values);
         }
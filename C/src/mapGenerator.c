@@ -14,6 +14,29 @@
 #include "loadingBar.h"
 #include "map.h"
 #include "mapGenerator.h"
+#include "textFormat.h"
+
+/**
+ * @brief The size of the fixed part of the payload of a recipe file, before the layers : the generator version, the gradient source,
+ * the gradient type and 2 reserved bytes.
+ * 
+ */
+#define RECIPE_FIXED_SIZE 8
+
+/**
+ * @brief The size of each layer in the payload of a recipe file : its gradient grid dimension (u32) and its factor (f64).
+ * 
+ */
+#define RECIPE_LAYER_SIZE 12
+
+/**
+ * @brief The maximum number of layers of a recipe. The layers arrays of a regeneration are on the stack : a read number of layers
+ * is never trusted beyond it.
+ * 
+ */
+#define RECIPE_MAX_LAYERS 64
+
+
 
 int gcd(int a, int b)
 {
@@ -116,9 +139,9 @@ int lcmOfArray(int nb, int array[nb])
 
 
 
-double* getCompleteMapSeaValue(completeMap* completeMap, int width_idx, int height_idx)
+altitude_t* getCompleteMapSeaValue(completeMap* completeMap, int width_idx, int height_idx)
 {
-    double* sea_value = NULL;
+    altitude_t* sea_value = NULL;
 
     if (completeMap != NULL)
     {
@@ -166,7 +189,7 @@ color* getCompleteMapColor(completeMap* completeMap, int width_idx, int height_i
             return NULL;
         }
 
-        map_color = completeMap->color_map[height_idx * width + width_idx];
+        map_color = completeMap->color_map + height_idx * width + width_idx;
     }
 
     return map_color;
@@ -174,57 +197,276 @@ color* getCompleteMapColor(completeMap* completeMap, int width_idx, int height_i
 
 
 
-color* colorize(double value, double sea_level, double min_value, double max_value)
+color colorize(double value, double sea_level, double min_value, double max_value)
+{
+    return getPaletteColor(NULL, value, sea_level, min_value, max_value);
+}
+
+
+
+
+
+/**
+ * @brief The parameters and results of the color map and sea level passes, shared by their row bands or chunk tasks.
+ * 
+ */
+struct postProcessingPass
+{
+    map* map; /**< the pointer to the map to process*/
+    double sea_level; /**< the sea altitude*/
+    int width; /**< the width of the map, in values*/
+    int height; /**< the height of the map, in values*/
+    int nb_parts; /**< the number of row bands or chunks the pass is split in*/
+    altitude_t* part_min_values; /**< the minimum value of each row band or chunk*/
+    altitude_t* part_max_values; /**< the maximum value of each row band or chunk*/
+    altitude_t min_value; /**< the minimum value of the whole map*/
+    altitude_t max_value; /**< the maximum value of the whole map*/
+    colorPalette* palette; /**< the palette of the color map, `NULL` for the default one*/
+    colorLUT* lut; /**< the color lookup table, built once the minimum and maximum values are known*/
+    color* color_map; /**< the color map to fill*/
+    altitude_t* sea_map; /**< the sea map to fill*/
+    unsigned int display_loading; /**< the display_loading value of the pass, `0` when run in parallel*/
+    clock_t start_time; /**< the start time of the pass, for the loading bars*/
+};
+
+/**
+ * @brief Gets the minimum and maximum values of the given area of the map (first pass of `generateColorMap`).
+ * 
+ * @param pass (struct postProcessingPass*) : the pointer to the pass.
+ * @param part_idx (int) : the index of the row band or chunk, where the results are stored.
+ * @param first_row (int) : the first row of the area.
+ * @param end_row (int) : the row after the last one of the area.
+ * @param first_col (int) : the first column of the area.
+ * @param end_col (int) : the column after the last one of the area.
+ */
+static void minMaxArea(struct postProcessingPass* pass, int part_idx, int first_row, int end_row, int first_col, int end_col)
 {
-    color* new_color = calloc(1, sizeof(color));
+    int width = pass->width;
+    int height = pass->height;
 
-    int i = (int) ((value - min_value) * 255. / (max_value - min_value));
-    int s = (int) ((value - min_value) * 200. / (sea_level - min_value));
+    altitude_t min_value = *getMapValueUnchecked(pass->map, first_col, first_row);
+    altitude_t max_value = min_value;
 
-    //? Show red dots on zero values. Could be removed.
-    if (value == 0)
+    for (int i = first_row; i < end_row; i++)
     {
-        new_color->red_int = 255;
-        new_color->green_int = 0;
-        new_color->blue_int = 0;
+        altitude_t* map_row = getMapValueUnchecked(pass->map, 0, i);
+
+        for (int j = first_col; j < end_col; j++)
+        {
+            altitude_t map_value = map_row[j];
+
+            if (map_value < min_value)
+            {
+                min_value = map_value;
+            }
+
+            if (map_value > max_value)
+            {
+                max_value = map_value;
+            }
+
+            if (pass->display_loading != 0)
+            {
+                // Begin of the loading bar, which will be finished in the following pass
+                int nb_indents = pass->display_loading - 1;
+
+                char base_str[100] = "Generating color map...            ";
 
-        new_color->red_float = 1.;
-        new_color->green_float = 0;
-        new_color->blue_float = 0;
+                predefined_loading_bar(i * width + j, 2 * height * width - 2, NUMBER_OF_SEGMENTS, base_str, nb_indents, pass->start_time);
+            }
+        }
     }
-    else if (value <= sea_level)
+
+    pass->part_min_values[part_idx] = min_value;
+    pass->part_max_values[part_idx] = max_value;
+}
+
+/**
+ * @brief Reduces the minimum and maximum values of every row band or chunk into the ones of the whole map.
+ * If the pass fills a color map, its lookup table is then built on this range.
+ * 
+ * @param argument (void*) : the pointer to the postProcessingPass structure.
+ */
+static void reduceMinMax(void* argument)
+{
+    struct postProcessingPass* pass = argument;
+
+    pass->min_value = pass->part_min_values[0];
+    pass->max_value = pass->part_max_values[0];
+
+    for (int k = 1; k < pass->nb_parts; k++)
     {
-        new_color->red_int = 50;
-        new_color->green_int = 50;
-        new_color->blue_int = s;
+        if (pass->part_min_values[k] < pass->min_value)
+        {
+            pass->min_value = pass->part_min_values[k];
+        }
 
-        new_color->red_float = 1./255 * 50;
-        new_color->green_float = 1./255 * 50;
-        new_color->blue_float = 1./255 * s;
+        if (pass->part_max_values[k] > pass->max_value)
+        {
+            pass->max_value = pass->part_max_values[k];
+        }
     }
-    else
+
+    if (pass->color_map != NULL)
+    {
+        pass->lut = newColorLUT(pass->palette, PALETTE_LUT_SIZE, pass->sea_level, pass->min_value, pass->max_value);
+    }
+}
+
+/**
+ * @brief Colorizes the given area of the map (second pass of `generateColorMap`).
+ * 
+ * @param pass (struct postProcessingPass*) : the pointer to the pass.
+ * @param first_row (int) : the first row of the area.
+ * @param end_row (int) : the row after the last one of the area.
+ * @param first_col (int) : the first column of the area.
+ * @param end_col (int) : the column after the last one of the area.
+ */
+static void colorizeArea(struct postProcessingPass* pass, int first_row, int end_row, int first_col, int end_col)
+{
+    int width = pass->width;
+    int height = pass->height;
+
+    colorLUT* lut = pass->lut;
+
+    for (int i = first_row; i < end_row; i++)
+    {
+        altitude_t* map_row = getMapValueUnchecked(pass->map, 0, i);
+        color* color_row = pass->color_map + i * width;
+
+        // One quantization and one table load per value
+        for (int j = first_col; j < end_col; j++)
+        {
+            color_row[j] = lookupColor(lut, map_row[j]);
+        }
+
+        if (pass->display_loading != 0)
+        {
+            // End of the loading bar, which was started in the previous pass : updated once per row, at its last value
+            int nb_indents = pass->display_loading - 1;
+
+            char base_str[100] = "Generating color map...            ";
+
+            predefined_loading_bar(height * width - 1 + i * width + end_col - 1, 2 * height * width - 2, NUMBER_OF_SEGMENTS, base_str, nb_indents, pass->start_time);
+        }
+    }
+}
+
+/**
+ * @brief Flattens the altitude values on the sea for the given area of the map (`setSeaLevel` pass).
+ * 
+ * @param pass (struct postProcessingPass*) : the pointer to the pass.
+ * @param first_row (int) : the first row of the area.
+ * @param end_row (int) : the row after the last one of the area.
+ * @param first_col (int) : the first column of the area.
+ * @param end_col (int) : the column after the last one of the area.
+ */
+static void seaLevelArea(struct postProcessingPass* pass, int first_row, int end_row, int first_col, int end_col)
+{
+    int width = pass->width;
+    int height = pass->height;
+    double sea_level = pass->sea_level;
+
+    for (int i = first_row; i < end_row; i++)
     {
-        new_color->red_int = 50;
-        new_color->green_int = i;
-        new_color->blue_int = 50;
+        altitude_t* map_row = getMapValueUnchecked(pass->map, 0, i);
+        altitude_t* sea_row = pass->sea_map + i * width;
+
+        for (int j = first_col; j < end_col; j++)
+        {
+            altitude_t map_value = map_row[j];
+
+            if (map_value <= sea_level)
+            {
+                sea_row[j] = (altitude_t) sea_level;
+            }
+            else
+            {
+                sea_row[j] = map_value;
+            }
+
 
-        new_color->red_float = 1./255 * 50;
-        new_color->green_float = 1./255 * i;
-        new_color->blue_float = 1./255 * 50;
+            if (pass->display_loading != 0)
+            {
+                int nb_indents = pass->display_loading - 1;
+
+                char base_str[100] = "Setting sea level...               ";
+
+                predefined_loading_bar(i * width + j, height * width - 1, NUMBER_OF_SEGMENTS, base_str, nb_indents, pass->start_time);
+            }
+        }
     }
+}
+
+/**
+ * @brief The min/max pass of `generateColorMap` on a band of map rows.
+ * 
+ * @param argument (void*) : the pointer to the postProcessingPass structure.
+ * @param band_idx (int) : the index of the row band, where its results are stored.
+ * @param first_row (int) : the first row of the band.
+ * @param end_row (int) : the row after the last one of the band.
+ */
+static void minMaxRowBand(void* argument, int band_idx, int first_row, int end_row)
+{
+    struct postProcessingPass* pass = argument;
+
+    minMaxArea(pass, band_idx, first_row, end_row, 0, pass->width);
+}
+
+/**
+ * @brief The colorizing pass of `generateColorMap` on a band of map rows.
+ * 
+ * @param argument (void*) : the pointer to the postProcessingPass structure.
+ * @param band_idx (int) : the index of the row band (unused).
+ * @param first_row (int) : the first row of the band.
+ * @param end_row (int) : the row after the last one of the band.
+ */
+static void colorizeRowBand(void* argument, int band_idx, int first_row, int end_row)
+{
+    struct postProcessingPass* pass = argument;
+
+    colorizeArea(pass, first_row, end_row, 0, pass->width);
+}
 
-    return new_color;
+/**
+ * @brief The `setSeaLevel` pass on a band of map rows.
+ * 
+ * @param argument (void*) : the pointer to the postProcessingPass structure.
+ * @param band_idx (int) : the index of the row band (unused).
+ * @param first_row (int) : the first row of the band.
+ * @param end_row (int) : the row after the last one of the band.
+ */
+static void seaLevelRowBand(void* argument, int band_idx, int first_row, int end_row)
+{
+    struct postProcessingPass* pass = argument;
+
+    seaLevelArea(pass, first_row, end_row, 0, pass->width);
+}
+
+/**
+ * @brief Prints the loading bar of a pass run in parallel, once every band is done.
+ * 
+ * @param base_str (char[]) : the base string of the loading bar.
+ * @param display_loading (unsigned int) : the display_loading value of the pass.
+ * @param start_time (clock_t) : the start time of the pass.
+ */
+static void printParallelPassLoading(char base_str[], unsigned int display_loading, clock_t start_time)
+{
+    if (display_loading != 0)
+    {
+        predefined_loading_bar(1, 1, NUMBER_OF_SEGMENTS, base_str, display_loading - 1, start_time);
+    }
 }
 
 
 
 
 
-color** generateColorMap(map* map, double sea_level, unsigned int display_loading)
+color* generateColorMap(map* map, double sea_level, generatorContext* context, unsigned int display_loading)
 {
     clock_t start_time = clock();
 
-    color** color_map = NULL;
+    color* color_map = NULL;
 
     if (map != NULL)
     {
@@ -232,68 +474,50 @@ color** generateColorMap(map* map, double sea_level, unsigned int display_loadin
         int width = map->map_width * map->chunk_width;
         int height = map->map_height * map->chunk_height;
 
-        color_map = calloc(width * height, sizeof(color*));
+        color_map = calloc(width * height, sizeof(color));
         if (color_map == NULL)
         {
             printf("%sColor map allocation was not successful. Returning NULL now...%s\n", RED_COLOR, DEFAULT_COLOR);
             return NULL;
         }
 
-        double min_value = *getMapValue(map, 0, 0);
-        double max_value = *getMapValue(map, 0, 0);
-
-        // Getting min and max values.
-        for (int i = 0; i < height; i++)
-        {
-            for (int j = 0; j < width; j++)
-            {
-                double map_value = *getMapValue(map, j, i);
-
-                if (map_value < min_value)
-                {
-                    min_value = map_value;
-                }
-
-                if (map_value > max_value)
-                {
-                    max_value = map_value;
-                }
-
-                if (display_loading != 0)
-                {
-                    // Begin of the loading bar, which will be finished in the following loop
-                    int nb_indents = display_loading - 1;
-
-                    char base_str[100] = "Generating color map...            ";
-
-                    predefined_loading_bar(i * width + j, 2 * height * width - 2, NUMBER_OF_SEGMENTS, base_str, nb_indents, start_time);
-                }
-            }
-        }
-
+        // Both passes are split in row bands, run in parallel when the context has several workers.
+        threadPool* pool = acquireThreadPool(context);
+        int nb_bands = countRowBands(pool, height);
+
+        struct postProcessingPass pass;
+
+        pass.map = map;
+        pass.sea_level = sea_level;
+        pass.width = width;
+        pass.height = height;
+        pass.nb_parts = nb_bands;
+        pass.part_min_values = calloc(nb_bands, sizeof(altitude_t));
+        pass.part_max_values = calloc(nb_bands, sizeof(altitude_t));
+        pass.palette = context != NULL ? context->options.palette : NULL;
+        pass.lut = NULL;
+        pass.color_map = color_map;
+        pass.sea_map = NULL;
+        pass.display_loading = pool == NULL ? display_loading : 0;
+        pass.start_time = start_time;
+
+        // Getting min and max values : every band reduces its own rows, then the bands are reduced in order.
+        parallelRowBands(pool, height, minMaxRowBand, &pass);
+        reduceMinMax(&pass);
 
         // Generating colors now
-        for (int i = 0; i < height; i++)
-        {
-            for (int j = 0; j < width; j++)
-            {
-                double map_value = *getMapValue(map, j, i);
-
-                color* c = colorize(map_value, sea_level, min_value, max_value);
-                
-                color_map[i * width + j] = c;
+        parallelRowBands(pool, height, colorizeRowBand, &pass);
 
-                if (display_loading != 0)
-                {
-                    // End of the loading bar, which was started in the previous loop
-                    int nb_indents = display_loading - 1;
+        if (pool != NULL)
+        {
+            printParallelPassLoading("Generating color map...            ", display_loading, start_time);
+        }
 
-                    char base_str[100] = "Generating color map...            ";
+        free(pass.part_min_values);
+        free(pass.part_max_values);
+        freeColorLUT(pass.lut);
 
-                    predefined_loading_bar(height * width - 1 + i * width + j, 2 * height * width - 2, NUMBER_OF_SEGMENTS, base_str, nb_indents, start_time);
-                }
-            }
-        }
+        releaseThreadPool(context, pool);
     }
 
     return color_map;
@@ -301,11 +525,11 @@ color** generateColorMap(map* map, double sea_level, unsigned int display_loadin
 
 
 
-double* setSeaLevel(map* map, double sea_level, unsigned int display_loading)
+altitude_t* setSeaLevel(map* map, double sea_level, generatorContext* context, unsigned int display_loading)
 {
     clock_t start_time = clock();
 
-    double* sea_map = NULL;
+    altitude_t* sea_map = NULL;
 
     if (map != NULL)
     {
@@ -313,50 +537,235 @@ double* setSeaLevel(map* map, double sea_level, unsigned int display_loading)
         int width = map->map_width * map->chunk_width;
         int height = map->map_height * map->chunk_height;
 
-        sea_map = calloc(width * height, sizeof(double));
+        sea_map = calloc(width * height, sizeof(altitude_t));
         if (sea_map == NULL)
         {
             printf("%sSea map allocation was not successful. Returning NULL now...%s\n", RED_COLOR, DEFAULT_COLOR);
             return NULL;
         }
 
+        // The pass is split in row bands, run in parallel when the context has several workers.
+        threadPool* pool = acquireThreadPool(context);
+
+        struct postProcessingPass pass;
+
+        pass.map = map;
+        pass.sea_level = sea_level;
+        pass.width = width;
+        pass.height = height;
+        pass.nb_parts = 0;
+        pass.part_min_values = NULL;
+        pass.part_max_values = NULL;
+        pass.palette = NULL;
+        pass.lut = NULL;
+        pass.color_map = NULL;
+        pass.sea_map = sea_map;
+        pass.display_loading = pool == NULL ? display_loading : 0;
+        pass.start_time = start_time;
+
         // Flattening the altitude values on the sea
-        for (int i = 0; i < height; i++)
+        parallelRowBands(pool, height, seaLevelRowBand, &pass);
+
+        if (pool != NULL)
         {
-            for (int j = 0; j < width; j++)
-            {
-                double map_value = *getMapValue(map, j, i);
+            printParallelPassLoading("Setting sea level...               ", display_loading, start_time);
+        }
 
-                if (map_value <= sea_level)
-                {
-                    sea_map[i * width + j] = sea_level;
-                }
-                else
-                {
-                    sea_map[i * width + j] = map_value;
-                }
+        releaseThreadPool(context, pool);
+    }
 
+    return sea_map;
+}
 
-                if (display_loading != 0)
-                {
-                    int nb_indents = display_loading - 1;
 
-                    char base_str[100] = "Setting sea level...               ";
 
-                    predefined_loading_bar(i * width + j, height * width - 1, NUMBER_OF_SEGMENTS, base_str, nb_indents, start_time);
-                }
-            }
-        }
+/**
+ * @brief A post-processing task of the complete map task graph, working on one chunk.
+ * 
+ */
+struct chunkPostProcessingTask
+{
+    struct postProcessingPass* pass; /**< the pointer to the pass shared by every chunk*/
+    int width_idx; /**< the width index of the chunk*/
+    int height_idx; /**< the height index of the chunk*/
+};
+
+/**
+ * @brief Sets the sea level of the chunk of the given task and gets its minimum and maximum values, once its final values are ready.
+ * 
+ * @param argument (void*) : the pointer to the chunkPostProcessingTask structure.
+ */
+static void seaLevelMinMaxChunk(void* argument)
+{
+    struct chunkPostProcessingTask* task = argument;
+    struct postProcessingPass* pass = task->pass;
+
+    int chunk_width = pass->map->chunk_width;
+    int chunk_height = pass->map->chunk_height;
+
+    int first_row = task->height_idx * chunk_height;
+    int first_col = task->width_idx * chunk_width;
+
+    seaLevelArea(pass, first_row, first_row + chunk_height, first_col, first_col + chunk_width);
+    minMaxArea(pass, task->height_idx * pass->map->map_width + task->width_idx, first_row, first_row + chunk_height, first_col, first_col + chunk_width);
+}
+
+/**
+ * @brief Colorizes the chunk of the given task, once the minimum and maximum values of the whole map are known.
+ * 
+ * @param argument (void*) : the pointer to the chunkPostProcessingTask structure.
+ */
+static void colorizeChunk(void* argument)
+{
+    struct chunkPostProcessingTask* task = argument;
+    struct postProcessingPass* pass = task->pass;
+
+    int chunk_width = pass->map->chunk_width;
+    int chunk_height = pass->map->chunk_height;
+
+    int first_row = task->height_idx * chunk_height;
+    int first_col = task->width_idx * chunk_width;
+
+    colorizeArea(pass, first_row, first_row + chunk_height, first_col, first_col + chunk_width);
+}
+
+/**
+ * @brief Generates a new completeMap structure as a single task graph on the workers of the given context : the sea level and the
+ * min/max values of each chunk are computed as soon as its final values are ready, while the next chunks are still being generated.
+ * Only the colors wait for the whole map, as they need its minimum and maximum values. The result is the same as the one of
+ * `newMap` followed by `newCompleteMapFromMap`.
+ * 
+ * @param number_of_layers (int) : the number of layers passed.
+ * @param gradGrids_width (int[number_of_layers]) : the array of gradientGrid width to be used to generate the random gradient grids.
+ * @param gradGrids_height (int[number_of_layers]) : the array of gradientGrid height to be used to generate the random gradient grids.
+ * @param size_factors (int[number_of_layers]) : the array of size factors to generate the layers.
+ * @param layers_factors (double[number_of_layers]) : the array of layers factors.
+ * @param map_width (int) : number of chunks in width.
+ * @param map_height (int) : number of chunks in height.
+ * @param sea_level (double) : sea altitude to use.
+ * @param context (generatorContext*) : the pointer to the root generator context.
+ * @param display_loading (unsigned int) : the given value defines the behaviour.
+ *                                         * If `0` the loading bars won't be printed.
+ *                                         * If `> 0` the loading bars will be printed with a number of indent equal to `display_loading - 1`.
+ * @return completeMap* : pointer to the newly generated completeMap structure.
+ */
+static completeMap* newCompleteMapTaskGraph(int number_of_layers, int gradGrids_width[number_of_layers], int gradGrids_height[number_of_layers],
+                                            int size_factors[number_of_layers], double layers_factors[number_of_layers],
+                                            int map_width, int map_height, double sea_level, generatorContext* context, unsigned int display_loading)
+{
+    clock_t start_time = clock();
+
+    if (display_loading != 0)
+    {
+        indent_print(display_loading - 1, "Running the complete map task graph...\n");
     }
 
-    return sea_map;
+    int nb_chunks = map_width * map_height;
+
+    generatorContext pool_context = *context;
+    threadPool* pool = acquireThreadPool(&pool_context);
+    pool_context.options.pool = pool;
+
+    // Every chunk shares the weights tables of the size factors
+    // size_factors should match gradient_grids dimensions - 1
+    int chunk_width = (gradGrids_width[0] - 1) * size_factors[0];
+    int chunk_height = (gradGrids_height[0] - 1) * size_factors[0];
+
+    pool_context.options.perlin_tables = acquirePerlinTables(context, number_of_layers, size_factors,
+                                                              chunk_width > chunk_height ? chunk_width : chunk_height);
+
+    taskGroup group = {0};
+    task* chunks_ready[nb_chunks];
+
+    // Chunks generation, values and base altitude
+    map* new_map = newMapTaskGraph(number_of_layers, gradGrids_width, gradGrids_height, size_factors, layers_factors, map_width, map_height,
+                                    &pool_context, &group, chunks_ready);
+
+    int width = map_width * new_map->chunk_width;
+    int height = map_height * new_map->chunk_height;
+
+    completeMap* complete_map = calloc(1, sizeof(completeMap));
+
+    complete_map->map = new_map;
+    complete_map->width = width;
+    complete_map->height = height;
+    complete_map->sea_level = sea_level;
+    complete_map->sea_values = calloc(width * height, sizeof(altitude_t));
+    complete_map->color_map = calloc(width * height, sizeof(color));
+
+    struct postProcessingPass pass;
+
+    pass.map = new_map;
+    pass.sea_level = sea_level;
+    pass.width = width;
+    pass.height = height;
+    pass.nb_parts = nb_chunks;
+    pass.part_min_values = calloc(nb_chunks, sizeof(altitude_t));
+    pass.part_max_values = calloc(nb_chunks, sizeof(altitude_t));
+    pass.palette = context->options.palette;
+    pass.lut = NULL;
+    pass.color_map = complete_map->color_map;
+    pass.sea_map = complete_map->sea_values;
+    pass.display_loading = 0;
+    pass.start_time = start_time;
+
+    struct chunkPostProcessingTask* tasks = calloc(nb_chunks, sizeof(struct chunkPostProcessingTask));
+
+    // The min/max reduction is the only barrier of the graph
+    task* reduce_task = newGraphTask(pool, &group, reduceMinMax, &pass);
+    task* colorize_tasks[nb_chunks];
+
+    for (int k = 0; k < nb_chunks; k++)
+    {
+        tasks[k].pass = &pass;
+        tasks[k].width_idx = k % map_width;
+        tasks[k].height_idx = k / map_width;
+
+        task* sea_task = newGraphTask(pool, &group, seaLevelMinMaxChunk, tasks + k);
+        addTaskDependency(pool, chunks_ready[k], sea_task);
+        addTaskDependency(pool, sea_task, reduce_task);
+        launchGraphTask(pool, sea_task);
+
+        colorize_tasks[k] = newGraphTask(pool, &group, colorizeChunk, tasks + k);
+        addTaskDependency(pool, reduce_task, colorize_tasks[k]);
+    }
+
+    launchGraphTask(pool, reduce_task);
+
+    for (int k = 0; k < nb_chunks; k++)
+    {
+        launchGraphTask(pool, colorize_tasks[k]);
+    }
+
+    waitTaskGroup(pool, &group);
+
+    free(tasks);
+    free(pass.part_min_values);
+    free(pass.part_max_values);
+    freeColorLUT(pass.lut);
+
+    releasePerlinTables(context, pool_context.options.perlin_tables);
+    releaseThreadPool(context, pool);
+
+    if (display_loading != 0)
+    {
+        double total_time = (double) (clock() - start_time)/CLOCKS_PER_SEC;
+        char final_string[200] = "";
+
+        snprintf(final_string, sizeof(final_string), "%sSUCCESS :%s The complete map task graph took a total of %.4lf second(s) in CPU time.\n",
+                                GREEN_COLOR, DEFAULT_COLOR, total_time);
+
+        indent_print(display_loading - 1, final_string);
+    }
+
+    return complete_map;
 }
 
 
 
 
 
-completeMap* newCompleteMapFromMap(map* p_map, double sea_level, unsigned int display_loading)
+completeMap* newCompleteMapFromMap(map* p_map, double sea_level, generatorContext* context, unsigned int display_loading)
 {
     completeMap* complete_map = NULL;
 
@@ -375,7 +784,7 @@ completeMap* newCompleteMapFromMap(map* p_map, double sea_level, unsigned int di
         complete_map->sea_level = sea_level;
 
         // Get the corresponding sea map
-        complete_map->sea_values = setSeaLevel(p_map, sea_level, display_loading);
+        complete_map->sea_values = setSeaLevel(p_map, sea_level, context, display_loading);
 
         if (display_loading != 0)
         {
@@ -384,7 +793,7 @@ completeMap* newCompleteMapFromMap(map* p_map, double sea_level, unsigned int di
         }
         
         // Get the corresponding color map
-        complete_map->color_map = generateColorMap(p_map, sea_level, display_loading);
+        complete_map->color_map = generateColorMap(p_map, sea_level, context, display_loading);
     }
 
     return complete_map;
@@ -394,17 +803,24 @@ completeMap* newCompleteMapFromMap(map* p_map, double sea_level, unsigned int di
 
 completeMap* newCompleteMap(int number_of_layers, int gradGrids_width[number_of_layers], int gradGrids_height[number_of_layers],
                             int size_factors[number_of_layers], double layers_factors[number_of_layers],
-                            int map_width, int map_height, double sea_level, unsigned int display_loading)
+                            int map_width, int map_height, double sea_level, generatorContext* context, unsigned int display_loading)
 {
+    if (context->options.nb_workers > 1)
+    {
+        // Every step of the generation is a task, started as soon as its inputs are ready
+        return newCompleteMapTaskGraph(number_of_layers, gradGrids_width, gradGrids_height, size_factors, layers_factors,
+                                        map_width, map_height, sea_level, context, display_loading);
+    }
+
     // Generates a new map from scratch
-    map* map = newMap(number_of_layers, gradGrids_width, gradGrids_height, size_factors, layers_factors, map_width, map_height, display_loading);
+    map* map = newMap(number_of_layers, gradGrids_width, gradGrids_height, size_factors, layers_factors, map_width, map_height, context, display_loading);
 
     completeMap* complete_map = NULL;
 
     if (map != NULL)
     {
         // If the map generation was successful, generates a completeMap from it
-        complete_map = newCompleteMapFromMap(map, sea_level, display_loading);
+        complete_map = newCompleteMapFromMap(map, sea_level, context, display_loading);
     }
 
     return complete_map;
@@ -414,8 +830,32 @@ completeMap* newCompleteMap(int number_of_layers, int gradGrids_width[number_of_
 
 
 
+/**
+ * @brief Gets the size factors and the gradient grids dimensions of the layers of a 2d map, so that every layer has the same size.
+ * 
+ * @param number_of_layers (int) : the number of layers.
+ * @param gradGrids_dimension (int[number_of_layers]) : the array of the number of cells of the gradient grids.
+ * @param size_factors (int[number_of_layers]) : the array to store the size factors in.
+ * @param gradGrid_corresponding_dimensions (int[number_of_layers]) : the array to store the gradient grids dimensions in.
+ */
+static void getLayersDimensions(int number_of_layers, int gradGrids_dimension[number_of_layers], int size_factors[number_of_layers],
+                                    int gradGrid_corresponding_dimensions[number_of_layers])
+{
+    // Get the final map size
+    int lcm = lcmOfArray(number_of_layers, gradGrids_dimension);
+
+    // Generates a new dimension array : size factors should match gradient grids dimensions - 1
+    for (int i = 0; i < number_of_layers; i++)
+    {
+        size_factors[i] = lcm / gradGrids_dimension[i];
+        gradGrid_corresponding_dimensions[i] = gradGrids_dimension[i] + 1;
+    }
+}
+
+
+
 map* get2dMap(int number_of_layers, int gradGrids_dimension[number_of_layers], double layers_factors[number_of_layers],
-                    int map_width, int map_height, unsigned int display_loading)
+                    int map_width, int map_height, generatorContext* context, unsigned int display_loading)
 {
     clock_t start_time = clock();
 
@@ -430,24 +870,15 @@ map* get2dMap(int number_of_layers, int gradGrids_dimension[number_of_layers], d
         m_loading += 1;
     }
 
-    // Get the final map size
-    int lcm = lcmOfArray(number_of_layers, gradGrids_dimension);
-
     int size_factors[number_of_layers];
-
-    // Generates a new dimension array : size factors should match gradient grids dimensions - 1
     int gradGrid_corresponding_dimensions[number_of_layers];
 
-    for (int i = 0; i < number_of_layers; i++)
-    {
-        size_factors[i] = lcm / gradGrids_dimension[i];
-        gradGrid_corresponding_dimensions[i] = gradGrids_dimension[i] + 1;
-    }
+    getLayersDimensions(number_of_layers, gradGrids_dimension, size_factors, gradGrid_corresponding_dimensions);
 
 
     // Generates the corresponding map
     map* new_map = newMap(number_of_layers, gradGrid_corresponding_dimensions, gradGrid_corresponding_dimensions, size_factors, layers_factors,
-                                map_width, map_height, m_loading);
+                                map_width, map_height, context, m_loading);
 
 
     if (display_loading == 1)
@@ -467,13 +898,27 @@ map* get2dMap(int number_of_layers, int gradGrids_dimension[number_of_layers], d
 
 
 
-completeMap* fullGen(int number_of_layers, int gradGrids_dimension[number_of_layers], double layers_factors[number_of_layers],
-                         int map_width, int map_height, double sea_level, unsigned int display_loading)
+int stream2dMap(int number_of_layers, int gradGrids_dimension[number_of_layers], double layers_factors[number_of_layers],
+                    int map_width, int map_height, generatorContext* context, mapRowSink sink, void* sink_data, unsigned int display_loading)
 {
-    clock_t start_time = clock();
-    int m_loading = display_loading;
+    int size_factors[number_of_layers];
+    int gradGrid_corresponding_dimensions[number_of_layers];
 
-    if (display_loading != 0)
+    getLayersDimensions(number_of_layers, gradGrids_dimension, size_factors, gradGrid_corresponding_dimensions);
+
+    return streamMap(number_of_layers, gradGrid_corresponding_dimensions, gradGrid_corresponding_dimensions, size_factors, layers_factors,
+                        map_width, map_height, context, sink, sink_data, display_loading);
+}
+
+
+
+completeMap* fullGen(int number_of_layers, int gradGrids_dimension[number_of_layers], double layers_factors[number_of_layers],
+                         int map_width, int map_height, double sea_level, generatorContext* context, unsigned int display_loading)
+{
+    clock_t start_time = clock();
+    int m_loading = display_loading;
+
+    if (display_loading != 0)
     {
         int nb_indents = display_loading - 1;
         indent_print(nb_indents, "Generating a complete map...\n");
@@ -481,17 +926,33 @@ completeMap* fullGen(int number_of_layers, int gradGrids_dimension[number_of_lay
         m_loading += 1;
     }
 
-    // Generates a new map
-    map* new_map = get2dMap(number_of_layers, gradGrids_dimension, layers_factors, map_width, map_height, m_loading);
+    completeMap* new_complete_map = NULL;
 
-    if (display_loading != 0)
+    if (context->options.nb_workers > 1)
     {
-        int nb_indents = display_loading;
-        indent_print(nb_indents, "\n");
+        // The whole generation is a single task graph : no barrier between the map and its post-processing
+        int size_factors[number_of_layers];
+        int gradGrid_corresponding_dimensions[number_of_layers];
+
+        getLayersDimensions(number_of_layers, gradGrids_dimension, size_factors, gradGrid_corresponding_dimensions);
+
+        new_complete_map = newCompleteMap(number_of_layers, gradGrid_corresponding_dimensions, gradGrid_corresponding_dimensions, size_factors,
+                                            layers_factors, map_width, map_height, sea_level, context, m_loading);
     }
+    else
+    {
+        // Generates a new map
+        map* new_map = get2dMap(number_of_layers, gradGrids_dimension, layers_factors, map_width, map_height, context, m_loading);
 
-    // Generates the completeMap from it
-    completeMap* new_complete_map = newCompleteMapFromMap(new_map, sea_level, m_loading);
+        if (display_loading != 0)
+        {
+            int nb_indents = display_loading;
+            indent_print(nb_indents, "\n");
+        }
+
+        // Generates the completeMap from it
+        new_complete_map = newCompleteMapFromMap(new_map, sea_level, context, m_loading);
+    }
 
     if (display_loading == 1)
     {
@@ -512,144 +973,295 @@ completeMap* fullGen(int number_of_layers, int gradGrids_dimension[number_of_lay
 
 
 
-void writeSeaMapFile(completeMap* completeMap, char path[])
+/**
+ * @brief Appends the given characters to the given file (see `textWriteFunction`, `flushTextRow`).
+ * 
+ * @param destination (void*) : the pointer to the asyncFile.
+ * @param chars (const char*) : the characters.
+ * @param nb_chars (size_t) : the number of characters.
+ * @return int : `1` if the file is still written successfully, `0` otherwise (see `writeAsyncFile`).
+ */
+static int writeAsyncChars(void* destination, const char* chars, size_t nb_chars)
 {
-    FILE* f = NULL;
+    return writeAsyncFile(destination, chars, nb_chars);
+}
 
-    f = fopen(path, "w");
 
-    if (f != NULL)
-    {
-        fprintf(f, "Sea Map\n");
 
-        int width = completeMap->width;
-        int height = completeMap->height;
+/**
+ * @brief Prints the sea map of the given completeMap in the given file (see `writeSeaMapFile`).
+ * 
+ * @param f (asyncFile*) : the pointer to the file.
+ * @param completeMap (completeMap*) : the pointer to the completeMap structure containing the sea map to be written.
+ * 
+ * @note The rows stop once a write of the file is known to have failed (see `writeAsyncFile`), the failures of the last buffers are reported by `waitAsyncWriter`.
+ */
+static void printSeaMap(asyncFile* f, completeMap* completeMap)
+{
+    printAsyncFile(f, "Sea Map\n");
 
-        double sea_level = completeMap->sea_level;
+    int width = completeMap->width;
+    int height = completeMap->height;
 
-        // Writing the parameters
-        fprintf(f, "width=%d\nheight=%d\nsea_level=% .8lf\n", width, height, sea_level);
+    double sea_level = completeMap->sea_level;
 
-        map* current_map = completeMap->map;
-        int map_width = current_map->map_width;
-        int map_height = current_map->map_height;
+    // Writing the parameters
+    printAsyncFile(f, "width=%d\nheight=%d\nsea_level=% .8lf\n", width, height, sea_level);
 
-        fprintf(f, "map_width_in_chunks=%d\nmap_height_in_chunks=%d\n", map_width, map_height);
+    map* current_map = completeMap->map;
+    int map_width = current_map->map_width;
+    int map_height = current_map->map_height;
 
-        // Writing the values
-        for (int i = 0; i < height; i++)
+    printAsyncFile(f, "map_width_in_chunks=%d\nmap_height_in_chunks=%d\n", map_width, map_height);
+
+    // Writing the values, one row at a time
+    textRow* row = newTextRow(TEXT_VALUE_LENGTH * width);
+    int success = 1;
+
+    for (int i = 0; i < height && success; i++)
+    {
+        for (int j = 0; j < width; j++)
         {
-            for (int j = 0; j < width; j++)
-            {
-                double value = *getCompleteMapSeaValue(completeMap, j, i);
-
-                if (j != width - 1)
-                {
-                    fprintf(f, "% .8lf\t", value);
-                }
-                else
-                {
-                    fprintf(f, "% .8lf\n", value);
-                }
-            }
+            altitude_t value = *getCompleteMapSeaValueUnchecked(completeMap, j, i);
+
+            appendTextFixed(row, value, 8, 1);
+            appendTextChar(row, j != width - 1 ? '\t' : '\n');
         }
 
-        fclose(f);
+        success = flushTextRow(row, writeAsyncChars, f);
     }
-    else
+
+    freeTextRow(row);
+}
+
+
+
+void writeSeaMapFile(completeMap* completeMap, char path[])
+{
+    asyncFile* f = openAsyncFile(NULL, path);
+
+    if (f != NULL)
     {
-        printf("%sERROR : could not open file in writing mode at path '%s'%s\n", RED_COLOR, path, DEFAULT_COLOR);
-        return;
+        printSeaMap(f, completeMap);
+        closeAsyncFile(f);
     }
 }
 
 
 
-void writeColorIntMapFile(color** color_map, int width, int height, char path[])
+/**
+ * @brief Prints the given color map in the given file, with integer channels (see `writeColorIntMapFile`).
+ * 
+ * @param f (asyncFile*) : the pointer to the file.
+ * @param color_map (color*) : the interleaved RGB8 array of colors.
+ * @param width (int) : the width of the color map.
+ * @param height (int) : the height of the color map.
+ * 
+ * @note The rows stop once a write of the file is known to have failed (see `writeAsyncFile`), the failures of the last buffers are reported by `waitAsyncWriter`.
+ */
+static void printColorIntMap(asyncFile* f, color* color_map, int width, int height)
 {
-    FILE* f = NULL;
+    printAsyncFile(f, "Color Int Map\n");
+
+    // Writing the parameters
+    printAsyncFile(f, "width=%d\nheight=%d\n", width, height);
+
+    // Writing the vectors, one row at a time
+    textRow* row = newTextRow(TEXT_VALUE_LENGTH * width);
+    int success = 1;
+
+    for (int i = 0; i < height && success; i++)
+    {
+        for (int j = 0; j < width; j++)
+        {
+            color* color = color_map + j + i * width;
+
+            appendTextChar(row, '(');
+            appendTextInteger(row, color->red);
+            appendTextChar(row, ',');
+            appendTextInteger(row, color->green);
+            appendTextChar(row, ',');
+            appendTextInteger(row, color->blue);
+            appendTextChar(row, ')');
+            appendTextChar(row, j != width - 1 ? '\t' : '\n');
+        }
 
-    f = fopen(path, "w");
+        success = flushTextRow(row, writeAsyncChars, f);
+    }
+
+    freeTextRow(row);
+}
+
+
+
+void writeColorIntMapFile(color* color_map, int width, int height, char path[])
+{
+    asyncFile* f = openAsyncFile(NULL, path);
 
     if (f != NULL)
     {
-        fprintf(f, "Color Int Map\n");
+        printColorIntMap(f, color_map, width, height);
+        closeAsyncFile(f);
+    }
+}
+
+
+
+/**
+ * @brief Derives the float value in [0, 1] of the given color channel.
+ * 
+ * @param channel (uint8_t) : the channel value in [0, 255].
+ * @return float : the float value of the channel.
+ */
+static float colorChannelFloat(uint8_t channel)
+{
+    return (float) (1./255 * channel);
+}
+
 
-        // Writing the parameters
-        fprintf(f, "width=%d\nheight=%d\n", width, height);
 
-        // Writing the vectors
-        for (int i = 0; i < height; i++)
+/**
+ * @brief Prints the given color map in the given file, with float channels (see `writeColorFloatMapFile`).
+ * 
+ * @param f (asyncFile*) : the pointer to the file.
+ * @param color_map (color*) : the interleaved RGB8 array of colors.
+ * @param width (int) : the width of the color map.
+ * @param height (int) : the height of the color map.
+ * 
+ * @note The rows stop once a write of the file is known to have failed (see `writeAsyncFile`), the failures of the last buffers are reported by `waitAsyncWriter`.
+ */
+static void printColorFloatMap(asyncFile* f, color* color_map, int width, int height)
+{
+    printAsyncFile(f, "Color Float Map\n");
+
+    // Writing the parameters
+    printAsyncFile(f, "width=%d\nheight=%d\n", width, height);
+
+    // Writing the vectors, one row at a time
+    textRow* row = newTextRow(2 * TEXT_VALUE_LENGTH * width);
+    int success = 1;
+
+    for (int i = 0; i < height && success; i++)
+    {
+        for (int j = 0; j < width; j++)
         {
-            for (int j = 0; j < width; j++)
-            {
-                color* color = color_map[j + i * width];
-
-                if (j != width - 1)
-                {
-                    fprintf(f, "(%d,%d,%d)\t", color->red_int, color->green_int, color->blue_int);
-                }
-                else
-                {
-                    fprintf(f, "(%d,%d,%d)\n", color->red_int, color->green_int, color->blue_int);
-                }
-            }
+            color* color = color_map + j + i * width;
+
+            float red = colorChannelFloat(color->red);
+            float green = colorChannelFloat(color->green);
+            float blue = colorChannelFloat(color->blue);
+
+            appendTextChar(row, '(');
+            appendTextFixed(row, red, 4, 0);
+            appendTextChar(row, ',');
+            appendTextFixed(row, green, 4, 0);
+            appendTextChar(row, ',');
+            appendTextFixed(row, blue, 4, 0);
+            appendTextChar(row, ')');
+            appendTextChar(row, j != width - 1 ? '\t' : '\n');
         }
 
-        fclose(f);
+        success = flushTextRow(row, writeAsyncChars, f);
     }
-    else
+
+    freeTextRow(row);
+}
+
+
+
+void writeColorFloatMapFile(color* color_map, int width, int height, char path[])
+{
+    asyncFile* f = openAsyncFile(NULL, path);
+
+    if (f != NULL)
     {
-        printf("%sERROR : could not open file in writing mode at path '%s'%s\n", RED_COLOR, path, DEFAULT_COLOR);
-        return;
+        printColorFloatMap(f, color_map, width, height);
+        closeAsyncFile(f);
     }
 }
 
 
 
-void writeColorFloatMapFile(color** color_map, int width, int height, char path[])
+void writeColorMapPPMFile(completeMap* completeMap, char path[])
+{
+    writePPMFile(completeMap->color_map, completeMap->width, completeMap->height, path);
+}
+
+
+
+void writeColorMapPNGFile(completeMap* completeMap, int compression, char path[])
 {
-    FILE* f = NULL;
+    writePNGFile(completeMap->color_map, completeMap->width, completeMap->height, compression, path);
+}
+
 
-    f = fopen(path, "w");
 
+/**
+ * @brief The text export of a completeMap, run by the formatting thread of an asyncWriter (see `writeCompleteMapFilesAsync`).
+ * 
+ */
+struct completeMapExport
+{
+    completeMap* complete_map; /**< the pointer to the completeMap to be saved*/
+    asyncWriter* writer; /**< the pointer to the writer of the files, `NULL` to write them synchronously*/
+    char folder_path[200]; /**< the path to the folder where the files shall be written*/
+};
+
+
+
+/**
+ * @brief Formats the three text files of a completeMap export one after another, then frees the export.
+ * 
+ * @param argument (void*) : the pointer to the completeMapExport structure.
+ */
+static void exportCompleteMapFiles(void* argument)
+{
+    struct completeMapExport* export = argument;
+
+    completeMap* complete_map = export->complete_map;
+    char* folder_path = export->folder_path;
+
+    // Generates the sea map file
+    char sea_map_path[220] = "";
+    snprintf(sea_map_path, sizeof(sea_map_path), "%ssea_map.txt", folder_path);
+
+    asyncFile* f = openAsyncFile(export->writer, sea_map_path);
     if (f != NULL)
     {
-        fprintf(f, "Color Float Map\n");
+        printSeaMap(f, complete_map);
+        closeAsyncFile(f);
+    }
 
-        // Writing the parameters
-        fprintf(f, "width=%d\nheight=%d\n", width, height);
 
-        // Writing the vectors
-        for (int i = 0; i < height; i++)
-        {
-            for (int j = 0; j < width; j++)
-            {
-                color* color = color_map[j + i * width];
-
-                if (j != width - 1)
-                {
-                    fprintf(f, "(%.4f,%.4f,%.4f)\t", color->red_float, color->green_float, color->blue_float);
-                }
-                else
-                {
-                    fprintf(f, "(%.4f,%.4f,%.4f)\n", color->red_float, color->green_float, color->blue_float);
-                }
-            }
-        }
+    // Generates the color int map file
+    char color_int_path[220] = "";
+    snprintf(color_int_path, sizeof(color_int_path), "%scolor_int_map.txt", folder_path);
 
-        fclose(f);
+    f = openAsyncFile(export->writer, color_int_path);
+    if (f != NULL)
+    {
+        printColorIntMap(f, complete_map->color_map, complete_map->width, complete_map->height);
+        closeAsyncFile(f);
     }
-    else
+
+
+    // Generates the color float map file
+    char color_float_path[220] = "";
+    snprintf(color_float_path, sizeof(color_float_path), "%scolor_float_map.txt", folder_path);
+
+    f = openAsyncFile(export->writer, color_float_path);
+    if (f != NULL)
     {
-        printf("%sERROR : could not open file in writing mode at path '%s'%s\n", RED_COLOR, path, DEFAULT_COLOR);
-        return;
+        printColorFloatMap(f, complete_map->color_map, complete_map->width, complete_map->height);
+        closeAsyncFile(f);
     }
+
+    free(export);
 }
 
 
 
-void writeCompleteMapFiles(completeMap* complete_map, char folder_path[])
+void writeCompleteMapFilesAsync(completeMap* complete_map, char folder_path[], asyncWriter* writer)
 {
     //! TEMPORARY? -> File storage may be ineffective because of the space complexity of it.
     //! These files are big!
@@ -662,27 +1274,586 @@ void writeCompleteMapFiles(completeMap* complete_map, char folder_path[])
         mkdir(folder_path, 0700);
     }
 
-    // Generates the sea map file
+    struct completeMapExport* export = calloc(1, sizeof(struct completeMapExport));
+
+    export->complete_map = complete_map;
+    export->writer = writer;
+    snprintf(export->folder_path, sizeof(export->folder_path), "%s", folder_path);
+
+    // Run right away without a writer, by the formatting thread of the writer otherwise
+    submitAsyncJob(writer, exportCompleteMapFiles, export);
+}
+
+
+
+void writeCompleteMapFiles(completeMap* complete_map, char folder_path[])
+{
+    writeCompleteMapFilesAsync(complete_map, folder_path, NULL);
+}
+
+
+
+/**
+ * @brief Maps a sea map or a color map binary file of a complete map in memory, and checks its dimensions.
+ * 
+ * @param path (char[]) : the path to the file.
+ * @param kind (int) : `BINARY_SEA_MAP` or `BINARY_COLOR_MAP`.
+ * @param dtype (int) : the type of the samples in memory.
+ * @param nb_components (int) : the number of samples per value.
+ * @param width (int) : the expected width, the one of the map.
+ * @param height (int) : the expected height, the one of the map.
+ * @return mappedBinaryFile* : the pointer to the mapped file, `NULL` if it could not be mapped or does not have the dimensions of the map.
+ */
+static mappedBinaryFile* mapCompleteMapBinaryPart(char path[], int kind, int dtype, int nb_components, int width, int height)
+{
+    mappedBinaryFile* mapped_file = mapBinaryFile(path, kind, dtype, nb_components);
+
+    if (mapped_file != NULL && (mapped_file->header.width != width || mapped_file->header.height != height))
+    {
+        printf("%sERROR : invalid complete map binary file at path '%s'%s\n", RED_COLOR, path, DEFAULT_COLOR);
+        unmapBinaryFile(mapped_file);
+        return NULL;
+    }
+
+    return mapped_file;
+}
+
+
+
+completeMap* readCompleteMapFiles(char path[])
+{
+    char map_path[200] = "";
+    snprintf(map_path, sizeof(map_path), "%smap.bin", path);
+
+    map* read_map = readMapFile(map_path);
+
+    if (read_map == NULL)
+    {
+        return NULL;
+    }
+
+    completeMap* complete_map = calloc(1, sizeof(completeMap));
+
+    complete_map->map = read_map;
+    complete_map->width = read_map->mapped_file->header.width;
+    complete_map->height = read_map->mapped_file->header.height;
+
     char sea_map_path[200] = "";
-    snprintf(sea_map_path, sizeof(sea_map_path), "%ssea_map.txt", folder_path);
-    writeSeaMapFile(complete_map, sea_map_path);
+    snprintf(sea_map_path, sizeof(sea_map_path), "%ssea_map.bin", path);
 
+    char color_map_path[200] = "";
+    snprintf(color_map_path, sizeof(color_map_path), "%scolor_map.bin", path);
 
-    // Generates the color int map file
-    char color_int_path[200] = "";
-    snprintf(color_int_path, sizeof(color_int_path), "%scolor_int_map.txt", folder_path);
-    writeColorIntMapFile(complete_map->color_map, complete_map->width, complete_map->height, color_int_path);
+    complete_map->sea_mapped_file = mapCompleteMapBinaryPart(sea_map_path, BINARY_SEA_MAP, ALTITUDE_DTYPE, 1, complete_map->width,
+                                                                complete_map->height);
+    complete_map->color_mapped_file = mapCompleteMapBinaryPart(color_map_path, BINARY_COLOR_MAP, BINARY_UINT8, 3, complete_map->width,
+                                                                complete_map->height);
 
+    if (complete_map->sea_mapped_file == NULL || complete_map->color_mapped_file == NULL)
+    {
+        freeCompleteMap(complete_map);
+        return NULL;
+    }
 
-    // Generates the color float map file
-    char color_float_path[200] = "";
-    snprintf(color_float_path, sizeof(color_float_path), "%scolor_float_map.txt", folder_path);
-    writeColorFloatMapFile(complete_map->color_map, complete_map->width, complete_map->height, color_float_path);
+    complete_map->sea_values = complete_map->sea_mapped_file->samples;
+    complete_map->color_map = complete_map->color_mapped_file->samples;
+
+    // The sea level is stored in the header of the sea map file
+    complete_map->sea_level = complete_map->sea_mapped_file->header.sea_level;
+
+    return complete_map;
+}
+
+
+
+/**
+ * @brief Writes a binary file holding the given values of the given completeMap structure, with its geometry and its sea level.
+ * 
+ * @param completeMap (completeMap*) : the pointer to the completeMap structure.
+ * @param kind (int) : the kind of values, `BINARY_SEA_MAP` or `BINARY_COLOR_MAP`.
+ * @param dtype (int) : the type of the samples.
+ * @param nb_components (int) : the number of samples per value.
+ * @param samples (void*) : the pointer to the samples.
+ * @param seed (uint64_t) : the seed of the generation, stored in the header.
+ * @param codec (int) : the codec of the samples.
+ * @param path (char[]) : path of the file to be written.
+ */
+static void writeCompleteMapBinaryPart(completeMap* completeMap, int kind, int dtype, int nb_components, void* samples, uint64_t seed, int codec,
+                                        char path[])
+{
+    FILE* f = fopen(path, "wb");
+
+    if (f == NULL)
+    {
+        printf("%sERROR : could not open file in writing mode at path '%s'%s\n", RED_COLOR, path, DEFAULT_COLOR);
+        return;
+    }
+
+    int width = completeMap->width;
+    int height = completeMap->height;
+
+    binaryHeader header = initBinaryHeader(kind, dtype, nb_components, width, height, seed);
+    header.map_width = completeMap->map->map_width;
+    header.map_height = completeMap->map->map_height;
+    header.chunk_width = completeMap->map->chunk_width;
+    header.chunk_height = completeMap->map->chunk_height;
+    header.sea_level = completeMap->sea_level;
+    header.codec = codec;
+    header.quantization_bits = codec == BINARY_CODEC_QUANTIZED ? BINARY_QUANTIZATION_BITS : 0;
+
+    if (!writeBinaryHeader(f, &header) || !writeBinaryPayload(f, &header, samples))
+    {
+        printf("%sERROR : could not write the complete map at path '%s'%s\n", RED_COLOR, path, DEFAULT_COLOR);
+    }
+
+    fclose(f);
 }
 
+/**
+ * @brief Reads the values of a binary file written by `writeCompleteMapBinaryPart`.
+ * 
+ * @param path (char[]) : path of the file to be read.
+ * @param kind (int) : the expected kind of values.
+ * @param dtype (int) : the type of the samples in memory.
+ * @param nb_components (int) : the expected number of samples per value.
+ * @param samples (void*) : the pointer to the array to fill.
+ * @param width (int) : the expected width of the complete map.
+ * @param height (int) : the expected height of the complete map.
+ * @param header (binaryHeader*) : the pointer to the header to fill with the one of the file.
+ * @return int : `1` on success, `0` otherwise.
+ */
+static int readCompleteMapBinaryPart(char path[], int kind, int dtype, int nb_components, void* samples, int width, int height, binaryHeader* header)
+{
+    FILE* f = fopen(path, "rb");
+
+    if (f == NULL)
+    {
+        printf("%sERROR : could not open file in reading mode at path '%s'%s\n", RED_COLOR, path, DEFAULT_COLOR);
+        return 0;
+    }
+
+    *header = initBinaryHeader(kind, 0, 0, 0, 0, 0);
 
+    int success = readBinaryHeader(f, kind, header) && header->nb_components == nb_components && header->width == width && header->height == height
+                    && readBinaryPayload(f, header, dtype, samples);
 
-completeMap* readCompleteMapFiles(char path[]);
+    if (!success)
+    {
+        printf("%sERROR : invalid complete map binary file at path '%s'%s\n", RED_COLOR, path, DEFAULT_COLOR);
+    }
+
+    fclose(f);
+
+    return success;
+}
+
+
+
+void writeSeaMapBinaryFile(completeMap* completeMap, uint64_t seed, int codec, char path[])
+{
+    writeCompleteMapBinaryPart(completeMap, BINARY_SEA_MAP, ALTITUDE_DTYPE, 1, completeMap->sea_values, seed, codec, path);
+}
+
+
+
+void writeColorMapBinaryFile(completeMap* completeMap, uint64_t seed, char path[])
+{
+    // A color is 3 packed bytes, that a varint can not shrink : the color map is always raw
+    writeCompleteMapBinaryPart(completeMap, BINARY_COLOR_MAP, BINARY_UINT8, 3, completeMap->color_map, seed, BINARY_CODEC_RAW, path);
+}
+
+
+
+void writeCompleteMapBinaryFiles(completeMap* complete_map, uint64_t seed, int codec, char folder_path[])
+{
+    struct stat st = {0};
+
+    // Generates a directory if it does not exist
+    if (stat(folder_path, &st) == -1)
+    {
+        mkdir(folder_path, 0700);
+    }
+
+    char map_path[200] = "";
+    snprintf(map_path, sizeof(map_path), "%smap.bin", folder_path);
+    writeMapBinaryFile(complete_map->map, seed, codec, map_path);
+
+    char sea_map_path[200] = "";
+    snprintf(sea_map_path, sizeof(sea_map_path), "%ssea_map.bin", folder_path);
+    writeSeaMapBinaryFile(complete_map, seed, codec, sea_map_path);
+
+    char color_map_path[200] = "";
+    snprintf(color_map_path, sizeof(color_map_path), "%scolor_map.bin", folder_path);
+    writeColorMapBinaryFile(complete_map, seed, color_map_path);
+}
+
+
+
+completeMap* readCompleteMapBinaryFiles(char folder_path[], binaryHeader* header)
+{
+    char map_path[200] = "";
+    snprintf(map_path, sizeof(map_path), "%smap.bin", folder_path);
+
+    binaryHeader map_header = initBinaryHeader(BINARY_MAP, 0, 0, 0, 0, 0);
+    map* read_map = readMapBinaryFile(map_path, &map_header);
+
+    if (header != NULL)
+    {
+        *header = map_header;
+    }
+
+    if (read_map == NULL)
+    {
+        return NULL;
+    }
+
+    completeMap* complete_map = calloc(1, sizeof(completeMap));
+
+    complete_map->map = read_map;
+    complete_map->width = map_header.width;
+    complete_map->height = map_header.height;
+    complete_map->sea_values = calloc((size_t) map_header.width * map_header.height, sizeof(altitude_t));
+    complete_map->color_map = calloc((size_t) map_header.width * map_header.height, sizeof(color));
+
+    char sea_map_path[200] = "";
+    snprintf(sea_map_path, sizeof(sea_map_path), "%ssea_map.bin", folder_path);
+
+    char color_map_path[200] = "";
+    snprintf(color_map_path, sizeof(color_map_path), "%scolor_map.bin", folder_path);
+
+    binaryHeader sea_header;
+    binaryHeader color_header;
+
+    if (!readCompleteMapBinaryPart(sea_map_path, BINARY_SEA_MAP, ALTITUDE_DTYPE, 1, complete_map->sea_values, map_header.width, map_header.height,
+                                    &sea_header)
+        || !readCompleteMapBinaryPart(color_map_path, BINARY_COLOR_MAP, BINARY_UINT8, 3, complete_map->color_map, map_header.width, map_header.height,
+                                        &color_header))
+    {
+        freeCompleteMap(complete_map);
+        return NULL;
+    }
+
+    // The sea level is stored in the header of the sea map file
+    complete_map->sea_level = sea_header.sea_level;
+
+    return complete_map;
+}
+
+
+
+
+
+mapRecipe* newMapRecipe(int number_of_layers, int gradGrids_dimension[number_of_layers], double layers_factors[number_of_layers],
+                            int map_width, int map_height, double sea_level, generatorContext* context)
+{
+    mapRecipe* new_recipe = calloc(1, sizeof(mapRecipe));
+
+    new_recipe->generator_version = GENERATOR_VERSION;
+    new_recipe->seed = context->seed;
+    new_recipe->gradient_source = context->options.gradient_source;
+    new_recipe->altitude_dtype = ALTITUDE_DTYPE;
+    new_recipe->gradient_dtype = GRADIENT_DTYPE;
+    new_recipe->number_of_layers = number_of_layers;
+    new_recipe->map_width = map_width;
+    new_recipe->map_height = map_height;
+    new_recipe->sea_level = sea_level;
+
+    new_recipe->gradGrids_dimension = calloc(number_of_layers, sizeof(int));
+    new_recipe->layers_factors = calloc(number_of_layers, sizeof(double));
+
+    for (int i = 0; i < number_of_layers; i++)
+    {
+        new_recipe->gradGrids_dimension[i] = gradGrids_dimension[i];
+        new_recipe->layers_factors[i] = layers_factors[i];
+    }
+
+    return new_recipe;
+}
+
+
+
+void writeMapRecipeFile(mapRecipe* recipe, char path[])
+{
+    FILE* f = fopen(path, "wb");
+
+    if (f == NULL)
+    {
+        printf("%sERROR : could not open file in writing mode at path '%s'%s\n", RED_COLOR, path, DEFAULT_COLOR);
+        return;
+    }
+
+    int number_of_layers = recipe->number_of_layers;
+
+    int size_factors[number_of_layers];
+    int gradGrid_corresponding_dimensions[number_of_layers];
+
+    getLayersDimensions(number_of_layers, recipe->gradGrids_dimension, size_factors, gradGrid_corresponding_dimensions);
+
+    // size_factors should match gradient_grids dimensions - 1
+    int chunk_size = (gradGrid_corresponding_dimensions[0] - 1) * size_factors[0];
+
+    binaryHeader header = initBinaryHeader(BINARY_RECIPE, recipe->altitude_dtype, 0, recipe->map_width * chunk_size,
+                                            recipe->map_height * chunk_size, recipe->seed);
+    header.map_width = recipe->map_width;
+    header.map_height = recipe->map_height;
+    header.chunk_width = chunk_size;
+    header.chunk_height = chunk_size;
+    header.number_of_layers = number_of_layers;
+    header.sea_level = recipe->sea_level;
+
+    size_t nb_bytes = RECIPE_FIXED_SIZE + (size_t) RECIPE_LAYER_SIZE * number_of_layers;
+    unsigned char* bytes = calloc(nb_bytes, sizeof(unsigned char));
+
+    putBinaryInteger(bytes, recipe->generator_version, 2);
+    putBinaryInteger(bytes + 2, recipe->gradient_source, 2);
+    putBinaryInteger(bytes + 4, recipe->gradient_dtype, 2);
+
+    for (int i = 0; i < number_of_layers; i++)
+    {
+        unsigned char* layer_bytes = bytes + RECIPE_FIXED_SIZE + RECIPE_LAYER_SIZE * i;
+
+        putBinaryInteger(layer_bytes, recipe->gradGrids_dimension[i], 4);
+        putBinaryDouble(layer_bytes + 4, recipe->layers_factors[i]);
+    }
+
+    int success = writeBinaryHeader(f, &header) && fwrite(bytes, 1, nb_bytes, f) == nb_bytes;
+    success = fclose(f) == 0 && success;
+
+    if (!success)
+    {
+        printf("%sERROR : could not write the recipe at path '%s'%s\n", RED_COLOR, path, DEFAULT_COLOR);
+    }
+
+    free(bytes);
+}
+
+
+
+mapRecipe* readMapRecipeFile(char path[])
+{
+    FILE* f = fopen(path, "rb");
+
+    if (f == NULL)
+    {
+        printf("%sERROR : could not open file in reading mode at path '%s'%s\n", RED_COLOR, path, DEFAULT_COLOR);
+        return NULL;
+    }
+
+    binaryHeader header;
+
+    if (!readBinaryHeader(f, BINARY_RECIPE, &header))
+    {
+        fclose(f);
+        return NULL;
+    }
+
+    int number_of_layers = header.number_of_layers;
+
+    if (number_of_layers <= 0 || number_of_layers > RECIPE_MAX_LAYERS)
+    {
+        printf("%sERROR : invalid number of layers %d in the recipe at path '%s' (at most %d)%s\n", RED_COLOR, number_of_layers, path,
+                    RECIPE_MAX_LAYERS, DEFAULT_COLOR);
+
+        fclose(f);
+        return NULL;
+    }
+
+    size_t nb_bytes = RECIPE_FIXED_SIZE + (size_t) RECIPE_LAYER_SIZE * number_of_layers;
+    unsigned char* bytes = calloc(nb_bytes, sizeof(unsigned char));
+
+    if (fread(bytes, 1, nb_bytes, f) != nb_bytes)
+    {
+        printf("%sERROR : the recipe at path '%s' is truncated%s\n", RED_COLOR, path, DEFAULT_COLOR);
+
+        free(bytes);
+        fclose(f);
+        return NULL;
+    }
+
+    fclose(f);
+
+    int gradient_source = (int) getBinaryInteger(bytes + 2, 2);
+
+    if (gradient_source != STORED_GRADIENTS && gradient_source != HASHED_GRADIENTS)
+    {
+        printf("%sERROR : invalid gradient source %d in the recipe at path '%s'%s\n", RED_COLOR, gradient_source, path, DEFAULT_COLOR);
+
+        free(bytes);
+        return NULL;
+    }
+
+    mapRecipe* new_recipe = calloc(1, sizeof(mapRecipe));
+
+    new_recipe->generator_version = (int) getBinaryInteger(bytes, 2);
+    new_recipe->seed = header.seed;
+    new_recipe->gradient_source = gradient_source;
+    new_recipe->altitude_dtype = header.dtype;
+    new_recipe->gradient_dtype = (int) getBinaryInteger(bytes + 4, 2);
+    new_recipe->number_of_layers = number_of_layers;
+    new_recipe->map_width = header.map_width;
+    new_recipe->map_height = header.map_height;
+    new_recipe->sea_level = header.sea_level;
+
+    new_recipe->gradGrids_dimension = calloc(number_of_layers, sizeof(int));
+    new_recipe->layers_factors = calloc(number_of_layers, sizeof(double));
+
+    for (int i = 0; i < number_of_layers; i++)
+    {
+        unsigned char* layer_bytes = bytes + RECIPE_FIXED_SIZE + RECIPE_LAYER_SIZE * i;
+
+        new_recipe->gradGrids_dimension[i] = (int) getBinaryInteger(layer_bytes, 4);
+        new_recipe->layers_factors[i] = getBinaryDouble(layer_bytes + 4);
+    }
+
+    free(bytes);
+
+    return new_recipe;
+}
+
+
+
+/**
+ * @brief Checks that the given recipe can be regenerated bit for bit by this build : same generator version, same precision,
+ * and valid parameters. Prints an error otherwise.
+ * 
+ * @param recipe (mapRecipe*) : the pointer to the recipe.
+ * @return int : `1` if the recipe can be regenerated, `0` otherwise.
+ */
+static int checkRecipe(mapRecipe* recipe)
+{
+    if (recipe->generator_version != GENERATOR_VERSION)
+    {
+        printf("%sERROR : the recipe was written by version %d of the generator, this one is version %d%s\n", RED_COLOR,
+                    recipe->generator_version, GENERATOR_VERSION, DEFAULT_COLOR);
+        return 0;
+    }
+
+    if (recipe->altitude_dtype != ALTITUDE_DTYPE || recipe->gradient_dtype != GRADIENT_DTYPE)
+    {
+        printf("%sERROR : the recipe was written by a build of another precision (see precision.h)%s\n", RED_COLOR, DEFAULT_COLOR);
+        return 0;
+    }
+
+    if (recipe->gradient_source != STORED_GRADIENTS && recipe->gradient_source != HASHED_GRADIENTS)
+    {
+        printf("%sERROR : invalid gradient source %d in the recipe%s\n", RED_COLOR, recipe->gradient_source, DEFAULT_COLOR);
+        return 0;
+    }
+
+    if (recipe->number_of_layers <= 0 || recipe->number_of_layers > RECIPE_MAX_LAYERS)
+    {
+        printf("%sERROR : invalid number of layers %d in the recipe (at most %d)%s\n", RED_COLOR, recipe->number_of_layers, RECIPE_MAX_LAYERS,
+                    DEFAULT_COLOR);
+        return 0;
+    }
+
+    for (int i = 0; i < recipe->number_of_layers; i++)
+    {
+        if (recipe->gradGrids_dimension[i] <= 0)
+        {
+            printf("%sERROR : invalid gradient grid dimension %d in the recipe%s\n", RED_COLOR, recipe->gradGrids_dimension[i], DEFAULT_COLOR);
+            return 0;
+        }
+    }
+
+    if (recipe->map_width <= 0 || recipe->map_height <= 0)
+    {
+        printf("%sERROR : invalid map dimensions %d x %d in the recipe%s\n", RED_COLOR, recipe->map_width, recipe->map_height, DEFAULT_COLOR);
+        return 0;
+    }
+
+    return 1;
+}
+
+/**
+ * @brief Builds the root context of the generation of the given recipe : its seed and gradient source, with the other options of the given context.
+ * 
+ * @param recipe (mapRecipe*) : the pointer to the recipe.
+ * @param context (generatorContext*) : the pointer to the context with the generation options. Can be `NULL` for the default ones.
+ * @return generatorContext : the root context.
+ */
+static generatorContext getRecipeContext(mapRecipe* recipe, generatorContext* context)
+{
+    // A new root context, so that its keys are derived from the seed of the recipe
+    generatorContext* new_context = newGeneratorContext(recipe->seed);
+    generatorContext recipe_context = *new_context;
+    freeGeneratorContext(new_context);
+
+    if (context != NULL)
+    {
+        recipe_context.options = context->options;
+    }
+
+    recipe_context.options.gradient_source = recipe->gradient_source;
+
+    return recipe_context;
+}
+
+
+
+completeMap* generateRecipeMap(mapRecipe* recipe, generatorContext* context, unsigned int display_loading)
+{
+    if (!checkRecipe(recipe))
+    {
+        return NULL;
+    }
+
+    generatorContext recipe_context = getRecipeContext(recipe, context);
+
+    return fullGen(recipe->number_of_layers, recipe->gradGrids_dimension, recipe->layers_factors, recipe->map_width, recipe->map_height,
+                    recipe->sea_level, &recipe_context, display_loading);
+}
+
+
+
+completeMap* loadMapRecipeFile(char path[], generatorContext* context, unsigned int display_loading)
+{
+    mapRecipe* recipe = readMapRecipeFile(path);
+
+    if (recipe == NULL)
+    {
+        return NULL;
+    }
+
+    completeMap* complete_map = generateRecipeMap(recipe, context, display_loading);
+    freeMapRecipe(recipe);
+
+    return complete_map;
+}
+
+
+
+chunk* regenerateRecipeChunk(mapRecipe* recipe, int chunk_x, int chunk_y, generatorContext* context)
+{
+    if (!checkRecipe(recipe))
+    {
+        return NULL;
+    }
+
+    generatorContext recipe_context = getRecipeContext(recipe, context);
+
+    int number_of_layers = recipe->number_of_layers;
+
+    int size_factors[number_of_layers];
+    int gradGrid_corresponding_dimensions[number_of_layers];
+
+    getLayersDimensions(number_of_layers, recipe->gradGrids_dimension, size_factors, gradGrid_corresponding_dimensions);
+
+    return regenerateMapChunk(number_of_layers, gradGrid_corresponding_dimensions, gradGrid_corresponding_dimensions, size_factors,
+                                recipe->layers_factors, recipe->map_width, recipe->map_height, chunk_x, chunk_y, &recipe_context);
+}
+
+
+
+void freeMapRecipe(mapRecipe* recipe)
+{
+    if (recipe != NULL)
+    {
+        free(recipe->gradGrids_dimension);
+        free(recipe->layers_factors);
+        free(recipe);
+    }
+}
 
 
 
@@ -692,21 +1863,21 @@ void freeCompleteMap(completeMap* completeMap)
 {
     if (completeMap != NULL)
     {
-        if (completeMap->sea_values != NULL)
+        if (completeMap->sea_mapped_file != NULL)
+        {
+            unmapBinaryFile(completeMap->sea_mapped_file);
+        }
+        else if (completeMap->sea_values != NULL)
         {
             free(completeMap->sea_values);
         }
 
-        if (completeMap->color_map != NULL)
+        if (completeMap->color_mapped_file != NULL)
+        {
+            unmapBinaryFile(completeMap->color_mapped_file);
+        }
+        else if (completeMap->color_map != NULL)
         {
-            for (int i = 0; i < completeMap->height; i++)
-            {
-                for (int j = 0; j < completeMap->width; j++)
-                {
-                    free(getCompleteMapColor(completeMap, j, i));
-                }
-            }
-
             free(completeMap->color_map);
         }
 
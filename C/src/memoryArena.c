@@ -0,0 +1,157 @@
+/**
+ * @file memoryArena.c
+ * @author Zyno and BlueNZ
+ * @brief memoryArena structure implementation
+ * @version 0.2
+ * @date 2024-06-19
+ *
+ */
+
+#include <malloc.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "loadingBar.h"
+#include "memoryArena.h"
+
+/**
+ * @brief Rounds the given size up to a multiple of `ARENA_ALIGNMENT`.
+ *
+ * @param size (size_t) : the size to round, in bytes.
+ * @return size_t : the rounded size.
+ */
+static size_t alignSize(size_t size)
+{
+    return (size + ARENA_ALIGNMENT - 1) & ~((size_t) ARENA_ALIGNMENT - 1);
+}
+
+/**
+ * @brief Allocates a new zeroed block of the given size. Its memory starts right after its header, aligned on `ARENA_ALIGNMENT`.
+ *
+ * @param size (size_t) : the size of the block memory, in bytes. Should be a multiple of `ARENA_ALIGNMENT`.
+ * @return arenaBlock* : the pointer to the new block, `NULL` if the allocation failed.
+ */
+static arenaBlock* newArenaBlock(size_t size)
+{
+    arenaBlock* new_block = calloc(1, sizeof(arenaBlock) + ARENA_ALIGNMENT + size);
+
+    if (new_block == NULL)
+    {
+        return NULL;
+    }
+
+    uintptr_t data_address = (uintptr_t) (new_block + 1);
+
+    new_block->data = (unsigned char*) alignSize(data_address);
+    new_block->size = size;
+    new_block->used = 0;
+    new_block->previous = NULL;
+
+    return new_block;
+}
+
+
+
+
+
+memoryArena* newMemoryArena(size_t block_size)
+{
+    memoryArena* new_arena = calloc(1, sizeof(memoryArena));
+
+    new_arena->block_size = alignSize(block_size > 0 ? block_size : DEFAULT_ARENA_BLOCK_SIZE);
+    new_arena->current_block = NULL;
+    new_arena->nb_blocks = 0;
+    new_arena->nb_bytes = 0;
+
+    pthread_mutex_init(&new_arena->mutex, NULL);
+
+    return new_arena;
+}
+
+
+
+void* arenaCalloc(memoryArena* arena, size_t nb_elements, size_t element_size)
+{
+    if (arena == NULL)
+    {
+        return calloc(nb_elements, element_size);
+    }
+
+    if (element_size != 0 && nb_elements > SIZE_MAX / element_size)
+    {
+        printf("%sERROR : arena allocation of %zu elements of %zu bytes is too big.%s\n", RED_COLOR, nb_elements, element_size, DEFAULT_COLOR);
+        return NULL;
+    }
+
+    // Every allocation keeps the next one aligned, and gets its own bytes even when empty
+    size_t size = alignSize(nb_elements * element_size > 0 ? nb_elements * element_size : 1);
+
+    void* memory = NULL;
+
+    pthread_mutex_lock(&arena->mutex);
+
+    arenaBlock* current_block = arena->current_block;
+
+    if (current_block != NULL && current_block->used + size <= current_block->size)
+    {
+        memory = current_block->data + current_block->used;
+        current_block->used += size;
+    }
+    else
+    {
+        // A big allocation gets its own block, behind the current one which is still used for the small ones
+        int own_block = size > arena->block_size / 4;
+
+        arenaBlock* new_block = newArenaBlock(own_block ? size : arena->block_size);
+
+        if (new_block == NULL)
+        {
+            printf("%sERROR : arena block allocation was not successful.%s\n", RED_COLOR, DEFAULT_COLOR);
+        }
+        else
+        {
+            if (own_block && current_block != NULL)
+            {
+                new_block->previous = current_block->previous;
+                current_block->previous = new_block;
+            }
+            else
+            {
+                new_block->previous = current_block;
+                arena->current_block = new_block;
+            }
+
+            memory = new_block->data;
+            new_block->used = size;
+
+            arena->nb_blocks += 1;
+            arena->nb_bytes += new_block->size;
+        }
+    }
+
+    pthread_mutex_unlock(&arena->mutex);
+
+    return memory;
+}
+
+
+
+void freeMemoryArena(memoryArena* arena)
+{
+    if (arena != NULL)
+    {
+        arenaBlock* block = arena->current_block;
+
+        while (block != NULL)
+        {
+            arenaBlock* previous = block->previous;
+            free(block);
+            block = previous;
+        }
+
+        pthread_mutex_destroy(&arena->mutex);
+
+        free(arena);
+    }
+}
@@ -0,0 +1,227 @@
+/**
+ * @file test_asyncWriter.c
+ * @author Zyno and BlueNZ
+ * @brief a testing script for the asynchronous exports of the complete maps
+ * @version 0.2
+ * @date 2024-06-19
+ *
+ */
+
+// clock_gettime is not part of C99
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "loadingBar.h"
+#include "mapGenerator.h"
+
+/**
+ * @brief Gets the elapsed wall clock time since the given time.
+ *
+ * @param start_time (struct timespec*) : the pointer to the start time.
+ * @return double : the elapsed time in seconds.
+ */
+static double getElapsedTime(struct timespec* start_time)
+{
+    struct timespec end_time;
+    clock_gettime(CLOCK_MONOTONIC, &end_time);
+
+    return (end_time.tv_sec - start_time->tv_sec) + 1e-9 * (end_time.tv_nsec - start_time->tv_nsec);
+}
+
+/**
+ * @brief Checks whether the two files at the given paths have the same bytes.
+ *
+ * @param path1 (char[]) : the path of the first file.
+ * @param path2 (char[]) : the path of the second file.
+ * @return int : `1` if both files exist and have the same bytes, `0` otherwise.
+ */
+static int sameFiles(char path1[], char path2[])
+{
+    FILE* f1 = fopen(path1, "rb");
+    FILE* f2 = fopen(path2, "rb");
+
+    int same = f1 != NULL && f2 != NULL;
+
+    while (same)
+    {
+        int c1 = fgetc(f1);
+        int c2 = fgetc(f2);
+
+        same = c1 == c2;
+
+        if (c1 == EOF)
+        {
+            break;
+        }
+    }
+
+    if (f1 != NULL)
+    {
+        fclose(f1);
+    }
+
+    if (f2 != NULL)
+    {
+        fclose(f2);
+    }
+
+    return same;
+}
+
+/**
+ * @brief Counts the text files of a complete map export that differ from the ones in the reference folder.
+ *
+ * @param folder_path (char[]) : the path to the folder of the export.
+ * @param reference_path (char[]) : the path to the folder of the reference export.
+ * @return int : the number of differing files.
+ */
+static int countDifferentExportFiles(char folder_path[], char reference_path[])
+{
+    char file_names[3][30] = {"sea_map.txt", "color_int_map.txt", "color_float_map.txt"};
+    int nb_differences = 0;
+
+    for (int k = 0; k < 3; k++)
+    {
+        char path[250] = "";
+        snprintf(path, sizeof(path), "%s%s", folder_path, file_names[k]);
+
+        char reference_file_path[250] = "";
+        snprintf(reference_file_path, sizeof(reference_file_path), "%s%s", reference_path, file_names[k]);
+
+        if (!sameFiles(path, reference_file_path))
+        {
+            nb_differences += 1;
+        }
+    }
+
+    return nb_differences;
+}
+
+
+
+int main()
+{
+    generatorContext* context = newGeneratorContext(42);
+
+    int dimensions[3] = {3, 5, 15};
+    double weights[3] = {1., 0.3, 0.05};
+
+    printf("Generating a complete map of 4 x 3 chunks...\n");
+    completeMap* complete_map = fullGen(3, dimensions, weights, 4, 3, 0., context, 0);
+
+    //! WARNING : ../saves/ the folder must exist for it to work properly
+    char sync_path[200] = "../saves/async_test/";
+    writeCompleteMapFiles(complete_map, sync_path);
+
+    printf("Writing the same files through asynchronous writers...\n");
+    char async_path[200] = "../saves/async_test/async/";
+    asyncWriter* writer = newAsyncWriter(ASYNC_NB_BUFFERS, ASYNC_BUFFER_SIZE, ASYNC_SYNC_ON_CLOSE);
+    writeCompleteMapFilesAsync(complete_map, async_path, writer);
+    int success = waitAsyncWriter(writer);
+
+    // Tiny buffers, shorter than some lines : every value is split across buffers
+    char small_path[200] = "../saves/async_test/small_buffers/";
+    asyncWriter* small_writer = newAsyncWriter(3, 7, ASYNC_SYNC_EACH_BUFFER);
+    writeCompleteMapFilesAsync(complete_map, small_path, small_writer);
+    success = freeAsyncWriter(small_writer) && success;
+
+    printf("Writes succeeded : %d (should be 1), files differing from the synchronous ones : %d and %d (should be 0 and 0)\n", success,
+                countDifferentExportFiles(async_path, sync_path), countDifferentExportFiles(small_path, sync_path));
+
+    freeCompleteMap(complete_map);
+
+    printf("Exporting a batch of maps, one after another...\n");
+    int nb_maps = 4;
+    char batch_path[200] = "../saves/async_test/batch/";
+
+    // A sequential generation leaves the other cores to the formatting and writer threads
+    generatorContext batch_context = *context;
+    batch_context.options.nb_workers = 1;
+
+    struct timespec start_time;
+    double generation_time = 0.;
+    double write_time = 0.;
+
+    for (int k = 0; k < nb_maps; k++)
+    {
+        clock_gettime(CLOCK_MONOTONIC, &start_time);
+        completeMap* batch_map = fullGen(3, dimensions, weights, 16, 16, 0., &batch_context, 0);
+        generation_time += getElapsedTime(&start_time);
+
+        clock_gettime(CLOCK_MONOTONIC, &start_time);
+        writeCompleteMapFiles(batch_map, batch_path);
+        write_time += getElapsedTime(&start_time);
+
+        freeCompleteMap(batch_map);
+    }
+
+    double sync_time = generation_time + write_time;
+
+    printf("Exporting the same batch while generating the next map...\n");
+    char async_batch_path[200] = "../saves/async_test/batch/async/";
+
+    struct timespec batch_start_time;
+    clock_gettime(CLOCK_MONOTONIC, &batch_start_time);
+
+    // Double buffering : the map k is formatted and written while the map k + 1 is generated
+    completeMap* previous_map = NULL;
+    double wait_time = 0.;
+
+    for (int k = 0; k < nb_maps; k++)
+    {
+        completeMap* batch_map = fullGen(3, dimensions, weights, 16, 16, 0., &batch_context, 0);
+
+        clock_gettime(CLOCK_MONOTONIC, &start_time);
+        success = waitAsyncWriter(writer) && success;
+        wait_time += getElapsedTime(&start_time);
+
+        freeCompleteMap(previous_map);
+
+        writeCompleteMapFilesAsync(batch_map, async_batch_path, writer);
+        previous_map = batch_map;
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &start_time);
+    success = waitAsyncWriter(writer) && success;
+    wait_time += getElapsedTime(&start_time);
+
+    freeCompleteMap(previous_map);
+
+    double async_time = getElapsedTime(&batch_start_time);
+
+    // The writes overlap the generation when the generating thread waits for them less than they take
+    int hidden_percentage = write_time > 0. ? (int) (100. * (1. - wait_time / write_time)) : 0;
+    long nb_cores = sysconf(_SC_NPROCESSORS_ONLN);
+
+    printf("Batch of %d maps : %lf second(s) of generation and %lf second(s) of writes synchronously, %lf second(s) waited for the writes "
+                "asynchronously\n", nb_maps, generation_time, write_time, wait_time);
+    printf("Writes time hidden behind the generation : %d%% (should be more than 0%%)\n", hidden_percentage > 0 ? hidden_percentage : 0);
+    printf("Batch exported in %lf second(s) synchronously, %lf second(s) asynchronously : asynchronous export faster : %d "
+                "(should be 1 with a free core, %ld core(s) here)\n", sync_time, async_time, async_time < sync_time, nb_cores);
+    printf("Writes succeeded : %d (should be 1), files differing from the synchronous ones : %d (should be 0)\n", success,
+                countDifferentExportFiles(async_batch_path, batch_path));
+
+    printf("Writing in a full device through a writer (should print errors)...\n");
+    char full_path[200] = "/dev/full";
+    asyncWriter* full_writer = newAsyncWriter(2, 7, ASYNC_SYNC_EACH_BUFFER);
+    asyncFile* full_file = openAsyncFile(full_writer, full_path);
+
+    writeAsyncFile(full_file, "0123456789", 10);
+    waitAsyncWriter(full_writer);
+
+    int write_success = writeAsyncFile(full_file, "0123456789", 10);
+    int close_success = closeAsyncFile(full_file);
+    int writer_success = freeAsyncWriter(full_writer);
+
+    printf("Writes succeeded according to the file : %d and %d, according to the writer : %d (should be 0, 0 and 0)\n",
+                write_success, close_success, writer_success);
+
+    printf("Deallocating now...\n");
+    freeAsyncWriter(writer);
+    freeGeneratorContext(context);
+
+    return 0;
+}
@@ -0,0 +1,397 @@
+/**
+ * @file test_binaryFormat.c
+ * @author Zyno and BlueNZ
+ * @brief a testing script for the binary files of the generated structures, read or mapped in memory
+ * @version 0.2
+ * @date 2024-06-19
+ *
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <time.h>
+
+#include "loadingBar.h"
+#include "mapGenerator.h"
+
+int main()
+{
+    uint64_t seed = 42;
+
+    generatorContext* context = newGeneratorContext(seed);
+
+    int dimensions[3] = {3, 5, 15};
+    double weights[3] = {1., 0.3, 0.05};
+
+    printf("Generating a complete map of 4 x 3 chunks...\n");
+    completeMap* complete_map = fullGen(3, dimensions, weights, 4, 3, 0., context, 0);
+
+    //! WARNING : ../saves/ the folder must exist for it to work properly
+    char folder_path[200] = "../saves/binary_test/";
+
+    clock_t start_time = clock();
+    writeCompleteMapFiles(complete_map, folder_path);
+    double text_time = (double) (clock() - start_time) / CLOCKS_PER_SEC;
+
+    start_time = clock();
+    writeCompleteMapBinaryFiles(complete_map, seed, BINARY_CODEC_RAW, folder_path);
+    double binary_time = (double) (clock() - start_time) / CLOCKS_PER_SEC;
+
+    printf("Text files written in %lf second(s), binary files in %lf second(s)\n", text_time, binary_time);
+
+    printf("Reading the binary files back...\n");
+    binaryHeader header;
+    completeMap* read_map = readCompleteMapBinaryFiles(folder_path, &header);
+
+    if (read_map == NULL)
+    {
+        printf("%sCould not read the binary files back%s\n", RED_COLOR, DEFAULT_COLOR);
+
+        freeCompleteMap(complete_map);
+        freeGeneratorContext(context);
+        return 1;
+    }
+
+    printf("Header : version %d, %d x %d values, %d x %d chunks of %d x %d, seed %llu\n", header.version, header.width, header.height,
+                header.map_width, header.map_height, header.chunk_width, header.chunk_height, (unsigned long long) header.seed);
+
+    int nb_differences = 0;
+
+    for (int i = 0; i < complete_map->height; i++)
+    {
+        for (int j = 0; j < complete_map->width; j++)
+        {
+            color* c1 = getCompleteMapColor(complete_map, j, i);
+            color* c2 = getCompleteMapColor(read_map, j, i);
+
+            if (*getMapValue(complete_map->map, j, i) != *getMapValue(read_map->map, j, i)
+                || *getCompleteMapSeaValue(complete_map, j, i) != *getCompleteMapSeaValue(read_map, j, i)
+                || c1->red != c2->red || c1->green != c2->green || c1->blue != c2->blue)
+            {
+                nb_differences += 1;
+            }
+        }
+    }
+
+    printf("Values differing after the round trip : %d (should be 0), sea level %lf (should be %lf)\n", nb_differences,
+                read_map->sea_level, complete_map->sea_level);
+
+    printf("Mapping the binary files in memory...\n");
+    start_time = clock();
+    completeMap* mapped_map = readCompleteMapFiles(folder_path);
+    double mapping_time = (double) (clock() - start_time) / CLOCKS_PER_SEC;
+
+    if (mapped_map == NULL)
+    {
+        printf("%sCould not map the binary files%s\n", RED_COLOR, DEFAULT_COLOR);
+
+        freeCompleteMap(read_map);
+        freeCompleteMap(complete_map);
+        freeGeneratorContext(context);
+        return 1;
+    }
+
+    nb_differences = 0;
+
+    for (int i = 0; i < complete_map->height; i++)
+    {
+        for (int j = 0; j < complete_map->width; j++)
+        {
+            color* c1 = getCompleteMapColor(complete_map, j, i);
+            color* c2 = getCompleteMapColor(mapped_map, j, i);
+
+            if (*getMapValue(complete_map->map, j, i) != *getMapValue(mapped_map->map, j, i)
+                || *getCompleteMapSeaValue(complete_map, j, i) != *getCompleteMapSeaValue(mapped_map, j, i)
+                || c1->red != c2->red || c1->green != c2->green || c1->blue != c2->blue)
+            {
+                nb_differences += 1;
+            }
+        }
+    }
+
+    printf("Files mapped in %lf second(s), values differing from the generated ones : %d (should be 0)\n", mapping_time, nb_differences);
+
+    printf("Compressing the map and the sea map...\n");
+    char codec_folders[3][200] = {"../saves/binary_test/", "../saves/binary_test/predictive/", "../saves/binary_test/quantized/"};
+    int codecs[3] = {BINARY_CODEC_RAW, BINARY_CODEC_PREDICTIVE, BINARY_CODEC_QUANTIZED};
+
+    for (int c = 1; c < 3; c++)
+    {
+        writeCompleteMapBinaryFiles(complete_map, seed, codecs[c], codec_folders[c]);
+    }
+
+    for (int c = 0; c < 3; c++)
+    {
+        char codec_map_path[220] = "";
+        snprintf(codec_map_path, sizeof(codec_map_path), "%smap.bin", codec_folders[c]);
+
+        FILE* f = fopen(codec_map_path, "rb");
+        fseek(f, 0, SEEK_END);
+        long file_size = ftell(f);
+        fclose(f);
+
+        completeMap* decoded_map = readCompleteMapBinaryFiles(codec_folders[c], NULL);
+        double max_error = 0.;
+
+        for (int i = 0; i < complete_map->height; i++)
+        {
+            for (int j = 0; j < complete_map->width; j++)
+            {
+                double error = fabs(*getMapValue(complete_map->map, j, i) - *getMapValue(decoded_map->map, j, i));
+
+                if (error > max_error)
+                {
+                    max_error = error;
+                }
+            }
+        }
+
+        printf("Codec %d : map file of %ld bytes, maximum error %g (should be 0 but for the quantized codec, at most %g)\n", codecs[c],
+                    file_size, max_error, ldexp(1., -BINARY_QUANTIZATION_BITS - 1));
+
+        freeCompleteMap(decoded_map);
+    }
+
+    printf("Reading single chunks from a tiled file...\n");
+    char tiled_path[200] = "../saves/binary_test/tiled_map.bin";
+    writeMapTiledFile(complete_map->map, seed, tiled_path);
+
+    binaryRecordFile* tiled_file = openMapTiledFile(tiled_path);
+    nb_differences = 0;
+
+    for (int y = 0; y < complete_map->map->map_height; y++)
+    {
+        for (int x = 0; x < complete_map->map->map_width; x++)
+        {
+            chunk* original_chunk = getChunk(complete_map->map, x, y);
+            chunk* tiled_chunk = readMapTiledChunk(tiled_file, x, y);
+
+            if (tiled_chunk->base_altitude != original_chunk->base_altitude
+                || tiled_chunk->layers[2]->size_factor != original_chunk->layers[2]->size_factor)
+            {
+                nb_differences += 1;
+            }
+
+            for (int i = 0; i < original_chunk->height; i++)
+            {
+                for (int j = 0; j < original_chunk->width; j++)
+                {
+                    // The tiled values are the final ones, base altitude included
+                    if (*getMapValue(complete_map->map, x * original_chunk->width + j, y * original_chunk->height + i)
+                            != *getChunkValue(tiled_chunk, j, i))
+                    {
+                        nb_differences += 1;
+                    }
+                }
+            }
+
+            freeChunk(tiled_chunk);
+        }
+    }
+
+    closeBinaryRecordFile(tiled_file);
+
+    printf("Values differing in the tiled chunks : %d (should be 0)\n", nb_differences);
+
+    printf("Round trip of a chunk and of a gradient grid...\n");
+    chunk* first_chunk = getChunk(complete_map->map, 1, 1);
+
+    char chunk_path[200] = "../saves/binary_test/chunk.bin";
+    writeChunkBinaryFile(first_chunk, seed, chunk_path);
+    chunk* read_chunk = readChunkBinaryFile(chunk_path, NULL);
+    chunk* mapped_chunk = readChunkFile(chunk_path);
+
+    char grid_path[200] = "../saves/binary_test/gradient_grid.bin";
+    gradientGrid* grid = first_chunk->layers[1]->gradient_grid;
+    writeGradientGridBinaryFile(grid, seed, grid_path);
+    gradientGrid* read_grid = readGradientGridBinaryFile(grid_path, NULL);
+    gradientGrid* mapped_grid = readGradientGridFile(grid_path);
+
+    nb_differences = 0;
+
+    for (int i = 0; i < first_chunk->height; i++)
+    {
+        for (int j = 0; j < first_chunk->width; j++)
+        {
+            if (*getChunkValue(first_chunk, j, i) != *getChunkValue(read_chunk, j, i)
+                || *getChunkValue(first_chunk, j, i) != *getChunkValue(mapped_chunk, j, i))
+            {
+                nb_differences += 1;
+            }
+        }
+    }
+
+    for (int i = 0; i < grid->height; i++)
+    {
+        for (int j = 0; j < grid->width; j++)
+        {
+            vector v1 = getGradient(grid, j, i);
+            vector v2 = getGradient(read_grid, j, i);
+            vector v3 = getGradient(mapped_grid, j, i);
+
+            if (v1.x != v2.x || v1.y != v2.y || v1.x != v3.x || v1.y != v3.y)
+            {
+                nb_differences += 1;
+            }
+        }
+    }
+
+    printf("Values differing after the round trip : %d (should be 0)\n", nb_differences);
+
+    printf("Regenerating the complete map from its recipe...\n");
+    char recipe_path[200] = "../saves/binary_test/recipe.bin";
+    mapRecipe* recipe = newMapRecipe(3, dimensions, weights, 4, 3, 0., context);
+    writeMapRecipeFile(recipe, recipe_path);
+    freeMapRecipe(recipe);
+
+    FILE* recipe_file = fopen(recipe_path, "rb");
+    fseek(recipe_file, 0, SEEK_END);
+    long recipe_size = ftell(recipe_file);
+    fclose(recipe_file);
+
+    completeMap* recipe_map = loadMapRecipeFile(recipe_path, NULL, 0);
+    nb_differences = 0;
+
+    for (int i = 0; i < complete_map->height; i++)
+    {
+        for (int j = 0; j < complete_map->width; j++)
+        {
+            color* c1 = getCompleteMapColor(complete_map, j, i);
+            color* c2 = getCompleteMapColor(recipe_map, j, i);
+
+            if (*getMapValue(complete_map->map, j, i) != *getMapValue(recipe_map->map, j, i)
+                || *getCompleteMapSeaValue(complete_map, j, i) != *getCompleteMapSeaValue(recipe_map, j, i)
+                || c1->red != c2->red || c1->green != c2->green || c1->blue != c2->blue)
+            {
+                nb_differences += 1;
+            }
+        }
+    }
+
+    printf("Recipe file of %ld bytes, values differing from the generated ones : %d (should be 0)\n", recipe_size, nb_differences);
+
+    recipe = readMapRecipeFile(recipe_path);
+    chunk* recipe_chunk = regenerateRecipeChunk(recipe, 2, 1, NULL);
+    nb_differences = 0;
+
+    for (int i = 0; i < recipe_chunk->height; i++)
+    {
+        for (int j = 0; j < recipe_chunk->width; j++)
+        {
+            if (*getChunkValue(recipe_chunk, j, i) != *getMapValue(complete_map->map, 2 * recipe_chunk->width + j, recipe_chunk->height + i))
+            {
+                nb_differences += 1;
+            }
+        }
+    }
+
+    printf("Values of the regenerated chunk (2, 1) differing from the map : %d (should be 0)\n", nb_differences);
+
+    printf("Quantizing samples out of the codec range (should print three errors)...\n");
+    char quantized_path[200] = "../saves/binary_test/quantized_test.bin";
+    double quantized_rows[4][2] = {{0., 1.5}, {0., NAN}, {0., 1e30}, {0., 1.5}};
+    int quantized_bits[4] = {BINARY_QUANTIZATION_BITS, BINARY_QUANTIZATION_BITS, BINARY_QUANTIZATION_BITS, BINARY_MAX_QUANTIZATION_BITS + 1};
+    int quantized_successes[4];
+
+    for (int k = 0; k < 4; k++)
+    {
+        FILE* quantized_file = fopen(quantized_path, "wb");
+        binaryHeader quantized_header = initBinaryHeader(BINARY_MAP, BINARY_FLOAT64, 1, 2, 1, seed);
+        quantized_header.codec = BINARY_CODEC_QUANTIZED;
+        quantized_header.quantization_bits = quantized_bits[k];
+
+        binaryEncoder* encoder = newBinaryEncoder(quantized_file, &quantized_header);
+        quantized_successes[k] = encodeBinaryRow(encoder, quantized_rows[k]);
+        freeBinaryEncoder(encoder);
+
+        fclose(quantized_file);
+    }
+
+    printf("Rows encoded : finite %d (should be 1), NaN %d (should be 0), 1e30 %d (should be 0), with %d bits %d (should be 0)\n",
+                quantized_successes[0], quantized_successes[1], quantized_successes[2], BINARY_MAX_QUANTIZATION_BITS + 1, quantized_successes[3]);
+
+    printf("Reading forged map headers (should print six errors)...\n");
+    char forged_path[200] = "../saves/binary_test/forged_map.bin";
+    int nb_accepted = 0;
+
+    // A map of 10^10 values in a file without payload, then too many values for the memory, then a width that does not fit in an int
+    uint64_t forged_sizes[3][2] = {{100000, 100000}, {0x7fffffff, 0x7fffffff}, {0xffffffff, 1}};
+
+    for (int k = 0; k < 3; k++)
+    {
+        FILE* forged_file = fopen(forged_path, "wb");
+        binaryHeader forged_header = initBinaryHeader(BINARY_MAP, ALTITUDE_DTYPE, 1, 0, 0, seed);
+
+        writeBinaryHeader(forged_file, &forged_header);
+        fclose(forged_file);
+
+        // The dimensions are patched in the bytes, as a corrupted file would hold them
+        forged_file = fopen(forged_path, "r+b");
+        unsigned char dimension_bytes[8];
+
+        putBinaryInteger(dimension_bytes, forged_sizes[k][0], 4);
+        putBinaryInteger(dimension_bytes + 4, forged_sizes[k][1], 4);
+        fseek(forged_file, 12, SEEK_SET);
+        fwrite(dimension_bytes, 1, 8, forged_file);
+        fclose(forged_file);
+
+        map* forged_map = readMapBinaryFile(forged_path, NULL);
+        map* mapped_forged_map = readMapFile(forged_path);
+
+        nb_accepted += (forged_map != NULL) + (mapped_forged_map != NULL);
+
+        freeMap(forged_map);
+        freeMap(mapped_forged_map);
+    }
+
+    printf("Forged files accepted : %d (should be 0)\n", nb_accepted);
+
+    printf("Reading forged recipes (should print two errors)...\n");
+    char forged_recipe_path[200] = "../saves/binary_test/forged_recipe.bin";
+    nb_accepted = 0;
+
+    // A number of layers far beyond the stack arrays of a regeneration, then a gradient source out of the enum
+    long forged_offsets[2] = {36, BINARY_HEADER_SIZE + 2};
+    uint64_t forged_values[2] = {1000000, 7};
+    int forged_lengths[2] = {4, 2};
+
+    for (int k = 0; k < 2; k++)
+    {
+        mapRecipe* forged_recipe = newMapRecipe(3, dimensions, weights, 4, 3, 0., context);
+        writeMapRecipeFile(forged_recipe, forged_recipe_path);
+        freeMapRecipe(forged_recipe);
+
+        FILE* forged_file = fopen(forged_recipe_path, "r+b");
+        unsigned char value_bytes[4];
+
+        putBinaryInteger(value_bytes, forged_values[k], forged_lengths[k]);
+        fseek(forged_file, forged_offsets[k], SEEK_SET);
+        fwrite(value_bytes, 1, forged_lengths[k], forged_file);
+        fclose(forged_file);
+
+        forged_recipe = readMapRecipeFile(forged_recipe_path);
+        nb_accepted += forged_recipe != NULL;
+
+        if (forged_recipe != NULL)
+        {
+            freeMapRecipe(forged_recipe);
+        }
+    }
+
+    printf("Forged recipes accepted : %d (should be 0)\n", nb_accepted);
+
+    printf("Deallocating now...\n");
+    freeChunk(recipe_chunk);
+    freeMapRecipe(recipe);
+    freeCompleteMap(recipe_map);
+    freeGradGrid(mapped_grid);
+    freeGradGrid(read_grid);
+    freeChunk(mapped_chunk);
+    freeChunk(read_chunk);
+    freeCompleteMap(mapped_map);
+    freeCompleteMap(read_map);
+    freeCompleteMap(complete_map);
+    freeGeneratorContext(context);
+
+    return 0;
+}
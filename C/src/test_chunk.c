@@ -24,14 +24,18 @@ int main()
     int width2 = 7;
     int height2 = 7;
 
-    setRandomSeed(time(NULL)); //? Comment this to make it not random, or give a constant rather than time(NULL)
+    generatorContext* context = newGeneratorContext(time(NULL)); //? Give a constant rather than time(NULL) to make it not random
+    generatorContext chunk_context = getChunkContext(context, 0, 0);
+    generatorContext layer_context1 = getLayerContext(&chunk_context, 0);
+    generatorContext layer_context2 = getLayerContext(&chunk_context, 1);
+    generatorContext another_chunk_context = getChunkContext(context, 1, 0);
 
     printf("Creating two gradient grids of sizes (height, width) = (%d x %d) and (%d x %d)\n", height1, width1, height2, width2);
 
-    gradientGrid* gradGrid1 = newRandomGradGrid(width1 + 1, height1 + 1, display_loading);
+    gradientGrid* gradGrid1 = newRandomGradGrid(width1 + 1, height1 + 1, &layer_context1, display_loading);
     // printGradientGrid(gradGrid1);
 
-    gradientGrid* gradGrid2 = newRandomGradGrid(width2 + 1, height2 + 1, display_loading);
+    gradientGrid* gradGrid2 = newRandomGradGrid(width2 + 1, height2 + 1, &layer_context2, display_loading);
     // printGradientGrid(gradGrid2);
 
 
@@ -64,7 +68,7 @@ int main()
 
     printf("Creating chunk with these two layers, and factors = {%lf, %lf}\n", my_factors[0], my_factors[1]);
 
-    chunk* my_chunk = newChunkFromLayers(layer_width1, layer_height1, 2, my_factors, my_layers, display_loading);
+    chunk* my_chunk = newChunkFromLayers(layer_width1, layer_height1, 2, my_factors, my_layers, NULL, 0, &chunk_context, display_loading);
 
     printChunk(my_chunk);
 
@@ -75,11 +79,56 @@ int main()
     int heights[] = {height1, height2};
     int size_factors[] = {sizeFactor1, sizeFactor2};
 
-    chunk* another_chunk = newChunk(2, widths, heights, size_factors, my_factors, display_loading);
+    chunk* another_chunk = newChunk(2, widths, heights, size_factors, my_factors, 1, NULL, 0, &another_chunk_context, display_loading);
 
     printChunk(another_chunk);
 
 
+    printf("Generating the same chunk with its layers in parallel...\n");
+
+    generatorContext parallel_context = another_chunk_context;
+    parallel_context.options.nb_workers = 2; //? Number of threads generating the layers
+
+    chunk* parallel_chunk = newChunk(2, widths, heights, size_factors, my_factors, 1, NULL, 0, &parallel_context, 0);
+
+    int nb_differences = 0;
+
+    for (int i = 0; i < another_chunk->height; i++)
+    {
+        for (int j = 0; j < another_chunk->width; j++)
+        {
+            if (*getChunkValue(another_chunk, j, i) != *getChunkValue(parallel_chunk, j, i))
+            {
+                nb_differences += 1;
+            }
+        }
+    }
+
+    printf("Values differing from the sequential chunk : %d (should be 0)\n", nb_differences);
+
+
+    printf("Trimming it, then regenerating and copying it (should print two errors)...\n");
+
+    trimChunk(parallel_chunk);
+    regenerateChunk(parallel_chunk, &parallel_context, 0);
+    chunk* trimmed_copy = copyChunk(parallel_chunk);
+
+    nb_differences = 0;
+
+    for (int i = 0; i < another_chunk->height; i++)
+    {
+        for (int j = 0; j < another_chunk->width; j++)
+        {
+            if (*getChunkValue(another_chunk, j, i) != *getChunkValue(parallel_chunk, j, i))
+            {
+                nb_differences += 1;
+            }
+        }
+    }
+
+    printf("Values changed by the refused regeneration : %d (should be 0), copy is NULL : %d (should be 1)\n", nb_differences, trimmed_copy == NULL);
+
+
 
     //? Comment this if you don't want to save it in a file.
     //! WARNING : ../saves/ the folder must exist for it to work properly
@@ -95,6 +144,9 @@ int main()
 
     freeChunk(my_chunk);
     freeChunk(another_chunk);
+    freeChunk(parallel_chunk);
+
+    freeGeneratorContext(context);
 
     return 0;
 }
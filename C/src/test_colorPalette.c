@@ -0,0 +1,151 @@
+/**
+ * @file test_colorPalette.c
+ * @author Zyno and BlueNZ
+ * @brief a testing script for the colorPalette and colorLUT implementation
+ * @version 0.2
+ * @date 2024-06-19
+ *
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "colorPalette.h"
+
+/**
+ * @brief Computes the color of the given altitude value as the original color maps did, before the palettes.
+ *
+ * @param value (double) : the altitude value.
+ * @param sea_level (double) : the sea level of the map.
+ * @param min_value (double) : the minimum altitude value of the map.
+ * @param max_value (double) : the maximum altitude value of the map.
+ * @return color : the original color of the value.
+ */
+static color getOriginalColor(double value, double sea_level, double min_value, double max_value)
+{
+    color res = {50, 50, 50};
+
+    if (value == 0)
+    {
+        res.red = 255;
+        res.green = 0;
+        res.blue = 0;
+    }
+    else if (value <= sea_level)
+    {
+        res.blue = (uint8_t) ((value - min_value) * 200. / (sea_level - min_value));
+    }
+    else
+    {
+        res.green = (uint8_t) ((value - min_value) * 255. / (max_value - min_value));
+    }
+
+    return res;
+}
+
+
+
+int main()
+{
+    double min_value = -1.;
+    double max_value = 1.5;
+    double sea_level = 0.2;
+
+    printf("Creating the default palette and its lookup table on [%lf, %lf], with a sea level at %lf\n", min_value, max_value, sea_level);
+    colorPalette* palette = newDefaultColorPalette();
+    colorLUT* lut = newColorLUT(palette, PALETTE_LUT_SIZE, sea_level, min_value, max_value);
+
+    double values[6] = {-2., -1., 0., 0.2, 1., 1.5};
+
+    for (int k = 0; k < 6; k++)
+    {
+        color exact = getPaletteColor(palette, values[k], sea_level, min_value, max_value);
+        color table = lookupColor(lut, values[k]);
+
+        printf("Value % lf : exact color (%d,%d,%d), table color (%d,%d,%d)\n", values[k], exact.red, exact.green, exact.blue,
+                    table.red, table.green, table.blue);
+    }
+
+    // No entry mixes the sea and the land : the table colors can only differ from the exact ones by the quantization, even at the sea level
+    int nb_values = 100000;
+    int max_difference = 0;
+
+    for (int k = 0; k < nb_values + 2; k++)
+    {
+        double value = min_value + (max_value - min_value) * k / (nb_values - 1);
+
+        if (k == nb_values)
+        {
+            value = nextafter(sea_level, INFINITY);
+        }
+        else if (k == nb_values + 1)
+        {
+            value = sea_level;
+        }
+
+        // The value a map would hold, given to both
+        altitude_t map_value = (altitude_t) value;
+
+        color exact = getPaletteColor(palette, map_value, sea_level, min_value, max_value);
+        color table = lookupColor(lut, map_value);
+
+        int differences[3] = {abs(exact.red - table.red), abs(exact.green - table.green), abs(exact.blue - table.blue)};
+
+        for (int c = 0; c < 3; c++)
+        {
+            if (differences[c] > max_difference)
+            {
+                max_difference = differences[c];
+            }
+        }
+    }
+
+    printf("Maximum channel difference over %d values : %d (should be at most 1)\n", nb_values + 2, max_difference);
+
+    // The default palette keeps the original colors, but for the rounding of the channels
+    int max_original_difference = 0;
+
+    for (int k = 0; k < nb_values + 1; k++)
+    {
+        double value = k < nb_values ? min_value + (max_value - min_value) * k / (nb_values - 1) : 0.;
+
+        color exact = getPaletteColor(palette, value, sea_level, min_value, max_value);
+        color original = getOriginalColor(value, sea_level, min_value, max_value);
+
+        int differences[3] = {abs(exact.red - original.red), abs(exact.green - original.green), abs(exact.blue - original.blue)};
+
+        for (int c = 0; c < 3; c++)
+        {
+            if (differences[c] > max_original_difference)
+            {
+                max_original_difference = differences[c];
+            }
+        }
+    }
+
+    printf("Maximum channel difference with the original colors : %d (should be at most 1)\n", max_original_difference);
+
+    printf("Creating a custom palette with three land stops\n");
+    paletteStop sea_stops[1] = {{0., {0, 0, 128}}};
+    paletteStop land_stops[3] = {{0., {240, 220, 130}}, {0.5, {30, 160, 30}}, {1., {255, 255, 255}}};
+
+    colorPalette* custom_palette = newColorPalette(1, sea_stops, 3, land_stops);
+    colorLUT* custom_lut = newColorLUT(custom_palette, 16, sea_level, min_value, max_value);
+
+    for (int k = 0; k < custom_lut->nb_entries; k++)
+    {
+        color c = custom_lut->entries[k];
+        printf("(%d,%d,%d) ", c.red, c.green, c.blue);
+    }
+    printf("\n");
+
+    printf("Deallocating now...\n");
+
+    freeColorLUT(custom_lut);
+    freeColorPalette(custom_palette);
+    freeColorLUT(lut);
+    freeColorPalette(palette);
+
+    return 0;
+}
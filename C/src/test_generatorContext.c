@@ -0,0 +1,81 @@
+/**
+ * @file test_generatorContext.c
+ * @author Zyno and BlueNZ
+ * @brief a testing script for the generatorContext implementation
+ * @version 0.2
+ * @date 2024-06-19
+ *
+ */
+
+#include <stdio.h>
+#include <time.h>
+
+#include "generatorContext.h"
+
+int main()
+{
+    generatorContext* context = newGeneratorContext(time(NULL)); //? Give a constant rather than time(NULL) to make it not random
+
+    int width = 4;
+    int height = 3;
+
+    printf("Random values of layer 0 in chunk (0, 0) on a (width x height) = (%d x %d) grid :\n", width, height);
+
+    generatorContext chunk_context = getChunkContext(context, 0, 0);
+    generatorContext layer_context = getLayerContext(&chunk_context, 0);
+
+    double values[3][4];
+
+    for (int i = 0; i < height; i++)
+    {
+        for (int j = 0; j < width; j++)
+        {
+            values[i][j] = getRandomUniform(&layer_context, j, i, 0);
+            printf("%lf   ", values[i][j]);
+        }
+        printf("\n");
+    }
+
+
+
+    printf("Drawing the same values again in reverse order, from a context derived on its own...\n");
+
+    generatorContext other_chunk_context = getChunkContext(context, 0, 0);
+    generatorContext other_layer_context = getLayerContext(&other_chunk_context, 0);
+
+    int nb_differences = 0;
+
+    for (int i = height - 1; i >= 0; i--)
+    {
+        for (int j = width - 1; j >= 0; j--)
+        {
+            if (getRandomUniform(&other_layer_context, j, i, 0) != values[i][j])
+            {
+                nb_differences += 1;
+            }
+        }
+    }
+
+    printf("Number of different values (should be 0) : %d\n", nb_differences);
+
+
+
+    printf("Values of the neighbour keys for cell (0, 0) (should all be different) :\n");
+
+    generatorContext next_chunk_context = getChunkContext(context, 1, 0);
+    generatorContext next_layer_context = getLayerContext(&chunk_context, 1);
+
+    printf("chunk (0, 0) layer 0 draw 0 : %lf\n", getRandomUniform(&layer_context, 0, 0, 0));
+    printf("chunk (0, 0) layer 0 draw 1 : %lf\n", getRandomUniform(&layer_context, 0, 0, 1));
+    printf("chunk (0, 0) layer 1 draw 0 : %lf\n", getRandomUniform(&next_layer_context, 0, 0, 0));
+    printf("chunk (1, 0) base altitude  : %lf\n", getRandomUniform(&next_chunk_context, 0, 0, 0));
+    printf("chunk (0, 0) base altitude  : %lf\n", getRandomUniform(&chunk_context, 0, 0, 0));
+
+
+
+    printf("Deallocating now...\n");
+
+    freeGeneratorContext(context);
+
+    return 0;
+}
@@ -19,11 +19,15 @@ int main()
     int width = 7;
     int height = 5;
 
-    setRandomSeed(time(NULL)); //? Comment this to make it not random, or give a constant rather than time(NULL)
+    generatorContext* context = newGeneratorContext(time(NULL)); //? Give a constant rather than time(NULL) to make it not random
+    generatorContext grid_context = getChunkContext(context, 0, 0);
+    generatorContext east_context = getChunkContext(context, 1, 0);
+    generatorContext south_context = getChunkContext(context, 0, 1);
+    generatorContext south_east_context = getChunkContext(context, 1, 1);
 
     printf("Creating a gradient grid of size (width x height) = (%d x %d)\n", width, height);
 
-    gradientGrid* gradGrid = newRandomGradGrid(width, height, display_loading);
+    gradientGrid* gradGrid = newRandomGradGrid(width, height, &grid_context, display_loading);
 
     printf("Total space used by this gradient grid : %ld\n", sizeof(*gradGrid) + width*height*sizeof(*(gradGrid->gradients)));
     //                                              Should be :    4 + 4 + 8   + width*height    *      (8 + 8)
@@ -32,20 +36,96 @@ int main()
     printGradientGrid(gradGrid);
 
     printf("Creating adjacent East gradient grid :\n");
-    gradientGrid* gradientEast = newAdjacentGradGrid(NULL, gradGrid, display_loading);
+    gradientGrid* gradientEast = newAdjacentGradGrid(NULL, gradGrid, &east_context, display_loading);
     printGradientGrid(gradientEast);
 
 
     printf("Creating adjacent South gradient grid :\n");
-    gradientGrid* gradientSouth = newAdjacentGradGrid(gradGrid, NULL, display_loading);
+    gradientGrid* gradientSouth = newAdjacentGradGrid(gradGrid, NULL, &south_context, display_loading);
     printGradientGrid(gradientSouth);
 
 
     printf("Creating adjacent South-East gradient grid :\n");
-    gradientGrid* gradientSouthEast = newAdjacentGradGrid(gradientEast, gradientSouth, display_loading);
+    gradientGrid* gradientSouthEast = newAdjacentGradGrid(gradientEast, gradientSouth, &south_east_context, display_loading);
     printGradientGrid(gradientSouthEast);
 
 
+    printf("Creating two adjacent hashed gradient grids :\n");
+    generatorContext lattice_context = getLatticeContext(context, 0);
+    gradientGrid* hashedWest = newHashedGradGrid(width, height, 0, 0, &lattice_context);
+    gradientGrid* hashedEast = newHashedGradGrid(width, height, width - 1, 0, &lattice_context);
+    printGradientGrid(hashedWest);
+    printGradientGrid(hashedEast);
+
+    // The east column of the west grid is the west column of the east grid
+    int nb_differences = 0;
+
+    for (int i = 0; i < height; i++)
+    {
+        vector west_vector = getGradient(hashedWest, width - 1, i);
+        vector east_vector = getGradient(hashedEast, 0, i);
+
+        if (west_vector.x != east_vector.x || west_vector.y != east_vector.y)
+        {
+            nb_differences += 1;
+        }
+    }
+
+    printf("Common boundary vectors differing : %d (should be 0)\n", nb_differences);
+
+    // The lattice keys are in their own domain : they should not draw the vectors of the layer 0 of the chunk (0, 0)
+    generatorContext layer_context = getLayerContext(&grid_context, 0);
+    gradientGrid* layerGrid = newRandomGradGrid(width, height, &layer_context, 0);
+    int nb_shared = 0;
+
+    for (int i = 0; i < height; i++)
+    {
+        for (int j = 0; j < width; j++)
+        {
+            vector lattice_vector = getGradient(hashedWest, j, i);
+            vector layer_vector = getGradient(layerGrid, j, i);
+
+            if (lattice_vector.x == layer_vector.x && lattice_vector.y == layer_vector.y)
+            {
+                nb_shared += 1;
+            }
+        }
+    }
+
+    printf("Vectors shared by the lattice and the layer 0 of the chunk (0, 0) : %d (should be 0)\n", nb_shared);
+
+
+    printf("Trimming a copy of the first gradient grid :\n");
+    gradientGrid* trimmedGrid = copyGrad(gradGrid);
+    trimGradGrid(trimmedGrid);
+
+    int nb_boundary_differences = 0;
+
+    for (int i = 0; i < height; i++)
+    {
+        for (int j = 0; j < width; j++)
+        {
+            if (i == height - 1 || j == width - 1)
+            {
+                vector trimmed_vector = getBoundaryGradient(trimmedGrid, j, i);
+                vector full_vector = getGradient(gradGrid, j, i);
+
+                if (trimmed_vector.x != full_vector.x || trimmed_vector.y != full_vector.y)
+                {
+                    nb_boundary_differences += 1;
+                }
+            }
+        }
+    }
+
+    printf("Boundary vectors differing from the full grid : %d (should be 0)\n", nb_boundary_differences);
+
+    printf("Its vectors can not be read nor written (should print two errors) :\n");
+    vector* trimmed_vector = getVector(trimmedGrid, 0, 0);
+    writeGradientGridFile(trimmedGrid, "../saves/gradGrid_trimmed_test.txt");
+    printf("Vector pointer is NULL : %d (should be 1)\n", trimmed_vector == NULL);
+
+
     //? Comment this if you don't want to save it in a file.
     //! WARNING : ../saves/ the folder must exist for it to work properly
     printf("File creation...\n");
@@ -61,6 +141,12 @@ int main()
     freeGradGrid(gradientEast);
     freeGradGrid(gradientSouth);
     freeGradGrid(gradientSouthEast);
+    freeGradGrid(hashedWest);
+    freeGradGrid(hashedEast);
+    freeGradGrid(layerGrid);
+    freeGradGrid(trimmedGrid);
+
+    freeGeneratorContext(context);
 
     return 0;
 }
@@ -0,0 +1,134 @@
+/**
+ * @file test_imageFile.c
+ * @author Zyno and BlueNZ
+ * @brief a testing script for the PPM and PNG exports of the color map
+ * @version 0.2
+ * @date 2024-06-19
+ *
+ */
+
+#include <stdio.h>
+#include <time.h>
+
+#include "loadingBar.h"
+#include "mapGenerator.h"
+
+/**
+ * @brief Gets the size of the file at the given path.
+ *
+ * @param path (char[]) : the path of the file.
+ * @return long : the size of the file in bytes, `-1` if it could not be opened.
+ */
+static long getFileSize(char path[])
+{
+    FILE* f = fopen(path, "rb");
+
+    if (f == NULL)
+    {
+        return -1;
+    }
+
+    fseek(f, 0, SEEK_END);
+    long file_size = ftell(f);
+    fclose(f);
+
+    return file_size;
+}
+
+
+
+int main()
+{
+    generatorContext* context = newGeneratorContext(42);
+
+    int dimensions[3] = {3, 5, 15};
+    double weights[3] = {1., 0.3, 0.05};
+
+    printf("Generating a complete map of 4 x 3 chunks...\n");
+    completeMap* complete_map = fullGen(3, dimensions, weights, 4, 3, 0., context, 0);
+
+    //! WARNING : ../saves/ the folder must exist for it to work properly
+    char folder_path[200] = "../saves/image_test/";
+    writeCompleteMapFiles(complete_map, folder_path);
+
+    char text_path[220] = "";
+    snprintf(text_path, sizeof(text_path), "%scolor_int_map.txt", folder_path);
+
+    char ppm_path[220] = "";
+    snprintf(ppm_path, sizeof(ppm_path), "%scolor_map.ppm", folder_path);
+
+    char stored_path[220] = "";
+    snprintf(stored_path, sizeof(stored_path), "%scolor_map_stored.png", folder_path);
+
+    char png_path[220] = "";
+    snprintf(png_path, sizeof(png_path), "%scolor_map.png", folder_path);
+
+    clock_t start_time = clock();
+    writeColorMapPPMFile(complete_map, ppm_path);
+    double ppm_time = (double) (clock() - start_time) / CLOCKS_PER_SEC;
+
+    start_time = clock();
+    writeColorMapPNGFile(complete_map, PNG_STORED, stored_path);
+    double stored_time = (double) (clock() - start_time) / CLOCKS_PER_SEC;
+
+    start_time = clock();
+    writeColorMapPNGFile(complete_map, PNG_DEFLATE, png_path);
+    double png_time = (double) (clock() - start_time) / CLOCKS_PER_SEC;
+
+    printf("Text color map of %ld bytes\n", getFileSize(text_path));
+    printf("PPM file of %ld bytes written in %lf second(s)\n", getFileSize(ppm_path), ppm_time);
+    printf("Stored PNG file of %ld bytes written in %lf second(s)\n", getFileSize(stored_path), stored_time);
+    printf("Compressed PNG file of %ld bytes written in %lf second(s)\n", getFileSize(png_path), png_time);
+
+    printf("Reading the PPM file back...\n");
+    FILE* f = fopen(ppm_path, "rb");
+    int width = 0;
+    int height = 0;
+    int max_value = 0;
+
+    if (f == NULL || fscanf(f, "P6 %d %d %d", &width, &height, &max_value) != 3 || fgetc(f) != '\n')
+    {
+        printf("%sCould not read the PPM header back%s\n", RED_COLOR, DEFAULT_COLOR);
+
+        if (f != NULL)
+        {
+            fclose(f);
+        }
+
+        freeCompleteMap(complete_map);
+        freeGeneratorContext(context);
+        return 1;
+    }
+
+    printf("PPM header : %d x %d, maximum value %d (should be %d x %d, 255)\n", width, height, max_value, complete_map->width,
+                complete_map->height);
+
+    int nb_differences = 0;
+
+    for (int i = 0; i < complete_map->height; i++)
+    {
+        for (int j = 0; j < complete_map->width; j++)
+        {
+            color* c = getCompleteMapColor(complete_map, j, i);
+
+            int red = fgetc(f);
+            int green = fgetc(f);
+            int blue = fgetc(f);
+
+            if (red != c->red || green != c->green || blue != c->blue)
+            {
+                nb_differences += 1;
+            }
+        }
+    }
+
+    fclose(f);
+
+    printf("Colors differing after the round trip : %d (should be 0)\n", nb_differences);
+
+    printf("Deallocating now...\n");
+    freeCompleteMap(complete_map);
+    freeGeneratorContext(context);
+
+    return 0;
+}
@@ -20,11 +20,14 @@ int main()
     int width = 5;
     int height = 4;
 
-    setRandomSeed(time(NULL)); //? Comment this to make it not random, or give a constant rather than time(NULL)
+    generatorContext* context = newGeneratorContext(time(NULL)); //? Give a constant rather than time(NULL) to make it not random
+    generatorContext chunk_context = getChunkContext(context, 0, 0);
+    generatorContext layer_context = getLayerContext(&chunk_context, 0);
+    generatorContext another_layer_context = getLayerContext(&chunk_context, 1);
 
     printf("Creating a gradient grid of size (height x width) = (%d x %d)\n", height, width);
 
-    gradientGrid* gradGrid = newRandomGradGrid(width, height, display_loading);
+    gradientGrid* gradGrid = newRandomGradGrid(width, height, &layer_context, display_loading);
 
     printGradientGrid(gradGrid);
 
@@ -42,12 +45,84 @@ int main()
 
     printf("Trying another layer.\n");
 
-    layer* another_layer = newLayer(width, height, sizeFactor, display_loading);
+    layer* another_layer = newLayer(width, height, sizeFactor, &another_layer_context, display_loading);
 
     printLayer(another_layer);
 
 
 
+    printf("Comparing the layers of every row kernel with perlin...\n");
+
+    int kernels[3] = {PERLIN_ROW_SCALAR, PERLIN_ROW_SSE2, PERLIN_ROW_AVX2};
+    char kernel_names[3][10] = {"scalar", "SSE2", "AVX2"};
+
+    // An odd size factor, so that the rows end with samples left to the scalar tail of the SIMD kernels
+    int kernel_size_factor = 7;
+
+    for (int k = 0; k < 3; k++)
+    {
+        if (!setPerlinRowKernel(kernels[k]))
+        {
+            printf("The %s kernel is not supported here, skipped\n", kernel_names[k]);
+            continue;
+        }
+
+        // The layer owns its gradient grid
+        layer* kernel_layer = newLayerFromGradient(copyGrad(gradGrid), kernel_size_factor, 0);
+        int nb_mismatches = 0;
+
+        for (int i = 0; i < kernel_layer->height; i++)
+        {
+            for (int j = 0; j < kernel_layer->width; j++)
+            {
+                altitude_t expected = perlin((altitude_t) j/kernel_size_factor, (altitude_t) i/kernel_size_factor, gradGrid);
+
+                if (*getLayerValue(kernel_layer, j, i) != expected)
+                {
+                    nb_mismatches += 1;
+                }
+            }
+        }
+
+        printf("The %s kernel : values differing from perlin : %d (should be 0)\n", kernel_names[k], nb_mismatches);
+
+        freeLayer(kernel_layer);
+    }
+
+    setPerlinRowKernel(PERLIN_ROW_AUTO);
+
+
+    printf("Generating layers from the shared weights tables of the size factors {7, 3, 7}...\n");
+    int set_size_factors[3] = {7, 3, 7};
+    int length = 7 * (gradGrid->width > gradGrid->height ? gradGrid->width - 1 : gradGrid->height - 1);
+
+    perlinTableSet* table_set = newPerlinTableSet(3, set_size_factors, length);
+    perlinTable* shared_table = getPerlinTable(table_set, 7, length);
+
+    layer* table_layer = newLayerFromTable(copyGrad(gradGrid), shared_table, 0);
+    layer* gradient_layer = newLayerFromGradient(copyGrad(gradGrid), 7, 0);
+    int nb_differences = 0;
+
+    for (int i = 0; i < table_layer->height; i++)
+    {
+        for (int j = 0; j < table_layer->width; j++)
+        {
+            if (*getLayerValue(table_layer, j, i) != *getLayerValue(gradient_layer, j, i))
+            {
+                nb_differences += 1;
+            }
+        }
+    }
+
+    printf("Tables : %d (should be 2), values differing from a layer with its own table : %d (should be 0)\n", table_set->nb_tables,
+                nb_differences);
+
+    freeLayer(table_layer);
+    freeLayer(gradient_layer);
+    freePerlinTableSet(table_set);
+
+
+
     //? Comment this if you don't want to save it in a file.
     //! WARNING : ../saves/ the folder must exist for it to work properly
     printf("File creation...\n");
@@ -64,5 +139,7 @@ int main()
 
     freeLayer(another_layer);
 
+    freeGeneratorContext(context);
+
     return 0;
 }
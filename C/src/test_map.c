@@ -16,9 +16,89 @@
 #include "chunk.h"
 #include "map.h"
 
+/**
+ * @brief The state of the comparison of a streamed map with the full one.
+ *
+ */
+struct streamCheck
+{
+    map* full_map; /**< the pointer to the full map*/
+    int nb_rows; /**< the number of rows received*/
+    int nb_differences; /**< the number of values differing from the full map*/
+};
+
+/**
+ * @brief Compares a streamed row with the one of the full map (a `mapRowSink`).
+ *
+ * @param sink_data (void*) : the pointer to the streamCheck structure.
+ * @param row_idx (int) : the index of the row.
+ * @param width (int) : the number of values of the row.
+ * @param row_values (altitude_t*) : the values of the row.
+ * @return int : always `1`.
+ */
+static int compareStreamedRow(void* sink_data, int row_idx, int width, altitude_t* row_values)
+{
+    struct streamCheck* check = sink_data;
+
+    for (int j = 0; j < width; j++)
+    {
+        if (row_values[j] != *getMapValue(check->full_map, j, row_idx))
+        {
+            check->nb_differences += 1;
+        }
+    }
+
+    check->nb_rows += 1;
+
+    return 1;
+}
+
+/**
+ * @brief Checks whether two files have the same content.
+ *
+ * @param path1 (char[]) : the path of the first file.
+ * @param path2 (char[]) : the path of the second file.
+ * @return int : `1` if both files could be read and are identical, `0` otherwise.
+ */
+static int sameFiles(char path1[], char path2[])
+{
+    FILE* f1 = fopen(path1, "rb");
+    FILE* f2 = fopen(path2, "rb");
+    int same = f1 != NULL && f2 != NULL;
+
+    while (same)
+    {
+        int c1 = fgetc(f1);
+        int c2 = fgetc(f2);
+
+        same = c1 == c2;
+
+        if (c1 == EOF)
+        {
+            break;
+        }
+    }
+
+    if (f1 != NULL)
+    {
+        fclose(f1);
+    }
+    if (f2 != NULL)
+    {
+        fclose(f2);
+    }
+
+    return same;
+}
+
+
+
 int main()
 {
-    setRandomSeed(time(NULL)); //? Comment this to make it not random, or give a constant rather than time(NULL)
+    generatorContext* context = newGeneratorContext(time(NULL)); //? Give a constant rather than time(NULL) to make it not random
+    context->options.nb_workers = 2; //? Number of threads generating the chunks, 1 for a sequential generation
+    context->options.chunk_views = 0; //? 1 to generate the chunks in place in the map values rather than copying them
+    context->options.chunk_retention = KEEP_FULL_CHUNKS; //? KEEP_CHUNK_BOUNDARIES to only keep the chunks gradient grids boundaries
 
     int display_loading = 1;
 
@@ -35,7 +115,7 @@ int main()
 
     printf("Creating a full map...\n");
 
-    map* my_map = newMap(nb_layers, gradGrids_width, gradGrids_height, size_factors, layers_factors, map_width, map_height, display_loading);
+    map* my_map = newMap(nb_layers, gradGrids_width, gradGrids_height, size_factors, layers_factors, map_width, map_height, context, display_loading);
 
     printMap(my_map);
 
@@ -50,9 +130,88 @@ int main()
     printf("File should be written now.\n");
 
 
+    printf("Streaming the same map row by row...\n");
+    struct streamCheck check = {my_map, 0, 0};
+
+    streamMap(nb_layers, gradGrids_width, gradGrids_height, size_factors, layers_factors, map_width, map_height, context,
+                compareStreamedRow, &check, display_loading);
+
+    printf("Rows streamed : %d (should be %d), values differing from the full map : %d (should be 0)\n", check.nb_rows,
+                map_height * my_map->chunk_height, check.nb_differences);
+
+    printf("Streaming it in a binary file...\n");
+    char binary_path[200] = "../saves/map_test.bin";
+    char streamed_path[200] = "../saves/map_streamed_test.bin";
+
+    writeMapBinaryFile(my_map, context->seed, BINARY_CODEC_PREDICTIVE, binary_path);
+    streamMapBinaryFile(nb_layers, gradGrids_width, gradGrids_height, size_factors, layers_factors, map_width, map_height, context,
+                            BINARY_CODEC_PREDICTIVE, streamed_path, 0);
+
+    printf("Streamed file identical to the written one : %d (should be 1)\n", sameFiles(binary_path, streamed_path));
+
+    printf("Regenerating every chunk on its own...\n");
+    int nb_differences = 0;
+
+    for (int y = 0; y < map_height; y++)
+    {
+        for (int x = 0; x < map_width; x++)
+        {
+            chunk* regenerated_chunk = regenerateMapChunk(nb_layers, gradGrids_width, gradGrids_height, size_factors, layers_factors,
+                                                            map_width, map_height, x, y, context);
+
+            for (int i = 0; i < regenerated_chunk->height; i++)
+            {
+                for (int j = 0; j < regenerated_chunk->width; j++)
+                {
+                    if (*getChunkValue(regenerated_chunk, j, i) != *getMapValue(my_map, x * my_map->chunk_width + j, y * my_map->chunk_height + i))
+                    {
+                        nb_differences += 1;
+                    }
+                }
+            }
+
+            freeChunk(regenerated_chunk);
+        }
+    }
+
+    printf("Values differing from the full map : %d (should be 0)\n", nb_differences);
+
+    printf("Generating the same map with its chunks in place, as views into the map values...\n");
+    generatorContext views_context = *context;
+    views_context.options.chunk_views = 1;
+
+    map* views_map = newMap(nb_layers, gradGrids_width, gradGrids_height, size_factors, layers_factors, map_width, map_height, &views_context, 0);
+    nb_differences = 0;
+
+    for (int i = 0; i < map_height * my_map->chunk_height; i++)
+    {
+        for (int j = 0; j < map_width * my_map->chunk_width; j++)
+        {
+            if (*getMapValue(views_map, j, i) != *getMapValue(my_map, j, i))
+            {
+                nb_differences += 1;
+            }
+        }
+    }
+
+    printf("Values differing from the full map : %d (should be 0)\n", nb_differences);
+
+    printf("Writing both maps in tiled files...\n");
+    char tiled_path[200] = "../saves/map_tiled_test.bin";
+    char views_tiled_path[200] = "../saves/map_views_tiled_test.bin";
+
+    writeMapTiledFile(my_map, context->seed, tiled_path);
+    writeMapTiledFile(views_map, context->seed, views_tiled_path);
+
+    printf("Tiled files identical with and without chunk views : %d (should be 1)\n", sameFiles(tiled_path, views_tiled_path));
+
+
     printf("Deallocating now...\n");
 
     freeMap(my_map);
+    freeMap(views_map);
+
+    freeGeneratorContext(context);
 
     return 0;
 }
@@ -8,10 +8,51 @@
  */
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <time.h>
 
 #include "mapGenerator.h"
 
+/**
+ * @brief Counts the values of the map, of the sea map and of the color map that differ between the two given complete maps.
+ * 
+ * @param complete_map1 (completeMap*) : the pointer to the first complete map.
+ * @param complete_map2 (completeMap*) : the pointer to the second complete map, with the same dimensions.
+ * @param nb_differences (int[3]) : the array to fill with the number of differing map values, sea values and colors.
+ */
+static void countCompleteMapDifferences(completeMap* complete_map1, completeMap* complete_map2, int nb_differences[3])
+{
+    nb_differences[0] = 0;
+    nb_differences[1] = 0;
+    nb_differences[2] = 0;
+
+    for (int i = 0; i < complete_map1->height; i++)
+    {
+        for (int j = 0; j < complete_map1->width; j++)
+        {
+            if (*getMapValueUnchecked(complete_map1->map, j, i) != *getMapValueUnchecked(complete_map2->map, j, i))
+            {
+                nb_differences[0] += 1;
+            }
+
+            if (*getCompleteMapSeaValueUnchecked(complete_map1, j, i) != *getCompleteMapSeaValueUnchecked(complete_map2, j, i))
+            {
+                nb_differences[1] += 1;
+            }
+
+            color color1 = complete_map1->color_map[j + i * complete_map1->width];
+            color color2 = complete_map2->color_map[j + i * complete_map2->width];
+
+            if (color1.red != color2.red || color1.green != color2.green || color1.blue != color2.blue)
+            {
+                nb_differences[2] += 1;
+            }
+        }
+    }
+}
+
+
+
 int main()
 {
     //? Booleans to decide which tests to do
@@ -19,6 +60,9 @@ int main()
     int lcm_testing = 0;
     int lcm_array_testing = 0;
 
+    int parallel_generation_testing = 1;
+    int arena_generation_testing = 1;
+    int color_classes_testing = 1;
     int complete_map_generation_testing = 1;
 
 
@@ -75,6 +119,156 @@ int main()
 
 
 
+    // Parallel fullGen testing : the task graph should give the same complete map as the sequential generation
+    if (parallel_generation_testing == 1)
+    {
+        int dimensions[] = {3, 5, 15};
+        double weights[] = {1, .3, .05};
+        int nb_workers = 4;
+
+        char source_names[2][10] = {"stored", "hashed"};
+
+        for (int gradient_source = STORED_GRADIENTS; gradient_source <= HASHED_GRADIENTS; gradient_source++)
+        {
+            printf("Generating a complete map of 5 x 4 chunks with %s gradients, with 1 then %d workers...\n", source_names[gradient_source], nb_workers);
+
+            generatorContext* context = newGeneratorContext(1715794433);
+            context->options.gradient_source = gradient_source;
+
+            completeMap* sequential_map = fullGen(3, dimensions, weights, 5, 4, -.1, context, 0);
+
+            context->options.nb_workers = nb_workers;
+            completeMap* parallel_map = fullGen(3, dimensions, weights, 5, 4, -.1, context, 0);
+
+            int nb_differences[3];
+            countCompleteMapDifferences(sequential_map, parallel_map, nb_differences);
+
+            printf("Values differing : %d in the map, %d in the sea map, %d in the color map (should be 0, 0 and 0)\n",
+                        nb_differences[0], nb_differences[1], nb_differences[2]);
+
+            freeCompleteMap(sequential_map);
+            freeCompleteMap(parallel_map);
+            freeGeneratorContext(context);
+        }
+    }
+
+
+
+    // fullGen in an arena testing : the structures of the map are taken from the arena, and should have the same values as calloc'd ones
+    if (arena_generation_testing == 1)
+    {
+        int dimensions[] = {3, 5, 15};
+        double weights[] = {1, .3, .05};
+
+        char configuration_names[2][80] = {"stored gradients and full chunks", "hashed gradients, chunk views and trimmed chunks"};
+
+        for (int configuration = 0; configuration < 2; configuration++)
+        {
+            printf("Generating a complete map of 5 x 4 chunks with %s, calloc'd then in an arena...\n", configuration_names[configuration]);
+
+            generatorContext* context = newGeneratorContext(1715794433);
+
+            if (configuration == 1)
+            {
+                context->options.gradient_source = HASHED_GRADIENTS;
+                context->options.chunk_views = 1;
+                context->options.chunk_retention = KEEP_CHUNK_BOUNDARIES;
+            }
+
+            completeMap* heap_map = fullGen(3, dimensions, weights, 5, 4, -.1, context, 0);
+
+            memoryArena* arena = newMemoryArena(0);
+            context->options.arena = arena;
+            completeMap* arena_map = fullGen(3, dimensions, weights, 5, 4, -.1, context, 0);
+
+            int nb_differences[3];
+            countCompleteMapDifferences(heap_map, arena_map, nb_differences);
+
+            printf("Arena of %d block(s), values differing : %d in the map, %d in the sea map, %d in the color map (should be 0, 0 and 0)\n",
+                        arena->nb_blocks, nb_differences[0], nb_differences[1], nb_differences[2]);
+
+            // The map belongs to the arena : only the sea and color maps are free'd here, the rest with the arena
+            freeCompleteMap(arena_map);
+            freeMemoryArena(arena);
+
+            freeCompleteMap(heap_map);
+            freeGeneratorContext(context);
+        }
+    }
+
+
+
+    // Color map testing : every pixel should get a color of the sea or land class of getPaletteColor, even on the sea level itself
+    if (color_classes_testing == 1)
+    {
+        int dimensions[] = {3, 5, 15};
+        double weights[] = {1, .3, .05};
+
+        // Every sea color is fully blue, and no land color has any blue
+        paletteStop sea_stops[2] = {{0., {0, 0, 255}}, {1., {0, 128, 255}}};
+        paletteStop land_stops[2] = {{0., {0, 128, 0}}, {1., {255, 255, 0}}};
+        colorPalette* palette = newColorPalette(2, sea_stops, 2, land_stops);
+
+        generatorContext* context = newGeneratorContext(1715794433);
+        context->options.palette = palette;
+
+        completeMap* complete_map = fullGen(3, dimensions, weights, 5, 4, -.1, context, 0);
+        map* map = complete_map->map;
+
+        // The sea level is put on a value of the map, so that some pixels are exactly on it
+        double sea_level = *getMapValueUnchecked(map, complete_map->width / 2, complete_map->height / 2);
+
+        printf("Generating the color map of a 5 x 4 chunks map with its sea level on one of its values...\n");
+        color* color_map = generateColorMap(map, sea_level, context, 0);
+
+        double min_value = *getMapValueUnchecked(map, 0, 0);
+        double max_value = min_value;
+
+        for (int i = 0; i < complete_map->height; i++)
+        {
+            for (int j = 0; j < complete_map->width; j++)
+            {
+                double value = *getMapValueUnchecked(map, j, i);
+
+                min_value = value < min_value ? value : min_value;
+                max_value = value > max_value ? value : max_value;
+            }
+        }
+
+        int nb_wrong_classes = 0;
+        int nb_on_sea_level = 0;
+
+        for (int i = 0; i < complete_map->height; i++)
+        {
+            for (int j = 0; j < complete_map->width; j++)
+            {
+                double value = *getMapValueUnchecked(map, j, i);
+
+                color exact = getPaletteColor(palette, value, sea_level, min_value, max_value);
+                color table = color_map[j + i * complete_map->width];
+
+                if ((exact.blue == 255) != (table.blue == 255))
+                {
+                    nb_wrong_classes += 1;
+                }
+
+                if (value == sea_level)
+                {
+                    nb_on_sea_level += 1;
+                }
+            }
+        }
+
+        printf("Pixels on the sea level : %d, pixels of the wrong sea or land class : %d (should be 0)\n", nb_on_sea_level, nb_wrong_classes);
+
+        free(color_map);
+        freeCompleteMap(complete_map);
+        freeGeneratorContext(context);
+        freeColorPalette(palette);
+    }
+
+
+
     // fullGen testing
     if (complete_map_generation_testing == 1)
     {
@@ -85,7 +279,8 @@ int main()
 
         printf("Seed used for the generation : %ld\n", seed);
 
-        setRandomSeed(seed); //? Comment this to make it not random, or give a constant rather than time(NULL)
+        generatorContext* context = newGeneratorContext(seed); //? Give a constant rather than time(NULL) to make it not random
+        context->options.nb_workers = 1; //? Number of threads generating the chunks, 1 for a sequential generation
 
         int nb_layers = 2;
 
@@ -106,16 +301,17 @@ int main()
 
 
         //? MEMORY SPACE REQUIRED
-        long int mem_space_by_chunk = sizeof(chunk) + final_size * final_size * sizeof(double) + nb_layers * (sizeof(double) + sizeof(layer*))
-                                        + sizeof(layer) + final_size * final_size * sizeof(double);
+        // Map chunks are fused : their layers only keep their gradient grid, not their values.
+        long int mem_space_by_chunk = sizeof(chunk) + final_size * final_size * sizeof(altitude_t) + nb_layers * (sizeof(double) + sizeof(layer*))
+                                        + nb_layers * sizeof(layer);
         
         for (int i = 0; i < nb_layers; i++)
         {
             mem_space_by_chunk += sizeof(gradientGrid) + dimensions[i] * dimensions[i] * sizeof(vector);
         }
 
-        long int total_memory_space_used = sizeof(completeMap) + width * final_size * height * final_size * (sizeof(double) + sizeof(color*) + sizeof(color)) 
-                                            + sizeof(map) + width * final_size * height * final_size * sizeof(double)
+        long int total_memory_space_used = sizeof(completeMap) + width * final_size * height * final_size * (sizeof(altitude_t) + sizeof(color)) 
+                                            + sizeof(map) + width * final_size * height * final_size * sizeof(altitude_t)
                                             + width * height * (sizeof(chunk*) + mem_space_by_chunk);
         
         printf("The complete memory space used will be around %ld bytes.\n", total_memory_space_used);
@@ -142,13 +338,14 @@ int main()
         if (user_input != 1)
         {
             printf("The process was cancelled.\n");
+            freeGeneratorContext(context);
             return 1;
         }
 
 
 
         printf("Generating a complete map with given parameters...\n");
-        completeMap* new_complete_map = fullGen(nb_layers, dimensions, weights, width, height, sea_level, display_loading);
+        completeMap* new_complete_map = fullGen(nb_layers, dimensions, weights, width, height, sea_level, context, display_loading);
         printf("Generation complete!\n");
 
 
@@ -167,6 +364,7 @@ int main()
 
         printf("Deallocating now...\n");
         freeCompleteMap(new_complete_map);
+        freeGeneratorContext(context);
 
         double total_time = (double) (clock() - start_time) / CLOCKS_PER_SEC;
         printf("The whole map generation of lcm %d size %d x %d took a total of %lf second(s) in CPU time\n", final_size, width, height, total_time);
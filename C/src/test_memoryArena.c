@@ -0,0 +1,67 @@
+/**
+ * @file test_memoryArena.c
+ * @author Zyno and BlueNZ
+ * @brief a testing script for the memoryArena implementation
+ * @version 0.2
+ * @date 2024-06-19
+ *
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include "memoryArena.h"
+
+int main()
+{
+    size_t block_size = 4096;
+
+    printf("Creating a memory arena of %zu bytes blocks\n", block_size);
+    memoryArena* arena = newMemoryArena(block_size);
+
+    int nb_allocations = 100;
+    int nb_misaligned = 0;
+    int nb_not_zeroed = 0;
+
+    printf("Allocating %d small arrays...\n", nb_allocations);
+
+    for (int i = 0; i < nb_allocations; i++)
+    {
+        int length = 1 + i % 13;
+        double* values = arenaCalloc(arena, length, sizeof(double));
+
+        if ((uintptr_t) values % ARENA_ALIGNMENT != 0)
+        {
+            nb_misaligned += 1;
+        }
+
+        for (int k = 0; k < length; k++)
+        {
+            if (values[k] != 0.)
+            {
+                nb_not_zeroed += 1;
+            }
+            values[k] = i;
+        }
+    }
+
+    printf("Allocating a big array, in its own block...\n");
+
+    double* big_values = arenaCalloc(arena, 10 * block_size, sizeof(double));
+    big_values[10 * block_size - 1] = 1.;
+
+    if ((uintptr_t) big_values % ARENA_ALIGNMENT != 0)
+    {
+        nb_misaligned += 1;
+    }
+
+    printf("Misaligned allocations : %d (should be 0)\n", nb_misaligned);
+    printf("Not zeroed values : %d (should be 0)\n", nb_not_zeroed);
+    printf("The arena holds %d blocks, %zu bytes in total\n", arena->nb_blocks, arena->nb_bytes);
+
+    printf("Deallocating now...\n");
+
+    freeMemoryArena(arena);
+
+    return 0;
+}
@@ -0,0 +1,207 @@
+/**
+ * @file test_textFormat.c
+ * @author Zyno and BlueNZ
+ * @brief a testing script for the fast number formatting of the text files
+ * @version 0.2
+ * @date 2024-06-19
+ *
+ */
+
+// clock_gettime is not part of C99
+#define _POSIX_C_SOURCE 200809L
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "textFormat.h"
+
+/**
+ * @brief A write function that never writes anything, as a full disk would (see `textWriteFunction`).
+ *
+ * @param destination (void*) : unused.
+ * @param chars (const char*) : unused.
+ * @param nb_chars (size_t) : unused.
+ * @return int : `0`.
+ */
+static int refuseChars(void* destination, const char* chars, size_t nb_chars)
+{
+    return 0;
+}
+
+/**
+ * @brief Gets the elapsed wall clock time since the given time.
+ *
+ * @param start_time (struct timespec*) : the pointer to the start time.
+ * @return double : the elapsed time in seconds.
+ */
+static double getElapsedTime(struct timespec* start_time)
+{
+    struct timespec end_time;
+    clock_gettime(CLOCK_MONOTONIC, &end_time);
+
+    return (end_time.tv_sec - start_time->tv_sec) + 1e-9 * (end_time.tv_nsec - start_time->tv_nsec);
+}
+
+/**
+ * @brief Checks whether `formatFixed` writes the same characters as `snprintf` for the given value, and prints both otherwise.
+ *
+ * @param value (double) : the value.
+ * @param nb_decimals (int) : the number of decimals.
+ * @param space_sign (int) : `1` to write a space before the positive values, `0` otherwise.
+ * @return int : `1` if the characters differ, `0` otherwise.
+ */
+static int compareFixed(double value, int nb_decimals, int space_sign)
+{
+    char expected[TEXT_NUMBER_MAX_LENGTH + 1] = "";
+    snprintf(expected, sizeof(expected), space_sign ? "% .*f" : "%.*f", nb_decimals, value);
+
+    char formatted[TEXT_NUMBER_MAX_LENGTH + 1] = "";
+    int length = formatFixed(formatted, value, nb_decimals, space_sign);
+    formatted[length] = '\0';
+
+    if (strcmp(expected, formatted) != 0)
+    {
+        printf("Value %.17g with %d decimals : '%s' instead of '%s'\n", value, nb_decimals, formatted, expected);
+        return 1;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Draws a random double with random bits, whose magnitude is spread over many exponents.
+ *
+ * @return double : the random value.
+ */
+static double randomValue()
+{
+    uint64_t bits = ((uint64_t) rand() << 62) ^ ((uint64_t) rand() << 31) ^ (uint64_t) rand();
+    double mantissa = (double) (bits & ((1ULL << 53) - 1)) / (double) (1ULL << 53);
+    int exponent = rand() % 80 - 50;
+
+    return (rand() % 2 ? -1. : 1.) * ldexp(mantissa, exponent);
+}
+
+
+
+int main()
+{
+    srand(42);
+
+    printf("Comparing the formatted values with snprintf...\n");
+
+    double edge_values[] = {0., -0., 1., -1., 0.5, 1.5, 2.5, -2.5, 0.125, 0.375, 1e-9, 5e-9, 4.9999999e-9, -5e-9, 0.000000005,
+                                0.123456785, 0.99999999999, 999999999.999999999, 123456789.5, 1e-300, -1e-300, 4.9406564584124654e-324,
+                                2.2250738585072014e-308, 1e9, -1e9, 1e300, 1e308, -1.7976931348623157e308, INFINITY, -INFINITY, NAN};
+    int nb_edge_values = sizeof(edge_values) / sizeof(double);
+    int nb_differences = 0;
+
+    for (int k = 0; k < nb_edge_values; k++)
+    {
+        for (int nb_decimals = 0; nb_decimals <= TEXT_MAX_DECIMALS; nb_decimals++)
+        {
+            nb_differences += compareFixed(edge_values[k], nb_decimals, 1);
+            nb_differences += compareFixed(edge_values[k], nb_decimals, 0);
+        }
+    }
+
+    printf("Edge values differing : %d (should be 0)\n", nb_differences);
+
+    // The exact halves of the last decimal, whose rounding goes to the even digit
+    nb_differences = 0;
+
+    for (int k = 0; k < 100000; k++)
+    {
+        double value = (2 * (rand() % 1000000) + 1) / 512.;
+        nb_differences += compareFixed(value, 8, 1) + compareFixed(-value, 2, 1);
+    }
+
+    printf("Halfway values differing : %d (should be 0)\n", nb_differences);
+
+    nb_differences = 0;
+    int nb_values = 1000000;
+
+    for (int k = 0; k < nb_values; k++)
+    {
+        double value = randomValue();
+        float float_value = (float) value;
+
+        nb_differences += compareFixed(value, 8, 1) + compareFixed(value, k % (TEXT_MAX_DECIMALS + 1), 0) + compareFixed(float_value, 4, 0);
+    }
+
+    printf("Random values differing : %d (should be 0)\n", nb_differences);
+
+    char integers[TEXT_NUMBER_MAX_LENGTH + 1] = "";
+    char expected[TEXT_NUMBER_MAX_LENGTH + 1] = "";
+    int integer_values[5] = {0, 255, -17, 2147483647, -2147483647 - 1};
+    nb_differences = 0;
+
+    for (int k = 0; k < 5; k++)
+    {
+        integers[formatInteger(integers, integer_values[k])] = '\0';
+        snprintf(expected, sizeof(expected), "%d", integer_values[k]);
+
+        nb_differences += strcmp(integers, expected) != 0;
+    }
+
+    printf("Integers differing : %d (should be 0)\n", nb_differences);
+
+    printf("Timing a row of %d values...\n", nb_values);
+    double* values = calloc(nb_values, sizeof(double));
+
+    for (int k = 0; k < nb_values; k++)
+    {
+        values[k] = 2. * rand() / RAND_MAX - 1.;
+    }
+
+    FILE* f = fopen("/dev/null", "w");
+
+    if (f == NULL)
+    {
+        printf("Could not open /dev/null, skipping the timings\n");
+        free(values);
+        return 0;
+    }
+
+    struct timespec start_time;
+    clock_gettime(CLOCK_MONOTONIC, &start_time);
+
+    for (int k = 0; k < nb_values; k++)
+    {
+        fprintf(f, "% .8lf\t", values[k]);
+    }
+
+    double fprintf_time = getElapsedTime(&start_time);
+
+    textRow* row = newTextRow(TEXT_VALUE_LENGTH * nb_values);
+    clock_gettime(CLOCK_MONOTONIC, &start_time);
+
+    for (int k = 0; k < nb_values; k++)
+    {
+        appendTextFixed(row, values[k], 8, 1);
+        appendTextChar(row, '\t');
+    }
+
+    int success = writeTextRow(row, f);
+
+    double row_time = getElapsedTime(&start_time);
+
+    printf("Values written in %lf second(s) with fprintf, %lf second(s) through a row buffer (written : %d, should be 1)\n", fprintf_time,
+                row_time, success);
+
+    // A short write is reported, and the row is emptied all the same
+    appendTextFixed(row, values[0], 8, 1);
+    int refused_success = flushTextRow(row, refuseChars, NULL);
+
+    printf("Row given to a failing write : written %d (should be 0), characters left %zu (should be 0)\n", refused_success, row->nb_chars);
+
+    freeTextRow(row);
+    fclose(f);
+    free(values);
+
+    return 0;
+}
@@ -0,0 +1,162 @@
+/**
+ * @file test_threadPool.c
+ * @author Zyno and BlueNZ
+ * @brief a testing script for the threadPool implementation
+ * @version 0.2
+ * @date 2024-06-19
+ *
+ */
+
+#include <stdio.h>
+
+#include "threadPool.h"
+
+/**
+ * @brief The argument of the testing tasks : a range of integers to sum, split in sub-tasks until it is small enough.
+ *
+ */
+struct sumTask
+{
+    threadPool* pool; /**< the pointer to the pool to submit the sub-tasks on*/
+    long int begin; /**< the first integer of the range*/
+    long int end; /**< the integer after the last one of the range*/
+    long int result; /**< the sum of the range*/
+};
+
+/**
+ * @brief Sums a range of integers, splitting it in two nested sub-tasks when it is too big.
+ *
+ * @param argument (void*) : the pointer to the sumTask structure.
+ */
+static void sumRange(void* argument)
+{
+    struct sumTask* range = argument;
+
+    if (range->end - range->begin <= 1000)
+    {
+        range->result = 0;
+        for (long int k = range->begin; k < range->end; k++)
+        {
+            range->result += k;
+        }
+        return;
+    }
+
+    long int middle = (range->begin + range->end) / 2;
+
+    struct sumTask first = {range->pool, range->begin, middle, 0};
+    struct sumTask second = {range->pool, middle, range->end, 0};
+
+    taskGroup group = {0};
+    submitTask(range->pool, &group, sumRange, &first);
+    submitTask(range->pool, &group, sumRange, &second);
+    waitTaskGroup(range->pool, &group);
+
+    range->result = first.result + second.result;
+}
+
+/**
+ * @brief The argument of the graph testing tasks : one term of the Fibonacci sequence, computed once the two previous ones are.
+ *
+ */
+struct fibonacciTask
+{
+    long int* terms; /**< the array of the terms of the sequence*/
+    int idx; /**< the index of the term to compute*/
+};
+
+/**
+ * @brief Computes one term of the Fibonacci sequence from the two previous ones.
+ *
+ * @param argument (void*) : the pointer to the fibonacciTask structure.
+ */
+static void computeFibonacciTerm(void* argument)
+{
+    struct fibonacciTask* term = argument;
+
+    term->terms[term->idx] = term->terms[term->idx - 1] + term->terms[term->idx - 2];
+}
+
+/**
+ * @brief Computes the Fibonacci sequence up to the given term with a graph of tasks, launched in the reverse order of their dependencies.
+ *
+ * @param pool (threadPool*) : the pointer to the pool to run the tasks on, can be `NULL`.
+ * @param n (int) : the index of the last term to compute. Should be in `[2, 90]`.
+ * @return long int : the last term.
+ */
+static long int fibonacciGraph(threadPool* pool, int n)
+{
+    long int terms[n + 1];
+    struct fibonacciTask arguments[n + 1];
+    task* graph_tasks[n + 1];
+
+    terms[0] = 0;
+    terms[1] = 1;
+
+    taskGroup group = {0};
+
+    for (int k = 2; k <= n; k++)
+    {
+        arguments[k].terms = terms;
+        arguments[k].idx = k;
+
+        graph_tasks[k] = newGraphTask(pool, &group, computeFibonacciTerm, arguments + k);
+
+        for (int d = k - 2; d < k; d++)
+        {
+            if (d >= 2)
+            {
+                addTaskDependency(pool, graph_tasks[d], graph_tasks[k]);
+            }
+        }
+    }
+
+    for (int k = n; k >= 2; k--)
+    {
+        launchGraphTask(pool, graph_tasks[k]);
+    }
+
+    waitTaskGroup(pool, &group);
+
+    return terms[n];
+}
+
+int main()
+{
+    int nb_threads = 4;
+    long int n = 1000000;
+
+    printf("Creating a thread pool of %d worker threads\n", nb_threads);
+    threadPool* pool = newThreadPool(nb_threads);
+
+    printf("Summing the integers from 0 to %ld with nested tasks...\n", n - 1);
+
+    struct sumTask range = {pool, 0, n, 0};
+
+    taskGroup group = {0};
+    submitTask(pool, &group, sumRange, &range);
+    waitTaskGroup(pool, &group);
+
+    printf("Result : %ld (should be %ld)\n", range.result, n * (n - 1) / 2);
+
+    printf("Summing them again without any pool...\n");
+
+    struct sumTask sequential_range = {NULL, 0, n, 0};
+    sumRange(&sequential_range);
+
+    printf("Result : %ld (should be %ld)\n", sequential_range.result, n * (n - 1) / 2);
+
+    int n_fibonacci = 90;
+
+    printf("Computing the Fibonacci term %d with a task graph...\n", n_fibonacci);
+    printf("Result : %ld (should be 2880067194370816120)\n", fibonacciGraph(pool, n_fibonacci));
+
+    printf("Computing it again without any pool...\n");
+    printf("Result : %ld (should be 2880067194370816120)\n", fibonacciGraph(NULL, n_fibonacci));
+
+    printf("Deallocating now...\n");
+
+    freeThreadPool(pool);
+
+    return 0;
+}
@@ -0,0 +1,326 @@
+/**
+ * @file textFormat.c
+ * @author Zyno and BlueNZ
+ * @brief fast number formatting implementation
+ * @version 0.2
+ * @date 2024-06-19
+ *
+ */
+
+#include <malloc.h>
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "textFormat.h"
+
+/**
+ * @brief The powers of ten up to `10^TEXT_MAX_DECIMALS`.
+ *
+ */
+static const uint64_t POWERS_OF_TEN[TEXT_MAX_DECIMALS + 1] = {1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL,
+                                                                100000000ULL, 1000000000ULL};
+
+/**
+ * @brief Gets the given bit of a 128 bits integer.
+ *
+ * @param high (uint64_t) : the 64 high bits of the integer.
+ * @param low (uint64_t) : the 64 low bits of the integer.
+ * @param bit_idx (int) : the index of the bit, in `[0, 128[`.
+ * @return int : the bit.
+ */
+static int getBit128(uint64_t high, uint64_t low, int bit_idx)
+{
+    return bit_idx < 64 ? (low >> bit_idx) & 1 : (high >> (bit_idx - 64)) & 1;
+}
+
+/**
+ * @brief Checks whether any of the bits below the given one of a 128 bits integer is set.
+ *
+ * @param high (uint64_t) : the 64 high bits of the integer.
+ * @param low (uint64_t) : the 64 low bits of the integer.
+ * @param nb_bits (int) : the number of low bits to look at, in `[0, 128]`.
+ * @return int : `1` if one of the `nb_bits` low bits is set, `0` otherwise.
+ */
+static int hasLowBits128(uint64_t high, uint64_t low, int nb_bits)
+{
+    if (nb_bits <= 0)
+    {
+        return 0;
+    }
+
+    if (nb_bits < 64)
+    {
+        return (low & ((1ULL << nb_bits) - 1)) != 0;
+    }
+
+    if (low != 0)
+    {
+        return 1;
+    }
+
+    return nb_bits > 64 && nb_bits < 128 ? (high & ((1ULL << (nb_bits - 64)) - 1)) != 0 : (nb_bits >= 128 && high != 0);
+}
+
+/**
+ * @brief Rounds the given finite value times `10^nb_decimals` to the nearest integer, half to even, without any intermediate rounding :
+ * the value is `mantissa * 2^exponent`, the product by the power of ten is exact on 128 bits before being shifted.
+ *
+ * @param magnitude (double) : the absolute value, below `TEXT_FAST_LIMIT`.
+ * @param nb_decimals (int) : the number of decimals, in `[0, TEXT_MAX_DECIMALS]`.
+ * @return uint64_t : the rounded scaled value.
+ */
+static uint64_t roundScaled(double magnitude, int nb_decimals)
+{
+    uint64_t bits = 0;
+    memcpy(&bits, &magnitude, sizeof(double));
+
+    int biased_exponent = (int) ((bits >> 52) & 0x7ff);
+    uint64_t mantissa = bits & ((1ULL << 52) - 1);
+    int exponent = -1074;
+
+    if (biased_exponent != 0)
+    {
+        mantissa |= 1ULL << 52;
+        exponent = biased_exponent - 1075;
+    }
+
+    uint64_t power = POWERS_OF_TEN[nb_decimals];
+
+    // An integer below the limit : exact on 64 bits
+    if (exponent >= 0)
+    {
+        return (mantissa << exponent) * power;
+    }
+
+    // The product on 128 bits, below 2^83
+    uint64_t low_product = (mantissa & 0xffffffffULL) * power;
+    uint64_t high_product = (mantissa >> 32) * power;
+
+    uint64_t low = low_product + (high_product << 32);
+    uint64_t high = (high_product >> 32) + (low < low_product);
+
+    int shift = -exponent;
+
+    // Below half of the last decimal
+    if (shift >= 84)
+    {
+        return 0;
+    }
+
+    uint64_t scaled = shift >= 64 ? high >> (shift - 64) : (low >> shift) | (high << (64 - shift));
+
+    // Half to even : up if above half, or exactly half and odd
+    if (getBit128(high, low, shift - 1) && (hasLowBits128(high, low, shift - 1) || (scaled & 1)))
+    {
+        scaled += 1;
+    }
+
+    return scaled;
+}
+
+/**
+ * @brief Writes the decimal digits of the given integer, with at least the given number of digits (padded with zeros).
+ *
+ * @param buffer (char*) : the buffer to write the digits in.
+ * @param value (uint64_t) : the integer.
+ * @param min_digits (int) : the minimum number of digits.
+ * @return int : the number of digits written.
+ */
+static int writeDigits(char* buffer, uint64_t value, int min_digits)
+{
+    char digits[20];
+    int nb_digits = 0;
+
+    do
+    {
+        digits[nb_digits] = (char) ('0' + value % 10);
+        value /= 10;
+        nb_digits += 1;
+    }
+    while (value != 0);
+
+    while (nb_digits < min_digits)
+    {
+        digits[nb_digits] = '0';
+        nb_digits += 1;
+    }
+
+    for (int k = 0; k < nb_digits; k++)
+    {
+        buffer[k] = digits[nb_digits - 1 - k];
+    }
+
+    return nb_digits;
+}
+
+/**
+ * @brief Writes the given characters in the given file with a single `fwrite` (see `textWriteFunction`).
+ *
+ * @param destination (void*) : the pointer to the file, opened in writing mode.
+ * @param chars (const char*) : the characters.
+ * @param nb_chars (size_t) : the number of characters.
+ * @return int : `1` if the characters were written, `0` otherwise.
+ */
+static int writeFileChars(void* destination, const char* chars, size_t nb_chars)
+{
+    return fwrite(chars, 1, nb_chars, destination) == nb_chars;
+}
+
+/**
+ * @brief Makes sure the row has room for `nb_chars` more characters, growing it if needed.
+ *
+ * @param row (textRow*) : the pointer to the row buffer.
+ * @param nb_chars (size_t) : the number of characters to be appended.
+ */
+static void reserveTextRow(textRow* row, size_t nb_chars)
+{
+    if (row->nb_chars + nb_chars > row->capacity)
+    {
+        size_t new_capacity = 2 * row->capacity;
+
+        if (new_capacity < row->nb_chars + nb_chars)
+        {
+            new_capacity = row->nb_chars + nb_chars;
+        }
+
+        row->chars = realloc(row->chars, new_capacity);
+        row->capacity = new_capacity;
+    }
+}
+
+
+
+
+
+int formatFixed(char* buffer, double value, int nb_decimals, int space_sign)
+{
+    if (nb_decimals < 0 || nb_decimals > TEXT_MAX_DECIMALS || !isfinite(value) || fabs(value) >= TEXT_FAST_LIMIT)
+    {
+        char text[TEXT_NUMBER_MAX_LENGTH + 1];
+        int length = snprintf(text, sizeof(text), space_sign ? "% .*f" : "%.*f", nb_decimals, value);
+
+        if (length < 0)
+        {
+            return 0;
+        }
+
+        if (length > TEXT_NUMBER_MAX_LENGTH)
+        {
+            length = TEXT_NUMBER_MAX_LENGTH;
+        }
+
+        memcpy(buffer, text, length);
+        return length;
+    }
+
+    int length = 0;
+
+    // The sign of a negative value is kept when it rounds to zero, as printf does
+    if (signbit(value))
+    {
+        buffer[length++] = '-';
+    }
+    else if (space_sign)
+    {
+        buffer[length++] = ' ';
+    }
+
+    uint64_t scaled = roundScaled(fabs(value), nb_decimals);
+    uint64_t power = POWERS_OF_TEN[nb_decimals];
+
+    length += writeDigits(buffer + length, scaled / power, 1);
+
+    if (nb_decimals > 0)
+    {
+        buffer[length++] = '.';
+        length += writeDigits(buffer + length, scaled % power, nb_decimals);
+    }
+
+    return length;
+}
+
+
+
+int formatInteger(char* buffer, int value)
+{
+    int length = 0;
+    uint64_t magnitude = (uint64_t) (value < 0 ? -(int64_t) value : value);
+
+    if (value < 0)
+    {
+        buffer[length++] = '-';
+    }
+
+    return length + writeDigits(buffer + length, magnitude, 1);
+}
+
+
+
+textRow* newTextRow(size_t capacity)
+{
+    textRow* new_row = calloc(1, sizeof(textRow));
+
+    new_row->capacity = capacity > 0 ? capacity : TEXT_NUMBER_MAX_LENGTH;
+    new_row->chars = malloc(new_row->capacity);
+    new_row->nb_chars = 0;
+
+    return new_row;
+}
+
+
+
+void appendTextChar(textRow* row, char character)
+{
+    reserveTextRow(row, 1);
+
+    row->chars[row->nb_chars] = character;
+    row->nb_chars += 1;
+}
+
+
+
+void appendTextFixed(textRow* row, double value, int nb_decimals, int space_sign)
+{
+    reserveTextRow(row, TEXT_NUMBER_MAX_LENGTH);
+
+    row->nb_chars += formatFixed(row->chars + row->nb_chars, value, nb_decimals, space_sign);
+}
+
+
+
+void appendTextInteger(textRow* row, int value)
+{
+    reserveTextRow(row, 11);
+
+    row->nb_chars += formatInteger(row->chars + row->nb_chars, value);
+}
+
+
+
+int flushTextRow(textRow* row, textWriteFunction write_chars, void* destination)
+{
+    int success = write_chars(destination, row->chars, row->nb_chars);
+
+    row->nb_chars = 0;
+
+    return success;
+}
+
+
+
+int writeTextRow(textRow* row, FILE* f)
+{
+    return flushTextRow(row, writeFileChars, f);
+}
+
+
+
+void freeTextRow(textRow* row)
+{
+    if (row != NULL)
+    {
+        free(row->chars);
+        free(row);
+    }
+}
@@ -0,0 +1,575 @@
+/**
+ * @file threadPool.c
+ * @author Zyno and BlueNZ
+ * @brief threadPool structure implementation
+ * @version 0.2
+ * @date 2024-06-19
+ *
+ */
+
+#include <malloc.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "loadingBar.h"
+#include "threadPool.h"
+
+/**
+ * @brief Pops the next task queued by a thread outside of the pool. The pool mutex should be locked.
+ *
+ * @param pool (threadPool*) : the pointer to the thread pool.
+ * @return task* : the pointer to the popped task, `NULL` if the queue is empty.
+ */
+static task* popTask(threadPool* pool)
+{
+    task* next_task = pool->first_task;
+
+    if (next_task != NULL)
+    {
+        pool->first_task = next_task->next;
+
+        if (pool->first_task == NULL)
+        {
+            pool->last_task = NULL;
+        }
+    }
+
+    return next_task;
+}
+
+/**
+ * @brief Pushes the given task at the bottom of the given deque, growing it if needed. The pool mutex should be locked.
+ *
+ * @param deque (taskDeque*) : the pointer to the deque.
+ * @param new_task (task*) : the pointer to the task to push.
+ */
+static void pushDequeBottom(taskDeque* deque, task* new_task)
+{
+    if (deque->nb_tasks == deque->capacity)
+    {
+        int new_capacity = deque->capacity > 0 ? 2 * deque->capacity : 16;
+        task** new_tasks = calloc(new_capacity, sizeof(task*));
+
+        for (int k = 0; k < deque->nb_tasks; k++)
+        {
+            new_tasks[k] = deque->tasks[(deque->top + k) % deque->capacity];
+        }
+
+        free(deque->tasks);
+
+        deque->tasks = new_tasks;
+        deque->top = 0;
+        deque->capacity = new_capacity;
+    }
+
+    deque->tasks[(deque->top + deque->nb_tasks) % deque->capacity] = new_task;
+    deque->nb_tasks += 1;
+}
+
+/**
+ * @brief Pops the newest task of the given deque, for its owner. The pool mutex should be locked.
+ *
+ * @param deque (taskDeque*) : the pointer to the deque.
+ * @return task* : the pointer to the popped task, `NULL` if the deque is empty.
+ */
+static task* popDequeBottom(taskDeque* deque)
+{
+    if (deque->nb_tasks == 0)
+    {
+        return NULL;
+    }
+
+    deque->nb_tasks -= 1;
+
+    return deque->tasks[(deque->top + deque->nb_tasks) % deque->capacity];
+}
+
+/**
+ * @brief Steals the oldest task of the given deque. The pool mutex should be locked.
+ *
+ * @param deque (taskDeque*) : the pointer to the deque.
+ * @return task* : the pointer to the stolen task, `NULL` if the deque is empty.
+ */
+static task* stealDequeTop(taskDeque* deque)
+{
+    if (deque->nb_tasks == 0)
+    {
+        return NULL;
+    }
+
+    task* stolen_task = deque->tasks[deque->top];
+
+    deque->top = (deque->top + 1) % deque->capacity;
+    deque->nb_tasks -= 1;
+
+    return stolen_task;
+}
+
+/**
+ * @brief Queues a task that is ready to run : at the bottom of the deque of the current thread if it is a worker,
+ * in the queue of the outside threads otherwise. The pool mutex should be locked.
+ *
+ * @param pool (threadPool*) : the pointer to the thread pool.
+ * @param ready_task (task*) : the pointer to the task to queue.
+ */
+static void pushReadyTask(threadPool* pool, task* ready_task)
+{
+    taskDeque* own_deque = pthread_getspecific(pool->worker_key);
+
+    if (own_deque != NULL)
+    {
+        pushDequeBottom(own_deque, ready_task);
+    }
+    else
+    {
+        ready_task->next = NULL;
+
+        if (pool->last_task == NULL)
+        {
+            pool->first_task = ready_task;
+        }
+        else
+        {
+            pool->last_task->next = ready_task;
+        }
+        pool->last_task = ready_task;
+    }
+
+    pthread_cond_broadcast(&pool->state_changed);
+}
+
+/**
+ * @brief Finds the next task the current thread should run : the newest one of its own deque, then the oldest one queued by the outside
+ * threads, then the oldest one of the other workers deques. The pool mutex should be locked.
+ *
+ * @param pool (threadPool*) : the pointer to the thread pool.
+ * @return task* : the pointer to the task to run, `NULL` if there is none.
+ */
+static task* findTask(threadPool* pool)
+{
+    taskDeque* own_deque = pthread_getspecific(pool->worker_key);
+    task* next_task = NULL;
+
+    if (own_deque != NULL)
+    {
+        next_task = popDequeBottom(own_deque);
+    }
+
+    if (next_task == NULL)
+    {
+        next_task = popTask(pool);
+    }
+
+    // Stealing, starting from the next worker so that the thieves spread over the deques
+    int first_victim = own_deque != NULL ? own_deque->worker_idx + 1 : 0;
+
+    for (int k = 0; next_task == NULL && k < pool->nb_threads; k++)
+    {
+        next_task = stealDequeTop(pool->deques + (first_victim + k) % pool->nb_threads);
+    }
+
+    return next_task;
+}
+
+static void runGraphTaskInline(task* graph_task);
+
+/**
+ * @brief Removes one dependency of the given graph task, and queues it (or runs it, without pool) if it was the last one.
+ * The pool mutex should be locked.
+ *
+ * @param pool (threadPool*) : the pointer to the thread pool, can be `NULL`.
+ * @param graph_task (task*) : the pointer to the graph task.
+ */
+static void releaseDependency(threadPool* pool, task* graph_task)
+{
+    graph_task->nb_dependencies -= 1;
+
+    if (graph_task->nb_dependencies == 0)
+    {
+        if (pool != NULL)
+        {
+            pushReadyTask(pool, graph_task);
+        }
+        else
+        {
+            runGraphTaskInline(graph_task);
+        }
+    }
+}
+
+/**
+ * @brief Runs the given ready graph task without any pool, then its successors that become ready.
+ *
+ * @param graph_task (task*) : the pointer to the graph task.
+ */
+static void runGraphTaskInline(task* graph_task)
+{
+    graph_task->function(graph_task->argument);
+
+    graph_task->done = 1;
+    graph_task->group->remaining -= 1;
+
+    for (int k = 0; k < graph_task->nb_successors; k++)
+    {
+        releaseDependency(NULL, graph_task->successors[k]);
+    }
+}
+
+/**
+ * @brief Runs the given task with the pool mutex unlocked, then marks it as done and releases its successors. The pool mutex should be locked.
+ *
+ * @param pool (threadPool*) : the pointer to the thread pool.
+ * @param current_task (task*) : the pointer to the task to run. It is free'd, unless it is a graph task.
+ */
+static void runTask(threadPool* pool, task* current_task)
+{
+    pthread_mutex_unlock(&pool->mutex);
+
+    current_task->function(current_task->argument);
+
+    pthread_mutex_lock(&pool->mutex);
+
+    current_task->group->remaining -= 1;
+
+    if (current_task->is_graph_task)
+    {
+        current_task->done = 1;
+
+        for (int k = 0; k < current_task->nb_successors; k++)
+        {
+            releaseDependency(pool, current_task->successors[k]);
+        }
+    }
+    else
+    {
+        free(current_task);
+    }
+
+    pthread_cond_broadcast(&pool->state_changed);
+}
+
+/**
+ * @brief The loop of every worker thread : runs the queued tasks until the pool stops.
+ *
+ * @param argument (void*) : the pointer to the deque of the worker.
+ * @return void* : always `NULL`.
+ */
+static void* workerLoop(void* argument)
+{
+    taskDeque* own_deque = argument;
+    threadPool* pool = own_deque->pool;
+
+    pthread_setspecific(pool->worker_key, own_deque);
+
+    pthread_mutex_lock(&pool->mutex);
+
+    while (1)
+    {
+        task* current_task = findTask(pool);
+
+        if (current_task != NULL)
+        {
+            runTask(pool, current_task);
+        }
+        else if (pool->stop)
+        {
+            break;
+        }
+        else
+        {
+            pthread_cond_wait(&pool->state_changed, &pool->mutex);
+        }
+    }
+
+    pthread_mutex_unlock(&pool->mutex);
+
+    return NULL;
+}
+
+
+
+
+
+threadPool* newThreadPool(int nb_threads)
+{
+    threadPool* new_pool = calloc(1, sizeof(threadPool));
+
+    new_pool->first_task = NULL;
+    new_pool->last_task = NULL;
+    new_pool->stop = 0;
+
+    pthread_mutex_init(&new_pool->mutex, NULL);
+    pthread_cond_init(&new_pool->state_changed, NULL);
+    pthread_key_create(&new_pool->worker_key, NULL);
+
+    new_pool->threads = calloc(nb_threads > 0 ? nb_threads : 1, sizeof(pthread_t));
+    new_pool->deques = calloc(nb_threads > 0 ? nb_threads : 1, sizeof(taskDeque));
+    new_pool->nb_threads = 0;
+
+    for (int i = 0; i < nb_threads; i++)
+    {
+        new_pool->deques[i].pool = new_pool;
+        new_pool->deques[i].worker_idx = i;
+
+        if (pthread_create(new_pool->threads + i, NULL, workerLoop, new_pool->deques + i) != 0)
+        {
+            printf("%sERROR : could not start worker thread %d. The pool will run with %d thread(s).%s\n", RED_COLOR, i, i, DEFAULT_COLOR);
+            break;
+        }
+
+        // Thieves only look at the started workers deques
+        pthread_mutex_lock(&new_pool->mutex);
+        new_pool->nb_threads += 1;
+        pthread_mutex_unlock(&new_pool->mutex);
+    }
+
+    return new_pool;
+}
+
+
+
+void submitTask(threadPool* pool, taskGroup* group, taskFunction function, void* argument)
+{
+    if (pool == NULL)
+    {
+        function(argument);
+        return;
+    }
+
+    task* new_task = calloc(1, sizeof(task));
+
+    new_task->function = function;
+    new_task->argument = argument;
+    new_task->group = group;
+    new_task->next = NULL;
+    new_task->is_graph_task = 0;
+
+    pthread_mutex_lock(&pool->mutex);
+
+    group->remaining += 1;
+    pushReadyTask(pool, new_task);
+
+    pthread_mutex_unlock(&pool->mutex);
+}
+
+
+
+task* newGraphTask(threadPool* pool, taskGroup* group, taskFunction function, void* argument)
+{
+    task* new_task = calloc(1, sizeof(task));
+
+    new_task->function = function;
+    new_task->argument = argument;
+    new_task->group = group;
+    new_task->next = NULL;
+    new_task->is_graph_task = 1;
+    // Held until it is launched
+    new_task->nb_dependencies = 1;
+    new_task->done = 0;
+    new_task->successors = NULL;
+    new_task->nb_successors = 0;
+    new_task->successors_capacity = 0;
+
+    if (pool != NULL)
+    {
+        pthread_mutex_lock(&pool->mutex);
+    }
+
+    group->remaining += 1;
+    new_task->next_graph_task = group->graph_tasks;
+    group->graph_tasks = new_task;
+
+    if (pool != NULL)
+    {
+        pthread_mutex_unlock(&pool->mutex);
+    }
+
+    return new_task;
+}
+
+
+
+void addTaskDependency(threadPool* pool, task* predecessor, task* successor)
+{
+    if (pool != NULL)
+    {
+        pthread_mutex_lock(&pool->mutex);
+    }
+
+    if (!predecessor->done)
+    {
+        if (predecessor->nb_successors == predecessor->successors_capacity)
+        {
+            predecessor->successors_capacity = predecessor->successors_capacity > 0 ? 2 * predecessor->successors_capacity : 4;
+            predecessor->successors = realloc(predecessor->successors, predecessor->successors_capacity * sizeof(task*));
+        }
+
+        predecessor->successors[predecessor->nb_successors] = successor;
+        predecessor->nb_successors += 1;
+
+        successor->nb_dependencies += 1;
+    }
+
+    if (pool != NULL)
+    {
+        pthread_mutex_unlock(&pool->mutex);
+    }
+}
+
+
+
+void launchGraphTask(threadPool* pool, task* graph_task)
+{
+    if (pool != NULL)
+    {
+        pthread_mutex_lock(&pool->mutex);
+    }
+
+    releaseDependency(pool, graph_task);
+
+    if (pool != NULL)
+    {
+        pthread_mutex_unlock(&pool->mutex);
+    }
+}
+
+
+
+void waitTaskGroup(threadPool* pool, taskGroup* group)
+{
+    if (pool != NULL)
+    {
+        pthread_mutex_lock(&pool->mutex);
+
+        while (group->remaining > 0)
+        {
+            // Helping the workers rather than sleeping : this is what makes nested waits safe.
+            task* current_task = findTask(pool);
+
+            if (current_task != NULL)
+            {
+                runTask(pool, current_task);
+            }
+            else
+            {
+                pthread_cond_wait(&pool->state_changed, &pool->mutex);
+            }
+        }
+
+        pthread_mutex_unlock(&pool->mutex);
+    }
+
+    // Every graph task of the group is done : nobody can reach them anymore
+    while (group->graph_tasks != NULL)
+    {
+        task* graph_task = group->graph_tasks;
+        group->graph_tasks = graph_task->next_graph_task;
+
+        free(graph_task->successors);
+        free(graph_task);
+    }
+}
+
+
+
+/**
+ * @brief One band of rows of `parallelRowBands`, run as a task.
+ *
+ */
+struct rowBandTask
+{
+    rowBandFunction function; /**< the function to run*/
+    void* argument; /**< the argument to pass to the function*/
+    int band_idx; /**< the index of the band*/
+    int first_row; /**< the first row of the band*/
+    int end_row; /**< the row after the last one of the band*/
+};
+
+/**
+ * @brief Runs the function of a rowBandTask on its band.
+ *
+ * @param argument (void*) : the pointer to the rowBandTask structure.
+ */
+static void runRowBand(void* argument)
+{
+    struct rowBandTask* band = argument;
+
+    band->function(band->argument, band->band_idx, band->first_row, band->end_row);
+}
+
+
+
+int countRowBands(threadPool* pool, int nb_rows)
+{
+    if (pool == NULL || nb_rows <= 1)
+    {
+        return 1;
+    }
+
+    // 4 bands per thread, the calling one included
+    int nb_bands = 4 * (pool->nb_threads + 1);
+
+    return nb_bands < nb_rows ? nb_bands : nb_rows;
+}
+
+
+
+void parallelRowBands(threadPool* pool, int nb_rows, rowBandFunction function, void* argument)
+{
+    int nb_bands = countRowBands(pool, nb_rows);
+
+    if (nb_bands == 1)
+    {
+        function(argument, 0, 0, nb_rows);
+        return;
+    }
+
+    struct rowBandTask* bands = calloc(nb_bands, sizeof(struct rowBandTask));
+    taskGroup group = {0};
+
+    for (int b = 0; b < nb_bands; b++)
+    {
+        bands[b].function = function;
+        bands[b].argument = argument;
+        bands[b].band_idx = b;
+        bands[b].first_row = (int) ((long int) nb_rows * b / nb_bands);
+        bands[b].end_row = (int) ((long int) nb_rows * (b + 1) / nb_bands);
+
+        submitTask(pool, &group, runRowBand, bands + b);
+    }
+
+    waitTaskGroup(pool, &group);
+
+    free(bands);
+}
+
+
+
+void freeThreadPool(threadPool* pool)
+{
+    if (pool != NULL)
+    {
+        pthread_mutex_lock(&pool->mutex);
+        pool->stop = 1;
+        pthread_cond_broadcast(&pool->state_changed);
+        pthread_mutex_unlock(&pool->mutex);
+
+        for (int i = 0; i < pool->nb_threads; i++)
+        {
+            pthread_join(pool->threads[i], NULL);
+        }
+
+        pthread_mutex_destroy(&pool->mutex);
+        pthread_cond_destroy(&pool->state_changed);
+        pthread_key_delete(pool->worker_key);
+
+        for (int i = 0; i < pool->nb_threads; i++)
+        {
+            free(pool->deques[i].tasks);
+        }
+
+        free(pool->deques);
+        free(pool->threads);
+        free(pool);
+    }
+}